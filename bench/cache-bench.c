@@ -0,0 +1,102 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include <stdio.h>
+#include "../include/d4/cache.h"
+#include "../include/d4/map-int.h"
+#include "../include/d4/number.h"
+#include "utils.h"
+
+D4_ARRAY_DECLARE(i32, int32_t)
+D4_ARRAY_DEFINE(i32, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_ARRAY_DECLARE(u64, uint64_t)
+D4_ARRAY_DEFINE(u64, uint64_t, uint64_t, element, lhs_element == rhs_element, (void) element, d4_u64_str(element))
+
+D4_MAP_INT_DECLARE(i32, int32_t, u64, uint64_t)
+D4_MAP_INT_DEFINE(i32, int32_t, int, d4_i32_str(key), u64, uint64_t, uint64_t, val, lhs_val == rhs_val, (void) val, d4_u64_str(val))
+
+D4_CACHE_DECLARE(i32, int32_t, i32, int32_t)
+D4_CACHE_DEFINE(i32, int32_t, key, lhs_key == rhs_key, (void) key, d4_map_hash_int((uint64_t) key, SIZE_MAX), d4_i32_str(key), i32, int32_t, val, (void) val, 1)
+
+#define CACHE_CAP 1024
+#define KEYS_RANGE 8192
+#define OPS_COUNT 1000000
+
+static uint64_t rand_state = 1;
+
+// Skewed key distribution, so that a small part of keys receives most of the requests.
+static int32_t next_key (void) {
+  uint64_t r;
+  rand_state = rand_state * 6364136223846793005ULL + 1442695040888963407ULL;
+  r = (rand_state >> 33) % KEYS_RANGE;
+  return (int32_t) (r * r / KEYS_RANGE);
+}
+
+static void bench_cache (const char *name, d4_cache_policy_t policy) {
+  d4_cache_i32MSi32ME_t c1 = d4_cache_i32MSi32ME_alloc(policy, CACHE_CAP, 0);
+  double start;
+
+  rand_state = 1;
+  start = bench_now();
+
+  for (size_t i = 0; i < OPS_COUNT; i++) {
+    int32_t key = next_key();
+    if (d4_cache_i32MSi32ME_lookup(&c1, key) == NULL) d4_cache_i32MSi32ME_put(&c1, key, key);
+  }
+
+  bench_report(name, OPS_COUNT, bench_now() - start);
+  printf("  hit rate %.2f%%\n", 100.0 * (double) c1.hits / OPS_COUNT);
+  d4_cache_i32MSi32ME_free(c1);
+}
+
+// Memoization as it is written without cache type: map of last use ticks and a full scan to find eviction victim.
+static void bench_map (void) {
+  d4_map_i32MSu64ME_t m1 = d4_map_i32MSu64ME_alloc(0);
+  size_t hits = 0;
+  double start;
+
+  rand_state = 1;
+  start = bench_now();
+
+  for (uint64_t i = 0; i < OPS_COUNT; i++) {
+    int32_t key = next_key();
+
+    if (d4_map_i32MSu64ME_has(m1, key)) {
+      d4_map_i32MSu64ME_set(&m1, key, i);
+      hits++;
+      continue;
+    }
+
+    if (m1.len == CACHE_CAP) {
+      d4_map_i32MSu64ME_iter_t it = d4_map_i32MSu64ME_iterBegin(m1);
+      int32_t victim = 0;
+      uint64_t victim_tick = UINT64_MAX;
+
+      while (d4_map_i32MSu64ME_iterNext(&it)) {
+        if (*it.value < victim_tick) {
+          victim = *it.key;
+          victim_tick = *it.value;
+        }
+      }
+
+      d4_map_i32MSu64ME_remove(&d4_err_state, 0, 0, &m1, victim);
+    }
+
+    d4_map_i32MSu64ME_set(&m1, key, i);
+  }
+
+  bench_report("map with scan eviction", OPS_COUNT, bench_now() - start);
+  printf("  hit rate %.2f%%\n", 100.0 * (double) hits / OPS_COUNT);
+  d4_map_i32MSu64ME_free(m1);
+}
+
+int main (void) {
+  bench_cache("lru cache", D4_CACHE_LRU);
+  bench_cache("clock cache", D4_CACHE_CLOCK);
+  bench_map();
+
+  return 0;
+}
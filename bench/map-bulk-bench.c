@@ -0,0 +1,61 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/map.h"
+#include "../include/d4/number.h"
+#include "utils.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_MAP_DECLARE(str, d4_str_t, int, int32_t)
+D4_MAP_DEFINE(str, d4_str_t, d4_str_t, d4_str_copy(key), d4_str_eq(lhs_key, rhs_key), d4_str_free(key), d4_str_copy(key), d4_str_copy(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+#define PAIRS_COUNT 1000000
+
+static d4_arr_str_t keys_alloc (void) {
+  d4_arr_str_t result = {d4_safe_alloc(PAIRS_COUNT * sizeof(d4_str_t)), PAIRS_COUNT};
+
+  for (int32_t i = 0; i < PAIRS_COUNT; i++) {
+    result.data[i] = d4_str_alloc(L"session-%" PRId32, i);
+  }
+
+  return result;
+}
+
+static d4_arr_int_t values_alloc (void) {
+  d4_arr_int_t result = {d4_safe_alloc(PAIRS_COUNT * sizeof(int32_t)), PAIRS_COUNT};
+
+  for (int32_t i = 0; i < PAIRS_COUNT; i++) {
+    result.data[i] = i;
+  }
+
+  return result;
+}
+
+int main (void) {
+  d4_arr_str_t keys = keys_alloc();
+  d4_arr_int_t values = values_alloc();
+  d4_map_strMSintME_t m;
+  double start;
+
+  start = bench_now();
+  m = d4_map_strMSintME_alloc(0);
+  for (int32_t i = 0; i < PAIRS_COUNT; i++) d4_map_strMSintME_set(&m, keys.data[i], values.data[i]);
+  bench_report("map build set loop", PAIRS_COUNT, bench_now() - start);
+  d4_map_strMSintME_free(m);
+
+  start = bench_now();
+  m = d4_map_strMSintME_fromArrays(keys, values);
+  bench_report("map build fromArrays", PAIRS_COUNT, bench_now() - start);
+  d4_map_strMSintME_free(m);
+
+  start = bench_now();
+  m = d4_map_strMSintME_fromArraysMove(keys, values);
+  bench_report("map build fromArraysMove", PAIRS_COUNT, bench_now() - start);
+  d4_map_strMSintME_free(m);
+
+  return 0;
+}
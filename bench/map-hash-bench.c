@@ -0,0 +1,93 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/map.h"
+#include "../include/d4/number.h"
+#include "utils.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_MAP_DECLARE(str, d4_str_t, int, int32_t)
+D4_MAP_DEFINE(str, d4_str_t, d4_str_t, d4_str_copy(key), d4_str_eq(lhs_key, rhs_key), d4_str_free(key), d4_str_copy(key), d4_str_copy(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+D4_ARRAY_DECLARE(skey, d4_str_t)
+D4_ARRAY_DEFINE(skey, d4_str_t, d4_str_t, d4_str_copy(element), d4_str_eq(lhs_element, rhs_element), d4_str_free(element), d4_str_copy(element))
+
+D4_MAP_DECLARE(skey, d4_str_t, int, int32_t)
+D4_MAP_DEFINE_WITH_HASH(skey, d4_str_t, d4_str_t, d4_str_copy(key), d4_str_eq(lhs_key, rhs_key), d4_str_free(key), d4_str_copy(key), d4_str_copy(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val), d4_map_hash_seeded)
+
+#define KEYS_COUNT 200000
+
+static void bench_hash (const char *name, size_t (*hash) (d4_str_t, size_t), size_t key_len, size_t iterations) {
+  wchar_t *data = d4_safe_alloc((key_len + 1) * sizeof(wchar_t));
+  d4_str_t key;
+  volatile size_t sink = 0;
+  double start;
+
+  for (size_t i = 0; i < key_len; i++) {
+    data[i] = (wchar_t) (L'a' + (wchar_t) (i % 26));
+  }
+
+  data[key_len] = L'\0';
+  key = (d4_str_t) {data, key_len, false};
+  start = bench_now();
+
+  for (size_t i = 0; i < iterations; i++) {
+    data[i % key_len] ^= 1;
+    sink += hash(key, 0xFFFFFFFFFFFFFFFF);
+  }
+
+  bench_report_bytes(name, iterations * key_len * sizeof(wchar_t), bench_now() - start);
+  (void) sink;
+  d4_safe_free(data);
+}
+
+int main (void) {
+  d4_str_t *keys = d4_safe_alloc(KEYS_COUNT * sizeof(d4_str_t));
+  d4_map_strMSintME_t m1 = d4_map_strMSintME_alloc(0);
+  d4_map_skeyMSintME_t m2 = d4_map_skeyMSintME_alloc(0);
+  volatile int64_t sink = 0;
+  double start;
+
+  bench_hash("hash fnv-1a 8 chars", d4_map_hash, 8, 10000000);
+  bench_hash("hash siphash-1-3 8 chars", d4_map_hash_seeded, 8, 10000000);
+  bench_hash("hash fnv-1a 32 chars", d4_map_hash, 32, 5000000);
+  bench_hash("hash siphash-1-3 32 chars", d4_map_hash_seeded, 32, 5000000);
+  bench_hash("hash fnv-1a 1024 chars", d4_map_hash, 1024, 200000);
+  bench_hash("hash siphash-1-3 1024 chars", d4_map_hash_seeded, 1024, 200000);
+
+  for (int32_t i = 0; i < KEYS_COUNT; i++) {
+    keys[i] = d4_str_alloc(L"session-%" PRId32, i);
+  }
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) d4_map_strMSintME_set(&m1, keys[i], i);
+  bench_report("map set fnv-1a", KEYS_COUNT, bench_now() - start);
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) d4_map_skeyMSintME_set(&m2, keys[i], i);
+  bench_report("map set siphash-1-3", KEYS_COUNT, bench_now() - start);
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) sink += d4_map_strMSintME_get(&d4_err_state, 0, 0, m1, keys[i]);
+  bench_report("map get fnv-1a", KEYS_COUNT, bench_now() - start);
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) sink += d4_map_skeyMSintME_get(&d4_err_state, 0, 0, m2, keys[i]);
+  bench_report("map get siphash-1-3", KEYS_COUNT, bench_now() - start);
+
+  (void) sink;
+
+  for (int32_t i = 0; i < KEYS_COUNT; i++) {
+    d4_str_free(keys[i]);
+  }
+
+  d4_map_strMSintME_free(m1);
+  d4_map_skeyMSintME_free(m2);
+  d4_safe_free(keys);
+
+  return 0;
+}
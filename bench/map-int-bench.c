@@ -0,0 +1,79 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/map.h"
+#include "../include/d4/map-int.h"
+#include "../include/d4/number.h"
+#include "../include/d4/sparse.h"
+#include "utils.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_ARRAY_DECLARE(i32, int32_t)
+D4_ARRAY_DEFINE(i32, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_MAP_DECLARE(int, int32_t, int, int32_t)
+D4_MAP_DEFINE(int, int32_t, int, key, lhs_key == rhs_key, (void) key, d4_i32_str(key), d4_i32_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+D4_MAP_INT_DECLARE(i32, int32_t, int, int32_t)
+D4_MAP_INT_DEFINE(i32, int32_t, int, d4_i32_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+D4_SPARSE_DECLARE(i32, int32_t, int, int32_t)
+D4_SPARSE_DEFINE(i32, int32_t, int, d4_i32_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+#define KEYS_COUNT 1000000
+
+int main (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_i32MSintME_t m2 = d4_map_i32MSintME_alloc(0);
+  d4_sparse_i32MSintME_t m3 = d4_sparse_i32MSintME_alloc(&d4_err_state, 0, 0, 0);
+  volatile int64_t sink = 0;
+  double start;
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) d4_map_intMSintME_set(&m1, i, i);
+  bench_report("set generic map", KEYS_COUNT, bench_now() - start);
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) d4_map_i32MSintME_set(&m2, i, i);
+  bench_report("set integer map", KEYS_COUNT, bench_now() - start);
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) d4_sparse_i32MSintME_set(&d4_err_state, 0, 0, &m3, i, i);
+  bench_report("set sparse set", KEYS_COUNT, bench_now() - start);
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) sink += d4_map_intMSintME_get(&d4_err_state, 0, 0, m1, i);
+  bench_report("get generic map", KEYS_COUNT, bench_now() - start);
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) sink += d4_map_i32MSintME_get(&d4_err_state, 0, 0, m2, i);
+  bench_report("get integer map", KEYS_COUNT, bench_now() - start);
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) sink += d4_sparse_i32MSintME_get(&d4_err_state, 0, 0, m3, i);
+  bench_report("get sparse set", KEYS_COUNT, bench_now() - start);
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) sink += d4_map_intMSintME_has(m1, i + KEYS_COUNT);
+  bench_report("miss generic map", KEYS_COUNT, bench_now() - start);
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) sink += d4_map_i32MSintME_has(m2, i + KEYS_COUNT);
+  bench_report("miss integer map", KEYS_COUNT, bench_now() - start);
+
+  start = bench_now();
+  for (int32_t i = 0; i < KEYS_COUNT; i++) sink += d4_sparse_i32MSintME_has(m3, i + KEYS_COUNT);
+  bench_report("miss sparse set", KEYS_COUNT, bench_now() - start);
+
+  (void) sink;
+
+  d4_map_intMSintME_free(m1);
+  d4_map_i32MSintME_free(m2);
+  d4_sparse_i32MSintME_free(m3);
+
+  return 0;
+}
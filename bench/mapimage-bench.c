@@ -0,0 +1,107 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include <stdio.h>
+#include "../include/d4/mapimage.h"
+#include "utils.h"
+
+D4_MAP_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_MAP_DEFINE(str, d4_str_t, d4_str_t, d4_str_copy(key), d4_str_eq(lhs_key, rhs_key), d4_str_free(key), d4_str_copy(key), d4_str_copy(key), str, d4_str_t, d4_str_t, d4_str_copy(val), d4_str_eq(lhs_val, rhs_val), d4_str_free(val), d4_str_quoted_escape(val))
+
+D4_MAPIMAGE_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_MAPIMAGE_DEFINE(str, d4_str_t, key.data, key.len * sizeof(wchar_t), ((d4_str_t) {data, size / sizeof(wchar_t), true}), d4_str_eq(lhs_key, rhs_key), d4_map_hash(key, SIZE_MAX), d4_str_copy(key), str, d4_str_t, val.data, val.len * sizeof(wchar_t), ((d4_str_t) {data, size / sizeof(wchar_t), true}), d4_str_copy(val))
+
+#define SMALL_COUNT 1000
+#define LARGE_COUNT 500000
+#define OPENS_COUNT 1000
+
+static d4_str_t *keys;
+static d4_str_t *values;
+
+static d4_map_strMSstrME_t build_map (size_t len) {
+  d4_map_strMSstrME_t result = d4_map_strMSstrME_alloc(0);
+
+  for (size_t i = 0; i < len; i++) {
+    d4_map_strMSstrME_set(&result, keys[i], values[i]);
+  }
+
+  return result;
+}
+
+static void bench_open (const char *name, const d4_str_t path) {
+  double start = bench_now();
+
+  for (size_t i = 0; i < OPENS_COUNT; i++) {
+    d4_mapimage_strMSstrME_t i1 = d4_mapimage_strMSstrME_open(&d4_err_state, 0, 0, path);
+    d4_mapimage_strMSstrME_free(i1);
+  }
+
+  bench_report(name, OPENS_COUNT, bench_now() - start);
+}
+
+int main (void) {
+  d4_str_t small_path = d4_str_alloc(L"mapimage-bench-small.bin");
+  d4_str_t large_path = d4_str_alloc(L"mapimage-bench-large.bin");
+  d4_map_strMSstrME_t m1;
+  d4_map_strMSstrME_t m2;
+  d4_mapimage_strMSstrME_t i1;
+  volatile size_t sink = 0;
+  double start;
+
+  keys = d4_safe_alloc(LARGE_COUNT * sizeof(d4_str_t));
+  values = d4_safe_alloc(LARGE_COUNT * sizeof(d4_str_t));
+
+  for (size_t i = 0; i < LARGE_COUNT; i++) {
+    keys[i] = d4_str_alloc(L"/api/v1/resource/%zu", i);
+    values[i] = d4_str_alloc(L"handler-%zu", i * 7);
+  }
+
+  start = bench_now();
+  m1 = build_map(LARGE_COUNT);
+  bench_report("build map from pairs", LARGE_COUNT, bench_now() - start);
+
+  m2 = build_map(SMALL_COUNT);
+  d4_mapimage_strMSstrME_write(&d4_err_state, 0, 0, m2, small_path);
+
+  start = bench_now();
+  d4_mapimage_strMSstrME_write(&d4_err_state, 0, 0, m1, large_path);
+  bench_report("write image", LARGE_COUNT, bench_now() - start);
+
+  bench_open("open image of 1000 pairs", small_path);
+  bench_open("open image of 500000 pairs", large_path);
+
+  start = bench_now();
+  for (size_t i = 0; i < LARGE_COUNT; i++) sink += d4_map_strMSstrME_has(m1, keys[i]);
+  bench_report("has map", LARGE_COUNT, bench_now() - start);
+
+  i1 = d4_mapimage_strMSstrME_open(&d4_err_state, 0, 0, large_path);
+  start = bench_now();
+
+  for (size_t i = 0; i < LARGE_COUNT; i++) {
+    d4_str_t value;
+    if (d4_mapimage_strMSstrME_lookup(i1, keys[i], &value)) sink += value.len;
+  }
+
+  bench_report("lookup image", LARGE_COUNT, bench_now() - start);
+  (void) sink;
+
+  d4_mapimage_strMSstrME_free(i1);
+  d4_map_strMSstrME_free(m1);
+  d4_map_strMSstrME_free(m2);
+  remove("mapimage-bench-small.bin");
+  remove("mapimage-bench-large.bin");
+
+  for (size_t i = 0; i < LARGE_COUNT; i++) {
+    d4_str_free(keys[i]);
+    d4_str_free(values[i]);
+  }
+
+  d4_safe_free(keys);
+  d4_safe_free(values);
+  d4_str_free(small_path);
+  d4_str_free(large_path);
+
+  return 0;
+}
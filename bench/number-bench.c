@@ -0,0 +1,43 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/number.h"
+#include "../include/d4/string.h"
+#include "utils.h"
+
+#define ITERATIONS 2000000
+
+static void bench_i32_str (const char *name, int32_t start_value, int32_t step) {
+  double start = bench_now();
+  int32_t value = start_value;
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    d4_str_free(d4_i32_str(value));
+    value += step;
+  }
+
+  bench_report(name, ITERATIONS, bench_now() - start);
+}
+
+static void bench_f64_str (const char *name, double start_value, double step) {
+  double start = bench_now();
+  double value = start_value;
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    d4_str_free(d4_f64_str(value));
+    value += step;
+  }
+
+  bench_report(name, ITERATIONS, bench_now() - start);
+}
+
+int main (void) {
+  bench_i32_str("i32 str small", 0, 1);
+  bench_i32_str("i32 str large", -2000000000, 1999);
+  bench_f64_str("f64 str integral", 0, 1);
+  bench_f64_str("f64 str fractional", 0.1, 0.3183098861837907);
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include <stdio.h>
+#include "../include/d4/array.h"
+#include "../include/d4/number.h"
+#include "../include/d4/safe.h"
+#include "utils.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int32_t, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+#define ITERATIONS 20
+
+// Builds string the way str methods used to, by reallocating the whole result for every fragment.
+static d4_str_t concat_join (const d4_arr_int_t arr) {
+  d4_str_t c = (d4_str_t) {L", ", 2, true};
+  d4_str_t result = d4_str_empty_val;
+  d4_str_t t1;
+  d4_str_t t2;
+
+  for (size_t i = 0; i < arr.len; i++) {
+    if (i != 0) {
+      result = d4_str_realloc(result, t1 = d4_str_concat(result, c));
+      d4_str_free(t1);
+    }
+
+    result = d4_str_realloc(result, t1 = d4_str_concat(result, t2 = d4_i32_str(arr.data[i])));
+    d4_str_free(t1);
+    d4_str_free(t2);
+  }
+
+  return result;
+}
+
+static d4_arr_int_t arr_alloc (size_t len) {
+  int32_t *data = d4_safe_alloc(len * sizeof(int32_t));
+
+  for (size_t i = 0; i < len; i++) {
+    data[i] = (int32_t) (i * 7919);
+  }
+
+  return (d4_arr_int_t) {data, len};
+}
+
+static void bench_str (size_t len, bool with_concat) {
+  d4_arr_int_t arr = arr_alloc(len);
+  char name[64];
+  double start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    d4_str_free(d4_arr_int_str(arr));
+  }
+
+  snprintf(name, sizeof(name), "array str of %zu elements", len);
+  bench_report(name, len * ITERATIONS, bench_now() - start);
+
+  if (with_concat) {
+    start = bench_now();
+
+    for (size_t i = 0; i < ITERATIONS; i++) {
+      d4_str_free(concat_join(arr));
+    }
+
+    snprintf(name, sizeof(name), "concat join of %zu elements", len);
+    bench_report(name, len * ITERATIONS, bench_now() - start);
+  }
+
+  d4_arr_int_free(arr);
+}
+
+static void bench_append_int (size_t len) {
+  d4_strbuf_t buf = d4_strbuf_alloc(0);
+  double start = bench_now();
+
+  for (size_t i = 0; i < len; i++) {
+    d4_strbuf_appendInt(&buf, (int64_t) (i * 7919));
+    d4_strbuf_appendChar(&buf, L' ');
+  }
+
+  bench_report("append integers", len, bench_now() - start);
+  d4_strbuf_free(buf);
+}
+
+int main (void) {
+  bench_str(1000, true);
+  bench_str(10000, true);
+  bench_str(100000, false);
+  bench_append_int(1000000);
+
+  return 0;
+}
@@ -0,0 +1,225 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include <stdio.h>
+#include "../include/d4/error.h"
+#include "../include/d4/safe.h"
+#include "../include/d4/string.h"
+#include "../include/d4/strview.h"
+#include "utils.h"
+
+#define TEXT_LEN 100000
+#define ITERATIONS 20
+
+static d4_str_t text_alloc (const wchar_t *pattern) {
+  size_t pattern_len = wcslen(pattern);
+  wchar_t *data = d4_safe_alloc((TEXT_LEN + 1) * sizeof(wchar_t));
+
+  for (size_t i = 0; i < TEXT_LEN; i++) {
+    data[i] = pattern[i % pattern_len];
+  }
+
+  data[TEXT_LEN] = L'\0';
+  return (d4_str_t) {data, TEXT_LEN, false};
+}
+
+// Reports number of heap allocated strings among results, which is the allocation rate of the operation.
+static void report_heap (const d4_arr_str_t result) {
+  size_t heap_len = 0;
+  size_t heap_bytes = 0;
+
+  for (size_t i = 0; i < result.len; i++) {
+    if (!result.data[i].is_static) {
+      heap_len++;
+      heap_bytes += (result.data[i].len + 1) * sizeof(wchar_t);
+    }
+  }
+
+  printf("  heap strings %zu of %zu, %zu bytes\n", heap_len, result.len, heap_bytes);
+}
+
+static void bench_split (const char *name, const d4_str_t text, const d4_str_t delimiter) {
+  d4_arr_str_t result = d4_str_split(text, 1, delimiter);
+  size_t len = result.len;
+  double start;
+
+  report_heap(result);
+  d4_arr_str_free(result);
+  start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    d4_arr_str_free(d4_str_split(text, 1, delimiter));
+  }
+
+  bench_report(name, len * ITERATIONS, bench_now() - start);
+}
+
+// Splits into trimmed views and copies only the fields that are kept, the way tokenizers use views.
+static void bench_split_views (const char *name, const d4_str_t text, const d4_str_t delimiter) {
+  d4_arr_strview_t result = d4_strview_split(d4_strview_from(text), 1, d4_strview_from(delimiter));
+  size_t len = result.len;
+  double start;
+
+  d4_arr_strview_free(result);
+  start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    d4_arr_strview_t views = d4_strview_split(d4_strview_from(text), 1, d4_strview_from(delimiter));
+    size_t kept = 0;
+
+    for (size_t j = 0; j < views.len; j++) {
+      kept += d4_strview_trim(views.data[j]).len;
+    }
+
+    if (kept == 0) printf("  no fields kept\n");
+    d4_arr_strview_free(views);
+  }
+
+  bench_report(name, len * ITERATIONS, bench_now() - start);
+}
+
+// Takes the first few fields of the text, which only pays for the fields taken.
+static void bench_split_first (const char *name, const d4_str_t text, const d4_str_t delimiter, size_t fields) {
+  double start = bench_now();
+  size_t kept = 0;
+
+  for (size_t i = 0; i < ITERATIONS * 1000; i++) {
+    d4_strview_iter_t it = d4_strview_splitIter(d4_strview_from(text), 1, d4_strview_from(delimiter));
+    d4_strview_t piece;
+
+    for (size_t j = 0; j < fields && d4_strview_iter_next(&it, &piece); j++) {
+      kept += piece.len;
+    }
+  }
+
+  if (kept == 0) printf("  no fields kept\n");
+  bench_report(name, ITERATIONS * 1000, bench_now() - start);
+}
+
+static void bench_lines (const char *name, const d4_str_t text) {
+  d4_arr_str_t result = d4_str_lines(text, 0, false);
+  size_t len = result.len;
+  double start;
+
+  report_heap(result);
+  d4_arr_str_free(result);
+  start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    d4_arr_str_free(d4_str_lines(text, 0, false));
+  }
+
+  bench_report(name, len * ITERATIONS, bench_now() - start);
+}
+
+static void bench_copy (const char *name, const d4_str_t text, size_t iterations) {
+  double start = bench_now();
+
+  for (size_t i = 0; i < iterations; i++) {
+    d4_str_free(d4_str_copy(text));
+  }
+
+  bench_report(name, iterations, bench_now() - start);
+}
+
+static void bench_parse (const char *name, const wchar_t *fmt, bool is_float) {
+  d4_str_t fields[1000];
+  double start;
+
+  for (size_t i = 0; i < 1000; i++) {
+    fields[i] = is_float ? d4_str_alloc(fmt, (double) i * 1.37 - 500) : d4_str_alloc(fmt, (int) (i * 7919) - 3000000);
+  }
+
+  start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS * 10000; i++) {
+    if (is_float) {
+      d4_str_toF64(&d4_err_state, 0, 0, fields[i % 1000]);
+    } else {
+      d4_str_toI64(&d4_err_state, 0, 0, fields[i % 1000], 0, 0);
+    }
+  }
+
+  bench_report(name, ITERATIONS * 10000, bench_now() - start);
+
+  for (size_t i = 0; i < 1000; i++) {
+    d4_str_free(fields[i]);
+  }
+}
+
+static void bench_search (const char *name, const d4_str_t text, const d4_str_t search) {
+  double start = bench_now();
+  size_t found = 0;
+
+  for (size_t i = 0; i < ITERATIONS * 10; i++) {
+    found += d4_str_contains(text, search);
+    found += d4_str_find(text, search) != -1;
+  }
+
+  bench_report_bytes(name, text.len * sizeof(wchar_t) * ITERATIONS * 20, bench_now() - start);
+  printf("  found %zu\n", found);
+}
+
+static void bench_replace (const char *name, const d4_str_t text, const d4_str_t search) {
+  double start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    d4_str_free(d4_str_replace(text, search, (d4_str_t) {L"#", 1, true}, 0, 0));
+  }
+
+  bench_report_bytes(name, text.len * sizeof(wchar_t) * ITERATIONS, bench_now() - start);
+}
+
+static void bench_map (const char *name, const d4_str_t text, d4_str_t (*func) (const d4_str_t)) {
+  double start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    d4_str_free(func(text));
+  }
+
+  bench_report_bytes(name, text.len * sizeof(wchar_t) * ITERATIONS, bench_now() - start);
+}
+
+int main (void) {
+  d4_str_t text = text_alloc(L"the quick brown fox jumps over the lazy dog, ");
+  d4_str_t csv = text_alloc(L"a,1,b,22,c,333,");
+  d4_str_t lines = text_alloc(L"x\ny\n{\n  key: value\n}\n");
+  d4_str_t log = text_alloc(L"  2024-01-01 INFO Request \"GET /index\" took 12 ms\t\n");
+  d4_str_t large;
+  d4_str_t large_shared;
+
+  bench_split("split into characters", text, d4_str_empty_val);
+  bench_split("split csv fields", csv, (d4_str_t) {L",", 1, true});
+  bench_split("split words", text, (d4_str_t) {L" ", 1, true});
+  bench_split_views("split words as views", text, (d4_str_t) {L" ", 1, true});
+  bench_split_views("split csv fields as views", csv, (d4_str_t) {L",", 1, true});
+  bench_split_first("split first 3 csv fields", csv, (d4_str_t) {L",", 1, true}, 3);
+  bench_lines("lines", lines);
+  bench_search("search missing word", text, (d4_str_t) {L"fax", 3, true});
+  bench_search("search missing sentence", text, (d4_str_t) {L"the quick brown fox jumps over the lazy cat", 43, true});
+  bench_replace("replace word", text, (d4_str_t) {L"fox", 3, true});
+  bench_split("split sentences", text, (d4_str_t) {L"lazy dog, ", 10, true});
+  bench_map("lower", log, d4_str_lower);
+  bench_map("upper", log, d4_str_upper);
+  bench_map("escape", log, d4_str_escape);
+  bench_map("trim", log, d4_str_trim);
+  bench_parse("parse i64", L"%d", false);
+  bench_parse("parse f64", L"%.3f", true);
+
+  large = d4_str_alloc(L"%0*d", (int) (1024 * 1024 / sizeof(wchar_t)), 0);
+  large_shared = d4_str_share(d4_str_copy(large));
+
+  bench_copy("copy 1 MB string", large, 2000);
+  bench_copy("copy 1 MB shared string", large_shared, 2000000);
+
+  d4_str_free(text);
+  d4_str_free(csv);
+  d4_str_free(lines);
+  d4_str_free(log);
+  d4_str_free(large);
+  d4_str_free(large_shared);
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include <stdio.h>
+#include "../include/d4/map.h"
+#include "../include/d4/safe.h"
+#include "../include/d4/strpack.h"
+#include "utils.h"
+
+#define KEYS_LEN 100000
+#define ITERATIONS 20
+
+static volatile size_t sink;
+
+static void bench_hash (const d4_str_t *keys, const d4_strpack_t *packed) {
+  double start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    for (size_t j = 0; j < KEYS_LEN; j++) sink += d4_map_hash(keys[j], 1024);
+  }
+
+  bench_report("hash string", KEYS_LEN * ITERATIONS, bench_now() - start);
+  start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    for (size_t j = 0; j < KEYS_LEN; j++) sink += d4_strpack_hash(packed[j], 1024);
+  }
+
+  bench_report("hash packed string", KEYS_LEN * ITERATIONS, bench_now() - start);
+}
+
+static void bench_eq (const d4_str_t *keys, const d4_strpack_t *packed) {
+  double start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    for (size_t j = 1; j < KEYS_LEN; j++) sink += d4_str_eq(keys[j - 1], keys[j]);
+  }
+
+  bench_report("eq string", KEYS_LEN * ITERATIONS, bench_now() - start);
+  start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    for (size_t j = 1; j < KEYS_LEN; j++) sink += d4_strpack_eq(packed[j - 1], packed[j]);
+  }
+
+  bench_report("eq packed string", KEYS_LEN * ITERATIONS, bench_now() - start);
+}
+
+static void bench_find (const d4_str_t text) {
+  d4_strpack_t packed = d4_strpack_from(text);
+  d4_str_t search = (d4_str_t) {L"/missing", 8, true};
+  d4_strpack_t packed_search = d4_strpack_from(search);
+  double start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    sink += (size_t) d4_str_find(text, search);
+  }
+
+  bench_report_bytes("find in string", text.len * sizeof(wchar_t) * ITERATIONS, bench_now() - start);
+  start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    sink += (size_t) d4_strpack_find(packed, packed_search);
+  }
+
+  bench_report_bytes("find in packed string", text.len * sizeof(wchar_t) * ITERATIONS, bench_now() - start);
+
+  d4_strpack_free(packed);
+  d4_strpack_free(packed_search);
+}
+
+int main (void) {
+  d4_str_t *keys = d4_safe_alloc(KEYS_LEN * sizeof(d4_str_t));
+  d4_strpack_t *packed = d4_safe_alloc(KEYS_LEN * sizeof(d4_strpack_t));
+  size_t str_bytes = 0;
+  size_t packed_bytes = 0;
+  d4_str_t text;
+
+  for (size_t i = 0; i < KEYS_LEN; i++) {
+    keys[i] = d4_str_alloc(L"/api/v1/users/%zu/profile", i);
+    packed[i] = d4_strpack_from(keys[i]);
+    str_bytes += (keys[i].len + 1) * sizeof(wchar_t);
+    packed_bytes += packed[i].len * packed[i].kind;
+  }
+
+  printf("  string keys %zu bytes, packed keys %zu bytes\n", str_bytes, packed_bytes);
+
+  bench_hash(keys, packed);
+  bench_eq(keys, packed);
+
+  text = d4_str_alloc(L"%0*d", 1000000, 0);
+  bench_find(text);
+  d4_str_free(text);
+
+  for (size_t i = 0; i < KEYS_LEN; i++) {
+    d4_str_free(keys[i]);
+    d4_strpack_free(packed[i]);
+  }
+
+  d4_safe_free(keys);
+  d4_safe_free(packed);
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include <stdio.h>
+#include "../include/d4/error.h"
+#include "../include/d4/safe.h"
+#include "../include/d4/string.h"
+#include "../include/d4/utf8.h"
+#include "utils.h"
+
+#define LINES_LEN 20000
+#define ITERATIONS 20
+
+static volatile size_t sink;
+
+// Reads fields of every line from UTF-8 input and writes them back as UTF-8, widening text on the way in and out.
+static void bench_wide (const d4_utf8_t input) {
+  double start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    d4_str_t text = d4_utf8_str(input);
+    d4_arr_str_t lines = d4_str_lines(text, 0, false);
+
+    for (size_t j = 0; j < lines.len; j++) {
+      d4_arr_str_t fields = d4_str_split(lines.data[j], 1, (d4_str_t) {L",", 1, true});
+      d4_utf8_t output = d4_utf8_fromStr(fields.data[1]);
+      sink += output.len;
+      d4_utf8_free(output);
+      d4_arr_str_free(fields);
+    }
+
+    d4_arr_str_free(lines);
+    d4_str_free(text);
+  }
+
+  bench_report_bytes("pass through as string", input.len * ITERATIONS, bench_now() - start);
+}
+
+// Does the same work on UTF-8 strings without widening.
+static void bench_utf8 (const d4_utf8_t input) {
+  double start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    d4_arr_utf8_t lines = d4_utf8_lines(input, 0, false);
+
+    for (size_t j = 0; j < lines.len; j++) {
+      d4_arr_utf8_t fields = d4_utf8_split(lines.data[j], 1, (d4_utf8_t) {",", 1, true});
+      sink += fields.data[1].len;
+      d4_arr_utf8_free(fields);
+    }
+
+    d4_arr_utf8_free(lines);
+  }
+
+  bench_report_bytes("pass through as UTF-8 string", input.len * ITERATIONS, bench_now() - start);
+}
+
+// Decodes UTF-8 input into string and encodes it back, reporting both directions separately.
+static void bench_transcode (const char *name, const d4_utf8_t input) {
+  char decode_name[64];
+  char encode_name[64];
+  d4_str_t text = d4_str_fromUtf8(&d4_err_state, 0, 0, input.data, input.len);
+  char *buf = d4_safe_alloc(d4_str_toUtf8Len(text));
+  double start = bench_now();
+
+  snprintf(decode_name, sizeof(decode_name), "decode %s", name);
+  snprintf(encode_name, sizeof(encode_name), "encode %s", name);
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    d4_str_t t = d4_str_fromUtf8(&d4_err_state, 0, 0, input.data, input.len);
+    sink += t.len;
+    d4_str_free(t);
+  }
+
+  bench_report_bytes(decode_name, input.len * ITERATIONS, bench_now() - start);
+  start = bench_now();
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    sink += d4_str_toUtf8(text, buf);
+  }
+
+  bench_report_bytes(encode_name, input.len * ITERATIONS, bench_now() - start);
+
+  d4_safe_free(buf);
+  d4_str_free(text);
+}
+
+int main (void) {
+  d4_utf8_t input = d4_utf8_empty_val;
+  d4_utf8_t ascii = d4_utf8_empty_val;
+
+  for (size_t i = 0; i < LINES_LEN; i++) {
+    d4_utf8_t line = d4_utf8_alloc("%zu,caf\xC3\xA9 number %zu,Z\xC3\xBCrich\n", i, i * 7);
+    d4_utf8_t t = d4_utf8_concat(input, line);
+    d4_utf8_free(input);
+    d4_utf8_free(line);
+    input = t;
+
+    line = d4_utf8_alloc("%zu,cafe number %zu,Zurich\n", i, i * 7);
+    t = d4_utf8_concat(ascii, line);
+    d4_utf8_free(ascii);
+    d4_utf8_free(line);
+    ascii = t;
+  }
+
+
+  bench_wide(input);
+  bench_utf8(input);
+  bench_transcode("ASCII text", ascii);
+  bench_transcode("mixed text", input);
+
+  d4_utf8_free(ascii);
+  d4_utf8_free(input);
+  return 0;
+}
@@ -0,0 +1,24 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "utils.h"
+#include <stdio.h>
+#include <time.h>
+
+double bench_now (void) {
+  clock_t now = clock();
+  return (double) now / CLOCKS_PER_SEC;
+}
+
+void bench_report (const char *name, size_t ops, double elapsed) {
+  double ns = elapsed * 1e9 / (double) (ops == 0 ? 1 : ops);
+  double per_sec = elapsed == 0 ? 0 : (double) ops / elapsed;
+  printf("%-48s %12.0f ops/s %10.2f ns/op\n", name, per_sec, ns);
+}
+
+void bench_report_bytes (const char *name, size_t bytes, double elapsed) {
+  double mb_per_sec = elapsed == 0 ? 0 : (double) bytes / elapsed / (1024 * 1024);
+  printf("%-48s %12.2f MB/s\n", name, mb_per_sec);
+}
@@ -0,0 +1,33 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <stddef.h>
+
+/**
+ * Returns processor time in seconds used by the program so far.
+ * @return Processor time in seconds.
+ */
+double bench_now (void);
+
+/**
+ * Prints benchmark result line with operations per second and nanoseconds per operation.
+ * @param name Name of the benchmark.
+ * @param ops Number of operations performed.
+ * @param elapsed Time in seconds that operations took.
+ */
+void bench_report (const char *name, size_t ops, double elapsed);
+
+/**
+ * Prints benchmark result line with throughput in megabytes per second.
+ * @param name Name of the benchmark.
+ * @param bytes Number of bytes processed.
+ * @param elapsed Time in seconds that processing took.
+ */
+void bench_report_bytes (const char *name, size_t bytes, double elapsed);
+
+#endif
@@ -0,0 +1,25 @@
+#
+# Copyright (c) Aaron Delasy
+# Licensed under the MIT License
+#
+
+if (CMAKE_PROJECT_NAME STREQUAL PROJECT_NAME AND LIBD4_BUILD_BENCHMARKS)
+  set(
+    benchmarks
+    cache
+    map-bulk
+    map-hash
+    map-int
+    mapimage
+    number
+    strbuf
+    strpack
+    string
+    utf8
+  )
+
+  foreach (benchmark ${benchmarks})
+    add_executable(${PROJECT_NAME}-bench-${benchmark} bench/${benchmark}-bench.c bench/utils.c)
+    target_link_libraries(${PROJECT_NAME}-bench-${benchmark} PUBLIC d4)
+  endforeach ()
+endif ()
@@ -9,8 +9,10 @@ if (CMAKE_PROJECT_NAME STREQUAL PROJECT_NAME AND LIBD4_BUILD_EXAMPLES)
     any
     arc
     array
+    btree
     bool
     byte
+    cache
     char
     crypto
     enum
@@ -19,15 +21,24 @@ if (CMAKE_PROJECT_NAME STREQUAL PROJECT_NAME AND LIBD4_BUILD_EXAMPLES)
     globals
     macro
     map
+    map-int
+    mapimage
     number
     object
     optional
     reference
     rand
     safe
+    set
+    snapmap
+    sparse
     ssl
+    strbuf
+    strpack
     string
+    strview
     union
+    utf8
   )
 
   foreach (example ${examples})
@@ -11,8 +11,10 @@ if (CMAKE_PROJECT_NAME STREQUAL PROJECT_NAME AND LIBD4_BUILD_TESTS)
     any
     arc
     array
+    btree
     bool
     byte
+    cache
     char
     crypto
     enum
@@ -20,6 +22,8 @@ if (CMAKE_PROJECT_NAME STREQUAL PROJECT_NAME AND LIBD4_BUILD_TESTS)
     fn
     globals
     map
+    map-int
+    mapimage
     number
     object
     optional
@@ -27,9 +31,16 @@ if (CMAKE_PROJECT_NAME STREQUAL PROJECT_NAME AND LIBD4_BUILD_TESTS)
     reference
     rune
     safe
+    set
+    snapmap
+    sparse
     ssl
+    strbuf
+    strpack
     string
+    strview
     union
+    utf8
   )
 
   foreach (test ${tests})
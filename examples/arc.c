@@ -25,7 +25,7 @@ D4_OBJECT_DEFINE(Person, Person, {
 }, {
   (void) self;
 }, {
-  result = d4_obj_str_append(result, d4_str_alloc(L"age"), d4_i32_str(self.age));
+  d4_obj_str_append(&buf, d4_str_alloc(L"age"), d4_i32_str(self.age));
 }, const int32_t age)
 
 D4_ARC_DEFINE(obj_Person, d4_obj_Person_t, d4_obj_Person_copy(ref), d4_obj_Person_eq(lhs_ref, rhs_ref), d4_obj_Person_free(ref), d4_obj_Person_str(ref))
@@ -0,0 +1,51 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/btree.h"
+#include "../include/d4/number.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_BTREE_DECLARE(int, int32_t, str, d4_str_t)
+D4_BTREE_DEFINE(int, int32_t, int, key, (lhs_key > rhs_key) - (lhs_key < rhs_key), (void) key, d4_i32_str(key), str, d4_str_t, d4_str_t, d4_str_copy(val), d4_str_eq(lhs_val, rhs_val), d4_str_free(val), d4_str_quoted_escape(val))
+
+int main (void) {
+  d4_str_t val = d4_str_alloc(L"event");
+  d4_btree_intMSstrME_t b1 = d4_btree_intMSstrME_alloc(0);
+  d4_btree_intMSstrME_t b2;
+  d4_btree_intMSstrME_iter_t it;
+  d4_str_t b2_str;
+
+  for (int32_t i = 0; i < 100; i++) {
+    d4_btree_intMSstrME_set(&b1, i * 10, val);
+  }
+
+  it = d4_btree_intMSstrME_floor(b1, 255);
+  if (d4_btree_intMSstrME_iterNext(&it)) wprintf(L"floor of 255: %" PRId32 L"\n", *it.key);
+
+  it = d4_btree_intMSstrME_ceiling(b1, 255);
+  if (d4_btree_intMSstrME_iterNext(&it)) wprintf(L"ceiling of 255: %" PRId32 L"\n", *it.key);
+
+  it = d4_btree_intMSstrME_range(b1, 300, 350);
+  while (d4_btree_intMSstrME_iterNext(&it)) {
+    wprintf(L"range: %" PRId32 L" = %ls\n", *it.key, it.value->data);
+  }
+
+  d4_btree_intMSstrME_remove(&d4_err_state, 0, 0, &b1, 0);
+  b2 = d4_btree_intMSstrME_alloc(2, 2, val, 1, val);
+  b2_str = d4_btree_intMSstrME_str(b2);
+
+  wprintf(L"b1 len: %zu\n", b1.len);
+  wprintf(L"has 0: %ls\n", d4_btree_intMSstrME_has(b1, 0) ? L"true" : L"false");
+  wprintf(L"b2: %ls\n", b2_str.data);
+
+  d4_btree_intMSstrME_free(b1);
+  d4_btree_intMSstrME_free(b2);
+  d4_str_free(b2_str);
+  d4_str_free(val);
+
+  return 0;
+}
@@ -0,0 +1,35 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/cache.h"
+
+D4_CACHE_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_CACHE_DEFINE(str, d4_str_t, d4_str_copy(key), d4_str_eq(lhs_key, rhs_key), d4_str_free(key), d4_map_hash(key, SIZE_MAX), d4_str_copy(key), str, d4_str_t, d4_str_copy(val), d4_str_free(val), val.len)
+
+int main (void) {
+  d4_cache_strMSstrME_t c1 = d4_cache_strMSstrME_alloc(D4_CACHE_LRU, 100, 16);
+  d4_str_t key1 = d4_str_alloc(L"greeting");
+  d4_str_t key2 = d4_str_alloc(L"farewell");
+  d4_str_t val1 = d4_str_alloc(L"Hello, World!");
+  d4_str_t val2 = d4_str_alloc(L"Goodbye!");
+  d4_str_t *v1;
+
+  d4_cache_strMSstrME_put(&c1, key1, val1);
+  v1 = d4_cache_strMSstrME_lookup(&c1, key1);
+  wprintf(L"%ls: %ls\n", key1.data, v1 == NULL ? L"miss" : v1->data);
+
+  // Total length of values is limited to 16 characters, so greeting is evicted.
+  d4_cache_strMSstrME_put(&c1, key2, val2);
+  wprintf(L"has %ls: %ls\n", key1.data, d4_cache_strMSstrME_has(c1, key1) ? L"true" : L"false");
+  wprintf(L"hits: %zu, misses: %zu, evictions: %zu\n", c1.hits, c1.misses, c1.evictions);
+
+  d4_cache_strMSstrME_free(c1);
+  d4_str_free(key1);
+  d4_str_free(key2);
+  d4_str_free(val1);
+  d4_str_free(val2);
+
+  return 0;
+}
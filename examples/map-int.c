@@ -0,0 +1,46 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/map-int.h"
+#include "../include/d4/number.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_MAP_INT_DECLARE(int, int32_t, str, d4_str_t)
+D4_MAP_INT_DEFINE(int, int32_t, int, d4_i32_str(key), str, d4_str_t, d4_str_t, d4_str_copy(val), d4_str_eq(lhs_val, rhs_val), d4_str_free(val), d4_str_quoted_escape(val))
+
+int main (void) {
+  d4_str_t val = d4_str_alloc(L"string");
+  d4_map_intMSstrME_t m1 = d4_map_intMSstrME_alloc(0);
+  d4_map_intMSstrME_t m2 = d4_map_intMSstrME_alloc(2, -1, val, 1, val);
+  d4_map_stats_t stats;
+  d4_str_t val2;
+  d4_str_t m2_str;
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_map_intMSstrME_set(&m1, i, val);
+  }
+
+  val2 = d4_map_intMSstrME_get(&d4_err_state, 0, 0, m1, 10);
+  d4_map_intMSstrME_remove(&d4_err_state, 0, 0, &m1, 10);
+  stats = d4_map_intMSstrME_stats(m1);
+  m2_str = d4_map_intMSstrME_str(m2);
+
+  wprintf(L"found value: %ls\n", val2.data);
+  wprintf(L"has 10: %ls\n", d4_map_intMSstrME_has(m1, 10) ? L"true" : L"false");
+  wprintf(L"has 11: %ls\n", d4_map_intMSstrME_has(m1, 11) ? L"true" : L"false");
+  wprintf(L"pairs: %zu, longest chain: %zu, identifier bytes: %zu\n", stats.len, stats.longest_chain, stats.ids_bytes);
+  wprintf(L"m2: %ls\n", m2_str.data);
+
+  d4_map_intMSstrME_free(m1);
+  d4_map_intMSstrME_free(m2);
+
+  d4_str_free(m2_str);
+  d4_str_free(val);
+  d4_str_free(val2);
+
+  return 0;
+}
@@ -0,0 +1,48 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include <stdio.h>
+#include "../include/d4/mapimage.h"
+
+D4_MAP_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_MAP_DEFINE(str, d4_str_t, d4_str_t, d4_str_copy(key), d4_str_eq(lhs_key, rhs_key), d4_str_free(key), d4_str_copy(key), d4_str_copy(key), str, d4_str_t, d4_str_t, d4_str_copy(val), d4_str_eq(lhs_val, rhs_val), d4_str_free(val), d4_str_quoted_escape(val))
+
+D4_MAPIMAGE_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_MAPIMAGE_DEFINE(str, d4_str_t, key.data, key.len * sizeof(wchar_t), ((d4_str_t) {data, size / sizeof(wchar_t), true}), d4_str_eq(lhs_key, rhs_key), d4_map_hash(key, SIZE_MAX), d4_str_copy(key), str, d4_str_t, val.data, val.len * sizeof(wchar_t), ((d4_str_t) {data, size / sizeof(wchar_t), true}), d4_str_copy(val))
+
+int main (void) {
+  d4_str_t path = d4_str_alloc(L"routes.bin");
+  d4_str_t key1 = d4_str_alloc(L"/");
+  d4_str_t key2 = d4_str_alloc(L"/about");
+  d4_str_t val1 = d4_str_alloc(L"index.html");
+  d4_str_t val2 = d4_str_alloc(L"about.html");
+  d4_map_strMSstrME_t m1 = d4_map_strMSstrME_alloc(2, key1, val1, key2, val2);
+  d4_mapimage_strMSstrME_t i1;
+  d4_str_t v1;
+
+  // Image is written once, e.g. at build time.
+  d4_mapimage_strMSstrME_write(&d4_err_state, 0, 0, m1, path);
+  d4_map_strMSstrME_free(m1);
+
+  // Opening maps file without reading pairs, values point into mapped file.
+  i1 = d4_mapimage_strMSstrME_open(&d4_err_state, 0, 0, path);
+
+  if (d4_mapimage_strMSstrME_lookup(i1, key2, &v1)) {
+    wprintf(L"%ls => %ls\n", key2.data, v1.data);
+  }
+
+  wprintf(L"pairs: %zu, intact: %ls\n", i1.len, d4_mapimage_strMSstrME_verify(i1) ? L"true" : L"false");
+
+  d4_mapimage_strMSstrME_free(i1);
+  remove("routes.bin");
+
+  d4_str_free(path);
+  d4_str_free(key1);
+  d4_str_free(key2);
+  d4_str_free(val1);
+  d4_str_free(val2);
+
+  return 0;
+}
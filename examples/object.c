@@ -24,8 +24,8 @@ D4_OBJECT_DEFINE(Animal, Animal, {
 }, {
   d4_str_free(self.name);
 }, {
-  result = d4_obj_str_append(result, d4_str_alloc(L"name"), d4_str_quoted_escape(self.name));
-  result = d4_obj_str_append(result, d4_str_alloc(L"age"), d4_i32_str(self.age));
+  d4_obj_str_append(&buf, d4_str_alloc(L"name"), d4_str_quoted_escape(self.name));
+  d4_obj_str_append(&buf, d4_str_alloc(L"age"), d4_i32_str(self.age));
 }, const d4_str_t name, const int32_t age)
 
 int main(void) {
@@ -0,0 +1,55 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/number.h"
+#include "../include/d4/set.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_SET_DECLARE(int, int32_t)
+D4_SET_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element), d4_i32_str(element))
+
+int main (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(3, 1, 2, 3);
+  d4_set_int_t s2 = d4_set_int_alloc(3, 3, 4, 5);
+  d4_set_int_t s3;
+  d4_set_int_t s4;
+  d4_set_int_t s5;
+  d4_str_t s3_str;
+  d4_str_t s4_str;
+  d4_str_t s5_str;
+
+  for (int32_t i = 10; i < 20; i++) {
+    d4_set_int_add(&s2, i);
+  }
+
+  s3 = d4_set_int_union(s1, s2);
+  s4 = d4_set_int_intersection(s1, s2);
+  s5 = d4_set_int_difference(s1, s2);
+  s3_str = d4_set_int_str(s3);
+  s4_str = d4_set_int_str(s4);
+  s5_str = d4_set_int_str(s5);
+
+  wprintf(L"union: %ls\n", s3_str.data);
+  wprintf(L"intersection: %ls\n", s4_str.data);
+  wprintf(L"difference: %ls\n", s5_str.data);
+  wprintf(L"has 2: %ls\n", d4_set_int_has(s1, 2) ? L"true" : L"false");
+  wprintf(L"is subset: %ls\n", d4_set_int_isSubset(s4, s1) ? L"true" : L"false");
+
+  d4_set_int_remove(&d4_err_state, 0, 0, &s1, 2);
+  wprintf(L"has 2 after remove: %ls\n", d4_set_int_has(s1, 2) ? L"true" : L"false");
+
+  d4_str_free(s3_str);
+  d4_str_free(s4_str);
+  d4_str_free(s5_str);
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+  d4_set_int_free(s3);
+  d4_set_int_free(s4);
+  d4_set_int_free(s5);
+
+  return 0;
+}
@@ -0,0 +1,51 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/snapmap.h"
+
+D4_MAP_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_MAP_DEFINE(str, d4_str_t, d4_str_t, d4_str_copy(key), d4_str_eq(lhs_key, rhs_key), d4_str_free(key), d4_str_copy(key), d4_str_copy(key), str, d4_str_t, d4_str_t, d4_str_copy(val), d4_str_eq(lhs_val, rhs_val), d4_str_free(val), d4_str_quoted_escape(val))
+
+D4_SNAPMAP_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_SNAPMAP_DEFINE(str, d4_str_t, d4_str_copy(key), str, d4_str_t)
+
+int main (void) {
+  d4_str_t key1 = d4_str_alloc(L"/");
+  d4_str_t key2 = d4_str_alloc(L"/about");
+  d4_str_t val1 = d4_str_alloc(L"index.html");
+  d4_str_t val2 = d4_str_alloc(L"about.html");
+  d4_map_strMSstrME_t routes = d4_map_strMSstrME_alloc(1, key1, val1);
+  d4_snapmap_strMSstrME_t sm = d4_snapmap_strMSstrME_alloc(routes);
+  d4_snapmap_strMSstrME_snapshot_t snapshot = d4_snapmap_strMSstrME_acquire(sm);
+  d4_str_t snapshot_str;
+  d4_str_t current_str;
+  d4_map_strMSstrME_t current;
+
+  d4_snapmap_strMSstrME_set(&sm, key2, val2);
+
+  current = d4_snapmap_strMSstrME_load(sm);
+  snapshot_str = d4_map_strMSstrME_str(*snapshot.map);
+  current_str = d4_map_strMSstrME_str(current);
+
+  wprintf(L"snapshot: %ls\n", snapshot_str.data);
+  wprintf(L"current: %ls\n", current_str.data);
+  wprintf(L"versions waiting for reclamation: %zu\n", d4_snapmap_pending(sm.core));
+
+  d4_snapmap_strMSstrME_release(sm, snapshot);
+  wprintf(L"versions waiting for reclamation after release: %zu\n", d4_snapmap_pending(sm.core));
+
+  d4_map_strMSstrME_free(current);
+  d4_map_strMSstrME_free(routes);
+  d4_snapmap_strMSstrME_free(sm);
+
+  d4_str_free(snapshot_str);
+  d4_str_free(current_str);
+  d4_str_free(key1);
+  d4_str_free(key2);
+  d4_str_free(val1);
+  d4_str_free(val2);
+
+  return 0;
+}
@@ -0,0 +1,38 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/number.h"
+#include "../include/d4/sparse.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_SPARSE_DECLARE(int, int32_t, int, int32_t)
+D4_SPARSE_DEFINE(int, int32_t, int, d4_i32_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+int main (void) {
+  d4_sparse_intMSintME_t s1 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 3, 100, 1, 101, 2, 102, 3);
+  d4_str_t s1_str;
+
+  for (int32_t i = 103; i < 110; i++) {
+    d4_sparse_intMSintME_set(&d4_err_state, 0, 0, &s1, i, i - 99);
+  }
+
+  d4_sparse_intMSintME_remove(&d4_err_state, 0, 0, &s1, 101);
+  s1_str = d4_sparse_intMSintME_str(s1);
+
+  wprintf(L"s1: %ls\n", s1_str.data);
+  wprintf(L"has 101: %ls\n", d4_sparse_intMSintME_has(s1, 101) ? L"true" : L"false");
+  wprintf(L"value of 105: %" PRId32 L"\n", d4_sparse_intMSintME_get(&d4_err_state, 0, 0, s1, 105));
+
+  for (size_t i = 0; i < s1.len; i++) {
+    wprintf(L"%" PRId32 L" => %" PRId32 L"\n", s1.keys[i], s1.values[i]);
+  }
+
+  d4_sparse_intMSintME_free(s1);
+  d4_str_free(s1_str);
+
+  return 0;
+}
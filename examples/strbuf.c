@@ -0,0 +1,25 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include "../include/d4/strbuf.h"
+
+int main (void) {
+  d4_strbuf_t b1 = d4_strbuf_alloc(0);
+  d4_str_t s1;
+
+  d4_strbuf_append(&b1, (d4_str_t) {L"Numbers:", 8, true});
+
+  for (int64_t i = 1; i <= 5; i++) {
+    d4_strbuf_appendChar(&b1, L' ');
+    d4_strbuf_appendInt(&b1, i * i);
+  }
+
+  d4_strbuf_appendFmt(&b1, L" (%d in total)", 5);
+  s1 = d4_strbuf_finish(&b1);
+
+  wprintf(L"string s1 = %ls" D4_EOL, s1.data);
+  d4_str_free(s1);
+}
@@ -16,7 +16,7 @@ int main (void) {
   d4_str_t a6 = d4_str_slice(a2, 1, 7, 1, -1);
   d4_str_t _7;
   d4_str_t a8 = d4_str_lower(a2);
-  wchar_t *c1 = d4_str_at(&d4_err_state, 10, 10, a1, 2);
+  const wchar_t *c1 = d4_str_at(&d4_err_state, 10, 10, a1, 2);
 
   a3 = d4_str_realloc(a3, a1);
 
@@ -0,0 +1,22 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include "../include/d4/strpack.h"
+
+int main (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello, World");
+  d4_strpack_t p1 = d4_strpack_from(s1);
+  d4_strpack_t p2 = d4_strpack_slice(p1, 1, 7, 0, 0);
+  d4_str_t s2 = d4_strpack_toStr(p2);
+
+  wprintf(L"packed %zu characters into %zu bytes" D4_EOL, p1.len, p1.len * p1.kind);
+  wprintf(L"string s2 = %ls" D4_EOL, s2.data);
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_strpack_free(p1);
+  d4_strpack_free(p2);
+}
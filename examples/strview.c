@@ -0,0 +1,27 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include "../include/d4/strview.h"
+
+int main (void) {
+  d4_str_t s1 = d4_str_alloc(L" name = libd4 \n version = 1 \n");
+  d4_strview_iter_t lines = d4_strview_linesIter(d4_strview_from(s1), 0, false);
+  d4_strview_t line;
+
+  while (d4_strview_iter_next(&lines, &line)) {
+    d4_arr_strview_t pair = d4_strview_splitN(line, 1, (d4_strview_t) {L"=", 1}, 2);
+    d4_str_t key = d4_strview_toOwned(d4_strview_trim(pair.data[0]));
+    d4_str_t value = d4_strview_toOwned(d4_strview_trim(pair.data[1]));
+
+    wprintf(L"%ls: %ls" D4_EOL, key.data, value.data);
+
+    d4_str_free(key);
+    d4_str_free(value);
+    d4_arr_strview_free(pair);
+  }
+
+  d4_str_free(s1);
+}
@@ -0,0 +1,22 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include <stdio.h>
+#include "../include/d4/utf8.h"
+
+int main (void) {
+  d4_utf8_t s1 = d4_utf8_alloc("name=caf\xC3\xA9;city=Z\xC3\xBCrich");
+  d4_arr_utf8_t fields = d4_utf8_split(s1, 1, (d4_utf8_t) {";", 1, true});
+
+  for (size_t i = 0; i < fields.len; i++) {
+    d4_utf8_t upper = d4_utf8_upper(fields.data[i]);
+    printf("%s\n", upper.data);
+    d4_utf8_free(upper);
+  }
+
+  d4_arr_utf8_free(fields);
+  d4_utf8_free(s1);
+}
@@ -12,6 +12,7 @@
 #include <string.h>
 #include "error.h"
 #include "fn.h"
+#include "strbuf.h"
 
 /**
  * Macro that can be used to define an array object.
@@ -155,22 +156,14 @@
   } \
   \
   d4_str_t d4_arr_##element_type_name##_join (const d4_arr_##element_type_name##_t self, unsigned char o1, const d4_str_t separator) { \
-    d4_str_t x = o1 == 0 ? d4_str_alloc(L",") : separator; \
-    d4_str_t result = (d4_str_t) {NULL, 0, false}; \
-    d4_str_t t1; \
-    d4_str_t t2; \
+    d4_str_t x = o1 == 0 ? (d4_str_t) {L",", 1, true} : separator; \
+    d4_strbuf_t result = d4_strbuf_alloc(0); \
     for (size_t i = 0; i < self.len; i++) { \
       const element_type element = self.data[i]; \
-      if (i != 0) { \
-        result = d4_str_realloc(result, t1 = d4_str_concat(result, x)); \
-        d4_str_free(t1); \
-      } \
-      result = d4_str_realloc(result, t1 = d4_str_concat(result, t2 = str_block)); \
-      d4_str_free(t1); \
-      d4_str_free(t2); \
+      if (i != 0) d4_strbuf_append(&result, x); \
+      d4_strbuf_appendMove(&result, str_block); \
     } \
-    if (o1 == 0) d4_str_free(x); \
-    return result; \
+    return d4_strbuf_finish(&result); \
   } \
   \
   element_type *d4_arr_##element_type_name##_last (d4_err_state_t *state, int line, int col, d4_arr_##element_type_name##_t *self) { \
@@ -301,26 +294,15 @@
   } \
   \
   d4_str_t d4_arr_##element_type_name##_str (const d4_arr_##element_type_name##_t self) { \
-    d4_str_t t1; \
-    d4_str_t t2; \
-    d4_str_t b = d4_str_alloc(L"]"); \
-    d4_str_t c = d4_str_alloc(L", "); \
-    d4_str_t r = d4_str_alloc(L"["); \
+    d4_strbuf_t r = d4_strbuf_alloc(0); \
+    d4_strbuf_appendChar(&r, L'['); \
     for (size_t i = 0; i < self.len; i++) { \
       const element_type element = self.data[i]; \
-      if (i != 0) { \
-        r = d4_str_realloc(r, t1 = d4_str_concat(r, c)); \
-        d4_str_free(t1); \
-      } \
-      r = d4_str_realloc(r, t1 = d4_str_concat(r, t2 = str_block)); \
-      d4_str_free(t1); \
-      d4_str_free(t2); \
+      if (i != 0) d4_strbuf_append(&r, (d4_str_t) {L", ", 2, true}); \
+      d4_strbuf_appendMove(&r, str_block); \
     } \
-    r = d4_str_realloc(r, t1 = d4_str_concat(r, b)); \
-    d4_str_free(t1); \
-    d4_str_free(b); \
-    d4_str_free(c); \
-    return r; \
+    d4_strbuf_appendChar(&r, L']'); \
+    return d4_strbuf_finish(&r); \
   }
 
 #endif
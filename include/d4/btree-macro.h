@@ -0,0 +1,315 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_BTREE_MACRO_H
+#define D4_BTREE_MACRO_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "array-macro.h"
+
+/** Minimum degree of the B-tree, every node except root holds at least D4_BTREE_MIN_DEGREE - 1 keys. */
+#define D4_BTREE_MIN_DEGREE 16
+
+/** Maximum number of keys that B-tree node can hold. */
+#define D4_BTREE_MAX_KEYS (2 * D4_BTREE_MIN_DEGREE - 1)
+
+/** Maximum height of the B-tree that iterators can traverse. */
+#define D4_BTREE_MAX_HEIGHT 24
+
+/**
+ * Macro that should be used to generate ordered B-tree map type.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the B-tree object.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the B-tree object.
+ */
+#define D4_BTREE_DECLARE(key_type_name, key_type, value_type_name, value_type) \
+  /** Object representation of the B-tree node type. */ \
+  typedef struct d4_btree_##key_type_name##MS##value_type_name##ME_node { \
+    /* Number of keys stored in the node. */ \
+    size_t len; \
+    \
+    /* Whether node has no children, leaf nodes are allocated without children container. */ \
+    bool leaf; \
+    \
+    /* Sorted keys of the node. */ \
+    key_type keys[D4_BTREE_MAX_KEYS]; \
+    \
+    /* Values of the node, stored at the same positions as keys. */ \
+    value_type values[D4_BTREE_MAX_KEYS]; \
+    \
+    /* Child nodes of the node, child at position i holds keys that are less than key at position i. */ \
+    struct d4_btree_##key_type_name##MS##value_type_name##ME_node *children[D4_BTREE_MAX_KEYS + 1]; \
+  } d4_btree_##key_type_name##MS##value_type_name##ME_node_t; \
+  \
+  /** Object representation of the B-tree type. */ \
+  typedef struct { \
+    /* Root node of the B-tree, NULL when B-tree is empty. */ \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *root; \
+    \
+    /* Length of the B-tree object. */ \
+    size_t len; \
+  } d4_btree_##key_type_name##MS##value_type_name##ME_t; \
+  \
+  /** Object representation of the B-tree iterator type. */ \
+  typedef struct { \
+    /* Path of nodes from root to the current node (used internally). */ \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *nodes[D4_BTREE_MAX_HEIGHT]; \
+    \
+    /* Position of the next key inside of every node of the path (used internally). */ \
+    size_t indexes[D4_BTREE_MAX_HEIGHT]; \
+    \
+    /* Number of nodes in the path (used internally). */ \
+    size_t depth; \
+    \
+    /* Whether iteration stops before end key (used internally). */ \
+    bool bounded; \
+    \
+    /* Exclusive upper bound of the iteration (used internally). */ \
+    key_type end; \
+    \
+    /* Pointer to the key of the current pair, owned by B-tree object. */ \
+    const key_type *key; \
+    \
+    /* Pointer to the value of the current pair, owned by B-tree object. */ \
+    value_type *value; \
+  } d4_btree_##key_type_name##MS##value_type_name##ME_iter_t; \
+  \
+  /**
+   * Allocates B-tree object.
+   * @param len Number of key pairs that are passed as arguments.
+   * @param ... Key pairs to copy into resulting B-tree, should be passed in the format key1, value1, key2, value2, etc.
+   * @return Allocated B-tree object.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t d4_btree_##key_type_name##MS##value_type_name##ME_alloc (size_t len, ...); \
+  \
+  /**
+   * Creates iterator positioned at the smallest key that is greater than or equal to provided key.
+   * Iterator is invalidated by any modification of the B-tree object.
+   * @param self B-tree object to iterate.
+   * @param key Key to search for.
+   * @return Iterator over pairs starting from the found key.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_iter_t d4_btree_##key_type_name##MS##value_type_name##ME_ceiling (const d4_btree_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Removes all pairs and changes length to zero.
+   * @param self B-tree object to clear.
+   * @return Reference to itself.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t *d4_btree_##key_type_name##MS##value_type_name##ME_clear (d4_btree_##key_type_name##MS##value_type_name##ME_t *self); \
+  \
+  /**
+   * Creates a copy of provided B-tree object.
+   * @param self B-tree object to create copy of.
+   * @return Copy of provided B-tree object.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t d4_btree_##key_type_name##MS##value_type_name##ME_copy (const d4_btree_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Checks whether B-tree has any pairs.
+   * @param self B-tree object to check.
+   * @return Whether B-tree has any pairs.
+   */ \
+  bool d4_btree_##key_type_name##MS##value_type_name##ME_empty (const d4_btree_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Compares whether B-tree object is equal to right-hand B-tree object.
+   * @param self B-tree object to check.
+   * @param rhs Right-hand B-tree object to check.
+   * @return Whether two B-tree objects are equal.
+   */ \
+  bool d4_btree_##key_type_name##MS##value_type_name##ME_eq (const d4_btree_##key_type_name##MS##value_type_name##ME_t self, const d4_btree_##key_type_name##MS##value_type_name##ME_t rhs); \
+  \
+  /**
+   * Creates iterator positioned at the largest key that is less than or equal to provided key.
+   * Iterator is invalidated by any modification of the B-tree object.
+   * @param self B-tree object to iterate.
+   * @param key Key to search for.
+   * @return Iterator over pairs starting from the found key.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_iter_t d4_btree_##key_type_name##MS##value_type_name##ME_floor (const d4_btree_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Deallocates B-tree object.
+   * @param self B-tree object to deallocate.
+   */ \
+  void d4_btree_##key_type_name##MS##value_type_name##ME_free (d4_btree_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Allocates B-tree object from arrays of keys and values, pairing elements by index. Extra elements of the longer array are ignored.
+   * When keys are sorted in strictly ascending order nodes are built bottom-up without any splits, otherwise pairs are inserted one by one.
+   * @param keys Array of keys to copy.
+   * @param values Array of values to copy.
+   * @return Allocated B-tree object.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t d4_btree_##key_type_name##MS##value_type_name##ME_fromSorted (const d4_arr_##key_type_name##_t keys, const d4_arr_##value_type_name##_t values); \
+  \
+  /**
+   * Retrieves value of provided key and if key doesn’t exist throws error.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self B-tree object to retrieve value from.
+   * @param key Key to retrieve value of.
+   * @return Value of the provided key.
+   */ \
+  value_type d4_btree_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, const d4_btree_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Checks whether B-tree object contains provided key.
+   * @param self B-tree object to check.
+   * @param key Key to check.
+   * @return Whether B-tree object contains provided key.
+   */ \
+  bool d4_btree_##key_type_name##MS##value_type_name##ME_has (const d4_btree_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Creates iterator positioned at the smallest key of the B-tree object.
+   * Iterator is invalidated by any modification of the B-tree object.
+   * @param self B-tree object to iterate.
+   * @return Iterator over all pairs in ascending order of keys.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_iter_t d4_btree_##key_type_name##MS##value_type_name##ME_iterBegin (const d4_btree_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Advances iterator to the next pair, current pair is available through key and value fields of the iterator.
+   * @param self Iterator to advance.
+   * @return Whether iterator was advanced, false when there are no more pairs.
+   */ \
+  bool d4_btree_##key_type_name##MS##value_type_name##ME_iterNext (d4_btree_##key_type_name##MS##value_type_name##ME_iter_t *self); \
+  \
+  /**
+   * Returns array of B-tree keys in ascending order.
+   * @param self B-tree object to use.
+   * @return Array of B-tree keys.
+   */ \
+  d4_arr_##key_type_name##_t d4_btree_##key_type_name##MS##value_type_name##ME_keys (const d4_btree_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Allocates B-tree node without any keys.
+   * @param leaf Whether node has no children.
+   * @return Allocated B-tree node.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_node_t *d4_btree_##key_type_name##MS##value_type_name##ME_nodeAlloc (bool leaf); \
+  \
+  /**
+   * Builds B-tree node of specified height from sorted keys and values (used internally).
+   * @param keys Sorted keys to copy.
+   * @param values Values to copy.
+   * @param len Number of keys.
+   * @param height Height of the resulting node, leaf nodes have height of 1.
+   * @return Allocated B-tree node.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_node_t *d4_btree_##key_type_name##MS##value_type_name##ME_nodeBuild (const key_type *keys, const value_type *values, size_t len, size_t height); \
+  \
+  /**
+   * Creates a deep copy of B-tree node and its children.
+   * @param node B-tree node to create copy of, can be NULL.
+   * @return Copy of provided B-tree node.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_node_t *d4_btree_##key_type_name##MS##value_type_name##ME_nodeCopy (const d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node); \
+  \
+  /**
+   * Makes sure child of B-tree node has at least D4_BTREE_MIN_DEGREE keys by borrowing key from sibling or merging with sibling (used internally).
+   * @param node B-tree node to change child of.
+   * @param index Position of the child.
+   * @return Position of the child after change.
+   */ \
+  size_t d4_btree_##key_type_name##MS##value_type_name##ME_nodeFill (d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node, size_t index); \
+  \
+  /**
+   * Deallocates B-tree node and its children.
+   * @param node B-tree node to deallocate, can be NULL.
+   */ \
+  void d4_btree_##key_type_name##MS##value_type_name##ME_nodeFree (d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node); \
+  \
+  /**
+   * Merges child of B-tree node with its right sibling and separating key (used internally).
+   * @param node B-tree node to change children of.
+   * @param index Position of the left child.
+   */ \
+  void d4_btree_##key_type_name##MS##value_type_name##ME_nodeMerge (d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node, size_t index); \
+  \
+  /**
+   * Searches for position of the smallest key that is greater than or equal to provided key inside of B-tree node.
+   * @param node B-tree node to search in.
+   * @param key Key to search for.
+   * @param found Whether key at resulting position is equal to provided key.
+   * @return Position of the key.
+   */ \
+  size_t d4_btree_##key_type_name##MS##value_type_name##ME_nodeSearch (const d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node, const key_type key, bool *found); \
+  \
+  /**
+   * Splits full child of B-tree node into two, moving median key into node (used internally).
+   * @param node B-tree node to change children of.
+   * @param index Position of the full child.
+   */ \
+  void d4_btree_##key_type_name##MS##value_type_name##ME_nodeSplit (d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node, size_t index); \
+  \
+  /**
+   * Removes key from subtree of B-tree node passing ownership of removed key and value to caller (used internally).
+   * @param node B-tree node to remove key from, should have at least D4_BTREE_MIN_DEGREE keys unless it's the root node.
+   * @param key Key to remove.
+   * @param out_key Pointer that receives removed key.
+   * @param out_value Pointer that receives removed value.
+   * @return Whether key was removed.
+   */ \
+  bool d4_btree_##key_type_name##MS##value_type_name##ME_nodeTake (d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node, const key_type key, key_type *out_key, value_type *out_value); \
+  \
+  /**
+   * Creates iterator over pairs with keys that are greater than or equal to start key and less than end key.
+   * Iterator is invalidated by any modification of the B-tree object.
+   * @param self B-tree object to iterate.
+   * @param start Inclusive lower bound of the keys.
+   * @param end Exclusive upper bound of the keys, should stay alive while iterator is used.
+   * @return Iterator over pairs of the range.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_iter_t d4_btree_##key_type_name##MS##value_type_name##ME_range (const d4_btree_##key_type_name##MS##value_type_name##ME_t self, const key_type start, const key_type end); \
+  \
+  /**
+   * Deallocates current B-tree object and returns a copy of another B-tree object.
+   * @param self B-tree object to deallocate.
+   * @param rhs B-tree object to return a copy of.
+   * @return Copy of another B-tree object.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t d4_btree_##key_type_name##MS##value_type_name##ME_realloc (d4_btree_##key_type_name##MS##value_type_name##ME_t self, const d4_btree_##key_type_name##MS##value_type_name##ME_t rhs); \
+  \
+  /**
+   * Removes provided key from the B-tree object and if key doesn’t exist throws error.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self B-tree object to remove key from.
+   * @param search_key Key to remove.
+   * @return Reference to itself.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t *d4_btree_##key_type_name##MS##value_type_name##ME_remove (d4_err_state_t *state, int line, int col, d4_btree_##key_type_name##MS##value_type_name##ME_t *self, const key_type search_key); \
+  \
+  /**
+   * Sets a pair inside B-tree object, if key exists - replaces its value.
+   * @param self B-tree object to set pair into.
+   * @param key Key of the new pair.
+   * @param value Value of the new pair.
+   * @return Reference to itself.
+   */ \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t *d4_btree_##key_type_name##MS##value_type_name##ME_set (d4_btree_##key_type_name##MS##value_type_name##ME_t *self, const key_type key, const value_type value); \
+  \
+  /**
+   * Generates string representation of the B-tree object.
+   * @param self B-tree object to generate string representation for.
+   * @return String representation of the B-tree object.
+   */ \
+  d4_str_t d4_btree_##key_type_name##MS##value_type_name##ME_str (const d4_btree_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Returns array of B-tree values in ascending order of keys.
+   * @param self B-tree object to use.
+   * @return Array of B-tree values.
+   */ \
+  d4_arr_##value_type_name##_t d4_btree_##key_type_name##MS##value_type_name##ME_values (const d4_btree_##key_type_name##MS##value_type_name##ME_t self);
+
+#endif
@@ -0,0 +1,543 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_BTREE_H
+#define D4_BTREE_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include <stddef.h>
+#include "btree-macro.h"
+#include "array.h"
+
+/**
+ * Macro that can be used to define an ordered B-tree map object.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the B-tree object.
+ * @param key_alloc_type Key type of the key to be used inside variadic argument (should be cast to int in some cases).
+ * @param key_copy_block Block that is used for copy method of key.
+ * @param key_cmp_block Block that is used to compare keys, should evaluate to negative number, zero or positive number when lhs_key is less than, equal to or greater than rhs_key.
+ * @param key_free_block Block that is used for free method of key.
+ * @param key_str_block Block that is used for str method of key.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the B-tree object.
+ * @param value_alloc_type Value type of the value to be used inside variadic argument (should be cast to int in some cases).
+ * @param value_copy_block Block that is used for copy method of value.
+ * @param value_eq_block Block that is used for equals method of value.
+ * @param value_free_block Block that is used for free method of value.
+ * @param value_str_block Block that is used for str method of value.
+ */
+#define D4_BTREE_DEFINE(key_type_name, key_type, key_alloc_type, key_copy_block, key_cmp_block, key_free_block, key_str_block, value_type_name, value_type, value_alloc_type, value_copy_block, value_eq_block, value_free_block, value_str_block) \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t d4_btree_##key_type_name##MS##value_type_name##ME_alloc (size_t len, ...) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_t self = {NULL, 0}; \
+    va_list args; \
+    if (len == 0) return self; \
+    va_start(args, len); \
+    for (size_t i = 0; i < len; i++) { \
+      const key_type key = va_arg(args, key_alloc_type); \
+      const value_type value = va_arg(args, value_alloc_type); \
+      d4_btree_##key_type_name##MS##value_type_name##ME_set(&self, key, value); \
+    } \
+    va_end(args); \
+    return self; \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_iter_t d4_btree_##key_type_name##MS##value_type_name##ME_ceiling (const d4_btree_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_iter_t iter; \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node = self.root; \
+    memset(&iter, 0, sizeof(iter)); \
+    while (node != NULL) { \
+      bool found; \
+      size_t i = d4_btree_##key_type_name##MS##value_type_name##ME_nodeSearch(node, key, &found); \
+      iter.nodes[iter.depth] = node; \
+      iter.indexes[iter.depth++] = i; \
+      if (found || node->leaf) break; \
+      node = node->children[i]; \
+    } \
+    return iter; \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t *d4_btree_##key_type_name##MS##value_type_name##ME_clear (d4_btree_##key_type_name##MS##value_type_name##ME_t *self) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_nodeFree(self->root); \
+    self->root = NULL; \
+    self->len = 0; \
+    return self; \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t d4_btree_##key_type_name##MS##value_type_name##ME_copy (const d4_btree_##key_type_name##MS##value_type_name##ME_t self) { \
+    return (d4_btree_##key_type_name##MS##value_type_name##ME_t) {d4_btree_##key_type_name##MS##value_type_name##ME_nodeCopy(self.root), self.len}; \
+  } \
+  \
+  bool d4_btree_##key_type_name##MS##value_type_name##ME_empty (const d4_btree_##key_type_name##MS##value_type_name##ME_t self) { \
+    return self.len == 0; \
+  } \
+  \
+  bool d4_btree_##key_type_name##MS##value_type_name##ME_eq (const d4_btree_##key_type_name##MS##value_type_name##ME_t self, const d4_btree_##key_type_name##MS##value_type_name##ME_t rhs) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_iter_t it1; \
+    d4_btree_##key_type_name##MS##value_type_name##ME_iter_t it2; \
+    if (self.len != rhs.len) return false; \
+    it1 = d4_btree_##key_type_name##MS##value_type_name##ME_iterBegin(self); \
+    it2 = d4_btree_##key_type_name##MS##value_type_name##ME_iterBegin(rhs); \
+    while (d4_btree_##key_type_name##MS##value_type_name##ME_iterNext(&it1) && d4_btree_##key_type_name##MS##value_type_name##ME_iterNext(&it2)) { \
+      const key_type lhs_key = *it1.key; \
+      const key_type rhs_key = *it2.key; \
+      value_type lhs_val = *it1.value; \
+      value_type rhs_val = *it2.value; \
+      if ((key_cmp_block) != 0 || !(value_eq_block)) return false; \
+    } \
+    return true; \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_iter_t d4_btree_##key_type_name##MS##value_type_name##ME_floor (const d4_btree_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_iter_t iter; \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node = self.root; \
+    memset(&iter, 0, sizeof(iter)); \
+    while (node != NULL) { \
+      bool found; \
+      size_t i = d4_btree_##key_type_name##MS##value_type_name##ME_nodeSearch(node, key, &found); \
+      iter.nodes[iter.depth] = node; \
+      iter.indexes[iter.depth++] = i; \
+      if (found) return iter; \
+      if (node->leaf) break; \
+      node = node->children[i]; \
+    } \
+    while (iter.depth > 0 && iter.indexes[iter.depth - 1] == 0) iter.depth--; \
+    if (iter.depth > 0) iter.indexes[iter.depth - 1] -= 1; \
+    return iter; \
+  } \
+  \
+  void d4_btree_##key_type_name##MS##value_type_name##ME_free (d4_btree_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_nodeFree(self.root); \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t d4_btree_##key_type_name##MS##value_type_name##ME_fromSorted (const d4_arr_##key_type_name##_t keys, const d4_arr_##value_type_name##_t values) { \
+    size_t len = keys.len < values.len ? keys.len : values.len; \
+    size_t height = 1; \
+    size_t height_cap = D4_BTREE_MAX_KEYS; \
+    d4_btree_##key_type_name##MS##value_type_name##ME_t self = {NULL, 0}; \
+    for (size_t i = 1; i < len; i++) { \
+      const key_type lhs_key = keys.data[i - 1]; \
+      const key_type rhs_key = keys.data[i]; \
+      if ((key_cmp_block) >= 0) { \
+        for (size_t j = 0; j < len; j++) d4_btree_##key_type_name##MS##value_type_name##ME_set(&self, keys.data[j], values.data[j]); \
+        return self; \
+      } \
+    } \
+    if (len == 0) return self; \
+    while (height_cap < len) { \
+      height_cap = D4_BTREE_MAX_KEYS + (D4_BTREE_MAX_KEYS + 1) * height_cap; \
+      height++; \
+    } \
+    self.root = d4_btree_##key_type_name##MS##value_type_name##ME_nodeBuild(keys.data, values.data, len, height); \
+    self.len = len; \
+    return self; \
+  } \
+  \
+  value_type d4_btree_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, const d4_btree_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node = self.root; \
+    value_type val; \
+    d4_str_t key_str; \
+    d4_str_t message; \
+    while (node != NULL) { \
+      bool found; \
+      size_t i = d4_btree_##key_type_name##MS##value_type_name##ME_nodeSearch(node, key, &found); \
+      if (found) { \
+        val = node->values[i]; \
+        return value_copy_block; \
+      } \
+      node = node->leaf ? NULL : node->children[i]; \
+    } \
+    key_str = key_str_block; \
+    message = d4_str_alloc(L"failed to find key '%ls'", key_str.data); \
+    d4_error_assign_generic(state, line, col, message); \
+    d4_str_free(message); \
+    d4_str_free(key_str); \
+    longjmp(state->buf_last->buf, state->id); \
+  } \
+  \
+  bool d4_btree_##key_type_name##MS##value_type_name##ME_has (const d4_btree_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node = self.root; \
+    while (node != NULL) { \
+      bool found; \
+      size_t i = d4_btree_##key_type_name##MS##value_type_name##ME_nodeSearch(node, key, &found); \
+      if (found) return true; \
+      node = node->leaf ? NULL : node->children[i]; \
+    } \
+    return false; \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_iter_t d4_btree_##key_type_name##MS##value_type_name##ME_iterBegin (const d4_btree_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_iter_t iter; \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node = self.root; \
+    memset(&iter, 0, sizeof(iter)); \
+    while (node != NULL) { \
+      iter.nodes[iter.depth] = node; \
+      iter.indexes[iter.depth++] = 0; \
+      node = node->leaf ? NULL : node->children[0]; \
+    } \
+    return iter; \
+  } \
+  \
+  bool d4_btree_##key_type_name##MS##value_type_name##ME_iterNext (d4_btree_##key_type_name##MS##value_type_name##ME_iter_t *self) { \
+    while (self->depth > 0) { \
+      d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node = self->nodes[self->depth - 1]; \
+      size_t i = self->indexes[self->depth - 1]; \
+      d4_btree_##key_type_name##MS##value_type_name##ME_node_t *child; \
+      if (i >= node->len) { \
+        self->depth--; \
+        continue; \
+      } \
+      if (self->bounded) { \
+        const key_type lhs_key = node->keys[i]; \
+        const key_type rhs_key = self->end; \
+        if ((key_cmp_block) >= 0) break; \
+      } \
+      self->key = &node->keys[i]; \
+      self->value = &node->values[i]; \
+      self->indexes[self->depth - 1] = i + 1; \
+      child = node->leaf ? NULL : node->children[i + 1]; \
+      while (child != NULL) { \
+        self->nodes[self->depth] = child; \
+        self->indexes[self->depth++] = 0; \
+        child = child->leaf ? NULL : child->children[0]; \
+      } \
+      return true; \
+    } \
+    self->depth = 0; \
+    self->key = NULL; \
+    self->value = NULL; \
+    return false; \
+  } \
+  \
+  d4_arr_##key_type_name##_t d4_btree_##key_type_name##MS##value_type_name##ME_keys (const d4_btree_##key_type_name##MS##value_type_name##ME_t self) { \
+    key_type *data = d4_safe_alloc(self.len * sizeof(key_type)); \
+    d4_btree_##key_type_name##MS##value_type_name##ME_iter_t iter = d4_btree_##key_type_name##MS##value_type_name##ME_iterBegin(self); \
+    size_t j = 0; \
+    while (d4_btree_##key_type_name##MS##value_type_name##ME_iterNext(&iter)) { \
+      key_type key = *iter.key; \
+      data[j++] = key_copy_block; \
+    } \
+    return (d4_arr_##key_type_name##_t) {data, self.len}; \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_node_t *d4_btree_##key_type_name##MS##value_type_name##ME_nodeAlloc (bool leaf) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node = d4_safe_alloc(leaf ? offsetof(d4_btree_##key_type_name##MS##value_type_name##ME_node_t, children) : sizeof(d4_btree_##key_type_name##MS##value_type_name##ME_node_t)); \
+    node->len = 0; \
+    node->leaf = leaf; \
+    return node; \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_node_t *d4_btree_##key_type_name##MS##value_type_name##ME_nodeBuild (const key_type *keys, const value_type *values, size_t len, size_t height) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node = d4_btree_##key_type_name##MS##value_type_name##ME_nodeAlloc(height == 1); \
+    size_t child_cap = D4_BTREE_MAX_KEYS; \
+    size_t children_len; \
+    size_t child_len; \
+    size_t extra; \
+    size_t offset = 0; \
+    if (height == 1) { \
+      for (size_t i = 0; i < len; i++) { \
+        key_type key = keys[i]; \
+        value_type val = values[i]; \
+        node->keys[i] = key_copy_block; \
+        node->values[i] = value_copy_block; \
+      } \
+      node->len = len; \
+      return node; \
+    } \
+    for (size_t i = 2; i < height; i++) { \
+      child_cap = D4_BTREE_MAX_KEYS + (D4_BTREE_MAX_KEYS + 1) * child_cap; \
+    } \
+    children_len = (len + child_cap + 1) / (child_cap + 1); \
+    if (children_len < 2) children_len = 2; \
+    child_len = (len - children_len + 1) / children_len; \
+    extra = (len - children_len + 1) % children_len; \
+    for (size_t i = 0; i < children_len; i++) { \
+      size_t n = child_len + (i < extra ? 1 : 0); \
+      node->children[i] = d4_btree_##key_type_name##MS##value_type_name##ME_nodeBuild(keys + offset, values + offset, n, height - 1); \
+      offset += n; \
+      if (i + 1 < children_len) { \
+        key_type key = keys[offset]; \
+        value_type val = values[offset]; \
+        node->keys[i] = key_copy_block; \
+        node->values[i] = value_copy_block; \
+        offset++; \
+      } \
+    } \
+    node->len = children_len - 1; \
+    return node; \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_node_t *d4_btree_##key_type_name##MS##value_type_name##ME_nodeCopy (const d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *result; \
+    if (node == NULL) return NULL; \
+    result = d4_btree_##key_type_name##MS##value_type_name##ME_nodeAlloc(node->leaf); \
+    result->len = node->len; \
+    for (size_t i = 0; i < node->len; i++) { \
+      key_type key = node->keys[i]; \
+      value_type val = node->values[i]; \
+      result->keys[i] = key_copy_block; \
+      result->values[i] = value_copy_block; \
+    } \
+    if (!node->leaf) { \
+      for (size_t i = 0; i <= node->len; i++) { \
+        result->children[i] = d4_btree_##key_type_name##MS##value_type_name##ME_nodeCopy(node->children[i]); \
+      } \
+    } \
+    return result; \
+  } \
+  \
+  size_t d4_btree_##key_type_name##MS##value_type_name##ME_nodeFill (d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node, size_t index) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *child = node->children[index]; \
+    if (child->len >= D4_BTREE_MIN_DEGREE) return index; \
+    if (index > 0 && node->children[index - 1]->len >= D4_BTREE_MIN_DEGREE) { \
+      d4_btree_##key_type_name##MS##value_type_name##ME_node_t *left = node->children[index - 1]; \
+      memmove(child->keys + 1, child->keys, child->len * sizeof(key_type)); \
+      memmove(child->values + 1, child->values, child->len * sizeof(value_type)); \
+      if (!child->leaf) { \
+        memmove(child->children + 1, child->children, (child->len + 1) * sizeof(d4_btree_##key_type_name##MS##value_type_name##ME_node_t *)); \
+        child->children[0] = left->children[left->len]; \
+      } \
+      child->keys[0] = node->keys[index - 1]; \
+      child->values[0] = node->values[index - 1]; \
+      node->keys[index - 1] = left->keys[left->len - 1]; \
+      node->values[index - 1] = left->values[left->len - 1]; \
+      left->len -= 1; \
+      child->len += 1; \
+      return index; \
+    } \
+    if (index < node->len && node->children[index + 1]->len >= D4_BTREE_MIN_DEGREE) { \
+      d4_btree_##key_type_name##MS##value_type_name##ME_node_t *right = node->children[index + 1]; \
+      child->keys[child->len] = node->keys[index]; \
+      child->values[child->len] = node->values[index]; \
+      if (!child->leaf) child->children[child->len + 1] = right->children[0]; \
+      node->keys[index] = right->keys[0]; \
+      node->values[index] = right->values[0]; \
+      memmove(right->keys, right->keys + 1, (right->len - 1) * sizeof(key_type)); \
+      memmove(right->values, right->values + 1, (right->len - 1) * sizeof(value_type)); \
+      if (!right->leaf) memmove(right->children, right->children + 1, right->len * sizeof(d4_btree_##key_type_name##MS##value_type_name##ME_node_t *)); \
+      right->len -= 1; \
+      child->len += 1; \
+      return index; \
+    } \
+    if (index < node->len) { \
+      d4_btree_##key_type_name##MS##value_type_name##ME_nodeMerge(node, index); \
+      return index; \
+    } \
+    d4_btree_##key_type_name##MS##value_type_name##ME_nodeMerge(node, index - 1); \
+    return index - 1; \
+  } \
+  \
+  void d4_btree_##key_type_name##MS##value_type_name##ME_nodeFree (d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node) { \
+    if (node == NULL) return; \
+    for (size_t i = 0; i < node->len; i++) { \
+      key_type key = node->keys[i]; \
+      value_type val = node->values[i]; \
+      key_free_block; \
+      value_free_block; \
+    } \
+    if (!node->leaf) { \
+      for (size_t i = 0; i <= node->len; i++) { \
+        d4_btree_##key_type_name##MS##value_type_name##ME_nodeFree(node->children[i]); \
+      } \
+    } \
+    d4_safe_free(node); \
+  } \
+  \
+  void d4_btree_##key_type_name##MS##value_type_name##ME_nodeMerge (d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node, size_t index) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *left = node->children[index]; \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *right = node->children[index + 1]; \
+    left->keys[left->len] = node->keys[index]; \
+    left->values[left->len] = node->values[index]; \
+    memcpy(left->keys + left->len + 1, right->keys, right->len * sizeof(key_type)); \
+    memcpy(left->values + left->len + 1, right->values, right->len * sizeof(value_type)); \
+    if (!left->leaf) memcpy(left->children + left->len + 1, right->children, (right->len + 1) * sizeof(d4_btree_##key_type_name##MS##value_type_name##ME_node_t *)); \
+    left->len += right->len + 1; \
+    memmove(node->keys + index, node->keys + index + 1, (node->len - index - 1) * sizeof(key_type)); \
+    memmove(node->values + index, node->values + index + 1, (node->len - index - 1) * sizeof(value_type)); \
+    memmove(node->children + index + 1, node->children + index + 2, (node->len - index - 1) * sizeof(d4_btree_##key_type_name##MS##value_type_name##ME_node_t *)); \
+    node->len -= 1; \
+    d4_safe_free(right); \
+  } \
+  \
+  size_t d4_btree_##key_type_name##MS##value_type_name##ME_nodeSearch (const d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node, const key_type key, bool *found) { \
+    size_t lo = 0; \
+    size_t hi = node->len; \
+    *found = false; \
+    while (lo < hi) { \
+      size_t mid = lo + (hi - lo) / 2; \
+      const key_type lhs_key = node->keys[mid]; \
+      const key_type rhs_key = key; \
+      int cmp = key_cmp_block; \
+      if (cmp == 0) { \
+        *found = true; \
+        return mid; \
+      } else if (cmp < 0) { \
+        lo = mid + 1; \
+      } else { \
+        hi = mid; \
+      } \
+    } \
+    return lo; \
+  } \
+  \
+  void d4_btree_##key_type_name##MS##value_type_name##ME_nodeSplit (d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node, size_t index) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *child = node->children[index]; \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *sibling = d4_btree_##key_type_name##MS##value_type_name##ME_nodeAlloc(child->leaf); \
+    sibling->len = D4_BTREE_MIN_DEGREE - 1; \
+    memcpy(sibling->keys, child->keys + D4_BTREE_MIN_DEGREE, sibling->len * sizeof(key_type)); \
+    memcpy(sibling->values, child->values + D4_BTREE_MIN_DEGREE, sibling->len * sizeof(value_type)); \
+    if (!child->leaf) memcpy(sibling->children, child->children + D4_BTREE_MIN_DEGREE, D4_BTREE_MIN_DEGREE * sizeof(d4_btree_##key_type_name##MS##value_type_name##ME_node_t *)); \
+    child->len = D4_BTREE_MIN_DEGREE - 1; \
+    memmove(node->keys + index + 1, node->keys + index, (node->len - index) * sizeof(key_type)); \
+    memmove(node->values + index + 1, node->values + index, (node->len - index) * sizeof(value_type)); \
+    memmove(node->children + index + 2, node->children + index + 1, (node->len - index) * sizeof(d4_btree_##key_type_name##MS##value_type_name##ME_node_t *)); \
+    node->keys[index] = child->keys[D4_BTREE_MIN_DEGREE - 1]; \
+    node->values[index] = child->values[D4_BTREE_MIN_DEGREE - 1]; \
+    node->children[index + 1] = sibling; \
+    node->len += 1; \
+  } \
+  \
+  bool d4_btree_##key_type_name##MS##value_type_name##ME_nodeTake (d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node, const key_type key, key_type *out_key, value_type *out_value) { \
+    while (true) { \
+      bool found; \
+      size_t i = d4_btree_##key_type_name##MS##value_type_name##ME_nodeSearch(node, key, &found); \
+      if (found && node->leaf) { \
+        *out_key = node->keys[i]; \
+        *out_value = node->values[i]; \
+        memmove(node->keys + i, node->keys + i + 1, (node->len - i - 1) * sizeof(key_type)); \
+        memmove(node->values + i, node->values + i + 1, (node->len - i - 1) * sizeof(value_type)); \
+        node->len -= 1; \
+        return true; \
+      } else if (found) { \
+        d4_btree_##key_type_name##MS##value_type_name##ME_node_t *left = node->children[i]; \
+        d4_btree_##key_type_name##MS##value_type_name##ME_node_t *right = node->children[i + 1]; \
+        d4_btree_##key_type_name##MS##value_type_name##ME_node_t *it; \
+        if (left->len >= D4_BTREE_MIN_DEGREE) { \
+          for (it = left; !it->leaf; it = it->children[it->len]) {} \
+          *out_key = node->keys[i]; \
+          *out_value = node->values[i]; \
+          return d4_btree_##key_type_name##MS##value_type_name##ME_nodeTake(left, it->keys[it->len - 1], &node->keys[i], &node->values[i]); \
+        } else if (right->len >= D4_BTREE_MIN_DEGREE) { \
+          for (it = right; !it->leaf; it = it->children[0]) {} \
+          *out_key = node->keys[i]; \
+          *out_value = node->values[i]; \
+          return d4_btree_##key_type_name##MS##value_type_name##ME_nodeTake(right, it->keys[0], &node->keys[i], &node->values[i]); \
+        } \
+        d4_btree_##key_type_name##MS##value_type_name##ME_nodeMerge(node, i); \
+        node = left; \
+      } else if (node->leaf) { \
+        return false; \
+      } else { \
+        node = node->children[d4_btree_##key_type_name##MS##value_type_name##ME_nodeFill(node, i)]; \
+      } \
+    } \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_iter_t d4_btree_##key_type_name##MS##value_type_name##ME_range (const d4_btree_##key_type_name##MS##value_type_name##ME_t self, const key_type start, const key_type end) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_iter_t iter = d4_btree_##key_type_name##MS##value_type_name##ME_ceiling(self, start); \
+    iter.bounded = true; \
+    iter.end = end; \
+    return iter; \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t d4_btree_##key_type_name##MS##value_type_name##ME_realloc (d4_btree_##key_type_name##MS##value_type_name##ME_t self, const d4_btree_##key_type_name##MS##value_type_name##ME_t rhs) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_free(self); \
+    return d4_btree_##key_type_name##MS##value_type_name##ME_copy(rhs); \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t *d4_btree_##key_type_name##MS##value_type_name##ME_remove (d4_err_state_t *state, int line, int col, d4_btree_##key_type_name##MS##value_type_name##ME_t *self, const key_type search_key) { \
+    key_type key = search_key; \
+    value_type val; \
+    bool found = self->root != NULL && d4_btree_##key_type_name##MS##value_type_name##ME_nodeTake(self->root, search_key, &key, &val); \
+    d4_str_t key_str; \
+    d4_str_t message; \
+    if (self->root != NULL && self->root->len == 0) { \
+      d4_btree_##key_type_name##MS##value_type_name##ME_node_t *root = self->root; \
+      self->root = root->leaf ? NULL : root->children[0]; \
+      d4_safe_free(root); \
+    } \
+    if (found) { \
+      key_free_block; \
+      value_free_block; \
+      self->len -= 1; \
+      return self; \
+    } \
+    key_str = key_str_block; \
+    message = d4_str_alloc(L"failed to remove key '%ls'", key_str.data); \
+    d4_error_assign_generic(state, line, col, message); \
+    d4_str_free(message); \
+    d4_str_free(key_str); \
+    longjmp(state->buf_last->buf, state->id); \
+  } \
+  \
+  d4_btree_##key_type_name##MS##value_type_name##ME_t *d4_btree_##key_type_name##MS##value_type_name##ME_set (d4_btree_##key_type_name##MS##value_type_name##ME_t *self, const key_type key, const value_type value) { \
+    d4_btree_##key_type_name##MS##value_type_name##ME_node_t *node; \
+    value_type val; \
+    if (self->root == NULL) { \
+      self->root = d4_btree_##key_type_name##MS##value_type_name##ME_nodeAlloc(true); \
+    } else if (self->root->len == D4_BTREE_MAX_KEYS) { \
+      d4_btree_##key_type_name##MS##value_type_name##ME_node_t *root = d4_btree_##key_type_name##MS##value_type_name##ME_nodeAlloc(false); \
+      root->children[0] = self->root; \
+      self->root = root; \
+      d4_btree_##key_type_name##MS##value_type_name##ME_nodeSplit(root, 0); \
+    } \
+    node = self->root; \
+    while (true) { \
+      bool found; \
+      size_t i = d4_btree_##key_type_name##MS##value_type_name##ME_nodeSearch(node, key, &found); \
+      if (found) { \
+        val = node->values[i]; \
+        value_free_block; \
+        val = value; \
+        node->values[i] = value_copy_block; \
+        return self; \
+      } else if (node->leaf) { \
+        memmove(node->keys + i + 1, node->keys + i, (node->len - i) * sizeof(key_type)); \
+        memmove(node->values + i + 1, node->values + i, (node->len - i) * sizeof(value_type)); \
+        val = value; \
+        node->keys[i] = key_copy_block; \
+        node->values[i] = value_copy_block; \
+        node->len += 1; \
+        self->len += 1; \
+        return self; \
+      } else if (node->children[i]->len == D4_BTREE_MAX_KEYS) { \
+        d4_btree_##key_type_name##MS##value_type_name##ME_nodeSplit(node, i); \
+      } else { \
+        node = node->children[i]; \
+      } \
+    } \
+  } \
+  \
+  d4_str_t d4_btree_##key_type_name##MS##value_type_name##ME_str (const d4_btree_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_strbuf_t r = d4_strbuf_alloc(0); \
+    d4_btree_##key_type_name##MS##value_type_name##ME_iter_t iter = d4_btree_##key_type_name##MS##value_type_name##ME_iterBegin(self); \
+    size_t j = 0; \
+    d4_strbuf_appendChar(&r, L'{'); \
+    while (d4_btree_##key_type_name##MS##value_type_name##ME_iterNext(&iter)) { \
+      key_type key = *iter.key; \
+      value_type val = *iter.value; \
+      d4_str_t key_str = key_str_block; \
+      if (j++ != 0) d4_strbuf_append(&r, (d4_str_t) {L", ", 2, true}); \
+      d4_strbuf_appendMove(&r, d4_str_quoted_escape(key_str)); \
+      d4_strbuf_append(&r, (d4_str_t) {L": ", 2, true}); \
+      d4_strbuf_appendMove(&r, value_str_block); \
+      d4_str_free(key_str); \
+    } \
+    d4_strbuf_appendChar(&r, L'}'); \
+    return d4_strbuf_finish(&r); \
+  } \
+  \
+  d4_arr_##value_type_name##_t d4_btree_##key_type_name##MS##value_type_name##ME_values (const d4_btree_##key_type_name##MS##value_type_name##ME_t self) { \
+    value_type *data = d4_safe_alloc(self.len * sizeof(value_type)); \
+    d4_btree_##key_type_name##MS##value_type_name##ME_iter_t iter = d4_btree_##key_type_name##MS##value_type_name##ME_iterBegin(self); \
+    size_t j = 0; \
+    while (d4_btree_##key_type_name##MS##value_type_name##ME_iterNext(&iter)) { \
+      value_type val = *iter.value; \
+      data[j++] = value_copy_block; \
+    } \
+    return (d4_arr_##value_type_name##_t) {data, self.len}; \
+  }
+
+#endif
@@ -0,0 +1,201 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_CACHE_MACRO_H
+#define D4_CACHE_MACRO_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "array-macro.h"
+
+/** Maximum number of hits CLOCK policy remembers per entry, each sweep of the clock hand forgets one of them. */
+#define D4_CACHE_MAX_FREQUENCY 3
+
+/** Object representation of the cache eviction policy. */
+typedef enum {
+  /* Evicts least recently used entry, every hit moves entry to the front of the eviction order. */
+  D4_CACHE_LRU,
+
+  /* Evicts the first entry without remembered hits found by the clock hand, hits only increase counter of the entry. */
+  D4_CACHE_CLOCK
+} d4_cache_policy_t;
+
+/**
+ * Macro that should be used to generate bounded cache type.
+ * All entries are allocated together with the cache object, so lookup, insertion, update and eviction are O(1) and don't allocate, apart from copy blocks of key and value.
+ * Capacity is limited by number of entries and optionally by total weight of values.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the cache object.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the cache object.
+ */
+#define D4_CACHE_DECLARE(key_type_name, key_type, value_type_name, value_type) \
+  /** Object representation of the cache entry type. */ \
+  typedef struct d4_cache_##key_type_name##MS##value_type_name##ME_entry { \
+    /* Full hash of the key (used internally). */ \
+    size_t hash; \
+    \
+    /* Key of the cache entry. */ \
+    key_type key; \
+    \
+    /* Value of the cache entry. */ \
+    value_type value; \
+    \
+    /* Weight of the value (used internally). */ \
+    size_t weight; \
+    \
+    /* Number of recent hits saturated at D4_CACHE_MAX_FREQUENCY, used by CLOCK policy (used internally). */ \
+    unsigned char frequency; \
+    \
+    /* Pointer to the next entry of the bucket or free list (used internally). */ \
+    struct d4_cache_##key_type_name##MS##value_type_name##ME_entry *next; \
+    \
+    /* Pointer to the previous entry of the eviction order (used internally). */ \
+    struct d4_cache_##key_type_name##MS##value_type_name##ME_entry *order_prev; \
+    \
+    /* Pointer to the next entry of the eviction order (used internally). */ \
+    struct d4_cache_##key_type_name##MS##value_type_name##ME_entry *order_next; \
+  } d4_cache_##key_type_name##MS##value_type_name##ME_entry_t; \
+  \
+  /** Object representation of the cache type. */ \
+  typedef struct { \
+    /* Data container of the bucket pointers. */ \
+    d4_cache_##key_type_name##MS##value_type_name##ME_entry_t **buckets; \
+    \
+    /* Number of buckets. */ \
+    size_t buckets_len; \
+    \
+    /* Preallocated entries, so no allocation happens after cache is allocated (used internally). */ \
+    d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *entries; \
+    \
+    /* Pointer to the first unused entry (used internally). */ \
+    d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *free_entries; \
+    \
+    /* Most recently used entry for LRU policy or clock hand for CLOCK policy (used internally). */ \
+    d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *head; \
+    \
+    /* Eviction policy of the cache object. */ \
+    d4_cache_policy_t policy; \
+    \
+    /* Maximum number of entries. */ \
+    size_t cap; \
+    \
+    /* Maximum total weight of entries, zero if weight is not limited. */ \
+    size_t max_weight; \
+    \
+    /* Number of entries. */ \
+    size_t len; \
+    \
+    /* Total weight of entries. */ \
+    size_t weight; \
+    \
+    /* Number of lookups that found key. */ \
+    size_t hits; \
+    \
+    /* Number of lookups that didn't find key. */ \
+    size_t misses; \
+    \
+    /* Number of entries evicted to make room for new ones. */ \
+    size_t evictions; \
+  } d4_cache_##key_type_name##MS##value_type_name##ME_t; \
+  \
+  /**
+   * Allocates cache object with all of its entries, so that further operations don't allocate.
+   * @param policy Eviction policy.
+   * @param cap Maximum number of entries.
+   * @param max_weight Maximum total weight of entries, zero to limit only number of entries.
+   * @return Allocated cache object.
+   */ \
+  d4_cache_##key_type_name##MS##value_type_name##ME_t d4_cache_##key_type_name##MS##value_type_name##ME_alloc (d4_cache_policy_t policy, size_t cap, size_t max_weight); \
+  \
+  /**
+   * Removes all entries and resets counters without affecting capacity.
+   * @param self Cache object to clear.
+   * @return Reference to itself.
+   */ \
+  d4_cache_##key_type_name##MS##value_type_name##ME_t *d4_cache_##key_type_name##MS##value_type_name##ME_clear (d4_cache_##key_type_name##MS##value_type_name##ME_t *self); \
+  \
+  /**
+   * Evicts one entry according to eviction policy (used internally).
+   * @param self Cache object to evict entry from.
+   * @param keep Entry that should not be evicted, can be NULL.
+   */ \
+  void d4_cache_##key_type_name##MS##value_type_name##ME_evict (d4_cache_##key_type_name##MS##value_type_name##ME_t *self, const d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *keep); \
+  \
+  /**
+   * Finds entry of the key (used internally).
+   * @param self Cache object to search in.
+   * @param hash Full hash of the key.
+   * @param key Key to search for.
+   * @return Entry of the key if found, NULL otherwise.
+   */ \
+  d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *d4_cache_##key_type_name##MS##value_type_name##ME_find (const d4_cache_##key_type_name##MS##value_type_name##ME_t self, size_t hash, const key_type key); \
+  \
+  /**
+   * Deallocates cache object.
+   * @param self Cache object to deallocate.
+   */ \
+  void d4_cache_##key_type_name##MS##value_type_name##ME_free (d4_cache_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Retrieves copy of the value by key, marks entry as recently used and throws if key doesn’t exist.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Cache object to perform action on.
+   * @param key Key of the entry to retrieve.
+   * @return Copy of the found value.
+   */ \
+  value_type d4_cache_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, d4_cache_##key_type_name##MS##value_type_name##ME_t *self, const key_type key); \
+  \
+  /**
+   * Checks whether cache object contains provided key, doesn't affect eviction order and counters.
+   * @param self Cache object to check.
+   * @param key Key to check.
+   * @return Whether cache object contains provided key.
+   */ \
+  bool d4_cache_##key_type_name##MS##value_type_name##ME_has (const d4_cache_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Finds value by key and marks entry as recently used without copying value.
+   * @param self Cache object to perform action on.
+   * @param key Key of the entry to find.
+   * @return Pointer to the value owned by cache object that is valid until the next put, NULL if key doesn’t exist.
+   */ \
+  value_type *d4_cache_##key_type_name##MS##value_type_name##ME_lookup (d4_cache_##key_type_name##MS##value_type_name##ME_t *self, const key_type key); \
+  \
+  /**
+   * Sets a key inside cache object, if key exists - updates its value. Evicts entries until new entry fits into capacity and maximum weight.
+   * Values heavier than maximum weight are not cached and remove existing entry of the key.
+   * @param self Cache object to put entry into.
+   * @param key Key of the entry.
+   * @param value Value of the entry.
+   * @return Reference to itself.
+   */ \
+  d4_cache_##key_type_name##MS##value_type_name##ME_t *d4_cache_##key_type_name##MS##value_type_name##ME_put (d4_cache_##key_type_name##MS##value_type_name##ME_t *self, const key_type key, const value_type value); \
+  \
+  /**
+   * Removes key from the cache object if it exists.
+   * @param self Cache object to remove key from.
+   * @param key Key to remove.
+   * @return Whether key was removed.
+   */ \
+  bool d4_cache_##key_type_name##MS##value_type_name##ME_remove (d4_cache_##key_type_name##MS##value_type_name##ME_t *self, const key_type key); \
+  \
+  /**
+   * Marks entry as recently used according to eviction policy (used internally).
+   * @param self Cache object entry belongs to.
+   * @param entry Entry to mark.
+   */ \
+  void d4_cache_##key_type_name##MS##value_type_name##ME_touch (d4_cache_##key_type_name##MS##value_type_name##ME_t *self, d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *entry); \
+  \
+  /**
+   * Unlinks entry from bucket and eviction order and deallocates its key and value (used internally).
+   * @param self Cache object entry belongs to.
+   * @param entry Entry to unlink.
+   */ \
+  void d4_cache_##key_type_name##MS##value_type_name##ME_unlink (d4_cache_##key_type_name##MS##value_type_name##ME_t *self, d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *entry);
+
+#endif
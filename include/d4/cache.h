@@ -0,0 +1,219 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_CACHE_H
+#define D4_CACHE_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "cache-macro.h"
+#include "map.h"
+
+/**
+ * Macro that can be used to define a cache object, should be paired with D4_CACHE_DECLARE.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the cache object.
+ * @param key_copy_block Block that is used for copy method of key.
+ * @param key_eq_block Block that is used for equals method of key.
+ * @param key_free_block Block that is used for free method of key.
+ * @param key_hash_block Block that is used to hash key into size_t without allocating, e.g. d4_map_hash(key, SIZE_MAX) or d4_map_hash_int((uint64_t) key, SIZE_MAX).
+ * @param key_str_block Block that is used for str method of key.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the cache object.
+ * @param value_copy_block Block that is used for copy method of value.
+ * @param value_free_block Block that is used for free method of value.
+ * @param value_weight_block Block that is used to weigh value against maximum weight, e.g. 1 or val.len.
+ */
+#define D4_CACHE_DEFINE(key_type_name, key_type, key_copy_block, key_eq_block, key_free_block, key_hash_block, key_str_block, value_type_name, value_type, value_copy_block, value_free_block, value_weight_block) \
+  d4_cache_##key_type_name##MS##value_type_name##ME_t d4_cache_##key_type_name##MS##value_type_name##ME_alloc (d4_cache_policy_t policy, size_t cap, size_t max_weight) { \
+    size_t buckets_len = d4_map_calc_cap(0x0F, cap); \
+    d4_cache_##key_type_name##MS##value_type_name##ME_t self = {NULL, buckets_len, NULL, NULL, NULL, policy, cap, max_weight, 0, 0, 0, 0, 0}; \
+    self.buckets = d4_safe_alloc(buckets_len * sizeof(d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *)); \
+    memset(self.buckets, 0, buckets_len * sizeof(d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *)); \
+    if (cap == 0) return self; \
+    self.entries = d4_safe_alloc(cap * sizeof(d4_cache_##key_type_name##MS##value_type_name##ME_entry_t)); \
+    for (size_t i = 0; i < cap; i++) { \
+      self.entries[i].next = i + 1 == cap ? NULL : &self.entries[i + 1]; \
+    } \
+    self.free_entries = self.entries; \
+    return self; \
+  } \
+  \
+  d4_cache_##key_type_name##MS##value_type_name##ME_t *d4_cache_##key_type_name##MS##value_type_name##ME_clear (d4_cache_##key_type_name##MS##value_type_name##ME_t *self) { \
+    while (self->head != NULL) { \
+      d4_cache_##key_type_name##MS##value_type_name##ME_unlink(self, self->head); \
+    } \
+    self->hits = 0; \
+    self->misses = 0; \
+    self->evictions = 0; \
+    return self; \
+  } \
+  \
+  void d4_cache_##key_type_name##MS##value_type_name##ME_evict (d4_cache_##key_type_name##MS##value_type_name##ME_t *self, const d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *keep) { \
+    d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *victim; \
+    if (self->policy == D4_CACHE_LRU) { \
+      victim = self->head->order_prev; \
+      if (victim == keep) victim = victim->order_prev; \
+    } else { \
+      while (self->head == keep || self->head->frequency != 0) { \
+        if (self->head != keep) self->head->frequency--; \
+        self->head = self->head->order_next; \
+      } \
+      victim = self->head; \
+    } \
+    d4_cache_##key_type_name##MS##value_type_name##ME_unlink(self, victim); \
+    self->evictions++; \
+  } \
+  \
+  d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *d4_cache_##key_type_name##MS##value_type_name##ME_find (const d4_cache_##key_type_name##MS##value_type_name##ME_t self, size_t hash, const key_type key) { \
+    d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *it = self.buckets[hash % self.buckets_len]; \
+    while (it != NULL) { \
+      if (it->hash == hash) { \
+        const key_type lhs_key = it->key; \
+        const key_type rhs_key = key; \
+        if (key_eq_block) return it; \
+      } \
+      it = it->next; \
+    } \
+    return NULL; \
+  } \
+  \
+  void d4_cache_##key_type_name##MS##value_type_name##ME_free (d4_cache_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_cache_##key_type_name##MS##value_type_name##ME_clear(&self); \
+    d4_safe_free(self.entries); \
+    d4_safe_free(self.buckets); \
+  } \
+  \
+  value_type d4_cache_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, d4_cache_##key_type_name##MS##value_type_name##ME_t *self, const key_type key) { \
+    value_type *value = d4_cache_##key_type_name##MS##value_type_name##ME_lookup(self, key); \
+    value_type val; \
+    if (value == NULL) { \
+      d4_str_t key_str = key_str_block; \
+      d4_str_t message = d4_str_alloc(L"failed to find key '%ls'", key_str.data); \
+      d4_error_assign_generic(state, line, col, message); \
+      d4_str_free(message); \
+      d4_str_free(key_str); \
+      longjmp(state->buf_last->buf, state->id); \
+    } \
+    val = *value; \
+    return value_copy_block; \
+  } \
+  \
+  bool d4_cache_##key_type_name##MS##value_type_name##ME_has (const d4_cache_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    size_t hash = key_hash_block; \
+    return d4_cache_##key_type_name##MS##value_type_name##ME_find(self, hash, key) != NULL; \
+  } \
+  \
+  value_type *d4_cache_##key_type_name##MS##value_type_name##ME_lookup (d4_cache_##key_type_name##MS##value_type_name##ME_t *self, const key_type key) { \
+    size_t hash = key_hash_block; \
+    d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *entry = d4_cache_##key_type_name##MS##value_type_name##ME_find(*self, hash, key); \
+    if (entry == NULL) { \
+      self->misses++; \
+      return NULL; \
+    } \
+    self->hits++; \
+    d4_cache_##key_type_name##MS##value_type_name##ME_touch(self, entry); \
+    return &entry->value; \
+  } \
+  \
+  d4_cache_##key_type_name##MS##value_type_name##ME_t *d4_cache_##key_type_name##MS##value_type_name##ME_put (d4_cache_##key_type_name##MS##value_type_name##ME_t *self, const key_type key, const value_type value) { \
+    size_t hash = key_hash_block; \
+    d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *entry = d4_cache_##key_type_name##MS##value_type_name##ME_find(*self, hash, key); \
+    const value_type val = value; \
+    size_t weight = value_weight_block; \
+    size_t index = hash % self->buckets_len; \
+    if (self->cap == 0) return self; \
+    if (self->max_weight != 0 && weight > self->max_weight) { \
+      if (entry != NULL) d4_cache_##key_type_name##MS##value_type_name##ME_unlink(self, entry); \
+      return self; \
+    } \
+    if (entry != NULL) { \
+      d4_cache_##key_type_name##MS##value_type_name##ME_touch(self, entry); \
+      self->weight -= entry->weight; \
+      entry->weight = 0; \
+      while (self->max_weight != 0 && self->weight + weight > self->max_weight) { \
+        d4_cache_##key_type_name##MS##value_type_name##ME_evict(self, entry); \
+      } \
+      { \
+        value_type val = entry->value; \
+        value_free_block; \
+      } \
+      entry->value = value_copy_block; \
+      entry->weight = weight; \
+      self->weight += weight; \
+      return self; \
+    } \
+    while (self->len == self->cap || (self->max_weight != 0 && self->weight + weight > self->max_weight)) { \
+      d4_cache_##key_type_name##MS##value_type_name##ME_evict(self, NULL); \
+    } \
+    entry = self->free_entries; \
+    self->free_entries = entry->next; \
+    entry->hash = hash; \
+    entry->key = key_copy_block; \
+    entry->value = value_copy_block; \
+    entry->weight = weight; \
+    entry->frequency = 0; \
+    entry->next = self->buckets[index]; \
+    self->buckets[index] = entry; \
+    if (self->head == NULL) { \
+      entry->order_prev = entry; \
+      entry->order_next = entry; \
+      self->head = entry; \
+    } else { \
+      entry->order_prev = self->head->order_prev; \
+      entry->order_next = self->head; \
+      self->head->order_prev->order_next = entry; \
+      self->head->order_prev = entry; \
+      if (self->policy == D4_CACHE_LRU) self->head = entry; \
+    } \
+    self->len++; \
+    self->weight += weight; \
+    return self; \
+  } \
+  \
+  bool d4_cache_##key_type_name##MS##value_type_name##ME_remove (d4_cache_##key_type_name##MS##value_type_name##ME_t *self, const key_type key) { \
+    size_t hash = key_hash_block; \
+    d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *entry = d4_cache_##key_type_name##MS##value_type_name##ME_find(*self, hash, key); \
+    if (entry == NULL) return false; \
+    d4_cache_##key_type_name##MS##value_type_name##ME_unlink(self, entry); \
+    return true; \
+  } \
+  \
+  void d4_cache_##key_type_name##MS##value_type_name##ME_touch (d4_cache_##key_type_name##MS##value_type_name##ME_t *self, d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *entry) { \
+    if (self->policy == D4_CACHE_CLOCK) { \
+      if (entry->frequency < D4_CACHE_MAX_FREQUENCY) entry->frequency++; \
+    } else if (self->head != entry) { \
+      entry->order_prev->order_next = entry->order_next; \
+      entry->order_next->order_prev = entry->order_prev; \
+      entry->order_prev = self->head->order_prev; \
+      entry->order_next = self->head; \
+      self->head->order_prev->order_next = entry; \
+      self->head->order_prev = entry; \
+      self->head = entry; \
+    } \
+  } \
+  \
+  void d4_cache_##key_type_name##MS##value_type_name##ME_unlink (d4_cache_##key_type_name##MS##value_type_name##ME_t *self, d4_cache_##key_type_name##MS##value_type_name##ME_entry_t *entry) { \
+    d4_cache_##key_type_name##MS##value_type_name##ME_entry_t **link = &self->buckets[entry->hash % self->buckets_len]; \
+    key_type key = entry->key; \
+    value_type val = entry->value; \
+    while (*link != entry) link = &(*link)->next; \
+    *link = entry->next; \
+    if (entry->order_next == entry) { \
+      self->head = NULL; \
+    } else { \
+      if (self->head == entry) self->head = entry->order_next; \
+      entry->order_prev->order_next = entry->order_next; \
+      entry->order_next->order_prev = entry->order_prev; \
+    } \
+    key_free_block; \
+    value_free_block; \
+    entry->next = self->free_entries; \
+    self->free_entries = entry; \
+    self->len--; \
+    self->weight -= entry->weight; \
+  }
+
+#endif
@@ -0,0 +1,346 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_MAP_INT_MACRO_H
+#define D4_MAP_INT_MACRO_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "map-macro.h"
+
+/**
+ * Macro that should be used to generate map type specialized for integer keys, i.e. one of i8 through u64, usize and isize.
+ * Generates the same types and methods as D4_MAP_DECLARE, so it can be used instead of it for any integer key type.
+ * Keys are stored inline and hashed with an integer mixer, pairs don't carry string identifiers.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the map object.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the map object.
+ */
+#define D4_MAP_INT_DECLARE(key_type_name, key_type, value_type_name, value_type) \
+  D4_FUNCTION_DECLARE_WITH_PARAMS(es, bool, bool, FP3##key_type_name##FP3##value_type_name, { \
+    d4_err_state_t *state; \
+    int line; \
+    int col; \
+    key_type n0; \
+    value_type n1; \
+  }) \
+  \
+  D4_FUNCTION_DECLARE_WITH_PARAMS(es, void, void, FP3##key_type_name##FP3##value_type_name##FP3int, { \
+    d4_err_state_t *state; \
+    int line; \
+    int col; \
+    key_type n0; \
+    value_type n1; \
+    int32_t n2; \
+  }) \
+  \
+  /** Object representation of the map pair type. */ \
+  typedef struct d4_map_##key_type_name##MS##value_type_name##ME_pair { \
+    \
+    /* Key of the map pair. */ \
+    key_type key; \
+    \
+    /* Value of the map pair. */ \
+    value_type value; \
+    \
+    /* Pointer to the next pair of the linked list. */ \
+    struct d4_map_##key_type_name##MS##value_type_name##ME_pair *next; \
+  } d4_map_##key_type_name##MS##value_type_name##ME_pair_t; \
+  \
+  /** Object representation of the map entry type used for bulk construction. */ \
+  typedef struct { \
+    /* Key of the map entry. */ \
+    key_type key; \
+    \
+    /* Value of the map entry. */ \
+    value_type value; \
+  } d4_map_##key_type_name##MS##value_type_name##ME_entry_t; \
+  \
+  /** Object representation of the map type. */ \
+  typedef struct { \
+    /* Data container of the pair pointers. */ \
+    d4_map_##key_type_name##MS##value_type_name##ME_pair_t **data; \
+    \
+    /* Total allocated size of the map object. */ \
+    size_t cap; \
+    \
+    /* Length of the map object. */ \
+    size_t len; \
+  } d4_map_##key_type_name##MS##value_type_name##ME_t; \
+  \
+  /** Object representation of the map iterator type. */ \
+  typedef struct { \
+    /* Data container of the iterated map object (used internally). */ \
+    d4_map_##key_type_name##MS##value_type_name##ME_pair_t **data; \
+    \
+    /* Total allocated size of the iterated map object (used internally). */ \
+    size_t cap; \
+    \
+    /* Position of the next bucket (used internally). */ \
+    size_t index; \
+    \
+    /* Pointer to the next pair (used internally). */ \
+    d4_map_##key_type_name##MS##value_type_name##ME_pair_t *next; \
+    \
+    /* Pointer to the key of the current pair, owned by map object. */ \
+    const key_type *key; \
+    \
+    /* Pointer to the value of the current pair, owned by map object. */ \
+    value_type *value; \
+  } d4_map_##key_type_name##MS##value_type_name##ME_iter_t; \
+  \
+  /**
+   * Allocates map object.
+   * @param len Number of key pairs that are passed as arguments.
+   * @param ... Arguments list that consists of pairs with key followed by value.
+   * @return Allocated map object.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_alloc (size_t len, ...); \
+  \
+  /**
+   * Removes all elements and changes length to zero without affecting capacity.
+   * @return Reference to itself.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_clear (d4_map_##key_type_name##MS##value_type_name##ME_t *self); \
+  \
+  /**
+   * Creates a copy of provided map object.
+   * @param self Map object to create copy of.
+   * @return Copy of provided map object
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_copy (const d4_map_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Checks whether map has any elements.
+   * @param self Map object to check.
+   * @return Whether map has any elements.
+   */ \
+  bool d4_map_##key_type_name##MS##value_type_name##ME_empty (const d4_map_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Compares whether map object is equal to right-hand map object.
+   * @param self Map object to check.
+   * @param rhs Right-hand map object to check.
+   * @return Whether two map objects are equal.
+   */ \
+  bool d4_map_##key_type_name##MS##value_type_name##ME_eq (const d4_map_##key_type_name##MS##value_type_name##ME_t self, const d4_map_##key_type_name##MS##value_type_name##ME_t rhs); \
+  \
+  /**
+   * Calls `iterator` on every pair, passing key and value without copying them.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Map object to perform action on.
+   * @param iterator Function to execute on each pair of the map, receives key, value and position of the pair.
+   */ \
+  void d4_map_##key_type_name##MS##value_type_name##ME_forEach (d4_err_state_t *state, int line, int col, const d4_map_##key_type_name##MS##value_type_name##ME_t self, const d4_fn_esFP3##key_type_name##FP3##value_type_name##FP3intFRvoidFE_t iterator); \
+  \
+  /**
+   * Deallocates map object.
+   * @param self Map object to deallocate.
+   */ \
+  void d4_map_##key_type_name##MS##value_type_name##ME_free (d4_map_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Allocates map object from arrays of keys and values, pairing elements by index. Extra elements of the longer array are ignored, repeated keys keep the last value.
+   * The map is sized once for all pairs, so no reallocation happens while building.
+   * @param keys Array of keys to copy.
+   * @param values Array of values to copy.
+   * @return Allocated map object.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_fromArrays (const d4_arr_##key_type_name##_t keys, const d4_arr_##value_type_name##_t values); \
+  \
+  /**
+   * Allocates map object from arrays of keys and values same as fromArrays, but moves elements into map object instead of copying them.
+   * Both arrays are consumed and must not be used or deallocated afterwards.
+   * @param keys Array of keys to consume.
+   * @param values Array of values to consume.
+   * @return Allocated map object.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_fromArraysMove (d4_arr_##key_type_name##_t keys, d4_arr_##value_type_name##_t values); \
+  \
+  /**
+   * Allocates map object from list of entries. Repeated keys keep the last value.
+   * The map is sized once for all entries, so no reallocation happens while building.
+   * @param entries Entries to copy keys and values from.
+   * @param len Number of entries.
+   * @return Allocated map object.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_fromPairs (const d4_map_##key_type_name##MS##value_type_name##ME_entry_t *entries, size_t len); \
+  \
+  /**
+   * Retrieves value by key and throws if key doesn’t exist.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Map object to perform action on.
+   * @param key Key of map object pair to retrieve.
+   * @return Value of found map object pair.
+   */ \
+  value_type d4_map_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, const d4_map_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Checks whether map object contains a pair with provided key.
+   * @param self Map object to check.
+   * @param key Key of map object pair to check.
+   * @return Whether map object contains a pair with provided key.
+   */ \
+  bool d4_map_##key_type_name##MS##value_type_name##ME_has (const d4_map_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Creates iterator positioned before the first pair of the map object.
+   * Removing the current pair with remove is allowed, any other modification invalidates the iterator.
+   * @param self Map object to iterate.
+   * @return Iterator over all pairs in bucket order.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_iter_t d4_map_##key_type_name##MS##value_type_name##ME_iterBegin (const d4_map_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Advances iterator to the next pair, current pair is available through key and value fields of the iterator.
+   * @param self Iterator to advance.
+   * @return Whether iterator was advanced, false when there are no more pairs.
+   */ \
+  bool d4_map_##key_type_name##MS##value_type_name##ME_iterNext (d4_map_##key_type_name##MS##value_type_name##ME_iter_t *self); \
+  \
+  /**
+   * Returns array of map keys.
+   * @param self Map object to use.
+   * @return Array of map keys.
+   */ \
+  d4_arr_##key_type_name##_t d4_map_##key_type_name##MS##value_type_name##ME_keys (const d4_map_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Merges other map’s data into self map. When iterating, if key exists it will update pair with a new value. Reallocates map object if load factor more than 75%.
+   * @param self Map object to merge into.
+   * @param other Map object to merge from.
+   * @return Reference to itself.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_merge (d4_map_##key_type_name##MS##value_type_name##ME_t *self, const d4_map_##key_type_name##MS##value_type_name##ME_t other); \
+  \
+  /**
+   * Moves other map’s pairs into self map without copying them, leaving other map empty, does nothing if both are the same map. If key exists it will update pair with a new value. Reallocates map object if load factor more than 75%.
+   * @param self Map object to merge into.
+   * @param other Map object to move pairs from, its capacity is kept.
+   * @return Reference to itself.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_mergeMove (d4_map_##key_type_name##MS##value_type_name##ME_t *self, d4_map_##key_type_name##MS##value_type_name##ME_t *other); \
+  \
+  /**
+   * Creates and places a pair inside map object.
+   * @param self Map object to place pair into.
+   * @param key Key of the new pair.
+   * @param value Value of the new pair.
+   */ \
+  void d4_map_##key_type_name##MS##value_type_name##ME_place (d4_map_##key_type_name##MS##value_type_name##ME_t self, const key_type key, const value_type value); \
+  \
+  /**
+   * Places a pair inside map object taking ownership of value, if key exists - replaces its value.
+   * Increases length when pair is created, but doesn't reallocate map object.
+   * @param self Map object to place pair into.
+   * @param key Key of the new pair.
+   * @param value Value of the new pair.
+   */ \
+  void d4_map_##key_type_name##MS##value_type_name##ME_placeMove (d4_map_##key_type_name##MS##value_type_name##ME_t *self, key_type key, value_type value); \
+  \
+  /**
+   * Deallocates current map object and returns a copy of another map object.
+   * @param self Map object to deallocate.
+   * @param rhs Map object to return a copy of.
+   * @return Copy of another map object.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_realloc (d4_map_##key_type_name##MS##value_type_name##ME_t self, const d4_map_##key_type_name##MS##value_type_name##ME_t rhs); \
+  \
+  /**
+   * Removes provided key from the map object and if key doesn’t exist throws error.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @return Reference to itself.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_remove (d4_err_state_t *state, int line, int col, d4_map_##key_type_name##MS##value_type_name##ME_t *self, const key_type search_key); \
+  \
+  /**
+   * Removes pairs for which predicate returns true, walking buckets once and deallocating pairs in place.
+   * Reallocates map object if load factor drops below low-water mark, see d4_map_low_water_set.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Map object to remove pairs from.
+   * @param predicate Function that is called with key and value of every pair.
+   * @return Reference to itself.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_removeIf (d4_err_state_t *state, int line, int col, d4_map_##key_type_name##MS##value_type_name##ME_t *self, const d4_fn_esFP3##key_type_name##FP3##value_type_name##FRboolFE_t predicate); \
+  \
+  /**
+   * Reserves a room for a specified number of pairs. Does nothing if the size provided is lower than the current capacity.
+   * @param self Map object to increase capacity of.
+   * @param size New map object capacity.
+   * @return Reference to itself.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_reserve (d4_map_##key_type_name##MS##value_type_name##ME_t *self, int32_t size); \
+  \
+  /**
+   * Keeps only pairs for which predicate returns true, walking buckets once and deallocating pairs in place.
+   * Reallocates map object if load factor drops below low-water mark, see d4_map_low_water_set.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Map object to remove pairs from.
+   * @param predicate Function that is called with key and value of every pair.
+   * @return Reference to itself.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_retain (d4_err_state_t *state, int line, int col, d4_map_##key_type_name##MS##value_type_name##ME_t *self, const d4_fn_esFP3##key_type_name##FP3##value_type_name##FRboolFE_t predicate); \
+  \
+  /**
+   * Sets a key inside map object, if key exists - updates its value. Reallocates map object if load factor more than 75%.
+   * @param self Map object to set a pair for.
+   * @param key Key of the pair.
+   * @param value Value of the pair.
+   * @return Reference to itself.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_set (d4_map_##key_type_name##MS##value_type_name##ME_t *self, const key_type key, const value_type value); \
+  \
+  /**
+   * Reduces capacity to a current map object length multiplied by 2.
+   * @param self Map object to reduce capacity of.
+   * @return Reference to itself.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_shrink (d4_map_##key_type_name##MS##value_type_name##ME_t *self); \
+  \
+  /**
+   * Collects statistics of the map object, can be used to detect pathological hashing.
+   * @param self Map object to collect statistics of.
+   * @return Statistics of the map object.
+   */ \
+  d4_map_stats_t d4_map_##key_type_name##MS##value_type_name##ME_stats (const d4_map_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Generates string representation of the map object.
+   * @param self Map object to generate string representation for.
+   * @return String representation of the map object.
+   */ \
+  d4_str_t d4_map_##key_type_name##MS##value_type_name##ME_str (const d4_map_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Removes pairs depending on predicate result (used internally by retain and removeIf).
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Map object to remove pairs from.
+   * @param predicate Function that is called with key and value of every pair.
+   * @param keep Predicate result of pairs that are kept.
+   * @return Reference to itself.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_sweep (d4_err_state_t *state, int line, int col, d4_map_##key_type_name##MS##value_type_name##ME_t *self, const d4_fn_esFP3##key_type_name##FP3##value_type_name##FRboolFE_t predicate, bool keep); \
+  \
+  /**
+   * Returns array of map values.
+   * @param self Map object to use.
+   * @return Array of map values.
+   */ \
+  d4_arr_##value_type_name##_t d4_map_##key_type_name##MS##value_type_name##ME_values (const d4_map_##key_type_name##MS##value_type_name##ME_t self);
+
+#endif
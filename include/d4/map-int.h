@@ -0,0 +1,507 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_MAP_INT_H
+#define D4_MAP_INT_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "map-int-macro.h"
+#include "map.h"
+
+/**
+ * Macro that can be used to define a map object specialized for integer keys, should be paired with D4_MAP_INT_DECLARE.
+ * Keys are compared with == and hashed with d4_map_hash_int, so no key blocks other than str are needed.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the map object, one of integer types.
+ * @param key_alloc_type Key type of the key to be used inside variadic argument (should be cast to int in some cases).
+ * @param key_str_block Block that is used for str method of key.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the map object.
+ * @param value_alloc_type Value type of the value to be used inside variadic argument (should be cast to int in some cases).
+ * @param value_copy_block Block that is used for copy method of value.
+ * @param value_eq_block Block that is used for equals method of value.
+ * @param value_free_block Block that is used for free method of value.
+ * @param value_str_block Block that is used for str method of value.
+ */
+#define D4_MAP_INT_DEFINE(key_type_name, key_type, key_alloc_type, key_str_block, value_type_name, value_type, value_alloc_type, value_copy_block, value_eq_block, value_free_block, value_str_block) \
+  D4_FUNCTION_DEFINE_WITH_PARAMS(es, bool, bool, FP3##key_type_name##FP3##value_type_name) \
+  D4_FUNCTION_DEFINE_WITH_PARAMS(es, void, void, FP3##key_type_name##FP3##value_type_name##FP3int) \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_alloc (size_t len, ...) { \
+    size_t cap = d4_map_calc_cap(0x0F, len); \
+    d4_map_##key_type_name##MS##value_type_name##ME_t self = {d4_safe_alloc(cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)), cap, 0}; \
+    va_list args; \
+    memset(self.data, 0, cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)); \
+    if (len == 0) return self; \
+    va_start(args, len); \
+    for (size_t i = 0; i < len; i++) { \
+      const key_type key = va_arg(args, key_alloc_type); \
+      const value_type val = va_arg(args, value_alloc_type); \
+      d4_map_##key_type_name##MS##value_type_name##ME_placeMove(&self, key, value_copy_block); \
+    } \
+    va_end(args); \
+    return self; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_clear (d4_map_##key_type_name##MS##value_type_name##ME_t *self) { \
+    for (size_t i = 0; i < self->cap; i++) { \
+      while (self->data[i] != NULL) { \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self->data[i]; \
+        value_type val = it->value; \
+        value_free_block; \
+        self->data[i] = it->next; \
+        d4_safe_free(it); \
+      } \
+    } \
+    memset(self->data, 0, self->cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)); \
+    self->len = 0; \
+    return self; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_copy (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_map_##key_type_name##MS##value_type_name##ME_t new_self = { \
+      d4_safe_alloc(self.cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)), \
+      self.cap, \
+      self.len \
+    }; \
+    memset(new_self.data, 0, new_self.cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)); \
+    for (size_t i = 0; i < self.cap; i++) { \
+      d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[i]; \
+      while (it != NULL) { \
+        d4_map_##key_type_name##MS##value_type_name##ME_place(new_self, it->key, it->value); \
+        it = it->next; \
+      } \
+    } \
+    return new_self; \
+  } \
+  \
+  bool d4_map_##key_type_name##MS##value_type_name##ME_empty (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
+    return self.len == 0; \
+  } \
+  \
+  bool d4_map_##key_type_name##MS##value_type_name##ME_eq (const d4_map_##key_type_name##MS##value_type_name##ME_t self, const d4_map_##key_type_name##MS##value_type_name##ME_t rhs) { \
+    if (self.len != rhs.len) return false; \
+    for (size_t i = 0; i < self.cap; i++) { \
+      d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it1 = self.data[i]; \
+      while (it1 != NULL) { \
+        size_t rhs_index = d4_map_hash_int((uint64_t) it1->key, rhs.cap); \
+        value_type lhs_val = it1->value; \
+        value_type rhs_val; \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it2 = rhs.data[rhs_index]; \
+        while (it2 != NULL) { \
+          if (it2->key == it1->key) break; \
+          it2 = it2->next; \
+        } \
+        if (it2 == NULL) return false; \
+        rhs_val = it2->value; \
+        if (!(value_eq_block)) return false; \
+        it1 = it1->next; \
+      } \
+    } \
+    return true; \
+  } \
+  \
+  void d4_map_##key_type_name##MS##value_type_name##ME_forEach (d4_err_state_t *state, int line, int col, const d4_map_##key_type_name##MS##value_type_name##ME_t self, const d4_fn_esFP3##key_type_name##FP3##value_type_name##FP3intFRvoidFE_t iterator) { \
+    int32_t j = 0; \
+    for (size_t i = 0; i < self.cap; i++) { \
+      for (d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[i]; it != NULL; it = it->next) { \
+        d4_fn_esFP3##key_type_name##FP3##value_type_name##FP3intFRvoidFE_params_t params = {state, line, col, it->key, it->value, j++}; \
+        iterator.func(iterator.ctx, &params); \
+      } \
+    } \
+  } \
+  \
+  void d4_map_##key_type_name##MS##value_type_name##ME_free (d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
+    for (size_t i = 0; i < self.cap; i++) { \
+      while (self.data[i] != NULL) { \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[i]; \
+        value_type val = it->value; \
+        value_free_block; \
+        self.data[i] = it->next; \
+        d4_safe_free(it); \
+      } \
+    } \
+    d4_safe_free(self.data); \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_fromArrays (const d4_arr_##key_type_name##_t keys, const d4_arr_##value_type_name##_t values) { \
+    size_t len = keys.len < values.len ? keys.len : values.len; \
+    size_t cap = d4_map_calc_cap(0x0F, len); \
+    d4_map_##key_type_name##MS##value_type_name##ME_t self = {d4_safe_alloc(cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)), cap, 0}; \
+    memset(self.data, 0, cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)); \
+    for (size_t i = 0; i < len; i++) { \
+      const value_type val = values.data[i]; \
+      d4_map_##key_type_name##MS##value_type_name##ME_placeMove(&self, keys.data[i], value_copy_block); \
+    } \
+    return self; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_fromArraysMove (d4_arr_##key_type_name##_t keys, d4_arr_##value_type_name##_t values) { \
+    size_t len = keys.len < values.len ? keys.len : values.len; \
+    size_t cap = d4_map_calc_cap(0x0F, len); \
+    d4_map_##key_type_name##MS##value_type_name##ME_t self = {d4_safe_alloc(cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)), cap, 0}; \
+    memset(self.data, 0, cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)); \
+    for (size_t i = 0; i < len; i++) { \
+      d4_map_##key_type_name##MS##value_type_name##ME_placeMove(&self, keys.data[i], values.data[i]); \
+    } \
+    for (size_t i = len; i < values.len; i++) { \
+      value_type val = values.data[i]; \
+      value_free_block; \
+    } \
+    d4_safe_free(keys.data); \
+    d4_safe_free(values.data); \
+    return self; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_fromPairs (const d4_map_##key_type_name##MS##value_type_name##ME_entry_t *entries, size_t len) { \
+    size_t cap = d4_map_calc_cap(0x0F, len); \
+    d4_map_##key_type_name##MS##value_type_name##ME_t self = {d4_safe_alloc(cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)), cap, 0}; \
+    memset(self.data, 0, cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)); \
+    for (size_t i = 0; i < len; i++) { \
+      const value_type val = entries[i].value; \
+      d4_map_##key_type_name##MS##value_type_name##ME_placeMove(&self, entries[i].key, value_copy_block); \
+    } \
+    return self; \
+  } \
+  \
+  value_type d4_map_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, const d4_map_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    size_t index = d4_map_hash_int((uint64_t) key, self.cap); \
+    value_type val; \
+    d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[index]; \
+    while (it != NULL) { \
+      if (it->key == key) break; \
+      it = it->next; \
+    } \
+    if (it == NULL) { \
+      d4_str_t key_str = key_str_block; \
+      d4_str_t message = d4_str_alloc(L"failed to find key '%ls'", key_str.data); \
+      d4_error_assign_generic(state, line, col, message); \
+      d4_str_free(message); \
+      d4_str_free(key_str); \
+      longjmp(state->buf_last->buf, state->id); \
+    } \
+    val = it->value; \
+    return value_copy_block; \
+  } \
+  \
+  bool d4_map_##key_type_name##MS##value_type_name##ME_has (const d4_map_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    size_t index = d4_map_hash_int((uint64_t) key, self.cap); \
+    d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[index]; \
+    while (it != NULL) { \
+      if (it->key == key) break; \
+      it = it->next; \
+    } \
+    return it != NULL; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_iter_t d4_map_##key_type_name##MS##value_type_name##ME_iterBegin (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
+    return (d4_map_##key_type_name##MS##value_type_name##ME_iter_t) {self.data, self.cap, 0, NULL, NULL, NULL}; \
+  } \
+  \
+  bool d4_map_##key_type_name##MS##value_type_name##ME_iterNext (d4_map_##key_type_name##MS##value_type_name##ME_iter_t *self) { \
+    while (self->next == NULL && self->index < self->cap) { \
+      self->next = self->data[self->index++]; \
+    } \
+    if (self->next == NULL) { \
+      self->key = NULL; \
+      self->value = NULL; \
+      return false; \
+    } \
+    self->key = &self->next->key; \
+    self->value = &self->next->value; \
+    self->next = self->next->next; \
+    return true; \
+  } \
+  \
+  d4_arr_##key_type_name##_t d4_map_##key_type_name##MS##value_type_name##ME_keys (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
+    key_type *data = d4_safe_alloc(self.len * sizeof(key_type)); \
+    size_t j = 0; \
+    for (size_t i = 0; i < self.cap; i++) { \
+      d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[i]; \
+      while (it != NULL) { \
+        data[j++] = it->key; \
+        it = it->next; \
+      } \
+    } \
+    return (d4_arr_##key_type_name##_t) {data, self.len}; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_merge (d4_map_##key_type_name##MS##value_type_name##ME_t *self, const d4_map_##key_type_name##MS##value_type_name##ME_t other) { \
+    size_t len = self->len > other.len ? self->len : other.len; \
+    if (d4_map_should_reserve(self->cap, len)) { \
+      size_t new_cap = d4_map_calc_cap(self->cap, len); \
+      d4_map_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) new_cap); \
+    } \
+    for (size_t i = 0; i < other.cap; i++) { \
+      d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = other.data[i]; \
+      while (it != NULL) { \
+        size_t index = d4_map_hash_int((uint64_t) it->key, self->cap); \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *existing = self->data[index]; \
+        while (existing != NULL && existing->key != it->key) existing = existing->next; \
+        if (existing == NULL) { \
+          d4_map_##key_type_name##MS##value_type_name##ME_place(*self, it->key, it->value); \
+          self->len += 1; \
+          if (d4_map_should_reserve(self->cap, self->len)) { \
+            size_t new_cap = d4_map_calc_cap(self->cap, self->len); \
+            d4_map_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) new_cap); \
+          } \
+        } else { \
+          value_type val = existing->value; \
+          value_free_block; \
+          val = it->value; \
+          existing->value = value_copy_block; \
+        } \
+        it = it->next; \
+      } \
+    } \
+    return self; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_mergeMove (d4_map_##key_type_name##MS##value_type_name##ME_t *self, d4_map_##key_type_name##MS##value_type_name##ME_t *other) { \
+    size_t len = self->len > other->len ? self->len : other->len; \
+    if (self == other) return self; \
+    if (d4_map_should_reserve(self->cap, len)) { \
+      size_t new_cap = d4_map_calc_cap(self->cap, len); \
+      d4_map_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) new_cap); \
+    } \
+    for (size_t i = 0; i < other->cap; i++) { \
+      while (other->data[i] != NULL) { \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = other->data[i]; \
+        size_t index = d4_map_hash_int((uint64_t) it->key, self->cap); \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *existing = self->data[index]; \
+        other->data[i] = it->next; \
+        while (existing != NULL && existing->key != it->key) existing = existing->next; \
+        if (existing == NULL) { \
+          it->next = self->data[index]; \
+          self->data[index] = it; \
+          self->len += 1; \
+          if (d4_map_should_reserve(self->cap, self->len)) { \
+            size_t new_cap = d4_map_calc_cap(self->cap, self->len); \
+            d4_map_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) new_cap); \
+          } \
+        } else { \
+          value_type val = existing->value; \
+          value_free_block; \
+          existing->value = it->value; \
+          d4_safe_free(it); \
+        } \
+      } \
+    } \
+    other->len = 0; \
+    return self; \
+  } \
+  \
+  void d4_map_##key_type_name##MS##value_type_name##ME_place (d4_map_##key_type_name##MS##value_type_name##ME_t self, const key_type key, const value_type value) { \
+    size_t index = d4_map_hash_int((uint64_t) key, self.cap); \
+    d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[index]; \
+    while (it != NULL) { \
+      if (it->key == key) break; \
+      it = it->next; \
+    } \
+    if (it == NULL) { \
+      d4_map_##key_type_name##MS##value_type_name##ME_pair_t *new_item = d4_safe_alloc(sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t)); \
+      value_type val = value; \
+      new_item->key = key; \
+      new_item->value = value_copy_block; \
+      new_item->next = self.data[index]; \
+      self.data[index] = new_item; \
+    } else { \
+      value_type val = it->value; \
+      value_free_block; \
+      val = value; \
+      it->value = value_copy_block; \
+    } \
+  } \
+  \
+  void d4_map_##key_type_name##MS##value_type_name##ME_placeMove (d4_map_##key_type_name##MS##value_type_name##ME_t *self, key_type key, value_type value) { \
+    size_t index = d4_map_hash_int((uint64_t) key, self->cap); \
+    d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self->data[index]; \
+    value_type val; \
+    while (it != NULL) { \
+      if (it->key == key) break; \
+      it = it->next; \
+    } \
+    if (it == NULL) { \
+      it = d4_safe_alloc(sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t)); \
+      it->key = key; \
+      it->value = value; \
+      it->next = self->data[index]; \
+      self->data[index] = it; \
+      self->len += 1; \
+      return; \
+    } \
+    val = it->value; \
+    value_free_block; \
+    it->value = value; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_realloc (d4_map_##key_type_name##MS##value_type_name##ME_t self, const d4_map_##key_type_name##MS##value_type_name##ME_t rhs) { \
+    d4_map_##key_type_name##MS##value_type_name##ME_free(self); \
+    return d4_map_##key_type_name##MS##value_type_name##ME_copy(rhs); \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_remove (d4_err_state_t *state, int line, int col, d4_map_##key_type_name##MS##value_type_name##ME_t *self, const key_type search_key) { \
+    key_type key = search_key; \
+    value_type val; \
+    size_t index = d4_map_hash_int((uint64_t) key, self->cap); \
+    d4_map_##key_type_name##MS##value_type_name##ME_pair_t *prev = NULL; \
+    d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self->data[index]; \
+    while (it != NULL) { \
+      if (it->key == key) break; \
+      prev = it; \
+      it = it->next; \
+    } \
+    if (it == NULL) { \
+      d4_str_t key_str = key_str_block; \
+      d4_str_t message = d4_str_alloc(L"failed to remove key '%ls'", key_str.data); \
+      d4_error_assign_generic(state, line, col, message); \
+      d4_str_free(message); \
+      d4_str_free(key_str); \
+      longjmp(state->buf_last->buf, state->id); \
+    } \
+    if (prev == NULL) { \
+      self->data[index] = it->next; \
+    } else { \
+      prev->next = it->next; \
+    } \
+    val = it->value; \
+    value_free_block; \
+    d4_safe_free(it); \
+    self->len -= 1; \
+    return self; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_removeIf (d4_err_state_t *state, int line, int col, d4_map_##key_type_name##MS##value_type_name##ME_t *self, const d4_fn_esFP3##key_type_name##FP3##value_type_name##FRboolFE_t predicate) { \
+    return d4_map_##key_type_name##MS##value_type_name##ME_sweep(state, line, col, self, predicate, false); \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_reserve (d4_map_##key_type_name##MS##value_type_name##ME_t *self, int32_t size) { \
+    d4_map_##key_type_name##MS##value_type_name##ME_t new_self; \
+    double resize_start = d4_map_counters_resize_start(); \
+    if (size < 0x0F) size = 0x0F; \
+    new_self.data = d4_safe_alloc(size * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)); \
+    new_self.cap = size; \
+    new_self.len = 0; \
+    memset(new_self.data, 0, new_self.cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)); \
+    for (size_t i = 0; i < self->cap; i++) { \
+      while (self->data[i] != NULL) { \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self->data[i]; \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *next = it->next; \
+        size_t index = d4_map_hash_int((uint64_t) it->key, new_self.cap); \
+        it->next = new_self.data[index]; \
+        new_self.data[index] = it; \
+        self->data[i] = next; \
+      } \
+    } \
+    d4_safe_free(self->data); \
+    self->cap = new_self.cap; \
+    self->data = new_self.data; \
+    d4_map_counters_resize_end(resize_start, self->len); \
+    return self; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_retain (d4_err_state_t *state, int line, int col, d4_map_##key_type_name##MS##value_type_name##ME_t *self, const d4_fn_esFP3##key_type_name##FP3##value_type_name##FRboolFE_t predicate) { \
+    return d4_map_##key_type_name##MS##value_type_name##ME_sweep(state, line, col, self, predicate, true); \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_set (d4_map_##key_type_name##MS##value_type_name##ME_t *self, const key_type key, const value_type value) { \
+    const value_type val = value; \
+    d4_map_##key_type_name##MS##value_type_name##ME_placeMove(self, key, value_copy_block); \
+    if (d4_map_should_reserve(self->cap, self->len)) { \
+      size_t new_cap = d4_map_calc_cap(self->cap, self->len); \
+      d4_map_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) new_cap); \
+    } \
+    return self; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_shrink (d4_map_##key_type_name##MS##value_type_name##ME_t *self) { \
+    d4_map_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) (self->len * 2)); \
+    return self; \
+  } \
+  \
+  d4_map_stats_t d4_map_##key_type_name##MS##value_type_name##ME_stats (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_map_stats_t stats; \
+    memset(&stats, 0, sizeof(stats)); \
+    stats.len = self.len; \
+    stats.cap = self.cap; \
+    stats.load_factor = self.cap == 0 ? 0 : (double) self.len / (double) self.cap; \
+    stats.buckets_bytes = self.cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *); \
+    for (size_t i = 0; i < self.cap; i++) { \
+      size_t chain = 0; \
+      for (d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[i]; it != NULL; it = it->next) { \
+        stats.pairs_bytes += sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t); \
+        chain++; \
+      } \
+      if (chain == 0) stats.empty_buckets++; \
+      if (chain > stats.longest_chain) stats.longest_chain = chain; \
+      stats.chain_histogram[chain < D4_MAP_STATS_HISTOGRAM_LEN ? chain : D4_MAP_STATS_HISTOGRAM_LEN - 1]++; \
+    } \
+    return stats; \
+  } \
+  \
+  d4_str_t d4_map_##key_type_name##MS##value_type_name##ME_str (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_strbuf_t r = d4_strbuf_alloc(0); \
+    d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it; \
+    size_t j = 0; \
+    d4_strbuf_appendChar(&r, L'{'); \
+    for (size_t i = 0; i < self.cap; i++) { \
+      it = self.data[i]; \
+      while (it != NULL) { \
+        key_type key = it->key; \
+        value_type val = it->value; \
+        d4_str_t key_str = key_str_block; \
+        if (j++ != 0) d4_strbuf_append(&r, (d4_str_t) {L", ", 2, true}); \
+        d4_strbuf_appendMove(&r, d4_str_quoted_escape(key_str)); \
+        d4_strbuf_append(&r, (d4_str_t) {L": ", 2, true}); \
+        d4_strbuf_appendMove(&r, value_str_block); \
+        d4_str_free(key_str); \
+        it = it->next; \
+      } \
+    } \
+    d4_strbuf_appendChar(&r, L'}'); \
+    return d4_strbuf_finish(&r); \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_sweep (d4_err_state_t *state, int line, int col, d4_map_##key_type_name##MS##value_type_name##ME_t *self, const d4_fn_esFP3##key_type_name##FP3##value_type_name##FRboolFE_t predicate, bool keep) { \
+    for (size_t i = 0; i < self->cap; i++) { \
+      d4_map_##key_type_name##MS##value_type_name##ME_pair_t **link = &self->data[i]; \
+      while (*link != NULL) { \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = *link; \
+        key_type key = it->key; \
+        value_type val = it->value; \
+        d4_fn_esFP3##key_type_name##FP3##value_type_name##FRboolFE_params_t params = {state, line, col, key, val}; \
+        if (predicate.func(predicate.ctx, &params) == keep) { \
+          link = &it->next; \
+          continue; \
+        } \
+        *link = it->next; \
+        value_free_block; \
+        d4_safe_free(it); \
+        self->len -= 1; \
+      } \
+    } \
+    if (d4_map_should_shrink(self->cap, self->len)) { \
+      size_t new_cap = d4_map_calc_cap(0x0F, self->len); \
+      d4_map_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) new_cap); \
+    } \
+    return self; \
+  } \
+  \
+  d4_arr_##value_type_name##_t d4_map_##key_type_name##MS##value_type_name##ME_values (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
+    value_type *data = d4_safe_alloc(self.len * sizeof(value_type)); \
+    size_t j = 0; \
+    for (size_t i = 0; i < self.cap; i++) { \
+      d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[i]; \
+      while (it != NULL) { \
+        value_type val = it->value; \
+        data[j++] = value_copy_block; \
+        it = it->next; \
+      } \
+    } \
+    return (d4_arr_##value_type_name##_t) {data, self.len}; \
+  }
+
+#endif
@@ -30,6 +30,31 @@
  * @param value_str_block Block that is used for str method of value.
  */
 #define D4_MAP_DEFINE(key_type_name, key_type, key_alloc_type, key_copy_block, key_eq_block, key_free_block, key_hash_block, key_str_block, value_type_name, value_type, value_alloc_type, value_copy_block, value_eq_block, value_free_block, value_str_block) \
+  D4_MAP_DEFINE_WITH_HASH(key_type_name, key_type, key_alloc_type, key_copy_block, key_eq_block, key_free_block, key_hash_block, key_str_block, value_type_name, value_type, value_alloc_type, value_copy_block, value_eq_block, value_free_block, value_str_block, d4_map_hash)
+
+/**
+ * Macro that can be used to define a map object with custom hash function.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the array object.
+ * @param key_alloc_type Key type of the key to be used inside variadic argument (should be cast to int in some cases).
+ * @param key_copy_block Block that is used for copy method of key.
+ * @param key_eq_block Block that is used for equals method of key.
+ * @param key_free_block Block that is used for free method of key.
+ * @param key_hash_block Block that is used to hash key.
+ * @param key_str_block Block that is used for str method of key.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the array object.
+ * @param value_alloc_type Value type of the value to be used inside variadic argument (should be cast to int in some cases).
+ * @param value_copy_block Block that is used for copy method of value.
+ * @param value_eq_block Block that is used for equals method of value.
+ * @param value_free_block Block that is used for free method of value.
+ * @param value_str_block Block that is used for str method of value.
+ * @param hash_func Function that maps identifier to index inside of the map, e.g. d4_map_hash or d4_map_hash_seeded.
+ */
+#define D4_MAP_DEFINE_WITH_HASH(key_type_name, key_type, key_alloc_type, key_copy_block, key_eq_block, key_free_block, key_hash_block, key_str_block, value_type_name, value_type, value_alloc_type, value_copy_block, value_eq_block, value_free_block, value_str_block, hash_func) \
+  D4_FUNCTION_DEFINE_WITH_PARAMS(es, bool, bool, FP3##key_type_name##FP3##value_type_name) \
+  D4_FUNCTION_DEFINE_WITH_PARAMS(es, void, void, FP3##key_type_name##FP3##value_type_name##FP3int) \
+  \
   d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_alloc (size_t len, ...) { \
     size_t cap = d4_map_calc_cap(0x0F, len); \
     d4_map_##key_type_name##MS##value_type_name##ME_t self = {d4_safe_alloc(cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)), cap, len}; \
@@ -92,7 +117,7 @@
     for (size_t i = 0; i < self.cap; i++) { \
       d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it1 = self.data[i]; \
       while (it1 != NULL) { \
-        size_t rhs_index = d4_map_hash(it1->id, rhs.cap); \
+        size_t rhs_index = hash_func(it1->id, rhs.cap); \
         value_type lhs_val = it1->value; \
         value_type rhs_val; \
         d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it2 = rhs.data[rhs_index]; \
@@ -109,6 +134,16 @@
     return true; \
   } \
   \
+  void d4_map_##key_type_name##MS##value_type_name##ME_forEach (d4_err_state_t *state, int line, int col, const d4_map_##key_type_name##MS##value_type_name##ME_t self, const d4_fn_esFP3##key_type_name##FP3##value_type_name##FP3intFRvoidFE_t iterator) { \
+    int32_t j = 0; \
+    for (size_t i = 0; i < self.cap; i++) { \
+      for (d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[i]; it != NULL; it = it->next) { \
+        d4_fn_esFP3##key_type_name##FP3##value_type_name##FP3intFRvoidFE_params_t params = {state, line, col, it->key, it->value, j++}; \
+        iterator.func(iterator.ctx, &params); \
+      } \
+    } \
+  } \
+  \
   void d4_map_##key_type_name##MS##value_type_name##ME_free (d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
     for (size_t i = 0; i < self.cap; i++) { \
       while (self.data[i] != NULL) { \
@@ -125,9 +160,59 @@
     d4_safe_free(self.data); \
   } \
   \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_fromArrays (const d4_arr_##key_type_name##_t keys, const d4_arr_##value_type_name##_t values) { \
+    size_t len = keys.len < values.len ? keys.len : values.len; \
+    size_t cap = d4_map_calc_cap(0x0F, len); \
+    d4_map_##key_type_name##MS##value_type_name##ME_t self = {d4_safe_alloc(cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)), cap, 0}; \
+    memset(self.data, 0, cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)); \
+    for (size_t i = 0; i < len; i++) { \
+      const key_type key = keys.data[i]; \
+      const value_type val = values.data[i]; \
+      d4_str_t id = key_hash_block; \
+      d4_map_##key_type_name##MS##value_type_name##ME_placeMove(&self, id, key_copy_block, value_copy_block); \
+    } \
+    return self; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_fromArraysMove (d4_arr_##key_type_name##_t keys, d4_arr_##value_type_name##_t values) { \
+    size_t len = keys.len < values.len ? keys.len : values.len; \
+    size_t cap = d4_map_calc_cap(0x0F, len); \
+    d4_map_##key_type_name##MS##value_type_name##ME_t self = {d4_safe_alloc(cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)), cap, 0}; \
+    memset(self.data, 0, cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)); \
+    for (size_t i = 0; i < len; i++) { \
+      key_type key = keys.data[i]; \
+      d4_str_t id = key_hash_block; \
+      d4_map_##key_type_name##MS##value_type_name##ME_placeMove(&self, id, key, values.data[i]); \
+    } \
+    for (size_t i = len; i < keys.len; i++) { \
+      key_type key = keys.data[i]; \
+      key_free_block; \
+    } \
+    for (size_t i = len; i < values.len; i++) { \
+      value_type val = values.data[i]; \
+      value_free_block; \
+    } \
+    d4_safe_free(keys.data); \
+    d4_safe_free(values.data); \
+    return self; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_fromPairs (const d4_map_##key_type_name##MS##value_type_name##ME_entry_t *entries, size_t len) { \
+    size_t cap = d4_map_calc_cap(0x0F, len); \
+    d4_map_##key_type_name##MS##value_type_name##ME_t self = {d4_safe_alloc(cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)), cap, 0}; \
+    memset(self.data, 0, cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)); \
+    for (size_t i = 0; i < len; i++) { \
+      const key_type key = entries[i].key; \
+      const value_type val = entries[i].value; \
+      d4_str_t id = key_hash_block; \
+      d4_map_##key_type_name##MS##value_type_name##ME_placeMove(&self, id, key_copy_block, value_copy_block); \
+    } \
+    return self; \
+  } \
+  \
   value_type d4_map_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, const d4_map_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
     d4_str_t id = key_hash_block; \
-    size_t index = d4_map_hash(id, self.cap); \
+    size_t index = hash_func(id, self.cap); \
     value_type val; \
     d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[index]; \
     while (it != NULL) { \
@@ -147,7 +232,7 @@
   \
   bool d4_map_##key_type_name##MS##value_type_name##ME_has (const d4_map_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
     d4_str_t id = key_hash_block; \
-    size_t index = d4_map_hash(id, self.cap); \
+    size_t index = hash_func(id, self.cap); \
     d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[index]; \
     bool r = false; \
     while (it != NULL) { \
@@ -159,6 +244,25 @@
     return r; \
   } \
   \
+  d4_map_##key_type_name##MS##value_type_name##ME_iter_t d4_map_##key_type_name##MS##value_type_name##ME_iterBegin (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
+    return (d4_map_##key_type_name##MS##value_type_name##ME_iter_t) {self.data, self.cap, 0, NULL, NULL, NULL}; \
+  } \
+  \
+  bool d4_map_##key_type_name##MS##value_type_name##ME_iterNext (d4_map_##key_type_name##MS##value_type_name##ME_iter_t *self) { \
+    while (self->next == NULL && self->index < self->cap) { \
+      self->next = self->data[self->index++]; \
+    } \
+    if (self->next == NULL) { \
+      self->key = NULL; \
+      self->value = NULL; \
+      return false; \
+    } \
+    self->key = &self->next->key; \
+    self->value = &self->next->value; \
+    self->next = self->next->next; \
+    return true; \
+  } \
+  \
   d4_arr_##key_type_name##_t d4_map_##key_type_name##MS##value_type_name##ME_keys (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
     key_type *data = d4_safe_alloc(self.len * sizeof(key_type)); \
     size_t j = 0; \
@@ -174,23 +278,75 @@
   } \
   \
   d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_merge (d4_map_##key_type_name##MS##value_type_name##ME_t *self, const d4_map_##key_type_name##MS##value_type_name##ME_t other) { \
-    self->len += other.len; \
-    if (d4_map_should_reserve(self->cap, self->len)) { \
-      size_t new_cap = d4_map_calc_cap(self->cap, self->len); \
+    size_t len = self->len > other.len ? self->len : other.len; \
+    if (d4_map_should_reserve(self->cap, len)) { \
+      size_t new_cap = d4_map_calc_cap(self->cap, len); \
       d4_map_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) new_cap); \
     } \
     for (size_t i = 0; i < other.cap; i++) { \
       d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = other.data[i]; \
       while (it != NULL) { \
-        d4_map_##key_type_name##MS##value_type_name##ME_place(*self, it->id, it->key, it->value); \
+        size_t index = hash_func(it->id, self->cap); \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *existing = self->data[index]; \
+        while (existing != NULL && !d4_str_eq(existing->id, it->id)) existing = existing->next; \
+        if (existing == NULL) { \
+          d4_map_##key_type_name##MS##value_type_name##ME_place(*self, it->id, it->key, it->value); \
+          self->len += 1; \
+          if (d4_map_should_reserve(self->cap, self->len)) { \
+            size_t new_cap = d4_map_calc_cap(self->cap, self->len); \
+            d4_map_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) new_cap); \
+          } \
+        } else { \
+          value_type val = existing->value; \
+          value_free_block; \
+          val = it->value; \
+          existing->value = value_copy_block; \
+        } \
         it = it->next; \
       } \
     } \
     return self; \
   } \
   \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_mergeMove (d4_map_##key_type_name##MS##value_type_name##ME_t *self, d4_map_##key_type_name##MS##value_type_name##ME_t *other) { \
+    size_t len = self->len > other->len ? self->len : other->len; \
+    if (self == other) return self; \
+    if (d4_map_should_reserve(self->cap, len)) { \
+      size_t new_cap = d4_map_calc_cap(self->cap, len); \
+      d4_map_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) new_cap); \
+    } \
+    for (size_t i = 0; i < other->cap; i++) { \
+      while (other->data[i] != NULL) { \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = other->data[i]; \
+        size_t index = hash_func(it->id, self->cap); \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *existing = self->data[index]; \
+        other->data[i] = it->next; \
+        while (existing != NULL && !d4_str_eq(existing->id, it->id)) existing = existing->next; \
+        if (existing == NULL) { \
+          it->next = self->data[index]; \
+          self->data[index] = it; \
+          self->len += 1; \
+          if (d4_map_should_reserve(self->cap, self->len)) { \
+            size_t new_cap = d4_map_calc_cap(self->cap, self->len); \
+            d4_map_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) new_cap); \
+          } \
+        } else { \
+          key_type key = it->key; \
+          value_type val = existing->value; \
+          value_free_block; \
+          existing->value = it->value; \
+          key_free_block; \
+          d4_str_free(it->id); \
+          d4_safe_free(it); \
+        } \
+      } \
+    } \
+    other->len = 0; \
+    return self; \
+  } \
+  \
   void d4_map_##key_type_name##MS##value_type_name##ME_place (d4_map_##key_type_name##MS##value_type_name##ME_t self, const d4_str_t id, const key_type key, const value_type value) { \
-    size_t index = d4_map_hash(id, self.cap); \
+    size_t index = hash_func(id, self.cap); \
     d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[index]; \
     while (it != NULL) { \
       if (d4_str_eq(it->id, id)) break; \
@@ -212,6 +368,31 @@
     } \
   } \
   \
+  void d4_map_##key_type_name##MS##value_type_name##ME_placeMove (d4_map_##key_type_name##MS##value_type_name##ME_t *self, d4_str_t id, key_type key, value_type value) { \
+    size_t index = hash_func(id, self->cap); \
+    d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self->data[index]; \
+    value_type val; \
+    while (it != NULL) { \
+      if (d4_str_eq(it->id, id)) break; \
+      it = it->next; \
+    } \
+    if (it == NULL) { \
+      it = d4_safe_alloc(sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t)); \
+      it->id = id; \
+      it->key = key; \
+      it->value = value; \
+      it->next = self->data[index]; \
+      self->data[index] = it; \
+      self->len += 1; \
+      return; \
+    } \
+    d4_str_free(id); \
+    key_free_block; \
+    val = it->value; \
+    value_free_block; \
+    it->value = value; \
+  } \
+  \
   d4_map_##key_type_name##MS##value_type_name##ME_t d4_map_##key_type_name##MS##value_type_name##ME_realloc (d4_map_##key_type_name##MS##value_type_name##ME_t self, const d4_map_##key_type_name##MS##value_type_name##ME_t rhs) { \
     d4_map_##key_type_name##MS##value_type_name##ME_free(self); \
     return d4_map_##key_type_name##MS##value_type_name##ME_copy(rhs); \
@@ -221,7 +402,7 @@
     key_type key = search_key; \
     value_type val; \
     d4_str_t id = key_hash_block; \
-    size_t index = d4_map_hash(id, self->cap); \
+    size_t index = hash_func(id, self->cap); \
     d4_map_##key_type_name##MS##value_type_name##ME_pair_t *prev = NULL; \
     d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self->data[index]; \
     while (it != NULL) { \
@@ -251,8 +432,13 @@
     return self; \
   } \
   \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_removeIf (d4_err_state_t *state, int line, int col, d4_map_##key_type_name##MS##value_type_name##ME_t *self, const d4_fn_esFP3##key_type_name##FP3##value_type_name##FRboolFE_t predicate) { \
+    return d4_map_##key_type_name##MS##value_type_name##ME_sweep(state, line, col, self, predicate, false); \
+  } \
+  \
   d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_reserve (d4_map_##key_type_name##MS##value_type_name##ME_t *self, int32_t size) { \
     d4_map_##key_type_name##MS##value_type_name##ME_t new_self; \
+    double resize_start = d4_map_counters_resize_start(); \
     if (size < 0x0F) size = 0x0F; \
     new_self.data = d4_safe_alloc(size * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *)); \
     new_self.cap = size; \
@@ -262,7 +448,7 @@
       while (self->data[i] != NULL) { \
         d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self->data[i]; \
         d4_map_##key_type_name##MS##value_type_name##ME_pair_t *next = it->next; \
-        size_t index = d4_map_hash(it->id, new_self.cap); \
+        size_t index = hash_func(it->id, new_self.cap); \
         it->next = new_self.data[index]; \
         new_self.data[index] = it; \
         self->data[i] = next; \
@@ -271,9 +457,14 @@
     d4_safe_free(self->data); \
     self->cap = new_self.cap; \
     self->data = new_self.data; \
+    d4_map_counters_resize_end(resize_start, self->len); \
     return self; \
   } \
   \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_retain (d4_err_state_t *state, int line, int col, d4_map_##key_type_name##MS##value_type_name##ME_t *self, const d4_fn_esFP3##key_type_name##FP3##value_type_name##FRboolFE_t predicate) { \
+    return d4_map_##key_type_name##MS##value_type_name##ME_sweep(state, line, col, self, predicate, true); \
+  } \
+  \
   d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_set (d4_map_##key_type_name##MS##value_type_name##ME_t *self, const key_type key, const value_type value) { \
     bool existed = d4_map_##key_type_name##MS##value_type_name##ME_has(*self, key); \
     d4_str_t id = key_hash_block; \
@@ -292,49 +483,75 @@
     return self; \
   } \
   \
+  d4_map_stats_t d4_map_##key_type_name##MS##value_type_name##ME_stats (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_map_stats_t stats; \
+    memset(&stats, 0, sizeof(stats)); \
+    stats.len = self.len; \
+    stats.cap = self.cap; \
+    stats.load_factor = self.cap == 0 ? 0 : (double) self.len / (double) self.cap; \
+    stats.buckets_bytes = self.cap * sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t *); \
+    for (size_t i = 0; i < self.cap; i++) { \
+      size_t chain = 0; \
+      for (d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = self.data[i]; it != NULL; it = it->next) { \
+        stats.pairs_bytes += sizeof(d4_map_##key_type_name##MS##value_type_name##ME_pair_t); \
+        if (!it->id.is_static || it->id.is_static == D4_STR_SHARED) stats.ids_bytes += (it->id.len + 1) * sizeof(wchar_t); \
+        chain++; \
+      } \
+      if (chain == 0) stats.empty_buckets++; \
+      if (chain > stats.longest_chain) stats.longest_chain = chain; \
+      stats.chain_histogram[chain < D4_MAP_STATS_HISTOGRAM_LEN ? chain : D4_MAP_STATS_HISTOGRAM_LEN - 1]++; \
+    } \
+    return stats; \
+  } \
+  \
   d4_str_t d4_map_##key_type_name##MS##value_type_name##ME_str (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
-    d4_str_t s = d4_str_alloc(L": "); \
-    d4_str_t c = d4_str_alloc(L", "); \
-    d4_str_t b = d4_str_alloc(L"}"); \
-    d4_str_t r = d4_str_alloc(L"{"); \
-    d4_str_t result; \
+    d4_strbuf_t r = d4_strbuf_alloc(0); \
     d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it; \
     size_t j = 0; \
+    d4_strbuf_appendChar(&r, L'{'); \
     for (size_t i = 0; i < self.cap; i++) { \
       it = self.data[i]; \
       while (it != NULL) { \
         key_type key = it->key; \
         value_type val = it->value; \
         d4_str_t key_str = key_str_block; \
-        d4_str_t value_str = value_str_block; \
-        d4_str_t key_quoted = d4_str_quoted_escape(key_str); \
-        d4_str_t r_with_key; \
-        d4_str_t r_with_colon; \
-        d4_str_t r_with_val; \
-        if (j++ != 0) { \
-          d4_str_t r_with_comma = d4_str_concat(r, c); \
-          r = d4_str_realloc(r, r_with_comma); \
-          d4_str_free(r_with_comma); \
-        } \
-        r_with_key = d4_str_concat(r, key_quoted); \
-        r_with_colon = d4_str_concat(r_with_key, s); \
-        r_with_val = d4_str_concat(r_with_colon, value_str); \
-        r = d4_str_realloc(r, r_with_val); \
+        if (j++ != 0) d4_strbuf_append(&r, (d4_str_t) {L", ", 2, true}); \
+        d4_strbuf_appendMove(&r, d4_str_quoted_escape(key_str)); \
+        d4_strbuf_append(&r, (d4_str_t) {L": ", 2, true}); \
+        d4_strbuf_appendMove(&r, value_str_block); \
         d4_str_free(key_str); \
-        d4_str_free(value_str); \
-        d4_str_free(key_quoted); \
-        d4_str_free(r_with_key); \
-        d4_str_free(r_with_colon); \
-        d4_str_free(r_with_val); \
         it = it->next; \
       } \
     } \
-    result = d4_str_concat(r, b); \
-    d4_str_free(s); \
-    d4_str_free(c); \
-    d4_str_free(b); \
-    d4_str_free(r); \
-    return result; \
+    d4_strbuf_appendChar(&r, L'}'); \
+    return d4_strbuf_finish(&r); \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t *d4_map_##key_type_name##MS##value_type_name##ME_sweep (d4_err_state_t *state, int line, int col, d4_map_##key_type_name##MS##value_type_name##ME_t *self, const d4_fn_esFP3##key_type_name##FP3##value_type_name##FRboolFE_t predicate, bool keep) { \
+    for (size_t i = 0; i < self->cap; i++) { \
+      d4_map_##key_type_name##MS##value_type_name##ME_pair_t **link = &self->data[i]; \
+      while (*link != NULL) { \
+        d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it = *link; \
+        key_type key = it->key; \
+        value_type val = it->value; \
+        d4_fn_esFP3##key_type_name##FP3##value_type_name##FRboolFE_params_t params = {state, line, col, key, val}; \
+        if (predicate.func(predicate.ctx, &params) == keep) { \
+          link = &it->next; \
+          continue; \
+        } \
+        *link = it->next; \
+        d4_str_free(it->id); \
+        key_free_block; \
+        value_free_block; \
+        d4_safe_free(it); \
+        self->len -= 1; \
+      } \
+    } \
+    if (d4_map_should_shrink(self->cap, self->len)) { \
+      size_t new_cap = d4_map_calc_cap(0x0F, self->len); \
+      d4_map_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) new_cap); \
+    } \
+    return self; \
   } \
   \
   d4_arr_##value_type_name##_t d4_map_##key_type_name##MS##value_type_name##ME_values (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
@@ -359,6 +576,34 @@
  */
 size_t d4_map_calc_cap (size_t cap, size_t len);
 
+/**
+ * Enables or disables collection of global map counters, collection is disabled by default.
+ * @param enable Whether to collect counters.
+ */
+void d4_map_counters_enable (bool enable);
+
+/**
+ * Retrieves snapshot of global map counters.
+ * @return Global map counters collected since the last reset.
+ */
+d4_map_counters_t d4_map_counters_get (void);
+
+/** Resets global map counters to zero. */
+void d4_map_counters_reset (void);
+
+/**
+ * Marks start of the map reallocation (used internally).
+ * @return Start time of the reallocation, negative number if collection of counters is disabled.
+ */
+double d4_map_counters_resize_start (void);
+
+/**
+ * Marks end of the map reallocation and updates global map counters (used internally).
+ * @param start Start time returned by d4_map_counters_resize_start.
+ * @param pairs Number of pairs that were rehashed.
+ */
+void d4_map_counters_resize_end (double start, size_t pairs);
+
 /**
  * Hashes and maps identifier to correct index inside of the map.
  * @param id Identifier to find index for.
@@ -367,6 +612,37 @@ size_t d4_map_calc_cap (size_t cap, size_t len);
  */
 size_t d4_map_hash (d4_str_t id, size_t cap);
 
+/**
+ * Mixes integer key with MurmurHash3 finalizer and maps it to correct index inside of the map, used by maps declared with D4_MAP_INT_DECLARE.
+ * Every bit of the key affects the index, so sequential and strided keys are spread evenly.
+ * @param key Integer key converted to 64-bit unsigned integer.
+ * @param cap Current map capacity.
+ * @return Index of the key inside of the map.
+ */
+size_t d4_map_hash_int (uint64_t key, size_t cap);
+
+/**
+ * Sets key of the seeded hash. Must be called before any map using d4_map_hash_seeded is populated, since existing pairs are not rehashed.
+ * @param key Key of 16 bytes to use instead of the random per-process key.
+ */
+void d4_map_hash_seed (const unsigned char *key);
+
+/**
+ * Hashes identifier with SipHash-1-3 keyed by random per-process key and maps it to correct index inside of the map.
+ * Slower than d4_map_hash, but resistant to collision attacks, use it for maps exposed to untrusted keys.
+ * @param id Identifier to find index for.
+ * @param cap Current map capacity.
+ * @return Index of the identifier inside of the map.
+ */
+size_t d4_map_hash_seeded (d4_str_t id, size_t cap);
+
+/**
+ * Sets low-water mark of the load factor, maps that drop below it after bulk removal are reallocated to a smaller capacity.
+ * Should be less than half of the load factor so that reallocated map doesn't cross the mark again, defaults to 0.125.
+ * @param ratio New low-water mark, zero disables automatic shrinking.
+ */
+void d4_map_low_water_set (double ratio);
+
 /**
  * Determines whether map needs to reallocate.
  * @param cap Current map capacity.
@@ -375,4 +651,12 @@ size_t d4_map_hash (d4_str_t id, size_t cap);
  */
 bool d4_map_should_reserve (size_t cap, size_t len);
 
+/**
+ * Determines whether map should reallocate to a smaller capacity after bulk removal.
+ * @param cap Current map capacity.
+ * @param len Current map length.
+ * @return Whether map should reallocate to a smaller capacity.
+ */
+bool d4_map_should_shrink (size_t cap, size_t len);
+
 #endif
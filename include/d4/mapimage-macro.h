@@ -0,0 +1,132 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_MAPIMAGE_MACRO_H
+#define D4_MAPIMAGE_MACRO_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "map-macro.h"
+
+/** Version of the map image format, images of other versions are rejected on open. */
+#define D4_MAPIMAGE_VERSION 1
+
+/** Object representation of the memory-mapped image file (used internally). */
+typedef struct d4_mapimage d4_mapimage_t;
+
+/** Object representation of the map image writer (used internally). */
+typedef struct d4_mapimage_writer d4_mapimage_writer_t;
+
+/** Object representation of the map image record, data pointers refer to the mapped file. */
+typedef struct {
+  /* Full hash of the key. */
+  size_t hash;
+
+  /* Offset of the next record of the bucket, zero for the last one. */
+  uint64_t next;
+
+  /* Pointer to the key bytes, followed by at least one zero wchar_t. */
+  void *key_data;
+
+  /* Number of the key bytes. */
+  size_t key_size;
+
+  /* Pointer to the value bytes, followed by at least one zero wchar_t. */
+  void *value_data;
+
+  /* Number of the value bytes. */
+  size_t value_size;
+} d4_mapimage_record_t;
+
+/**
+ * Macro that should be used to generate map image type, a read-only binary image of the map object that is opened with mmap.
+ * Image is written once from a map object of strings and scalars, opening it doesn't read pairs and lookup returns values pointing into mapped file.
+ * Map type of the same key and value types should be declared beforehand.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the map image object.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the map image object.
+ */
+#define D4_MAPIMAGE_DECLARE(key_type_name, key_type, value_type_name, value_type) \
+  /** Object representation of the map image type. */ \
+  typedef struct { \
+    /* Mapped file of the image (used internally). */ \
+    d4_mapimage_t *core; \
+    \
+    /* Number of pairs in the image. */ \
+    size_t len; \
+  } d4_mapimage_##key_type_name##MS##value_type_name##ME_t; \
+  \
+  /**
+   * Finds record of the key (used internally). Follows at most as many records as there are pairs, so that a chain that loops in corrupted image ends as a missing key.
+   * @param self Map image object to search in.
+   * @param key Key to search for.
+   * @param record Pointer to store found record into.
+   * @return Whether key was found.
+   */ \
+  bool d4_mapimage_##key_type_name##MS##value_type_name##ME_find (const d4_mapimage_##key_type_name##MS##value_type_name##ME_t self, const key_type key, d4_mapimage_record_t *record); \
+  \
+  /**
+   * Unmaps file of the map image object, values returned by lookup are invalid afterwards.
+   * @param self Map image object to deallocate.
+   */ \
+  void d4_mapimage_##key_type_name##MS##value_type_name##ME_free (d4_mapimage_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Retrieves copy of the value by key and throws if key doesn’t exist.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Map image object to perform action on.
+   * @param key Key of the pair to retrieve.
+   * @return Copy of the found value.
+   */ \
+  value_type d4_mapimage_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, const d4_mapimage_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Checks whether map image object contains a pair with provided key.
+   * @param self Map image object to check.
+   * @param key Key of the pair to check.
+   * @return Whether map image object contains a pair with provided key.
+   */ \
+  bool d4_mapimage_##key_type_name##MS##value_type_name##ME_has (const d4_mapimage_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Finds value by key without copying it, value points into mapped file and must not be modified or deallocated.
+   * @param self Map image object to perform action on.
+   * @param key Key of the pair to find.
+   * @param value Pointer to store found value into.
+   * @return Whether key was found.
+   */ \
+  bool d4_mapimage_##key_type_name##MS##value_type_name##ME_lookup (const d4_mapimage_##key_type_name##MS##value_type_name##ME_t self, const key_type key, value_type *value); \
+  \
+  /**
+   * Maps image file into memory for read-only lookup. Takes constant time regardless of image size, only header is validated.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param path Path of the image file.
+   * @return Opened map image object.
+   */ \
+  d4_mapimage_##key_type_name##MS##value_type_name##ME_t d4_mapimage_##key_type_name##MS##value_type_name##ME_open (d4_err_state_t *state, int line, int col, const d4_str_t path); \
+  \
+  /**
+   * Checks checksum and structure of the whole image, takes time proportional to image size.
+   * @param self Map image object to verify.
+   * @return Whether image is intact.
+   */ \
+  bool d4_mapimage_##key_type_name##MS##value_type_name##ME_verify (const d4_mapimage_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Writes map object into image file, replacing existing file.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param map Map object to write.
+   * @param path Path of the image file.
+   */ \
+  void d4_mapimage_##key_type_name##MS##value_type_name##ME_write (d4_err_state_t *state, int line, int col, const d4_map_##key_type_name##MS##value_type_name##ME_t map, const d4_str_t path);
+
+#endif
@@ -0,0 +1,186 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_MAPIMAGE_H
+#define D4_MAPIMAGE_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "mapimage-macro.h"
+#include "map.h"
+
+/**
+ * Macro that can be used to define a map image object, map object of the same key and value types should be defined beforehand.
+ * Data and size blocks serialize key or value into bytes, view blocks turn bytes back into key or value without copying.
+ * For strings use key.data, key.len * sizeof(wchar_t) and (d4_str_t) {data, size / sizeof(wchar_t), true}.
+ * For scalars use &key, sizeof(key) and *(int32_t *) data.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the map image object.
+ * @param key_data_block Block that returns pointer to bytes of key.
+ * @param key_size_block Block that returns number of bytes of key.
+ * @param key_view_block Block that creates key from data and size, should not allocate.
+ * @param key_eq_block Block that is used for equals method of key.
+ * @param key_hash_block Block that is used to hash key into size_t, should be the same in every process, e.g. d4_map_hash(key, SIZE_MAX).
+ * @param key_str_block Block that is used for str method of key.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the map image object.
+ * @param value_data_block Block that returns pointer to bytes of value.
+ * @param value_size_block Block that returns number of bytes of value.
+ * @param value_view_block Block that creates value from data and size, should not allocate.
+ * @param value_copy_block Block that is used for copy method of value.
+ */
+#define D4_MAPIMAGE_DEFINE(key_type_name, key_type, key_data_block, key_size_block, key_view_block, key_eq_block, key_hash_block, key_str_block, value_type_name, value_type, value_data_block, value_size_block, value_view_block, value_copy_block) \
+  bool d4_mapimage_##key_type_name##MS##value_type_name##ME_find (const d4_mapimage_##key_type_name##MS##value_type_name##ME_t self, const key_type key, d4_mapimage_record_t *record) { \
+    size_t hash = key_hash_block; \
+    uint64_t offset = d4_mapimage_bucket(self.core, hash); \
+    size_t hops = 0; \
+    while (hops++ < self.len && d4_mapimage_record(self.core, offset, record)) { \
+      if (record->hash == hash) { \
+        void *data = record->key_data; \
+        size_t size = record->key_size; \
+        const key_type lhs_key = key_view_block; \
+        const key_type rhs_key = key; \
+        (void) size; \
+        if (key_eq_block) return true; \
+      } \
+      offset = record->next; \
+    } \
+    return false; \
+  } \
+  \
+  void d4_mapimage_##key_type_name##MS##value_type_name##ME_free (d4_mapimage_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_mapimage_free(self.core); \
+  } \
+  \
+  value_type d4_mapimage_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, const d4_mapimage_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    value_type val; \
+    if (!d4_mapimage_##key_type_name##MS##value_type_name##ME_lookup(self, key, &val)) { \
+      d4_str_t key_str = key_str_block; \
+      d4_str_t message = d4_str_alloc(L"failed to find key '%ls'", key_str.data); \
+      d4_error_assign_generic(state, line, col, message); \
+      d4_str_free(message); \
+      d4_str_free(key_str); \
+      longjmp(state->buf_last->buf, state->id); \
+    } \
+    return value_copy_block; \
+  } \
+  \
+  bool d4_mapimage_##key_type_name##MS##value_type_name##ME_has (const d4_mapimage_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    d4_mapimage_record_t record; \
+    return d4_mapimage_##key_type_name##MS##value_type_name##ME_find(self, key, &record); \
+  } \
+  \
+  bool d4_mapimage_##key_type_name##MS##value_type_name##ME_lookup (const d4_mapimage_##key_type_name##MS##value_type_name##ME_t self, const key_type key, value_type *value) { \
+    d4_mapimage_record_t record; \
+    if (!d4_mapimage_##key_type_name##MS##value_type_name##ME_find(self, key, &record)) return false; \
+    { \
+      void *data = record.value_data; \
+      size_t size = record.value_size; \
+      (void) size; \
+      *value = value_view_block; \
+    } \
+    return true; \
+  } \
+  \
+  d4_mapimage_##key_type_name##MS##value_type_name##ME_t d4_mapimage_##key_type_name##MS##value_type_name##ME_open (d4_err_state_t *state, int line, int col, const d4_str_t path) { \
+    d4_mapimage_t *core = d4_mapimage_open(state, line, col, path); \
+    return (d4_mapimage_##key_type_name##MS##value_type_name##ME_t) {core, d4_mapimage_len(core)}; \
+  } \
+  \
+  bool d4_mapimage_##key_type_name##MS##value_type_name##ME_verify (const d4_mapimage_##key_type_name##MS##value_type_name##ME_t self) { \
+    return d4_mapimage_verify(self.core); \
+  } \
+  \
+  void d4_mapimage_##key_type_name##MS##value_type_name##ME_write (d4_err_state_t *state, int line, int col, const d4_map_##key_type_name##MS##value_type_name##ME_t map, const d4_str_t path) { \
+    d4_mapimage_writer_t *writer = d4_mapimage_write_begin(state, line, col, path, d4_map_calc_cap(0x0F, map.len)); \
+    d4_map_##key_type_name##MS##value_type_name##ME_iter_t it = d4_map_##key_type_name##MS##value_type_name##ME_iterBegin(map); \
+    while (d4_map_##key_type_name##MS##value_type_name##ME_iterNext(&it)) { \
+      const key_type key = *it.key; \
+      const value_type val = *it.value; \
+      size_t hash = key_hash_block; \
+      d4_mapimage_write_entry(writer, hash, key_data_block, key_size_block, value_data_block, value_size_block); \
+    } \
+    d4_mapimage_write_end(state, line, col, writer); \
+  }
+
+/**
+ * Finds offset of the first record of the bucket that hash belongs to (used internally).
+ * @param self Map image to search in.
+ * @param hash Full hash of the key.
+ * @return Offset of the first record, zero if bucket is empty.
+ */
+uint64_t d4_mapimage_bucket (const d4_mapimage_t *self, size_t hash);
+
+/**
+ * Unmaps image file (used internally).
+ * @param self Map image to unmap.
+ */
+void d4_mapimage_free (d4_mapimage_t *self);
+
+/**
+ * Returns number of pairs in the image (used internally).
+ * @param self Map image to get length of.
+ * @return Number of pairs.
+ */
+size_t d4_mapimage_len (const d4_mapimage_t *self);
+
+/**
+ * Maps image file into memory and validates its header, throws if file can't be opened, isn't a map image or has another version (used internally).
+ * @param state Error state to perform action on.
+ * @param line Line where error appeared.
+ * @param col Line column where error appeared.
+ * @param path Path of the image file.
+ * @return Opened map image.
+ */
+d4_mapimage_t *d4_mapimage_open (d4_err_state_t *state, int line, int col, const d4_str_t path);
+
+/**
+ * Reads record at offset, checking that it lies within the image (used internally).
+ * @param self Map image to read record of.
+ * @param offset Offset of the record.
+ * @param record Pointer to store record into.
+ * @return Whether offset points to a valid record, false for zero offset.
+ */
+bool d4_mapimage_record (const d4_mapimage_t *self, uint64_t offset, d4_mapimage_record_t *record);
+
+/**
+ * Checks checksum of the image and that every bucket chain is well-formed (used internally).
+ * @param self Map image to verify.
+ * @return Whether image is intact.
+ */
+bool d4_mapimage_verify (const d4_mapimage_t *self);
+
+/**
+ * Creates image file and starts writing it, throws if file can't be created (used internally).
+ * @param state Error state to perform action on.
+ * @param line Line where error appeared.
+ * @param col Line column where error appeared.
+ * @param path Path of the image file.
+ * @param buckets_len Number of buckets of the image.
+ * @return Writer of the image.
+ */
+d4_mapimage_writer_t *d4_mapimage_write_begin (d4_err_state_t *state, int line, int col, const d4_str_t path, size_t buckets_len);
+
+/**
+ * Writes header and buckets of the image, closes file and deallocates writer, throws if any write failed (used internally).
+ * @param state Error state to perform action on.
+ * @param line Line where error appeared.
+ * @param col Line column where error appeared.
+ * @param self Writer of the image.
+ */
+void d4_mapimage_write_end (d4_err_state_t *state, int line, int col, d4_mapimage_writer_t *self);
+
+/**
+ * Appends record to the image (used internally).
+ * @param self Writer of the image.
+ * @param hash Full hash of the key.
+ * @param key_data Pointer to bytes of the key.
+ * @param key_size Number of bytes of the key.
+ * @param value_data Pointer to bytes of the value.
+ * @param value_size Number of bytes of the value.
+ */
+void d4_mapimage_write_entry (d4_mapimage_writer_t *self, size_t hash, const void *key_data, size_t key_size, const void *value_data, size_t value_size);
+
+#endif
@@ -9,6 +9,7 @@
 /* See https://github.com/thelang-io/libd4 for reference. */
 
 #include "object-macro.h"
+#include "strbuf.h"
 
 /**
  * Macro used to define object type.
@@ -18,7 +19,7 @@
  * @param copy_block Block used for copy method of object type.
  * @param eq_block Block used for eq method of object type.
  * @param free_block Block used for free method of object type.
- * @param str_block Block used for str method of object type.
+ * @param str_block Block used for str method of object type, appends fields to `buf` string buffer.
  */
 #define D4_OBJECT_DEFINE(type_name, display_name, alloc_block, copy_block, eq_block, free_block, str_block, ...) \
   d4_obj_##type_name##_t d4_obj_##type_name##_alloc (__VA_ARGS__) { \
@@ -43,27 +44,20 @@
   } \
   \
   d4_str_t d4_obj_##type_name##_str (const d4_obj_##type_name##_t self) { \
-    d4_str_t right_brace = d4_str_alloc(L"}"); \
-    d4_str_t result = d4_str_empty_val; \
-    d4_str_t t1; \
-    d4_str_t t2; \
+    d4_strbuf_t buf = d4_strbuf_alloc(0); \
+    d4_strbuf_append(&buf, (d4_str_t) {#display_name L"{", sizeof(#display_name), true}); \
     str_block \
-    result = d4_str_realloc(result, t1 = d4_str_concat(t2 = d4_str_alloc(#display_name  L"{"), result)); \
-    d4_str_free(t1); \
-    d4_str_free(t2); \
-    result = d4_str_realloc(result, t1 = d4_str_concat(result, right_brace)); \
-    d4_str_free(t1); \
-    d4_str_free(right_brace); \
-    return result; \
+    d4_strbuf_appendChar(&buf, L'}'); \
+    return d4_strbuf_finish(&buf); \
   }
 
 /**
  * Helper function to make object type definition str_block generation easier.
- * @param result String to append data to.
+ * Separates field from previous one unless buffer is empty or ends with opening brace.
+ * @param buf String buffer to append data to.
  * @param name Name of the field.
  * @param value Value fo the object type field.
- * @return Resulting string with information about new field added.
  */
-d4_str_t d4_obj_str_append (d4_str_t result, d4_str_t name, d4_str_t value);
+void d4_obj_str_append (d4_strbuf_t *buf, d4_str_t name, d4_str_t value);
 
 #endif
@@ -0,0 +1,211 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_SET_MACRO_H
+#define D4_SET_MACRO_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "array-macro.h"
+
+/**
+ * Macro that should be used to generate set type. Array type of the same element type should be declared beforehand.
+ * @param element_type_name Type name of the element.
+ * @param element_type Element type of the set object.
+ */
+#define D4_SET_DECLARE(element_type_name, element_type) \
+  /** Object representation of the set node type. */ \
+  typedef struct d4_set_##element_type_name##_node { \
+    \
+    /* Full hash of the element (used internally). */ \
+    size_t hash; \
+    \
+    /* Element of the set node. */ \
+    element_type element; \
+    \
+    /* Pointer to the next node of the linked list. */ \
+    struct d4_set_##element_type_name##_node *next; \
+  } d4_set_##element_type_name##_node_t; \
+  \
+  /** Object representation of the set type. */ \
+  typedef struct { \
+    /* Data container of the node pointers. */ \
+    d4_set_##element_type_name##_node_t **data; \
+    \
+    /* Total allocated size of the set object. */ \
+    size_t cap; \
+    \
+    /* Length of the set object. */ \
+    size_t len; \
+  } d4_set_##element_type_name##_t; \
+  \
+  /**
+   * Allocates set object.
+   * @param len Number of elements that are passed as arguments.
+   * @param ... Elements to copy into resulting set, repeated elements are added once.
+   * @return Allocated set object.
+   */ \
+  d4_set_##element_type_name##_t d4_set_##element_type_name##_alloc (size_t len, ...); \
+  \
+  /**
+   * Adds element to the set object, does nothing if element exists. Reallocates set object if load factor more than 75%.
+   * @param self Set object to add element to.
+   * @param element Element to add.
+   * @return Reference to itself.
+   */ \
+  d4_set_##element_type_name##_t *d4_set_##element_type_name##_add (d4_set_##element_type_name##_t *self, const element_type element); \
+  \
+  /**
+   * Removes all elements and changes length to zero without affecting capacity.
+   * @param self Set object to clear.
+   * @return Reference to itself.
+   */ \
+  d4_set_##element_type_name##_t *d4_set_##element_type_name##_clear (d4_set_##element_type_name##_t *self); \
+  \
+  /**
+   * Creates a copy of provided set object.
+   * @param self Set object to create copy of.
+   * @return Copy of provided set object.
+   */ \
+  d4_set_##element_type_name##_t d4_set_##element_type_name##_copy (const d4_set_##element_type_name##_t self); \
+  \
+  /**
+   * Creates set of elements that exist in set object, but not in other set object.
+   * @param self Set object to take elements from.
+   * @param other Set object with elements to exclude.
+   * @return Set object with difference of two set objects.
+   */ \
+  d4_set_##element_type_name##_t d4_set_##element_type_name##_difference (const d4_set_##element_type_name##_t self, const d4_set_##element_type_name##_t other); \
+  \
+  /**
+   * Checks whether set has any elements.
+   * @param self Set object to check.
+   * @return Whether set has any elements.
+   */ \
+  bool d4_set_##element_type_name##_empty (const d4_set_##element_type_name##_t self); \
+  \
+  /**
+   * Compares whether set object is equal to right-hand set object.
+   * @param self Set object to check.
+   * @param rhs Right-hand set object to check.
+   * @return Whether two set objects are equal.
+   */ \
+  bool d4_set_##element_type_name##_eq (const d4_set_##element_type_name##_t self, const d4_set_##element_type_name##_t rhs); \
+  \
+  /**
+   * Calls `iterator` on every element.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Set object to perform action on.
+   * @param iterator Function to execute on each element of the set.
+   */ \
+  void d4_set_##element_type_name##_forEach (d4_err_state_t *state, int line, int col, const d4_set_##element_type_name##_t self, const d4_fn_esFP3##element_type_name##FP3intFRvoidFE_t iterator); \
+  \
+  /**
+   * Deallocates set object.
+   * @param self Set object to deallocate.
+   */ \
+  void d4_set_##element_type_name##_free (d4_set_##element_type_name##_t self); \
+  \
+  /**
+   * Checks whether set object contains provided element.
+   * @param self Set object to check.
+   * @param element Element to check.
+   * @return Whether set object contains provided element.
+   */ \
+  bool d4_set_##element_type_name##_has (const d4_set_##element_type_name##_t self, const element_type element); \
+  \
+  /**
+   * Creates set of elements that exist in both set objects.
+   * @param self First set object.
+   * @param other Second set object.
+   * @return Set object with intersection of two set objects.
+   */ \
+  d4_set_##element_type_name##_t d4_set_##element_type_name##_intersection (const d4_set_##element_type_name##_t self, const d4_set_##element_type_name##_t other); \
+  \
+  /**
+   * Checks whether every element of set object exists in other set object.
+   * @param self Set object to check.
+   * @param other Set object to check against.
+   * @return Whether set object is a subset of other set object.
+   */ \
+  bool d4_set_##element_type_name##_isSubset (const d4_set_##element_type_name##_t self, const d4_set_##element_type_name##_t other); \
+  \
+  /**
+   * Finds node of the element inside set object.
+   * @param self Set object to search in.
+   * @param hash Full hash of the element.
+   * @param element Element to search for.
+   * @return Node of the element if found, NULL otherwise.
+   */ \
+  d4_set_##element_type_name##_node_t *d4_set_##element_type_name##_lookup (const d4_set_##element_type_name##_t self, size_t hash, const element_type element); \
+  \
+  /**
+   * Creates and places a node inside set object if element doesn't exist. Doesn't change length.
+   * @param self Set object to place node into.
+   * @param hash Full hash of the element.
+   * @param element Element of the new node.
+   * @return Whether node was placed.
+   */ \
+  bool d4_set_##element_type_name##_place (d4_set_##element_type_name##_t self, size_t hash, const element_type element); \
+  \
+  /**
+   * Deallocates current set object and returns a copy of another set object.
+   * @param self Set object to deallocate.
+   * @param rhs Set object to return a copy of.
+   * @return Copy of another set object.
+   */ \
+  d4_set_##element_type_name##_t d4_set_##element_type_name##_realloc (d4_set_##element_type_name##_t self, const d4_set_##element_type_name##_t rhs); \
+  \
+  /**
+   * Removes provided element from the set object and if element doesn’t exist throws error.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Set object to remove element from.
+   * @param element Element to remove.
+   * @return Reference to itself.
+   */ \
+  d4_set_##element_type_name##_t *d4_set_##element_type_name##_remove (d4_err_state_t *state, int line, int col, d4_set_##element_type_name##_t *self, const element_type element); \
+  \
+  /**
+   * Reserves a room for a specified number of nodes.
+   * @param self Set object to change capacity of.
+   * @param size New set object capacity.
+   * @return Reference to itself.
+   */ \
+  d4_set_##element_type_name##_t *d4_set_##element_type_name##_reserve (d4_set_##element_type_name##_t *self, int32_t size); \
+  \
+  /**
+   * Reduces capacity to a current set object length multiplied by 2.
+   * @param self Set object to reduce capacity of.
+   * @return Reference to itself.
+   */ \
+  d4_set_##element_type_name##_t *d4_set_##element_type_name##_shrink (d4_set_##element_type_name##_t *self); \
+  \
+  /**
+   * Generates string representation of the set object.
+   * @param self Set object to generate string representation for.
+   * @return String representation of the set object.
+   */ \
+  d4_str_t d4_set_##element_type_name##_str (const d4_set_##element_type_name##_t self); \
+  \
+  /**
+   * Creates set of elements that exist in any of two set objects.
+   * @param self First set object.
+   * @param other Second set object.
+   * @return Set object with union of two set objects.
+   */ \
+  d4_set_##element_type_name##_t d4_set_##element_type_name##_union (const d4_set_##element_type_name##_t self, const d4_set_##element_type_name##_t other); \
+  \
+  /**
+   * Returns array of set elements.
+   * @param self Set object to use.
+   * @return Array of set elements.
+   */ \
+  d4_arr_##element_type_name##_t d4_set_##element_type_name##_values (const d4_set_##element_type_name##_t self);
+
+#endif
@@ -0,0 +1,355 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_SET_H
+#define D4_SET_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "set-macro.h"
+#include "map.h"
+
+/**
+ * Macro that can be used to define a set object. Set objects share hashing and growth policy with map objects.
+ * @param element_type_name Type name of the element.
+ * @param element_type Element type of the set object.
+ * @param alloc_element_type Element type of the element to be used inside variadic argument (should be cast to int in some cases).
+ * @param copy_block Block that is used for copy method of element.
+ * @param eq_block Block that is used for equals method of element.
+ * @param free_block Block that is used for free method of element.
+ * @param hash_block Block that is used to hash element.
+ * @param str_block Block that is used for str method of element.
+ */
+#define D4_SET_DEFINE(element_type_name, element_type, alloc_element_type, copy_block, eq_block, free_block, hash_block, str_block) \
+  D4_SET_DEFINE_WITH_HASH(element_type_name, element_type, alloc_element_type, copy_block, eq_block, free_block, hash_block, str_block, d4_map_hash)
+
+/**
+ * Macro that can be used to define a set object with custom hash function.
+ * @param element_type_name Type name of the element.
+ * @param element_type Element type of the set object.
+ * @param alloc_element_type Element type of the element to be used inside variadic argument (should be cast to int in some cases).
+ * @param copy_block Block that is used for copy method of element.
+ * @param eq_block Block that is used for equals method of element.
+ * @param free_block Block that is used for free method of element.
+ * @param hash_block Block that is used to hash element.
+ * @param str_block Block that is used for str method of element.
+ * @param hash_func Function that maps identifier to index inside of the set, e.g. d4_map_hash or d4_map_hash_seeded.
+ */
+#define D4_SET_DEFINE_WITH_HASH(element_type_name, element_type, alloc_element_type, copy_block, eq_block, free_block, hash_block, str_block, hash_func) \
+  d4_set_##element_type_name##_t d4_set_##element_type_name##_alloc (size_t len, ...) { \
+    d4_set_##element_type_name##_t self = {d4_safe_alloc(0x0F * sizeof(d4_set_##element_type_name##_node_t *)), 0x0F, 0}; \
+    va_list args; \
+    memset(self.data, 0, self.cap * sizeof(d4_set_##element_type_name##_node_t *)); \
+    if (len == 0) return self; \
+    va_start(args, len); \
+    for (size_t i = 0; i < len; i++) { \
+      const element_type element = va_arg(args, alloc_element_type); \
+      d4_set_##element_type_name##_add(&self, element); \
+    } \
+    va_end(args); \
+    return self; \
+  } \
+  \
+  d4_set_##element_type_name##_t *d4_set_##element_type_name##_add (d4_set_##element_type_name##_t *self, const element_type element) { \
+    d4_str_t id = hash_block; \
+    size_t hash = hash_func(id, SIZE_MAX); \
+    d4_str_free(id); \
+    if (!d4_set_##element_type_name##_place(*self, hash, element)) return self; \
+    self->len += 1; \
+    if (d4_map_should_reserve(self->cap, self->len)) { \
+      size_t new_cap = d4_map_calc_cap(self->cap, self->len); \
+      d4_set_##element_type_name##_reserve(self, (int32_t) new_cap); \
+    } \
+    return self; \
+  } \
+  \
+  d4_set_##element_type_name##_t *d4_set_##element_type_name##_clear (d4_set_##element_type_name##_t *self) { \
+    for (size_t i = 0; i < self->cap; i++) { \
+      while (self->data[i] != NULL) { \
+        d4_set_##element_type_name##_node_t *it = self->data[i]; \
+        element_type element = it->element; \
+        free_block; \
+        self->data[i] = it->next; \
+        d4_safe_free(it); \
+      } \
+    } \
+    self->len = 0; \
+    return self; \
+  } \
+  \
+  d4_set_##element_type_name##_t d4_set_##element_type_name##_copy (const d4_set_##element_type_name##_t self) { \
+    d4_set_##element_type_name##_t new_self = {d4_safe_alloc(self.cap * sizeof(d4_set_##element_type_name##_node_t *)), self.cap, self.len}; \
+    memset(new_self.data, 0, new_self.cap * sizeof(d4_set_##element_type_name##_node_t *)); \
+    for (size_t i = 0; i < self.cap; i++) { \
+      for (d4_set_##element_type_name##_node_t *it = self.data[i]; it != NULL; it = it->next) { \
+        d4_set_##element_type_name##_node_t *new_item = d4_safe_alloc(sizeof(d4_set_##element_type_name##_node_t)); \
+        const element_type element = it->element; \
+        new_item->hash = it->hash; \
+        new_item->element = copy_block; \
+        new_item->next = new_self.data[i]; \
+        new_self.data[i] = new_item; \
+      } \
+    } \
+    return new_self; \
+  } \
+  \
+  d4_set_##element_type_name##_t d4_set_##element_type_name##_difference (const d4_set_##element_type_name##_t self, const d4_set_##element_type_name##_t other) { \
+    d4_set_##element_type_name##_t result; \
+    if (self.len <= other.len) { \
+      result = d4_set_##element_type_name##_alloc(0); \
+      for (size_t i = 0; i < self.cap; i++) { \
+        for (d4_set_##element_type_name##_node_t *it = self.data[i]; it != NULL; it = it->next) { \
+          if (d4_set_##element_type_name##_lookup(other, it->hash, it->element) != NULL) continue; \
+          d4_set_##element_type_name##_place(result, it->hash, it->element); \
+          result.len += 1; \
+          if (d4_map_should_reserve(result.cap, result.len)) { \
+            d4_set_##element_type_name##_reserve(&result, (int32_t) d4_map_calc_cap(result.cap, result.len)); \
+          } \
+        } \
+      } \
+      return result; \
+    } \
+    result = d4_set_##element_type_name##_copy(self); \
+    for (size_t i = 0; i < other.cap; i++) { \
+      for (d4_set_##element_type_name##_node_t *it = other.data[i]; it != NULL; it = it->next) { \
+        size_t index = it->hash % result.cap; \
+        d4_set_##element_type_name##_node_t *prev = NULL; \
+        d4_set_##element_type_name##_node_t *it2 = result.data[index]; \
+        const element_type rhs_element = it->element; \
+        while (it2 != NULL) { \
+          const element_type lhs_element = it2->element; \
+          if (it2->hash == it->hash && (eq_block)) break; \
+          prev = it2; \
+          it2 = it2->next; \
+        } \
+        if (it2 == NULL) continue; \
+        if (prev == NULL) { \
+          result.data[index] = it2->next; \
+        } else { \
+          prev->next = it2->next; \
+        } \
+        { \
+          element_type element = it2->element; \
+          free_block; \
+        } \
+        d4_safe_free(it2); \
+        result.len -= 1; \
+      } \
+    } \
+    return result; \
+  } \
+  \
+  bool d4_set_##element_type_name##_empty (const d4_set_##element_type_name##_t self) { \
+    return self.len == 0; \
+  } \
+  \
+  bool d4_set_##element_type_name##_eq (const d4_set_##element_type_name##_t self, const d4_set_##element_type_name##_t rhs) { \
+    if (self.len != rhs.len) return false; \
+    for (size_t i = 0; i < self.cap; i++) { \
+      for (d4_set_##element_type_name##_node_t *it = self.data[i]; it != NULL; it = it->next) { \
+        if (d4_set_##element_type_name##_lookup(rhs, it->hash, it->element) == NULL) return false; \
+      } \
+    } \
+    return true; \
+  } \
+  \
+  void d4_set_##element_type_name##_forEach (d4_err_state_t *state, int line, int col, const d4_set_##element_type_name##_t self, const d4_fn_esFP3##element_type_name##FP3intFRvoidFE_t iterator) { \
+    int32_t j = 0; \
+    for (size_t i = 0; i < self.cap; i++) { \
+      for (d4_set_##element_type_name##_node_t *it = self.data[i]; it != NULL; it = it->next) { \
+        void *params = d4_safe_calloc( \
+          &(d4_fn_esFP3##element_type_name##FP3intFRvoidFE_params_t) {state, line, col, it->element, j++}, \
+          sizeof(d4_fn_esFP3##element_type_name##FP3intFRvoidFE_params_t) \
+        ); \
+        iterator.func(iterator.ctx, params); \
+        d4_safe_free(params); \
+      } \
+    } \
+  } \
+  \
+  void d4_set_##element_type_name##_free (d4_set_##element_type_name##_t self) { \
+    for (size_t i = 0; i < self.cap; i++) { \
+      while (self.data[i] != NULL) { \
+        d4_set_##element_type_name##_node_t *it = self.data[i]; \
+        element_type element = it->element; \
+        free_block; \
+        self.data[i] = it->next; \
+        d4_safe_free(it); \
+      } \
+    } \
+    d4_safe_free(self.data); \
+  } \
+  \
+  bool d4_set_##element_type_name##_has (const d4_set_##element_type_name##_t self, const element_type element) { \
+    d4_str_t id = hash_block; \
+    size_t hash = hash_func(id, SIZE_MAX); \
+    d4_str_free(id); \
+    return d4_set_##element_type_name##_lookup(self, hash, element) != NULL; \
+  } \
+  \
+  d4_set_##element_type_name##_t d4_set_##element_type_name##_intersection (const d4_set_##element_type_name##_t self, const d4_set_##element_type_name##_t other) { \
+    bool self_smaller = self.len <= other.len; \
+    const d4_set_##element_type_name##_t small = self_smaller ? self : other; \
+    const d4_set_##element_type_name##_t big = self_smaller ? other : self; \
+    d4_set_##element_type_name##_t result = d4_set_##element_type_name##_alloc(0); \
+    for (size_t i = 0; i < small.cap; i++) { \
+      for (d4_set_##element_type_name##_node_t *it = small.data[i]; it != NULL; it = it->next) { \
+        d4_set_##element_type_name##_node_t *found = d4_set_##element_type_name##_lookup(big, it->hash, it->element); \
+        if (found == NULL) continue; \
+        d4_set_##element_type_name##_place(result, it->hash, self_smaller ? it->element : found->element); \
+        result.len += 1; \
+        if (d4_map_should_reserve(result.cap, result.len)) { \
+          d4_set_##element_type_name##_reserve(&result, (int32_t) d4_map_calc_cap(result.cap, result.len)); \
+        } \
+      } \
+    } \
+    return result; \
+  } \
+  \
+  bool d4_set_##element_type_name##_isSubset (const d4_set_##element_type_name##_t self, const d4_set_##element_type_name##_t other) { \
+    if (self.len > other.len) return false; \
+    for (size_t i = 0; i < self.cap; i++) { \
+      for (d4_set_##element_type_name##_node_t *it = self.data[i]; it != NULL; it = it->next) { \
+        if (d4_set_##element_type_name##_lookup(other, it->hash, it->element) == NULL) return false; \
+      } \
+    } \
+    return true; \
+  } \
+  \
+  d4_set_##element_type_name##_node_t *d4_set_##element_type_name##_lookup (const d4_set_##element_type_name##_t self, size_t hash, const element_type element) { \
+    const element_type rhs_element = element; \
+    d4_set_##element_type_name##_node_t *it = self.data[hash % self.cap]; \
+    while (it != NULL) { \
+      const element_type lhs_element = it->element; \
+      if (it->hash == hash && (eq_block)) return it; \
+      it = it->next; \
+    } \
+    return NULL; \
+  } \
+  \
+  bool d4_set_##element_type_name##_place (d4_set_##element_type_name##_t self, size_t hash, const element_type element) { \
+    size_t index = hash % self.cap; \
+    d4_set_##element_type_name##_node_t *new_item; \
+    if (d4_set_##element_type_name##_lookup(self, hash, element) != NULL) return false; \
+    new_item = d4_safe_alloc(sizeof(d4_set_##element_type_name##_node_t)); \
+    new_item->hash = hash; \
+    new_item->element = copy_block; \
+    new_item->next = self.data[index]; \
+    self.data[index] = new_item; \
+    return true; \
+  } \
+  \
+  d4_set_##element_type_name##_t d4_set_##element_type_name##_realloc (d4_set_##element_type_name##_t self, const d4_set_##element_type_name##_t rhs) { \
+    d4_set_##element_type_name##_free(self); \
+    return d4_set_##element_type_name##_copy(rhs); \
+  } \
+  \
+  d4_set_##element_type_name##_t *d4_set_##element_type_name##_remove (d4_err_state_t *state, int line, int col, d4_set_##element_type_name##_t *self, const element_type element) { \
+    d4_str_t id = hash_block; \
+    size_t hash = hash_func(id, SIZE_MAX); \
+    size_t index = hash % self->cap; \
+    const element_type rhs_element = element; \
+    d4_set_##element_type_name##_node_t *prev = NULL; \
+    d4_set_##element_type_name##_node_t *it = self->data[index]; \
+    while (it != NULL) { \
+      const element_type lhs_element = it->element; \
+      if (it->hash == hash && (eq_block)) break; \
+      prev = it; \
+      it = it->next; \
+    } \
+    if (it == NULL) { \
+      d4_str_t message = d4_str_alloc(L"failed to remove element '%ls'", id.data); \
+      d4_error_assign_generic(state, line, col, message); \
+      d4_str_free(message); \
+    } \
+    d4_str_free(id); \
+    if (state->id != -1) longjmp(state->buf_last->buf, state->id); \
+    if (prev == NULL) { \
+      self->data[index] = it->next; \
+    } else { \
+      prev->next = it->next; \
+    } \
+    { \
+      element_type element = it->element; \
+      free_block; \
+    } \
+    d4_safe_free(it); \
+    self->len -= 1; \
+    return self; \
+  } \
+  \
+  d4_set_##element_type_name##_t *d4_set_##element_type_name##_reserve (d4_set_##element_type_name##_t *self, int32_t size) { \
+    d4_set_##element_type_name##_node_t **data; \
+    size_t cap; \
+    if (size < 0x0F) size = 0x0F; \
+    cap = (size_t) size; \
+    data = d4_safe_alloc(cap * sizeof(d4_set_##element_type_name##_node_t *)); \
+    memset(data, 0, cap * sizeof(d4_set_##element_type_name##_node_t *)); \
+    for (size_t i = 0; i < self->cap; i++) { \
+      while (self->data[i] != NULL) { \
+        d4_set_##element_type_name##_node_t *it = self->data[i]; \
+        size_t index = it->hash % cap; \
+        self->data[i] = it->next; \
+        it->next = data[index]; \
+        data[index] = it; \
+      } \
+    } \
+    d4_safe_free(self->data); \
+    self->cap = cap; \
+    self->data = data; \
+    return self; \
+  } \
+  \
+  d4_set_##element_type_name##_t *d4_set_##element_type_name##_shrink (d4_set_##element_type_name##_t *self) { \
+    d4_set_##element_type_name##_reserve(self, (int32_t) (self->len * 2)); \
+    return self; \
+  } \
+  \
+  d4_str_t d4_set_##element_type_name##_str (const d4_set_##element_type_name##_t self) { \
+    d4_strbuf_t r = d4_strbuf_alloc(0); \
+    size_t j = 0; \
+    d4_strbuf_appendChar(&r, L'{'); \
+    for (size_t i = 0; i < self.cap; i++) { \
+      for (d4_set_##element_type_name##_node_t *it = self.data[i]; it != NULL; it = it->next) { \
+        const element_type element = it->element; \
+        if (j++ != 0) d4_strbuf_append(&r, (d4_str_t) {L", ", 2, true}); \
+        d4_strbuf_appendMove(&r, str_block); \
+      } \
+    } \
+    d4_strbuf_appendChar(&r, L'}'); \
+    return d4_strbuf_finish(&r); \
+  } \
+  \
+  d4_set_##element_type_name##_t d4_set_##element_type_name##_union (const d4_set_##element_type_name##_t self, const d4_set_##element_type_name##_t other) { \
+    bool self_smaller = self.len < other.len; \
+    const d4_set_##element_type_name##_t small = self_smaller ? self : other; \
+    d4_set_##element_type_name##_t result = d4_set_##element_type_name##_copy(self_smaller ? other : self); \
+    for (size_t i = 0; i < small.cap; i++) { \
+      for (d4_set_##element_type_name##_node_t *it = small.data[i]; it != NULL; it = it->next) { \
+        if (!d4_set_##element_type_name##_place(result, it->hash, it->element)) continue; \
+        result.len += 1; \
+        if (d4_map_should_reserve(result.cap, result.len)) { \
+          d4_set_##element_type_name##_reserve(&result, (int32_t) d4_map_calc_cap(result.cap, result.len)); \
+        } \
+      } \
+    } \
+    return result; \
+  } \
+  \
+  d4_arr_##element_type_name##_t d4_set_##element_type_name##_values (const d4_set_##element_type_name##_t self) { \
+    element_type *data; \
+    size_t j = 0; \
+    if (self.len == 0) return (d4_arr_##element_type_name##_t) {NULL, 0}; \
+    data = d4_safe_alloc(self.len * sizeof(element_type)); \
+    for (size_t i = 0; i < self.cap; i++) { \
+      for (d4_set_##element_type_name##_node_t *it = self.data[i]; it != NULL; it = it->next) { \
+        const element_type element = it->element; \
+        data[j++] = copy_block; \
+      } \
+    } \
+    return (d4_arr_##element_type_name##_t) {data, self.len}; \
+  }
+
+#endif
@@ -0,0 +1,131 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_SNAPMAP_MACRO_H
+#define D4_SNAPMAP_MACRO_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "map-macro.h"
+
+/** Number of snapshots that can be held at the same time, readers beyond it wait for a free slot. */
+#define D4_SNAPMAP_SLOTS 64
+
+/** Object representation of the snapshot map core that publishes versions and reclaims them (used internally). */
+typedef struct d4_snapmap d4_snapmap_t;
+
+/**
+ * Macro that should be used to generate snapshot map type, a read-mostly wrapper of the map type.
+ * Readers take lock-free snapshots of the current version, writers copy it, apply changes and publish new version by atomic pointer swap.
+ * Old versions are deallocated once no snapshot refers to them. Map type of the same key and value types should be declared beforehand.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the snapshot map object.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the snapshot map object.
+ */
+#define D4_SNAPMAP_DECLARE(key_type_name, key_type, value_type_name, value_type) \
+  /** Object representation of the snapshot map type. */ \
+  typedef struct { \
+    /* Core that holds published and retired versions (used internally). */ \
+    d4_snapmap_t *core; \
+  } d4_snapmap_##key_type_name##MS##value_type_name##ME_t; \
+  \
+  /** Object representation of the snapshot map snapshot type. */ \
+  typedef struct { \
+    /* Version of the map object, stays valid and unchanged until snapshot is released. */ \
+    const d4_map_##key_type_name##MS##value_type_name##ME_t *map; \
+    \
+    /* Slot that protects version from reclamation (used internally). */ \
+    size_t slot; \
+  } d4_snapmap_##key_type_name##MS##value_type_name##ME_snapshot_t; \
+  \
+  /**
+   * Takes snapshot of the current version without locking, must be released with release method.
+   * @param self Snapshot map object to take snapshot of.
+   * @return Snapshot of the current version.
+   */ \
+  d4_snapmap_##key_type_name##MS##value_type_name##ME_snapshot_t d4_snapmap_##key_type_name##MS##value_type_name##ME_acquire (const d4_snapmap_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Allocates snapshot map object with a copy of map object as the first version.
+   * @param map Map object to copy.
+   * @return Allocated snapshot map object.
+   */ \
+  d4_snapmap_##key_type_name##MS##value_type_name##ME_t d4_snapmap_##key_type_name##MS##value_type_name##ME_alloc (const d4_map_##key_type_name##MS##value_type_name##ME_t map); \
+  \
+  /**
+   * Deallocates snapshot map object with all of its versions, no snapshots should be held.
+   * @param self Snapshot map object to deallocate.
+   */ \
+  void d4_snapmap_##key_type_name##MS##value_type_name##ME_free (d4_snapmap_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Retrieves value by key from the current version and throws if key doesn’t exist.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Snapshot map object to perform action on.
+   * @param key Key of the pair to retrieve.
+   * @return Value of found pair.
+   */ \
+  value_type d4_snapmap_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, const d4_snapmap_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Checks whether current version contains a pair with provided key.
+   * @param self Snapshot map object to check.
+   * @param key Key of the pair to check.
+   * @return Whether current version contains a pair with provided key.
+   */ \
+  bool d4_snapmap_##key_type_name##MS##value_type_name##ME_has (const d4_snapmap_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Creates a copy of the current version.
+   * @param self Snapshot map object to copy current version of.
+   * @return Copy of the current version.
+   */ \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_snapmap_##key_type_name##MS##value_type_name##ME_load (const d4_snapmap_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Releases snapshot, its version can be deallocated afterwards.
+   * @param self Snapshot map object snapshot was taken of.
+   * @param snapshot Snapshot to release.
+   */ \
+  void d4_snapmap_##key_type_name##MS##value_type_name##ME_release (const d4_snapmap_##key_type_name##MS##value_type_name##ME_t self, const d4_snapmap_##key_type_name##MS##value_type_name##ME_snapshot_t snapshot); \
+  \
+  /**
+   * Publishes a copy of the current version without provided key and if key doesn’t exist throws error.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Snapshot map object to remove key from.
+   * @param key Key of the pair to remove.
+   * @return Reference to itself.
+   */ \
+  d4_snapmap_##key_type_name##MS##value_type_name##ME_t *d4_snapmap_##key_type_name##MS##value_type_name##ME_remove (d4_err_state_t *state, int line, int col, d4_snapmap_##key_type_name##MS##value_type_name##ME_t *self, const key_type key); \
+  \
+  /**
+   * Publishes a copy of the current version with provided pair set.
+   * @param self Snapshot map object to set a pair for.
+   * @param key Key of the pair.
+   * @param value Value of the pair.
+   * @return Reference to itself.
+   */ \
+  d4_snapmap_##key_type_name##MS##value_type_name##ME_t *d4_snapmap_##key_type_name##MS##value_type_name##ME_set (d4_snapmap_##key_type_name##MS##value_type_name##ME_t *self, const key_type key, const value_type value); \
+  \
+  /**
+   * Publishes map object as the new version taking ownership of it, can be used to apply many changes at once.
+   * @param self Snapshot map object to publish version into.
+   * @param map Map object to publish, must not be used or deallocated afterwards.
+   * @return Reference to itself.
+   */ \
+  d4_snapmap_##key_type_name##MS##value_type_name##ME_t *d4_snapmap_##key_type_name##MS##value_type_name##ME_store (d4_snapmap_##key_type_name##MS##value_type_name##ME_t *self, d4_map_##key_type_name##MS##value_type_name##ME_t map); \
+  \
+  /**
+   * Deallocates version of the map object (used internally).
+   * @param version Heap allocated map object to deallocate.
+   */ \
+  void d4_snapmap_##key_type_name##MS##value_type_name##ME_versionFree (void *version);
+
+#endif
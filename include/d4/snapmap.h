@@ -0,0 +1,167 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_SNAPMAP_H
+#define D4_SNAPMAP_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "snapmap-macro.h"
+#include "map.h"
+
+/**
+ * Macro that can be used to define a snapshot map object, map object of the same key and value types should be defined beforehand.
+ * Key and value blocks of the map object are reused, so any map object can be wrapped.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the snapshot map object.
+ * @param key_str_block Block that is used for str method of key.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the snapshot map object.
+ */
+#define D4_SNAPMAP_DEFINE(key_type_name, key_type, key_str_block, value_type_name, value_type) \
+  d4_snapmap_##key_type_name##MS##value_type_name##ME_snapshot_t d4_snapmap_##key_type_name##MS##value_type_name##ME_acquire (const d4_snapmap_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_snapmap_##key_type_name##MS##value_type_name##ME_snapshot_t snapshot; \
+    snapshot.map = d4_snapmap_acquire(self.core, &snapshot.slot); \
+    return snapshot; \
+  } \
+  \
+  d4_snapmap_##key_type_name##MS##value_type_name##ME_t d4_snapmap_##key_type_name##MS##value_type_name##ME_alloc (const d4_map_##key_type_name##MS##value_type_name##ME_t map) { \
+    d4_map_##key_type_name##MS##value_type_name##ME_t *version = d4_safe_alloc(sizeof(d4_map_##key_type_name##MS##value_type_name##ME_t)); \
+    *version = d4_map_##key_type_name##MS##value_type_name##ME_copy(map); \
+    return (d4_snapmap_##key_type_name##MS##value_type_name##ME_t) {d4_snapmap_alloc(version, d4_snapmap_##key_type_name##MS##value_type_name##ME_versionFree)}; \
+  } \
+  \
+  void d4_snapmap_##key_type_name##MS##value_type_name##ME_free (d4_snapmap_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_snapmap_free(self.core); \
+  } \
+  \
+  value_type d4_snapmap_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, const d4_snapmap_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    d4_snapmap_##key_type_name##MS##value_type_name##ME_snapshot_t snapshot = d4_snapmap_##key_type_name##MS##value_type_name##ME_acquire(self); \
+    value_type result; \
+    if (!d4_map_##key_type_name##MS##value_type_name##ME_has(*snapshot.map, key)) { \
+      d4_str_t key_str = key_str_block; \
+      d4_str_t message = d4_str_alloc(L"failed to find key '%ls'", key_str.data); \
+      d4_snapmap_##key_type_name##MS##value_type_name##ME_release(self, snapshot); \
+      d4_error_assign_generic(state, line, col, message); \
+      d4_str_free(message); \
+      d4_str_free(key_str); \
+      longjmp(state->buf_last->buf, state->id); \
+    } \
+    result = d4_map_##key_type_name##MS##value_type_name##ME_get(state, line, col, *snapshot.map, key); \
+    d4_snapmap_##key_type_name##MS##value_type_name##ME_release(self, snapshot); \
+    return result; \
+  } \
+  \
+  bool d4_snapmap_##key_type_name##MS##value_type_name##ME_has (const d4_snapmap_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    d4_snapmap_##key_type_name##MS##value_type_name##ME_snapshot_t snapshot = d4_snapmap_##key_type_name##MS##value_type_name##ME_acquire(self); \
+    bool result = d4_map_##key_type_name##MS##value_type_name##ME_has(*snapshot.map, key); \
+    d4_snapmap_##key_type_name##MS##value_type_name##ME_release(self, snapshot); \
+    return result; \
+  } \
+  \
+  d4_map_##key_type_name##MS##value_type_name##ME_t d4_snapmap_##key_type_name##MS##value_type_name##ME_load (const d4_snapmap_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_snapmap_##key_type_name##MS##value_type_name##ME_snapshot_t snapshot = d4_snapmap_##key_type_name##MS##value_type_name##ME_acquire(self); \
+    d4_map_##key_type_name##MS##value_type_name##ME_t result = d4_map_##key_type_name##MS##value_type_name##ME_copy(*snapshot.map); \
+    d4_snapmap_##key_type_name##MS##value_type_name##ME_release(self, snapshot); \
+    return result; \
+  } \
+  \
+  void d4_snapmap_##key_type_name##MS##value_type_name##ME_release (const d4_snapmap_##key_type_name##MS##value_type_name##ME_t self, const d4_snapmap_##key_type_name##MS##value_type_name##ME_snapshot_t snapshot) { \
+    d4_snapmap_release(self.core, snapshot.slot); \
+  } \
+  \
+  d4_snapmap_##key_type_name##MS##value_type_name##ME_t *d4_snapmap_##key_type_name##MS##value_type_name##ME_remove (d4_err_state_t *state, int line, int col, d4_snapmap_##key_type_name##MS##value_type_name##ME_t *self, const key_type key) { \
+    const d4_map_##key_type_name##MS##value_type_name##ME_t *current = d4_snapmap_write_begin(self->core); \
+    d4_map_##key_type_name##MS##value_type_name##ME_t *version; \
+    if (!d4_map_##key_type_name##MS##value_type_name##ME_has(*current, key)) { \
+      d4_str_t key_str = key_str_block; \
+      d4_str_t message = d4_str_alloc(L"failed to remove key '%ls'", key_str.data); \
+      d4_snapmap_write_end(self->core, NULL); \
+      d4_error_assign_generic(state, line, col, message); \
+      d4_str_free(message); \
+      d4_str_free(key_str); \
+      longjmp(state->buf_last->buf, state->id); \
+    } \
+    version = d4_safe_alloc(sizeof(d4_map_##key_type_name##MS##value_type_name##ME_t)); \
+    *version = d4_map_##key_type_name##MS##value_type_name##ME_copy(*current); \
+    d4_map_##key_type_name##MS##value_type_name##ME_remove(state, line, col, version, key); \
+    d4_snapmap_write_end(self->core, version); \
+    return self; \
+  } \
+  \
+  d4_snapmap_##key_type_name##MS##value_type_name##ME_t *d4_snapmap_##key_type_name##MS##value_type_name##ME_set (d4_snapmap_##key_type_name##MS##value_type_name##ME_t *self, const key_type key, const value_type value) { \
+    const d4_map_##key_type_name##MS##value_type_name##ME_t *current = d4_snapmap_write_begin(self->core); \
+    d4_map_##key_type_name##MS##value_type_name##ME_t *version = d4_safe_alloc(sizeof(d4_map_##key_type_name##MS##value_type_name##ME_t)); \
+    *version = d4_map_##key_type_name##MS##value_type_name##ME_copy(*current); \
+    d4_map_##key_type_name##MS##value_type_name##ME_set(version, key, value); \
+    d4_snapmap_write_end(self->core, version); \
+    return self; \
+  } \
+  \
+  d4_snapmap_##key_type_name##MS##value_type_name##ME_t *d4_snapmap_##key_type_name##MS##value_type_name##ME_store (d4_snapmap_##key_type_name##MS##value_type_name##ME_t *self, d4_map_##key_type_name##MS##value_type_name##ME_t map) { \
+    d4_map_##key_type_name##MS##value_type_name##ME_t *version = d4_safe_alloc(sizeof(d4_map_##key_type_name##MS##value_type_name##ME_t)); \
+    *version = map; \
+    d4_snapmap_write_begin(self->core); \
+    d4_snapmap_write_end(self->core, version); \
+    return self; \
+  } \
+  \
+  void d4_snapmap_##key_type_name##MS##value_type_name##ME_versionFree (void *version) { \
+    d4_map_##key_type_name##MS##value_type_name##ME_t *map = version; \
+    d4_map_##key_type_name##MS##value_type_name##ME_free(*map); \
+    d4_safe_free(map); \
+  }
+
+/**
+ * Protects current version from reclamation and returns it (used internally).
+ * @param self Snapshot map core to take version of.
+ * @param slot Pointer to store slot that protects version into.
+ * @return Current version.
+ */
+void *d4_snapmap_acquire (d4_snapmap_t *self, size_t *slot);
+
+/**
+ * Allocates snapshot map core (used internally).
+ * @param version First version to publish.
+ * @param version_free Function that deallocates versions.
+ * @return Allocated snapshot map core.
+ */
+d4_snapmap_t *d4_snapmap_alloc (void *version, void (*version_free) (void *));
+
+/**
+ * Deallocates snapshot map core with current and retired versions (used internally).
+ * @param self Snapshot map core to deallocate.
+ */
+void d4_snapmap_free (d4_snapmap_t *self);
+
+/**
+ * Counts retired versions that are still protected by snapshots and wait for reclamation.
+ * @param self Snapshot map core to count retired versions of.
+ * @return Number of retired versions.
+ */
+size_t d4_snapmap_pending (d4_snapmap_t *self);
+
+/**
+ * Releases slot that protects version from reclamation (used internally).
+ * @param self Snapshot map core slot belongs to.
+ * @param slot Slot returned by d4_snapmap_acquire.
+ */
+void d4_snapmap_release (d4_snapmap_t *self, size_t slot);
+
+/**
+ * Locks snapshot map core for writing and returns current version (used internally).
+ * @param self Snapshot map core to lock.
+ * @return Current version, must not be modified.
+ */
+void *d4_snapmap_write_begin (d4_snapmap_t *self);
+
+/**
+ * Publishes new version, retires the previous one, reclaims retired versions without snapshots and unlocks snapshot map core (used internally).
+ * @param self Snapshot map core to publish version into.
+ * @param version Version to publish, NULL to unlock without publishing.
+ */
+void d4_snapmap_write_end (d4_snapmap_t *self, void *version);
+
+#endif
@@ -0,0 +1,194 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_SPARSE_MACRO_H
+#define D4_SPARSE_MACRO_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "array-macro.h"
+
+/** Maximum number of keys that index of the sparse set object covers, keys further apart than that are rejected with error. */
+#define D4_SPARSE_MAX_RANGE ((size_t) 0x1000000)
+
+/**
+ * Macro that should be used to generate sparse set type, a map with integer keys that is directly indexed by key.
+ * Suits small dense key ranges, lookup is a single index access and pairs are stored contiguously, but memory is proportional to the range between the smallest and the largest key.
+ * Array types of the key and value types should be declared beforehand.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the sparse set object, one of integer types.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the sparse set object.
+ */
+#define D4_SPARSE_DECLARE(key_type_name, key_type, value_type_name, value_type) \
+  /** Object representation of the sparse set type. */ \
+  typedef struct { \
+    /* Keys of the sparse set object, stored contiguously. */ \
+    key_type *keys; \
+    \
+    /* Values of the sparse set object, stored at the same positions as their keys. */ \
+    value_type *values; \
+    \
+    /* Positions of the pairs plus one indexed by key offset from min, zero for absent keys (used internally). */ \
+    size_t *index; \
+    \
+    /* Smallest key covered by index (used internally). */ \
+    key_type min; \
+    \
+    /* Number of keys covered by index (used internally). */ \
+    size_t range; \
+    \
+    /* Total allocated size of the keys and values containers. */ \
+    size_t cap; \
+    \
+    /* Length of the sparse set object. */ \
+    size_t len; \
+  } d4_sparse_##key_type_name##MS##value_type_name##ME_t; \
+  \
+  /**
+   * Allocates sparse set object, throws error if keys are further apart than D4_SPARSE_MAX_RANGE.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param len Number of key pairs that are passed as arguments.
+   * @param ... Arguments list that consists of pairs with key followed by value.
+   * @return Allocated sparse set object.
+   */ \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t d4_sparse_##key_type_name##MS##value_type_name##ME_alloc (d4_err_state_t *state, int line, int col, size_t len, ...); \
+  \
+  /**
+   * Removes all pairs and changes length to zero without affecting capacity and covered range.
+   * @param self Sparse set object to clear.
+   * @return Reference to itself.
+   */ \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t *d4_sparse_##key_type_name##MS##value_type_name##ME_clear (d4_sparse_##key_type_name##MS##value_type_name##ME_t *self); \
+  \
+  /**
+   * Creates a copy of provided sparse set object.
+   * @param self Sparse set object to create copy of.
+   * @return Copy of provided sparse set object.
+   */ \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t d4_sparse_##key_type_name##MS##value_type_name##ME_copy (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Extends index of the sparse set object to cover provided key (used internally), throws error if covered range would exceed D4_SPARSE_MAX_RANGE.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Sparse set object to extend index of.
+   * @param key Key to cover.
+   * @return Offset of the key inside of the index.
+   */ \
+  size_t d4_sparse_##key_type_name##MS##value_type_name##ME_cover (d4_err_state_t *state, int line, int col, d4_sparse_##key_type_name##MS##value_type_name##ME_t *self, const key_type key); \
+  \
+  /**
+   * Checks whether sparse set has any pairs.
+   * @param self Sparse set object to check.
+   * @return Whether sparse set has any pairs.
+   */ \
+  bool d4_sparse_##key_type_name##MS##value_type_name##ME_empty (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Compares whether sparse set object is equal to right-hand sparse set object, order of pairs is not taken into account.
+   * @param self Sparse set object to check.
+   * @param rhs Right-hand sparse set object to check.
+   * @return Whether two sparse set objects are equal.
+   */ \
+  bool d4_sparse_##key_type_name##MS##value_type_name##ME_eq (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self, const d4_sparse_##key_type_name##MS##value_type_name##ME_t rhs); \
+  \
+  /**
+   * Finds position of the pair with provided key (used internally).
+   * @param self Sparse set object to search in.
+   * @param key Key to search for.
+   * @return Position of the pair plus one if found, zero otherwise.
+   */ \
+  size_t d4_sparse_##key_type_name##MS##value_type_name##ME_find (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Deallocates sparse set object.
+   * @param self Sparse set object to deallocate.
+   */ \
+  void d4_sparse_##key_type_name##MS##value_type_name##ME_free (d4_sparse_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Retrieves value by key and throws if key doesn’t exist.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Sparse set object to perform action on.
+   * @param key Key of sparse set object pair to retrieve.
+   * @return Value of found sparse set object pair.
+   */ \
+  value_type d4_sparse_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, const d4_sparse_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Checks whether sparse set object contains a pair with provided key.
+   * @param self Sparse set object to check.
+   * @param key Key of sparse set object pair to check.
+   * @return Whether sparse set object contains a pair with provided key.
+   */ \
+  bool d4_sparse_##key_type_name##MS##value_type_name##ME_has (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self, const key_type key); \
+  \
+  /**
+   * Returns array of sparse set keys in storage order.
+   * @param self Sparse set object to use.
+   * @return Array of sparse set keys.
+   */ \
+  d4_arr_##key_type_name##_t d4_sparse_##key_type_name##MS##value_type_name##ME_keys (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Deallocates current sparse set object and returns a copy of another sparse set object.
+   * @param self Sparse set object to deallocate.
+   * @param rhs Sparse set object to return a copy of.
+   * @return Copy of another sparse set object.
+   */ \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t d4_sparse_##key_type_name##MS##value_type_name##ME_realloc (d4_sparse_##key_type_name##MS##value_type_name##ME_t self, const d4_sparse_##key_type_name##MS##value_type_name##ME_t rhs); \
+  \
+  /**
+   * Removes provided key from the sparse set object and if key doesn’t exist throws error. The last pair is moved into the freed position.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Sparse set object to remove pair from.
+   * @param key Key of the pair to remove.
+   * @return Reference to itself.
+   */ \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t *d4_sparse_##key_type_name##MS##value_type_name##ME_remove (d4_err_state_t *state, int line, int col, d4_sparse_##key_type_name##MS##value_type_name##ME_t *self, const key_type key); \
+  \
+  /**
+   * Reserves a room for a specified number of pairs. Does nothing if the size provided is lower than the current capacity.
+   * @param self Sparse set object to increase capacity of.
+   * @param size New sparse set object capacity.
+   * @return Reference to itself.
+   */ \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t *d4_sparse_##key_type_name##MS##value_type_name##ME_reserve (d4_sparse_##key_type_name##MS##value_type_name##ME_t *self, int32_t size); \
+  \
+  /**
+   * Sets a key inside sparse set object, if key exists - updates its value. Extends index if key is outside of the covered range, throws error if covered range would exceed D4_SPARSE_MAX_RANGE.
+   * @param state Error state to perform action on.
+   * @param line Line where error appeared.
+   * @param col Line column where error appeared.
+   * @param self Sparse set object to set a pair for.
+   * @param key Key of the pair.
+   * @param value Value of the pair.
+   * @return Reference to itself.
+   */ \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t *d4_sparse_##key_type_name##MS##value_type_name##ME_set (d4_err_state_t *state, int line, int col, d4_sparse_##key_type_name##MS##value_type_name##ME_t *self, const key_type key, const value_type value); \
+  \
+  /**
+   * Generates string representation of the sparse set object in the same format as map object.
+   * @param self Sparse set object to generate string representation for.
+   * @return String representation of the sparse set object.
+   */ \
+  d4_str_t d4_sparse_##key_type_name##MS##value_type_name##ME_str (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self); \
+  \
+  /**
+   * Returns array of sparse set values in storage order.
+   * @param self Sparse set object to use.
+   * @return Array of sparse set values.
+   */ \
+  d4_arr_##value_type_name##_t d4_sparse_##key_type_name##MS##value_type_name##ME_values (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self);
+
+#endif
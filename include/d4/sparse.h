@@ -0,0 +1,280 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_SPARSE_H
+#define D4_SPARSE_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "sparse-macro.h"
+#include "array.h"
+
+/**
+ * Macro that can be used to define a sparse set object, should be paired with D4_SPARSE_DECLARE.
+ * @param key_type_name Type name of the key.
+ * @param key_type Key type of the sparse set object, one of integer types.
+ * @param key_alloc_type Key type of the key to be used inside variadic argument (should be cast to int in some cases).
+ * @param key_str_block Block that is used for str method of key.
+ * @param value_type_name Type name of the value.
+ * @param value_type Value type of the sparse set object.
+ * @param value_alloc_type Value type of the value to be used inside variadic argument (should be cast to int in some cases).
+ * @param value_copy_block Block that is used for copy method of value.
+ * @param value_eq_block Block that is used for equals method of value.
+ * @param value_free_block Block that is used for free method of value.
+ * @param value_str_block Block that is used for str method of value.
+ */
+#define D4_SPARSE_DEFINE(key_type_name, key_type, key_alloc_type, key_str_block, value_type_name, value_type, value_alloc_type, value_copy_block, value_eq_block, value_free_block, value_str_block) \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t d4_sparse_##key_type_name##MS##value_type_name##ME_alloc (d4_err_state_t *state, int line, int col, size_t len, ...) { \
+    d4_sparse_##key_type_name##MS##value_type_name##ME_t self = {NULL, NULL, NULL, 0, 0, 0, 0}; \
+    key_type min; \
+    key_type max; \
+    va_list args; \
+    if (len == 0) return self; \
+    va_start(args, len); \
+    min = max = (key_type) va_arg(args, key_alloc_type); \
+    (void) va_arg(args, value_alloc_type); \
+    for (size_t i = 1; i < len; i++) { \
+      const key_type key = va_arg(args, key_alloc_type); \
+      (void) va_arg(args, value_alloc_type); \
+      if (key < min) min = key; \
+      if (key > max) max = key; \
+    } \
+    va_end(args); \
+    if ((uint64_t) max - (uint64_t) min >= D4_SPARSE_MAX_RANGE) { \
+      const key_type key = max; \
+      d4_str_t key_str = key_str_block; \
+      d4_str_t message = d4_str_alloc(L"key '%ls' is out of sparse set range", key_str.data); \
+      d4_error_assign_generic(state, line, col, message); \
+      d4_str_free(message); \
+      d4_str_free(key_str); \
+      longjmp(state->buf_last->buf, state->id); \
+    } \
+    d4_sparse_##key_type_name##MS##value_type_name##ME_reserve(&self, (int32_t) len); \
+    va_start(args, len); \
+    for (size_t i = 0; i < len; i++) { \
+      const key_type key = va_arg(args, key_alloc_type); \
+      const value_type value = va_arg(args, value_alloc_type); \
+      d4_sparse_##key_type_name##MS##value_type_name##ME_set(state, line, col, &self, key, value); \
+    } \
+    va_end(args); \
+    return self; \
+  } \
+  \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t *d4_sparse_##key_type_name##MS##value_type_name##ME_clear (d4_sparse_##key_type_name##MS##value_type_name##ME_t *self) { \
+    for (size_t i = 0; i < self->len; i++) { \
+      value_type val = self->values[i]; \
+      value_free_block; \
+    } \
+    if (self->range != 0) memset(self->index, 0, self->range * sizeof(size_t)); \
+    self->len = 0; \
+    return self; \
+  } \
+  \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t d4_sparse_##key_type_name##MS##value_type_name##ME_copy (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_sparse_##key_type_name##MS##value_type_name##ME_t new_self = {NULL, NULL, NULL, self.min, self.range, self.cap, self.len}; \
+    if (self.cap != 0) { \
+      new_self.keys = d4_safe_alloc(self.cap * sizeof(key_type)); \
+      new_self.values = d4_safe_alloc(self.cap * sizeof(value_type)); \
+      memcpy(new_self.keys, self.keys, self.len * sizeof(key_type)); \
+    } \
+    if (self.range != 0) { \
+      new_self.index = d4_safe_alloc(self.range * sizeof(size_t)); \
+      memcpy(new_self.index, self.index, self.range * sizeof(size_t)); \
+    } \
+    for (size_t i = 0; i < self.len; i++) { \
+      value_type val = self.values[i]; \
+      new_self.values[i] = value_copy_block; \
+    } \
+    return new_self; \
+  } \
+  \
+  size_t d4_sparse_##key_type_name##MS##value_type_name##ME_cover (d4_err_state_t *state, int line, int col, d4_sparse_##key_type_name##MS##value_type_name##ME_t *self, const key_type key) { \
+    uint64_t offset; \
+    size_t new_range; \
+    if (self->range == 0) { \
+      new_range = 0x10; \
+      self->min = key; \
+      self->index = d4_safe_alloc(new_range * sizeof(size_t)); \
+      memset(self->index, 0, new_range * sizeof(size_t)); \
+      self->range = new_range; \
+      return 0; \
+    } \
+    offset = key < self->min ? (uint64_t) self->min - (uint64_t) key : (uint64_t) key - (uint64_t) self->min; \
+    if (key >= self->min && offset < self->range) { \
+      return (size_t) offset; \
+    } else if (key < self->min ? offset > D4_SPARSE_MAX_RANGE - self->range : offset >= D4_SPARSE_MAX_RANGE) { \
+      d4_str_t key_str = key_str_block; \
+      d4_str_t message = d4_str_alloc(L"key '%ls' is out of sparse set range", key_str.data); \
+      d4_error_assign_generic(state, line, col, message); \
+      d4_str_free(message); \
+      d4_str_free(key_str); \
+      longjmp(state->buf_last->buf, state->id); \
+    } else if (key < self->min) { \
+      key_type new_min = (key_type) ((uint64_t) key - self->range); \
+      size_t shift; \
+      if ((uint64_t) key - (uint64_t) new_min != self->range || offset + self->range > D4_SPARSE_MAX_RANGE - self->range) new_min = key; \
+      shift = (size_t) ((uint64_t) self->min - (uint64_t) new_min); \
+      new_range = self->range + shift; \
+      self->index = d4_safe_realloc(self->index, new_range * sizeof(size_t)); \
+      memmove(self->index + shift, self->index, self->range * sizeof(size_t)); \
+      memset(self->index, 0, shift * sizeof(size_t)); \
+      self->min = new_min; \
+      self->range = new_range; \
+    } else { \
+      new_range = self->range * 2 > offset ? self->range * 2 : (size_t) offset + 1; \
+      if (new_range > D4_SPARSE_MAX_RANGE) new_range = D4_SPARSE_MAX_RANGE; \
+      self->index = d4_safe_realloc(self->index, new_range * sizeof(size_t)); \
+      memset(self->index + self->range, 0, (new_range - self->range) * sizeof(size_t)); \
+      self->range = new_range; \
+    } \
+    return (size_t) ((uint64_t) key - (uint64_t) self->min); \
+  } \
+  \
+  bool d4_sparse_##key_type_name##MS##value_type_name##ME_empty (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self) { \
+    return self.len == 0; \
+  } \
+  \
+  bool d4_sparse_##key_type_name##MS##value_type_name##ME_eq (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self, const d4_sparse_##key_type_name##MS##value_type_name##ME_t rhs) { \
+    if (self.len != rhs.len) return false; \
+    for (size_t i = 0; i < self.len; i++) { \
+      size_t position = d4_sparse_##key_type_name##MS##value_type_name##ME_find(rhs, self.keys[i]); \
+      value_type lhs_val; \
+      value_type rhs_val; \
+      if (position == 0) return false; \
+      lhs_val = self.values[i]; \
+      rhs_val = rhs.values[position - 1]; \
+      if (!(value_eq_block)) return false; \
+    } \
+    return true; \
+  } \
+  \
+  size_t d4_sparse_##key_type_name##MS##value_type_name##ME_find (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    uint64_t offset; \
+    if (self.range == 0 || key < self.min) return 0; \
+    offset = (uint64_t) key - (uint64_t) self.min; \
+    return offset < self.range ? self.index[(size_t) offset] : 0; \
+  } \
+  \
+  void d4_sparse_##key_type_name##MS##value_type_name##ME_free (d4_sparse_##key_type_name##MS##value_type_name##ME_t self) { \
+    for (size_t i = 0; i < self.len; i++) { \
+      value_type val = self.values[i]; \
+      value_free_block; \
+    } \
+    d4_safe_free(self.keys); \
+    d4_safe_free(self.values); \
+    d4_safe_free(self.index); \
+  } \
+  \
+  value_type d4_sparse_##key_type_name##MS##value_type_name##ME_get (d4_err_state_t *state, int line, int col, const d4_sparse_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    size_t position = d4_sparse_##key_type_name##MS##value_type_name##ME_find(self, key); \
+    value_type val; \
+    if (position == 0) { \
+      d4_str_t key_str = key_str_block; \
+      d4_str_t message = d4_str_alloc(L"failed to find key '%ls'", key_str.data); \
+      d4_error_assign_generic(state, line, col, message); \
+      d4_str_free(message); \
+      d4_str_free(key_str); \
+      longjmp(state->buf_last->buf, state->id); \
+    } \
+    val = self.values[position - 1]; \
+    return value_copy_block; \
+  } \
+  \
+  bool d4_sparse_##key_type_name##MS##value_type_name##ME_has (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self, const key_type key) { \
+    return d4_sparse_##key_type_name##MS##value_type_name##ME_find(self, key) != 0; \
+  } \
+  \
+  d4_arr_##key_type_name##_t d4_sparse_##key_type_name##MS##value_type_name##ME_keys (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self) { \
+    key_type *data = d4_safe_alloc(self.len * sizeof(key_type)); \
+    if (self.len != 0) memcpy(data, self.keys, self.len * sizeof(key_type)); \
+    return (d4_arr_##key_type_name##_t) {data, self.len}; \
+  } \
+  \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t d4_sparse_##key_type_name##MS##value_type_name##ME_realloc (d4_sparse_##key_type_name##MS##value_type_name##ME_t self, const d4_sparse_##key_type_name##MS##value_type_name##ME_t rhs) { \
+    d4_sparse_##key_type_name##MS##value_type_name##ME_free(self); \
+    return d4_sparse_##key_type_name##MS##value_type_name##ME_copy(rhs); \
+  } \
+  \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t *d4_sparse_##key_type_name##MS##value_type_name##ME_remove (d4_err_state_t *state, int line, int col, d4_sparse_##key_type_name##MS##value_type_name##ME_t *self, const key_type key) { \
+    size_t position = d4_sparse_##key_type_name##MS##value_type_name##ME_find(*self, key); \
+    size_t last; \
+    value_type val; \
+    if (position == 0) { \
+      d4_str_t key_str = key_str_block; \
+      d4_str_t message = d4_str_alloc(L"failed to remove key '%ls'", key_str.data); \
+      d4_error_assign_generic(state, line, col, message); \
+      d4_str_free(message); \
+      d4_str_free(key_str); \
+      longjmp(state->buf_last->buf, state->id); \
+    } \
+    val = self->values[position - 1]; \
+    value_free_block; \
+    last = self->len - 1; \
+    if (position - 1 != last) { \
+      self->keys[position - 1] = self->keys[last]; \
+      self->values[position - 1] = self->values[last]; \
+      self->index[(size_t) ((uint64_t) self->keys[last] - (uint64_t) self->min)] = position; \
+    } \
+    self->index[(size_t) ((uint64_t) key - (uint64_t) self->min)] = 0; \
+    self->len -= 1; \
+    return self; \
+  } \
+  \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t *d4_sparse_##key_type_name##MS##value_type_name##ME_reserve (d4_sparse_##key_type_name##MS##value_type_name##ME_t *self, int32_t size) { \
+    if (size <= 0 || (size_t) size <= self->cap) return self; \
+    self->keys = d4_safe_realloc(self->keys, (size_t) size * sizeof(key_type)); \
+    self->values = d4_safe_realloc(self->values, (size_t) size * sizeof(value_type)); \
+    self->cap = (size_t) size; \
+    return self; \
+  } \
+  \
+  d4_sparse_##key_type_name##MS##value_type_name##ME_t *d4_sparse_##key_type_name##MS##value_type_name##ME_set (d4_err_state_t *state, int line, int col, d4_sparse_##key_type_name##MS##value_type_name##ME_t *self, const key_type key, const value_type value) { \
+    size_t offset = d4_sparse_##key_type_name##MS##value_type_name##ME_cover(state, line, col, self, key); \
+    size_t position = self->index[offset]; \
+    value_type val; \
+    if (position != 0) { \
+      val = self->values[position - 1]; \
+      value_free_block; \
+      val = value; \
+      self->values[position - 1] = value_copy_block; \
+      return self; \
+    } \
+    if (self->len == self->cap) { \
+      d4_sparse_##key_type_name##MS##value_type_name##ME_reserve(self, (int32_t) (self->cap == 0 ? 0x0F : self->cap * 2)); \
+    } \
+    val = value; \
+    self->keys[self->len] = key; \
+    self->values[self->len] = value_copy_block; \
+    self->index[offset] = ++self->len; \
+    return self; \
+  } \
+  \
+  d4_str_t d4_sparse_##key_type_name##MS##value_type_name##ME_str (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self) { \
+    d4_strbuf_t r = d4_strbuf_alloc(0); \
+    d4_strbuf_appendChar(&r, L'{'); \
+    for (size_t i = 0; i < self.len; i++) { \
+      key_type key = self.keys[i]; \
+      value_type val = self.values[i]; \
+      d4_str_t key_str = key_str_block; \
+      if (i != 0) d4_strbuf_append(&r, (d4_str_t) {L", ", 2, true}); \
+      d4_strbuf_appendMove(&r, d4_str_quoted_escape(key_str)); \
+      d4_strbuf_append(&r, (d4_str_t) {L": ", 2, true}); \
+      d4_strbuf_appendMove(&r, value_str_block); \
+      d4_str_free(key_str); \
+    } \
+    d4_strbuf_appendChar(&r, L'}'); \
+    return d4_strbuf_finish(&r); \
+  } \
+  \
+  d4_arr_##value_type_name##_t d4_sparse_##key_type_name##MS##value_type_name##ME_values (const d4_sparse_##key_type_name##MS##value_type_name##ME_t self) { \
+    value_type *data = d4_safe_alloc(self.len * sizeof(value_type)); \
+    for (size_t i = 0; i < self.len; i++) { \
+      value_type val = self.values[i]; \
+      data[i] = value_copy_block; \
+    } \
+    return (d4_arr_##value_type_name##_t) {data, self.len}; \
+  }
+
+#endif
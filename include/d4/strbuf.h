@@ -0,0 +1,96 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_STRBUF_H
+#define D4_STRBUF_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include <stdint.h>
+#include "string.h"
+
+/** Structure representing string buffer, that builds string by appending fragments with geometric growth. */
+typedef struct {
+  /** Data container, reserves one character for null terminator. */
+  wchar_t *data;
+
+  /** Length of the string buffer. */
+  size_t len;
+
+  /** Total allocated number of characters, including null terminator. */
+  size_t cap;
+} d4_strbuf_t;
+
+/**
+ * Allocates empty string buffer.
+ * @param cap Number of characters to reserve, can be 0.
+ * @return Allocated string buffer.
+ */
+d4_strbuf_t d4_strbuf_alloc (size_t cap);
+
+/**
+ * Appends string to the end of string buffer.
+ * @param self String buffer to append to.
+ * @param str String to append.
+ */
+void d4_strbuf_append (d4_strbuf_t *self, const d4_str_t str);
+
+/**
+ * Appends character to the end of string buffer.
+ * @param self String buffer to append to.
+ * @param c Character to append.
+ */
+void d4_strbuf_appendChar (d4_strbuf_t *self, wchar_t c);
+
+/**
+ * Appends string with format specifiers (similar to printf) to the end of string buffer.
+ * @param self String buffer to append to.
+ * @param fmt String that contains text with format specifiers.
+ * @param ... Arguments corresponding to the format specifiers.
+ */
+void d4_strbuf_appendFmt (d4_strbuf_t *self, const wchar_t *fmt, ...);
+
+/**
+ * Appends decimal representation of integer to the end of string buffer.
+ * @param self String buffer to append to.
+ * @param value Integer to append.
+ */
+void d4_strbuf_appendInt (d4_strbuf_t *self, int64_t value);
+
+/**
+ * Appends string to the end of string buffer and deallocates it.
+ * @param self String buffer to append to.
+ * @param str String to append and deallocate.
+ */
+void d4_strbuf_appendMove (d4_strbuf_t *self, d4_str_t str);
+
+/**
+ * Hands data of string buffer over as a string, string buffer is empty afterwards.
+ * @param self String buffer to finish.
+ * @return String with data of string buffer.
+ */
+d4_str_t d4_strbuf_finish (d4_strbuf_t *self);
+
+/**
+ * Deallocates string buffer.
+ * @param self String buffer to deallocate.
+ */
+void d4_strbuf_free (d4_strbuf_t self);
+
+/**
+ * Creates string buffer that continues string, taking ownership of its data, so that appending to it doesn't copy it.
+ * @param self String to continue, must not be used afterwards.
+ * @return String buffer with data of the string.
+ */
+d4_strbuf_t d4_strbuf_from (d4_str_t self);
+
+/**
+ * Makes sure string buffer has room for additional characters without reallocating.
+ * @param self String buffer to reserve room in.
+ * @param additional Number of characters to reserve room for.
+ */
+void d4_strbuf_reserve (d4_strbuf_t *self, size_t additional);
+
+#endif
@@ -12,6 +12,9 @@
 #include <stddef.h>
 #include <wchar.h>
 
+/** Value of is_static of the string object whose data is a shared reference-counted buffer, such string must not be modified. */
+#define D4_STR_SHARED 2
+
 /** Structure representing string object. */
 typedef struct {
   /** String object representation as wide character array. */
@@ -20,8 +23,8 @@ typedef struct {
   /** Length of the string object. */
   size_t len;
 
-  /** Whether string is static. */
-  bool is_static;
+  /** Whether string is static, or D4_STR_SHARED when data is released by dropping a reference. */
+  unsigned char is_static;
 } d4_str_t;
 
 #endif
@@ -12,6 +12,9 @@
 
 D4_ARRAY_DECLARE(str, d4_str_t)
 
+/** Minimum length of the string whose copies are made shared, so that copying them again only increments reference count. */
+#define D4_STR_SHARED_MIN_LEN 64
+
 /** Empty value that can be used when you need to initialize a string. */
 extern d4_str_t d4_str_empty_val;
 
@@ -33,6 +36,19 @@ d4_str_t d4_str_calloc (const wchar_t *self, size_t length);
 
 /**
  * Returns a wide character at specified position in string otherwise throws error if index more than string length.
+ * Character can't be written through returned pointer, use d4_str_atMut for that.
+ * @param state Error state to assign error to.
+ * @param line Source line number.
+ * @param col Source line column.
+ * @param self The string to find a character in.
+ * @param index Character position to search for.
+ * @return Found wide character in a specified string.
+ */
+const wchar_t *d4_str_at (d4_err_state_t *state, int line, int col, const d4_str_t self, int32_t index);
+
+/**
+ * Returns a writable wide character at specified position in string otherwise throws error if index more than string length.
+ * Static strings and shared strings whose buffer is referenced by other copies are copied into own buffer first.
  * @param state Error state to assign error to.
  * @param line Source line number.
  * @param col Source line column.
@@ -40,7 +56,7 @@ d4_str_t d4_str_calloc (const wchar_t *self, size_t length);
  * @param index Character position to search for.
  * @return Found wide character in a specified string.
  */
-wchar_t *d4_str_at (d4_err_state_t *state, int line, int col, const d4_str_t self, int32_t index);
+wchar_t *d4_str_atMut (d4_err_state_t *state, int line, int col, d4_str_t *self, int32_t index);
 
 /**
  * Concatenates two string into one.
@@ -59,9 +75,10 @@ d4_str_t d4_str_concat (const d4_str_t self, const d4_str_t other);
 bool d4_str_contains (const d4_str_t self, const d4_str_t search);
 
 /**
- * Creates deep copy of the string.
+ * Creates copy of the string. Copy of the shared string takes a reference instead of copying data, strings of at least D4_STR_SHARED_MIN_LEN are copied into a shared buffer.
+ * Copy must be modified through d4_str_atMut, which copies shared data on write.
  * @param self String to create copy of.
- * @return Deep copy of the string.
+ * @return Copy of the string.
  */
 d4_str_t d4_str_copy (const d4_str_t self);
 
@@ -109,6 +126,25 @@ int32_t d4_str_find (const d4_str_t self, const d4_str_t search);
  */
 void d4_str_free (d4_str_t self);
 
+/**
+ * Decodes UTF-8 bytes into string and throws if bytes are not valid UTF-8.
+ * @param state Error state to perform action on.
+ * @param line Line where error appeared.
+ * @param col Line column where error appeared.
+ * @param data UTF-8 bytes to decode.
+ * @param len Number of bytes to decode.
+ * @return Decoded string.
+ */
+d4_str_t d4_str_fromUtf8 (d4_err_state_t *state, int line, int col, const char *data, size_t len);
+
+/**
+ * Calculates length of the string that valid UTF-8 bytes decode into, without decoding them.
+ * @param data UTF-8 bytes to calculate length for.
+ * @param len Number of bytes.
+ * @return Length of the decoded string.
+ */
+size_t d4_str_fromUtf8Len (const char *data, size_t len);
+
 /**
  * Checks whether string is greater than or equal to right-hand string.
  * @param self String to compare.
@@ -197,6 +233,13 @@ d4_str_t d4_str_realloc (d4_str_t self, const d4_str_t rhs);
  */
 d4_str_t d4_str_replace (const d4_str_t self, const d4_str_t search, const d4_str_t replacement, unsigned char o3, int32_t count);
 
+/**
+ * Turns string into a shared reference-counted string, so that its copies don't copy data. Shared strings are released with d4_str_free and must not be modified.
+ * @param self String to share, must not be used afterwards.
+ * @return Shared string, or self if string is empty, static or already shared.
+ */
+d4_str_t d4_str_share (d4_str_t self);
+
 /**
  * Creates and returns slice of the string.
  * @param self String to take slice of.
@@ -217,6 +260,16 @@ d4_str_t d4_str_slice (const d4_str_t self, unsigned char o1, int32_t start, uns
  */
 d4_arr_str_t d4_str_split (const d4_str_t self, unsigned char o1, const d4_str_t delimiter);
 
+/**
+ * Splits string into at most n strings by provided delimiter, the last string holds the rest unsplit.
+ * @param self String to split.
+ * @param o1 Whether `delimiter` parameter is specified.
+ * @param delimiter Delimiter substring to split string by.
+ * @param n Maximum number of strings.
+ * @return String split into array of string.
+ */
+d4_arr_str_t d4_str_splitN (const d4_str_t self, unsigned char o1, const d4_str_t delimiter, size_t n);
+
 /**
  * Checks whether string starts with provided substring.
  * @param self String to check.
@@ -375,6 +428,21 @@ uint32_t d4_str_toU32 (d4_err_state_t *state, int line, int col, const d4_str_t
  */
 uint64_t d4_str_toU64 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix);
 
+/**
+ * Encodes string into UTF-8 bytes, unpaired surrogates and invalid characters are encoded as U+FFFD.
+ * @param self String to encode.
+ * @param buf Buffer to write bytes into, should fit d4_str_toUtf8Len bytes, null terminator is not written.
+ * @return Number of written bytes.
+ */
+size_t d4_str_toUtf8 (const d4_str_t self, char *buf);
+
+/**
+ * Calculates number of bytes that string encodes into as UTF-8, without encoding it.
+ * @param self String to calculate number of bytes for.
+ * @return Number of bytes.
+ */
+size_t d4_str_toUtf8Len (const d4_str_t self);
+
 /**
  * Creates and returns string with whitespaces removed from both ends of the string provided.
  * @param self String to remove whitespace from.
@@ -0,0 +1,116 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_STRPACK_H
+#define D4_STRPACK_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include <stdint.h>
+#include "string.h"
+
+/** Kind of the packed string whose characters are all below 0x100, stored in one byte each. */
+#define D4_STRPACK_LATIN1 1
+
+/** Kind of the packed string whose characters are all below 0x10000, stored in two bytes each. */
+#define D4_STRPACK_UCS2 2
+
+/** Kind of the packed string with characters of any value, stored in four bytes each. */
+#define D4_STRPACK_UCS4 4
+
+/**
+ * Structure representing packed string, compact storage of the string that takes as many bytes per character as its widest character needs.
+ * Kind is always the narrowest one that fits, so packed strings of different kinds are never equal.
+ */
+typedef struct {
+  /** Characters of the packed string, each taking kind bytes, not null terminated. */
+  void *data;
+
+  /** Length of the packed string in characters. */
+  size_t len;
+
+  /** Number of bytes every character takes, one of D4_STRPACK_LATIN1, D4_STRPACK_UCS2 or D4_STRPACK_UCS4. */
+  unsigned char kind;
+} d4_strpack_t;
+
+/**
+ * Gets character of the packed string.
+ * @param self Packed string to get character of.
+ * @param index Index of the character, must be less than length.
+ * @return Character at the index.
+ */
+uint32_t d4_strpack_at (const d4_strpack_t self, size_t index);
+
+/**
+ * Concatenates two packed strings, result takes the wider kind of the two.
+ * @param self First packed string to concatenate.
+ * @param other Second packed string to concatenate.
+ * @return Concatenated packed string.
+ */
+d4_strpack_t d4_strpack_concat (const d4_strpack_t self, const d4_strpack_t other);
+
+/**
+ * Creates a copy of the packed string.
+ * @param self Packed string to copy.
+ * @return Copy of the packed string.
+ */
+d4_strpack_t d4_strpack_copy (const d4_strpack_t self);
+
+/**
+ * Checks whether two packed strings are equal.
+ * @param self First packed string to compare.
+ * @param rhs Second packed string to compare.
+ * @return Whether two packed strings are equal.
+ */
+bool d4_strpack_eq (const d4_strpack_t self, const d4_strpack_t rhs);
+
+/**
+ * Finds packed string in a packed string.
+ * @param self Packed string to search in.
+ * @param search Packed string to search for.
+ * @return Position of found packed string, -1 otherwise.
+ */
+int32_t d4_strpack_find (const d4_strpack_t self, const d4_strpack_t search);
+
+/**
+ * Deallocates packed string.
+ * @param self Packed string to deallocate.
+ */
+void d4_strpack_free (d4_strpack_t self);
+
+/**
+ * Packs string into the narrowest kind that fits all of its characters.
+ * @param str String to pack.
+ * @return Packed string.
+ */
+d4_strpack_t d4_strpack_from (const d4_str_t str);
+
+/**
+ * Hashes packed string, the result is the same as d4_map_hash gives for the unpacked string.
+ * @param self Packed string to hash.
+ * @param cap Capacity of the map to calculate index for.
+ * @return Index inside of the map.
+ */
+size_t d4_strpack_hash (const d4_strpack_t self, size_t cap);
+
+/**
+ * Creates slice of the packed string, result is narrowed to the kind of the sliced characters.
+ * @param self Packed string to take slice of.
+ * @param o1 Whether `start` parameter is specified.
+ * @param start Start of the slice.
+ * @param o2 Whether `end` parameter is specified.
+ * @param end End of the slice.
+ * @return Slice of the packed string provided.
+ */
+d4_strpack_t d4_strpack_slice (const d4_strpack_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end);
+
+/**
+ * Unpacks packed string into a new string.
+ * @param self Packed string to unpack.
+ * @return String with characters of the packed string.
+ */
+d4_str_t d4_strpack_toStr (const d4_strpack_t self);
+
+#endif
@@ -0,0 +1,192 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_STRVIEW_H
+#define D4_STRVIEW_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "string.h"
+
+/** Structure representing string view, a borrowed part of the string that is never allocated or deallocated. */
+typedef struct {
+  /** Start of the viewed characters, not null terminated. */
+  const wchar_t *data;
+
+  /** Length of the string view. */
+  size_t len;
+} d4_strview_t;
+
+/** Structure representing cursor that yields pieces of the string view one at a time, see d4_strview_splitIter and d4_strview_linesIter. */
+typedef struct {
+  /** String view that is being split. */
+  d4_strview_t view;
+
+  /** Delimiter to split by, unused when splitting into lines. */
+  d4_strview_t delimiter;
+
+  /** Position of the next piece in the string view. */
+  size_t pos;
+
+  /** Whether cursor splits into lines instead of splitting by delimiter. */
+  bool lines;
+
+  /** Whether line breaks are kept in lines. */
+  bool keepLineBreaks;
+
+  /** Whether all pieces were yielded. */
+  bool done;
+} d4_strview_iter_t;
+
+D4_ARRAY_DECLARE(strview, d4_strview_t)
+
+/**
+ * Checks whether string view contains search string view.
+ * @param self String view to search in.
+ * @param search String view to search for.
+ * @return Whether string view contains search string view.
+ */
+bool d4_strview_contains (const d4_strview_t self, const d4_strview_t search);
+
+/**
+ * Checks whether string view ends with search string view.
+ * @param self String view to check.
+ * @param search String view to search for.
+ * @return Whether string view ends with search string view.
+ */
+bool d4_strview_endsWith (const d4_strview_t self, const d4_strview_t search);
+
+/**
+ * Checks whether two string views contain the same characters.
+ * @param self First string view to compare.
+ * @param rhs Second string view to compare.
+ * @return Whether two string views are equal.
+ */
+bool d4_strview_eq (const d4_strview_t self, const d4_strview_t rhs);
+
+/**
+ * Finds string view in a string view.
+ * @param self String view to search in.
+ * @param search String view to search for.
+ * @return Position of found string view, -1 otherwise.
+ */
+int32_t d4_strview_find (const d4_strview_t self, const d4_strview_t search);
+
+/**
+ * Creates string view of the whole string, string must not be modified or deallocated while view is used.
+ * @param str String to view.
+ * @return String view of the string.
+ */
+d4_strview_t d4_strview_from (const d4_str_t str);
+
+/**
+ * Yields next piece of the cursor.
+ * @param self Cursor to advance.
+ * @param piece Pointer to store the next piece into.
+ * @return Whether piece was yielded, false when cursor has no pieces left.
+ */
+bool d4_strview_iter_next (d4_strview_iter_t *self, d4_strview_t *piece);
+
+/**
+ * Returns part of the string view that cursor didn't yield yet.
+ * @param self Cursor to take remaining part of.
+ * @return Remaining part of the string view.
+ */
+d4_strview_t d4_strview_iter_rest (const d4_strview_iter_t self);
+
+/**
+ * Splits string view by new line into array of string views.
+ * @param self String view to split into lines.
+ * @param o1 Whether `keepLineBreaks` parameter is specified.
+ * @param keepLineBreaks Whether to keep line breaks in resulting array.
+ * @return Split by new line array of string views.
+ */
+d4_arr_strview_t d4_strview_lines (const d4_strview_t self, unsigned char o1, bool keepLineBreaks);
+
+/**
+ * Creates cursor that yields lines of the string view one at a time, the same pieces as d4_strview_lines does.
+ * @param self String view to split into lines.
+ * @param o1 Whether `keepLineBreaks` parameter is specified.
+ * @param keepLineBreaks Whether to keep line breaks in yielded lines.
+ * @return Cursor over lines of the string view.
+ */
+d4_strview_iter_t d4_strview_linesIter (const d4_strview_t self, unsigned char o1, bool keepLineBreaks);
+
+/**
+ * Creates slice of the string view without copying.
+ * @param self String view to take slice of.
+ * @param o1 Whether `start` parameter is specified.
+ * @param start Start of the slice.
+ * @param o2 Whether `end` parameter is specified.
+ * @param end End of the slice.
+ * @return Slice of the string view provided.
+ */
+d4_strview_t d4_strview_slice (const d4_strview_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end);
+
+/**
+ * Splits string view into array of string views by provided delimiter.
+ * @param self String view to split.
+ * @param o1 Whether `delimiter` parameter is specified.
+ * @param delimiter Delimiter string view to split string view by.
+ * @return String view split into array of string views.
+ */
+d4_arr_strview_t d4_strview_split (const d4_strview_t self, unsigned char o1, const d4_strview_t delimiter);
+
+/**
+ * Creates cursor that yields pieces of the string view split by delimiter one at a time, the same pieces as d4_strview_split does.
+ * @param self String view to split.
+ * @param o1 Whether `delimiter` parameter is specified.
+ * @param delimiter Delimiter string view to split string view by.
+ * @return Cursor over pieces of the string view.
+ */
+d4_strview_iter_t d4_strview_splitIter (const d4_strview_t self, unsigned char o1, const d4_strview_t delimiter);
+
+/**
+ * Splits string view into at most n string views by provided delimiter, the last string view holds the rest unsplit.
+ * @param self String view to split.
+ * @param o1 Whether `delimiter` parameter is specified.
+ * @param delimiter Delimiter string view to split string view by.
+ * @param n Maximum number of string views.
+ * @return String view split into array of string views.
+ */
+d4_arr_strview_t d4_strview_splitN (const d4_strview_t self, unsigned char o1, const d4_strview_t delimiter, size_t n);
+
+/**
+ * Checks whether string view starts with search string view.
+ * @param self String view to check.
+ * @param search String view to search for.
+ * @return Whether string view starts with search string view.
+ */
+bool d4_strview_startsWith (const d4_strview_t self, const d4_strview_t search);
+
+/**
+ * Copies characters of the string view into a new string.
+ * @param self String view to copy.
+ * @return String with characters of the string view.
+ */
+d4_str_t d4_strview_toOwned (const d4_strview_t self);
+
+/**
+ * Creates string view with whitespaces removed from both ends of the string view provided.
+ * @param self String view to remove whitespace from.
+ * @return String view without whitespaces at both ends.
+ */
+d4_strview_t d4_strview_trim (const d4_strview_t self);
+
+/**
+ * Creates string view with whitespaces removed from the end of the string view provided.
+ * @param self String view to remove whitespace from.
+ * @return String view without whitespaces at the end.
+ */
+d4_strview_t d4_strview_trimEnd (const d4_strview_t self);
+
+/**
+ * Creates string view with whitespaces removed from the start of the string view provided.
+ * @param self String view to remove whitespace from.
+ * @return String view without whitespaces at the start.
+ */
+d4_strview_t d4_strview_trimStart (const d4_strview_t self);
+
+#endif
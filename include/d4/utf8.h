@@ -0,0 +1,256 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef D4_UTF8_H
+#define D4_UTF8_H
+
+/* See https://github.com/thelang-io/libd4 for reference. */
+
+#include "string.h"
+
+/** Structure representing UTF-8 string object, that keeps text in the encoding it is read and written in. */
+typedef struct {
+  /** UTF-8 encoded bytes of the string object, null terminated. */
+  char *data;
+
+  /** Length of the string object in bytes. */
+  size_t len;
+
+  /** Whether string is static. */
+  bool is_static;
+} d4_utf8_t;
+
+D4_ARRAY_DECLARE(utf8, d4_utf8_t)
+
+/** Empty value that can be used when you need to initialize a UTF-8 string. */
+extern d4_utf8_t d4_utf8_empty_val;
+
+/**
+ * Allocates UTF-8 string with format specifiers (similar to printf).
+ * @param fmt String that contains text with format specifiers.
+ * @param ... Arguments corresponding to the format specifiers.
+ * @return Newly allocated UTF-8 string.
+ */
+d4_utf8_t d4_utf8_alloc (const char *fmt, ...);
+
+/**
+ * Allocates UTF-8 string from bytes of specified size.
+ * @param self Bytes to copy data from.
+ * @param length Number of bytes that need to be copied.
+ * @return Newly allocated UTF-8 string.
+ */
+d4_utf8_t d4_utf8_calloc (const char *self, size_t length);
+
+/**
+ * Concatenates two UTF-8 strings.
+ * @param self First UTF-8 string to concatenate.
+ * @param other Second UTF-8 string to concatenate.
+ * @return Concatenated UTF-8 string.
+ */
+d4_utf8_t d4_utf8_concat (const d4_utf8_t self, const d4_utf8_t other);
+
+/**
+ * Checks whether UTF-8 string contains search UTF-8 string.
+ * @param self UTF-8 string to search in.
+ * @param search UTF-8 string to search for.
+ * @return Whether UTF-8 string contains search UTF-8 string.
+ */
+bool d4_utf8_contains (const d4_utf8_t self, const d4_utf8_t search);
+
+/**
+ * Creates a copy of the UTF-8 string.
+ * @param self UTF-8 string to copy.
+ * @return Copy of the UTF-8 string.
+ */
+d4_utf8_t d4_utf8_copy (const d4_utf8_t self);
+
+/**
+ * Checks whether UTF-8 string is empty.
+ * @param self UTF-8 string to check.
+ * @return Whether UTF-8 string is empty.
+ */
+bool d4_utf8_empty (const d4_utf8_t self);
+
+/**
+ * Checks whether UTF-8 string ends with search UTF-8 string.
+ * @param self UTF-8 string to check.
+ * @param search UTF-8 string to search for.
+ * @return Whether UTF-8 string ends with search UTF-8 string.
+ */
+bool d4_utf8_endsWith (const d4_utf8_t self, const d4_utf8_t search);
+
+/**
+ * Checks whether two UTF-8 strings are equal.
+ * @param self First UTF-8 string to compare.
+ * @param rhs Second UTF-8 string to compare.
+ * @return Whether two UTF-8 strings are equal.
+ */
+bool d4_utf8_eq (const d4_utf8_t self, const d4_utf8_t rhs);
+
+/**
+ * Escapes UTF-8 string the same way d4_str_escape does.
+ * @param self UTF-8 string to escape.
+ * @return Escaped UTF-8 string.
+ */
+d4_utf8_t d4_utf8_escape (const d4_utf8_t self);
+
+/**
+ * Finds UTF-8 string in a UTF-8 string.
+ * @param self UTF-8 string to search in.
+ * @param search UTF-8 string to search for.
+ * @return Position of found UTF-8 string in characters, -1 otherwise.
+ */
+int32_t d4_utf8_find (const d4_utf8_t self, const d4_utf8_t search);
+
+/**
+ * Deallocates UTF-8 string.
+ * @param self UTF-8 string to deallocate.
+ */
+void d4_utf8_free (d4_utf8_t self);
+
+/**
+ * Encodes string into UTF-8 string.
+ * @param str String to encode.
+ * @return Encoded UTF-8 string.
+ */
+d4_utf8_t d4_utf8_fromStr (const d4_str_t str);
+
+/**
+ * Checks whether UTF-8 string is greater than or equal to right-hand UTF-8 string, comparing by code points.
+ * @param self UTF-8 string to compare.
+ * @param rhs UTF-8 string to compare.
+ * @return Whether UTF-8 string is greater or equal than right-hand UTF-8 string.
+ */
+bool d4_utf8_ge (const d4_utf8_t self, const d4_utf8_t rhs);
+
+/**
+ * Checks whether UTF-8 string is greater than right-hand UTF-8 string, comparing by code points.
+ * @param self UTF-8 string to compare.
+ * @param rhs UTF-8 string to compare.
+ * @return Whether UTF-8 string is greater than right-hand UTF-8 string.
+ */
+bool d4_utf8_gt (const d4_utf8_t self, const d4_utf8_t rhs);
+
+/**
+ * Checks whether UTF-8 string is less than or equal to right-hand UTF-8 string, comparing by code points.
+ * @param self UTF-8 string to compare.
+ * @param rhs UTF-8 string to compare.
+ * @return Whether UTF-8 string is less or equal than right-hand UTF-8 string.
+ */
+bool d4_utf8_le (const d4_utf8_t self, const d4_utf8_t rhs);
+
+/**
+ * Counts characters of the UTF-8 string.
+ * @param self UTF-8 string to count characters of.
+ * @return Number of characters.
+ */
+size_t d4_utf8_len (const d4_utf8_t self);
+
+/**
+ * Splits UTF-8 string by new line into array of UTF-8 strings.
+ * @param self UTF-8 string to split into lines.
+ * @param o1 Whether `keepLineBreaks` parameter is specified.
+ * @param keepLineBreaks Whether to keep line breaks in resulting array.
+ * @return Split by new line array of UTF-8 strings.
+ */
+d4_arr_utf8_t d4_utf8_lines (const d4_utf8_t self, unsigned char o1, bool keepLineBreaks);
+
+/**
+ * Converts all characters of the UTF-8 string to lower case.
+ * @param self UTF-8 string to convert.
+ * @return UTF-8 string in lower case.
+ */
+d4_utf8_t d4_utf8_lower (const d4_utf8_t self);
+
+/**
+ * Checks whether UTF-8 string is less than right-hand UTF-8 string, comparing by code points.
+ * @param self UTF-8 string to compare.
+ * @param rhs UTF-8 string to compare.
+ * @return Whether UTF-8 string is less than right-hand UTF-8 string.
+ */
+bool d4_utf8_lt (const d4_utf8_t self, const d4_utf8_t rhs);
+
+/**
+ * Checks whether UTF-8 string is empty.
+ * @param self UTF-8 string to check.
+ * @return Whether UTF-8 string is empty.
+ */
+bool d4_utf8_not (const d4_utf8_t self);
+
+/**
+ * Replaces search pattern with replacement in UTF-8 string provided.
+ * @param self UTF-8 string to replace in.
+ * @param search UTF-8 string to search for.
+ * @param replacement UTF-8 string to replace with.
+ * @param o3 Whether `count` parameter is specified.
+ * @param count How many occurrences to replace. If less than or equal to zero - then it will act as if parameter was not passed.
+ * @return UTF-8 string with replaced search pattern.
+ */
+d4_utf8_t d4_utf8_replace (const d4_utf8_t self, const d4_utf8_t search, const d4_utf8_t replacement, unsigned char o3, int32_t count);
+
+/**
+ * Creates slice of the UTF-8 string, start and end are in characters.
+ * @param self UTF-8 string to take slice of.
+ * @param o1 Whether `start` parameter is specified.
+ * @param start Start of the slice.
+ * @param o2 Whether `end` parameter is specified.
+ * @param end End of the slice.
+ * @return Slice of the UTF-8 string provided.
+ */
+d4_utf8_t d4_utf8_slice (const d4_utf8_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end);
+
+/**
+ * Splits UTF-8 string into array of UTF-8 strings by provided delimiter.
+ * @param self UTF-8 string to split.
+ * @param o1 Whether `delimiter` parameter is specified.
+ * @param delimiter Delimiter UTF-8 string to split by, empty delimiter splits into characters.
+ * @return UTF-8 string split into array of UTF-8 strings.
+ */
+d4_arr_utf8_t d4_utf8_split (const d4_utf8_t self, unsigned char o1, const d4_utf8_t delimiter);
+
+/**
+ * Checks whether UTF-8 string starts with search UTF-8 string.
+ * @param self UTF-8 string to check.
+ * @param search UTF-8 string to search for.
+ * @return Whether UTF-8 string starts with search UTF-8 string.
+ */
+bool d4_utf8_startsWith (const d4_utf8_t self, const d4_utf8_t search);
+
+/**
+ * Decodes UTF-8 string into string, invalid sequences are decoded as U+FFFD.
+ * @param self UTF-8 string to decode.
+ * @return Decoded string.
+ */
+d4_str_t d4_utf8_str (const d4_utf8_t self);
+
+/**
+ * Removes whitespaces from both ends of the UTF-8 string provided.
+ * @param self UTF-8 string to remove whitespace from.
+ * @return UTF-8 string without whitespaces at both ends.
+ */
+d4_utf8_t d4_utf8_trim (const d4_utf8_t self);
+
+/**
+ * Removes whitespaces from the end of the UTF-8 string provided.
+ * @param self UTF-8 string to remove whitespace from.
+ * @return UTF-8 string without whitespaces at the end.
+ */
+d4_utf8_t d4_utf8_trimEnd (const d4_utf8_t self);
+
+/**
+ * Removes whitespaces from the start of the UTF-8 string provided.
+ * @param self UTF-8 string to remove whitespace from.
+ * @return UTF-8 string without whitespaces at the start.
+ */
+d4_utf8_t d4_utf8_trimStart (const d4_utf8_t self);
+
+/**
+ * Converts all characters of the UTF-8 string to upper case.
+ * @param self UTF-8 string to convert.
+ * @return UTF-8 string in upper case.
+ */
+d4_utf8_t d4_utf8_upper (const d4_utf8_t self);
+
+#endif
@@ -51,8 +51,8 @@ d4_str_t d4_char_repeat (char self, int32_t times) {
 }
 
 d4_str_t d4_char_str (char self) {
-  wchar_t buf[2] = {self, '\0'};
-  return d4_str_alloc(buf);
+  wchar_t c = self;
+  return c == L'\0' ? d4_str_empty_val : d4_str_calloc(&c, 1);
 }
 
 char d4_char_upper (char self) {
@@ -26,35 +26,29 @@ static void print_func (D4_UNUSED void *ctx, void *params) {
   d4_str_t terminator = p->o2 == 0 ? (d4_str_t) {D4_EOL, D4_EOL_LEN, true} : p->n2;
   FILE *stream = d4_str_eq(p->n3, (d4_str_t) {L"stderr", 6, true}) ? stderr : stdout;
   int stream_fd = fileno(stream);
-  d4_str_t result = d4_str_empty_val;
-  d4_str_t t1;
+  d4_strbuf_t builder = d4_strbuf_alloc(0);
+  d4_str_t result;
   size_t buf_len;
   char *buf;
 
   for (size_t i = 0; i < p->n0.len; i++) {
-    d4_str_t param_str = d4_any_str(p->n0.data[i]);
-    if (i != 0) {
-      result = d4_str_realloc(result, t1 = d4_str_concat(result, separator));
-      d4_str_free(t1);
-    }
-    result = d4_str_realloc(result, t1 = d4_str_concat(result, param_str));
-    d4_str_free(t1);
-    d4_str_free(param_str);
+    if (i != 0) d4_strbuf_append(&builder, separator);
+    d4_strbuf_appendMove(&builder, d4_any_str(p->n0.data[i]));
   }
 
-  result = d4_str_realloc(result, t1 = d4_str_concat(result, terminator));
-  d4_str_free(t1);
+  d4_strbuf_append(&builder, terminator);
+  result = d4_strbuf_finish(&builder);
 
-  buf_len = wcstombs(NULL, result.data, 0) + 1;
-  buf = d4_safe_alloc(buf_len);
-  wcstombs(buf, result.data, buf_len);
+  buf_len = d4_str_toUtf8Len(result);
+  buf = d4_safe_alloc(buf_len + 1);
+  d4_str_toUtf8(result, buf);
 
   #if defined(D4_OS_WINDOWS)
     _setmode(stream_fd, _O_BINARY);
-    _write(stream_fd, buf, result.len);
+    _write(stream_fd, buf, (unsigned int) buf_len);
     _setmode(stream_fd, _O_TEXT);
   #else
-    write(stream_fd, buf, result.len);
+    write(stream_fd, buf, buf_len);
   #endif
 
   d4_safe_free(buf);
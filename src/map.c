@@ -3,7 +3,16 @@
  * Licensed under the MIT License
  */
 
+#include "../include/d4/macro.h"
 #include "map.h"
+#include <time.h>
+#include "../include/d4/rand.h"
+
+#if defined(D4_OS_WINDOWS)
+  #include <windows.h>
+#else
+  #include <pthread.h>
+#endif
 
 /*
  * Load factor of 0.75 provides a good balance between space efficiency
@@ -11,6 +20,122 @@
  */
 const double D4_MAP_LOAD_FACTOR = 0.75;
 
+/* Load factor below which maps are reallocated to a smaller capacity after bulk removal. */
+static double d4_map_low_water = 0.125;
+
+/* Global map counters, guarded by lock since reallocations can happen on any thread. */
+static bool d4_map_counters_enabled = false;
+static d4_map_counters_t d4_map_counters_val = {0, 0, 0, 0};
+
+#if defined(D4_OS_WINDOWS)
+  static SRWLOCK d4_map_counters_lock = SRWLOCK_INIT;
+#else
+  static pthread_mutex_t d4_map_counters_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* Per-process key of the seeded hash, populated once on first use. */
+static uint64_t d4_map_hash_k0;
+static uint64_t d4_map_hash_k1;
+
+#if defined(D4_OS_WINDOWS)
+  static INIT_ONCE d4_map_hash_key_once = INIT_ONCE_STATIC_INIT;
+#else
+  static pthread_once_t d4_map_hash_key_once = PTHREAD_ONCE_INIT;
+#endif
+
+static void d4_map_hash_key_set (const unsigned char *key) {
+  d4_map_hash_k0 = 0;
+  d4_map_hash_k1 = 0;
+
+  for (size_t i = 0; i < 8; i++) {
+    d4_map_hash_k0 |= (uint64_t) key[i] << (i * 8);
+    d4_map_hash_k1 |= (uint64_t) key[i + 8] << (i * 8);
+  }
+}
+
+static void d4_map_hash_key_generate (void) {
+  unsigned char key[16];
+
+  if (RAND_bytes(key, sizeof(key)) != 1) {
+    // LCOV_EXCL_START
+    uint64_t fallback = (uint64_t) time(NULL) ^ ((uint64_t) clock() << 32) ^ (uint64_t) (uintptr_t) &fallback;
+
+    for (size_t i = 0; i < sizeof(key); i++) {
+      fallback = fallback * 0x5851f42d4c957f2d + 0x14057b7ef767814f;
+      key[i] = (unsigned char) (fallback >> 56);
+    }
+    // LCOV_EXCL_STOP
+  }
+
+  d4_map_hash_key_set(key);
+}
+
+#if defined(D4_OS_WINDOWS)
+  static BOOL CALLBACK d4_map_hash_key_generate_once (D4_UNUSED PINIT_ONCE once, D4_UNUSED PVOID param, D4_UNUSED PVOID *ctx) {
+    d4_map_hash_key_generate();
+    return TRUE;
+  }
+#endif
+
+static void d4_map_hash_key_init (void) {
+  #if defined(D4_OS_WINDOWS)
+    InitOnceExecuteOnce(&d4_map_hash_key_once, d4_map_hash_key_generate_once, NULL, NULL);
+  #else
+    pthread_once(&d4_map_hash_key_once, d4_map_hash_key_generate);
+  #endif
+}
+
+static void d4_map_counters_lock_acquire (void) {
+  #if defined(D4_OS_WINDOWS)
+    AcquireSRWLockExclusive(&d4_map_counters_lock);
+  #else
+    pthread_mutex_lock(&d4_map_counters_lock);
+  #endif
+}
+
+static void d4_map_counters_lock_release (void) {
+  #if defined(D4_OS_WINDOWS)
+    ReleaseSRWLockExclusive(&d4_map_counters_lock);
+  #else
+    pthread_mutex_unlock(&d4_map_counters_lock);
+  #endif
+}
+
+static double d4_map_counters_now (void) {
+  #if defined(D4_OS_WINDOWS)
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double) counter.QuadPart / (double) frequency.QuadPart;
+  #else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+  #endif
+}
+
+static uint64_t d4_map_rotl (uint64_t x, int b) {
+  return (x << b) | (x >> (64 - b));
+}
+
+static void d4_map_sipround (uint64_t *v) {
+  v[0] += v[1];
+  v[1] = d4_map_rotl(v[1], 13);
+  v[1] ^= v[0];
+  v[0] = d4_map_rotl(v[0], 32);
+  v[2] += v[3];
+  v[3] = d4_map_rotl(v[3], 16);
+  v[3] ^= v[2];
+  v[0] += v[3];
+  v[3] = d4_map_rotl(v[3], 21);
+  v[3] ^= v[0];
+  v[2] += v[1];
+  v[1] = d4_map_rotl(v[1], 17);
+  v[1] ^= v[2];
+  v[2] = d4_map_rotl(v[2], 32);
+}
+
 size_t d4_map_calc_cap (size_t cap, size_t len) {
   while (d4_map_should_reserve(cap, len)) {
     cap *= 2;
@@ -19,6 +144,47 @@ size_t d4_map_calc_cap (size_t cap, size_t len) {
   return cap;
 }
 
+void d4_map_counters_enable (bool enable) {
+  d4_map_counters_lock_acquire();
+  d4_map_counters_enabled = enable;
+  d4_map_counters_lock_release();
+}
+
+d4_map_counters_t d4_map_counters_get (void) {
+  d4_map_counters_t result;
+  d4_map_counters_lock_acquire();
+  result = d4_map_counters_val;
+  d4_map_counters_lock_release();
+  return result;
+}
+
+void d4_map_counters_reset (void) {
+  d4_map_counters_lock_acquire();
+  d4_map_counters_val = (d4_map_counters_t) {0, 0, 0, 0};
+  d4_map_counters_lock_release();
+}
+
+double d4_map_counters_resize_start (void) {
+  bool enabled;
+  d4_map_counters_lock_acquire();
+  enabled = d4_map_counters_enabled;
+  d4_map_counters_lock_release();
+  return enabled ? d4_map_counters_now() : -1;
+}
+
+void d4_map_counters_resize_end (double start, size_t pairs) {
+  double elapsed;
+  if (start < 0) return;
+  elapsed = d4_map_counters_now() - start;
+
+  d4_map_counters_lock_acquire();
+  d4_map_counters_val.resizes += 1;
+  d4_map_counters_val.rehashed_pairs += pairs;
+  d4_map_counters_val.resize_time += elapsed;
+  if (elapsed > d4_map_counters_val.longest_resize_time) d4_map_counters_val.longest_resize_time = elapsed;
+  d4_map_counters_lock_release();
+}
+
 size_t d4_map_hash (d4_str_t id, size_t cap) {
   size_t result = 0xcbf29ce484222325;
 
@@ -30,6 +196,63 @@ size_t d4_map_hash (d4_str_t id, size_t cap) {
   return result % cap;
 }
 
+size_t d4_map_hash_int (uint64_t key, size_t cap) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccd;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53;
+  key ^= key >> 33;
+
+  return (size_t) (key % cap);
+}
+
+void d4_map_hash_seed (const unsigned char *key) {
+  d4_map_hash_key_init();
+  d4_map_hash_key_set(key);
+}
+
+size_t d4_map_hash_seeded (d4_str_t id, size_t cap) {
+  uint64_t v[4];
+  uint64_t b = (uint64_t) (id.len * 4) << 56;
+  size_t i = 0;
+
+  d4_map_hash_key_init();
+  v[0] = d4_map_hash_k0 ^ 0x736f6d6570736575;
+  v[1] = d4_map_hash_k1 ^ 0x646f72616e646f6d;
+  v[2] = d4_map_hash_k0 ^ 0x6c7967656e657261;
+  v[3] = d4_map_hash_k1 ^ 0x7465646279746573;
+
+  /* Every character is fed as 4 little-endian bytes, so two characters make up one SipHash word. */
+  for (; i + 1 < id.len; i += 2) {
+    uint64_t m = (uint64_t) (uint32_t) id.data[i] | ((uint64_t) (uint32_t) id.data[i + 1] << 32);
+    v[3] ^= m;
+    d4_map_sipround(v);
+    v[0] ^= m;
+  }
+
+  if (i < id.len) {
+    b |= (uint64_t) (uint32_t) id.data[i];
+  }
+
+  v[3] ^= b;
+  d4_map_sipround(v);
+  v[0] ^= b;
+  v[2] ^= 0xff;
+  d4_map_sipround(v);
+  d4_map_sipround(v);
+  d4_map_sipround(v);
+
+  return (size_t) (v[0] ^ v[1] ^ v[2] ^ v[3]) % cap;
+}
+
+void d4_map_low_water_set (double ratio) {
+  d4_map_low_water = ratio;
+}
+
 bool d4_map_should_reserve (size_t cap, size_t len) {
   return len >= (size_t) ((double) cap * D4_MAP_LOAD_FACTOR);
 }
+
+bool d4_map_should_shrink (size_t cap, size_t len) {
+  return cap > 0x0F && (double) len < (double) cap * d4_map_low_water;
+}
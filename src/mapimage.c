@@ -0,0 +1,373 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include "mapimage.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/d4/error.h"
+#include "safe.h"
+#include "string.h"
+
+#if defined(D4_OS_WINDOWS)
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+/*
+ * Image layout, all integers are in native byte order, which is checked on open together with sizes of wchar_t and size_t:
+ *   header                  - d4_mapimage_header_t
+ *   buckets                 - buckets_len offsets of the first record in bucket, 0 for empty bucket
+ *   records                 - d4_mapimage_record_header_t followed by key and value bytes
+ * Key and value bytes are padded with at least 4 zero bytes up to 8 bytes boundary, so that
+ * strings are null-terminated and scalars are aligned. Checksum covers records and then buckets.
+ */
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint16_t wchar_size;
+  uint16_t size_size;
+  uint32_t reserved;
+  uint64_t len;
+  uint64_t buckets_len;
+  uint64_t size;
+  uint64_t checksum;
+} d4_mapimage_header_t;
+
+typedef struct {
+  uint64_t hash;
+  uint64_t next;
+  uint64_t key_size;
+  uint64_t value_size;
+} d4_mapimage_record_header_t;
+
+struct d4_mapimage {
+  unsigned char *data;
+  size_t size;
+
+  #if defined(D4_OS_WINDOWS)
+    HANDLE file;
+    HANDLE mapping;
+  #endif
+};
+
+struct d4_mapimage_writer {
+  FILE *file;
+  d4_str_t path;
+  uint64_t *buckets;
+  uint64_t buckets_len;
+  uint64_t len;
+  uint64_t offset;
+  uint64_t checksum;
+  bool failed;
+};
+
+static const char d4_mapimage_magic[8] = {'D', '4', 'M', 'A', 'P', 'I', 'M', 'G'};
+static const unsigned char d4_mapimage_zeros[16] = {0};
+
+#define D4_MAPIMAGE_BYTE_ORDER 0x01020304
+#define D4_MAPIMAGE_CHECKSUM_INIT 0xcbf29ce484222325
+
+static uint64_t d4_mapimage_checksum (uint64_t checksum, const void *data, size_t size) {
+  const unsigned char *bytes = data;
+
+  for (size_t i = 0; i < size; i++) {
+    checksum ^= bytes[i];
+    checksum *= 0x100000001b3;
+  }
+
+  return checksum;
+}
+
+static uint64_t d4_mapimage_padded (uint64_t size) {
+  return (size + 4 + 7) & ~(uint64_t) 7;
+}
+
+static void d4_mapimage_throw (d4_err_state_t *state, int line, int col, const wchar_t *fmt, const d4_str_t path) {
+  d4_str_t message = d4_str_alloc(fmt, path.data);
+  d4_error_assign_generic(state, line, col, message);
+  d4_str_free(message);
+  longjmp(state->buf_last->buf, state->id);
+}
+
+static void d4_mapimage_write_bytes (d4_mapimage_writer_t *self, const void *data, size_t size) {
+  if (size != 0 && fwrite(data, 1, size, self->file) != size) self->failed = true;
+  self->checksum = d4_mapimage_checksum(self->checksum, data, size);
+  self->offset += size;
+}
+
+#if !defined(D4_OS_WINDOWS)
+  static char *d4_mapimage_path (const d4_str_t path) {
+    size_t buf_len = wcstombs(NULL, path.data, 0) + 1;
+    char *buf = d4_safe_alloc(buf_len);
+    wcstombs(buf, path.data, buf_len);
+    return buf;
+  }
+#endif
+
+uint64_t d4_mapimage_bucket (const d4_mapimage_t *self, size_t hash) {
+  const d4_mapimage_header_t *header = (const d4_mapimage_header_t *) self->data;
+  uint64_t offset;
+
+  memcpy(&offset, self->data + sizeof(d4_mapimage_header_t) + (hash % header->buckets_len) * sizeof(uint64_t), sizeof(uint64_t));
+  return offset;
+}
+
+void d4_mapimage_free (d4_mapimage_t *self) {
+  #if defined(D4_OS_WINDOWS)
+    UnmapViewOfFile(self->data);
+    CloseHandle(self->mapping);
+    CloseHandle(self->file);
+  #else
+    munmap(self->data, self->size);
+  #endif
+
+  d4_safe_free(self);
+}
+
+size_t d4_mapimage_len (const d4_mapimage_t *self) {
+  const d4_mapimage_header_t *header = (const d4_mapimage_header_t *) self->data;
+  return (size_t) header->len;
+}
+
+d4_mapimage_t *d4_mapimage_open (d4_err_state_t *state, int line, int col, const d4_str_t path) {
+  d4_mapimage_t *self;
+  const d4_mapimage_header_t *header;
+  unsigned char *data;
+  size_t size;
+
+  #if defined(D4_OS_WINDOWS)
+    HANDLE file = CreateFileW(path.data, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    HANDLE mapping;
+    LARGE_INTEGER file_size;
+
+    if (file == INVALID_HANDLE_VALUE) {
+      d4_mapimage_throw(state, line, col, L"failed to open map image '%ls'", path);
+    } else if (!GetFileSizeEx(file, &file_size) || (uint64_t) file_size.QuadPart < sizeof(d4_mapimage_header_t)) {
+      CloseHandle(file);
+      d4_mapimage_throw(state, line, col, L"invalid map image '%ls'", path);
+    }
+
+    size = (size_t) file_size.QuadPart;
+    mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    data = mapping == NULL ? NULL : MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (data == NULL) {
+      if (mapping != NULL) CloseHandle(mapping);
+      CloseHandle(file);
+      d4_mapimage_throw(state, line, col, L"failed to open map image '%ls'", path);
+    }
+  #else
+    char *path_buf = d4_mapimage_path(path);
+    int fd = open(path_buf, O_RDONLY);
+    struct stat st;
+
+    d4_safe_free(path_buf);
+
+    if (fd == -1) {
+      d4_mapimage_throw(state, line, col, L"failed to open map image '%ls'", path);
+    } else if (fstat(fd, &st) != 0 || (uint64_t) st.st_size < sizeof(d4_mapimage_header_t)) {
+      close(fd);
+      d4_mapimage_throw(state, line, col, L"invalid map image '%ls'", path);
+    }
+
+    size = (size_t) st.st_size;
+    data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+      d4_mapimage_throw(state, line, col, L"failed to open map image '%ls'", path);
+    }
+  #endif
+
+  self = d4_safe_alloc(sizeof(d4_mapimage_t));
+  self->data = data;
+  self->size = size;
+
+  #if defined(D4_OS_WINDOWS)
+    self->file = file;
+    self->mapping = mapping;
+  #endif
+
+  header = (const d4_mapimage_header_t *) data;
+
+  if (
+    memcmp(header->magic, d4_mapimage_magic, sizeof(d4_mapimage_magic)) != 0 ||
+    header->byte_order != D4_MAPIMAGE_BYTE_ORDER ||
+    header->wchar_size != sizeof(wchar_t) ||
+    header->size_size != sizeof(size_t) ||
+    header->size != size ||
+    header->buckets_len == 0 ||
+    header->buckets_len > (size - sizeof(d4_mapimage_header_t)) / sizeof(uint64_t)
+  ) {
+    d4_mapimage_free(self);
+    d4_mapimage_throw(state, line, col, L"invalid map image '%ls'", path);
+  } else if (header->version != D4_MAPIMAGE_VERSION) {
+    d4_mapimage_free(self);
+    d4_mapimage_throw(state, line, col, L"unsupported version of map image '%ls'", path);
+  }
+
+  return self;
+}
+
+bool d4_mapimage_record (const d4_mapimage_t *self, uint64_t offset, d4_mapimage_record_t *record) {
+  const d4_mapimage_header_t *header = (const d4_mapimage_header_t *) self->data;
+  uint64_t records_start = sizeof(d4_mapimage_header_t) + header->buckets_len * sizeof(uint64_t);
+  const d4_mapimage_record_header_t *record_header;
+  uint64_t key_padded;
+  uint64_t value_padded;
+
+  if (offset < records_start || offset % 8 != 0 || offset > self->size - sizeof(d4_mapimage_record_header_t)) {
+    return false;
+  }
+
+  record_header = (const d4_mapimage_record_header_t *) (self->data + offset);
+  offset += sizeof(d4_mapimage_record_header_t);
+
+  if (record_header->key_size > self->size || record_header->value_size > self->size) {
+    return false;
+  }
+
+  key_padded = d4_mapimage_padded(record_header->key_size);
+  value_padded = d4_mapimage_padded(record_header->value_size);
+
+  if (key_padded + value_padded > self->size - offset) {
+    return false;
+  }
+
+  record->hash = (size_t) record_header->hash;
+  record->next = record_header->next;
+  record->key_data = self->data + offset;
+  record->key_size = (size_t) record_header->key_size;
+  record->value_data = self->data + offset + key_padded;
+  record->value_size = (size_t) record_header->value_size;
+
+  return true;
+}
+
+bool d4_mapimage_verify (const d4_mapimage_t *self) {
+  const d4_mapimage_header_t *header = (const d4_mapimage_header_t *) self->data;
+  uint64_t records_start = sizeof(d4_mapimage_header_t) + header->buckets_len * sizeof(uint64_t);
+  uint64_t checksum = D4_MAPIMAGE_CHECKSUM_INIT;
+  uint64_t len = 0;
+
+  checksum = d4_mapimage_checksum(checksum, self->data + records_start, self->size - records_start);
+  checksum = d4_mapimage_checksum(checksum, self->data + sizeof(d4_mapimage_header_t), records_start - sizeof(d4_mapimage_header_t));
+
+  if (checksum != header->checksum) {
+    return false;
+  }
+
+  for (uint64_t i = 0; i < header->buckets_len; i++) {
+    uint64_t offset = d4_mapimage_bucket(self, (size_t) i);
+    d4_mapimage_record_t record;
+
+    while (offset != 0) {
+      if (!d4_mapimage_record(self, offset, &record) || record.hash % header->buckets_len != i || record.next == offset) {
+        return false;
+      }
+
+      offset = record.next;
+      if (++len > header->len) return false;
+    }
+  }
+
+  return len == header->len;
+}
+
+d4_mapimage_writer_t *d4_mapimage_write_begin (d4_err_state_t *state, int line, int col, const d4_str_t path, size_t buckets_len) {
+  d4_mapimage_writer_t *self;
+  FILE *file;
+
+  #if defined(D4_OS_WINDOWS)
+    file = _wfopen(path.data, L"wb");
+  #else
+    char *path_buf = d4_mapimage_path(path);
+    file = fopen(path_buf, "wb");
+    d4_safe_free(path_buf);
+  #endif
+
+  if (file == NULL) {
+    d4_mapimage_throw(state, line, col, L"failed to write map image '%ls'", path);
+  }
+
+  self = d4_safe_alloc(sizeof(d4_mapimage_writer_t));
+  self->file = file;
+  self->path = d4_str_copy(path);
+  self->buckets_len = buckets_len == 0 ? 1 : buckets_len;
+  self->buckets = d4_safe_alloc(self->buckets_len * sizeof(uint64_t));
+  self->len = 0;
+  self->offset = sizeof(d4_mapimage_header_t) + self->buckets_len * sizeof(uint64_t);
+  self->checksum = D4_MAPIMAGE_CHECKSUM_INIT;
+  self->failed = fseek(file, (long) self->offset, SEEK_SET) != 0;
+
+  memset(self->buckets, 0, self->buckets_len * sizeof(uint64_t));
+  return self;
+}
+
+void d4_mapimage_write_end (d4_err_state_t *state, int line, int col, d4_mapimage_writer_t *self) {
+  d4_mapimage_header_t header;
+  d4_str_t path = self->path;
+  bool failed;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, d4_mapimage_magic, sizeof(d4_mapimage_magic));
+  header.version = D4_MAPIMAGE_VERSION;
+  header.byte_order = D4_MAPIMAGE_BYTE_ORDER;
+  header.wchar_size = sizeof(wchar_t);
+  header.size_size = sizeof(size_t);
+  header.len = self->len;
+  header.buckets_len = self->buckets_len;
+  header.size = self->offset;
+  header.checksum = d4_mapimage_checksum(self->checksum, self->buckets, self->buckets_len * sizeof(uint64_t));
+
+  if (
+    fseek(self->file, 0, SEEK_SET) != 0 ||
+    fwrite(&header, sizeof(header), 1, self->file) != 1 ||
+    fwrite(self->buckets, sizeof(uint64_t), self->buckets_len, self->file) != self->buckets_len
+  ) {
+    self->failed = true;
+  }
+
+  failed = fclose(self->file) != 0 || self->failed;
+  d4_safe_free(self->buckets);
+  d4_safe_free(self);
+
+  if (failed) {
+    d4_str_t message = d4_str_alloc(L"failed to write map image '%ls'", path.data);
+    d4_str_free(path);
+    d4_error_assign_generic(state, line, col, message);
+    d4_str_free(message);
+    longjmp(state->buf_last->buf, state->id);
+  }
+
+  d4_str_free(path);
+}
+
+void d4_mapimage_write_entry (d4_mapimage_writer_t *self, size_t hash, const void *key_data, size_t key_size, const void *value_data, size_t value_size) {
+  d4_mapimage_record_header_t record_header;
+  uint64_t bucket = (uint64_t) hash % self->buckets_len;
+  uint64_t offset = self->offset;
+
+  record_header.hash = (uint64_t) hash;
+  record_header.next = self->buckets[bucket];
+  record_header.key_size = (uint64_t) key_size;
+  record_header.value_size = (uint64_t) value_size;
+
+  d4_mapimage_write_bytes(self, &record_header, sizeof(record_header));
+  d4_mapimage_write_bytes(self, key_data, key_size);
+  d4_mapimage_write_bytes(self, d4_mapimage_zeros, (size_t) (d4_mapimage_padded(key_size) - key_size));
+  d4_mapimage_write_bytes(self, value_data, value_size);
+  d4_mapimage_write_bytes(self, d4_mapimage_zeros, (size_t) (d4_mapimage_padded(value_size) - value_size));
+
+  self->buckets[bucket] = offset;
+  self->len++;
+}
@@ -0,0 +1,11 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef SRC_MAPIMAGE_H
+#define SRC_MAPIMAGE_H
+
+#include "../include/d4/mapimage.h"
+
+#endif
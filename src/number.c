@@ -6,60 +6,326 @@
 #include "number.h"
 #include <float.h>
 #include <inttypes.h>
+#include <string.h>
 #include "../include/d4/string.h"
 
+/* Number of characters enough for any integer, sign and exponent of the float representation. */
+#define D4_NUMBER_BUF_LEN 32
+
+/* Two decimal digits of every number below 100, used to write integers two digits at a time. */
+static const char d4_number_digits[201] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+/* Powers of five that fit in 64 bits. */
+static const uint64_t d4_number_pow5[28] = {
+  1ULL, 5ULL, 25ULL, 125ULL, 625ULL, 3125ULL, 15625ULL, 78125ULL, 390625ULL, 1953125ULL, 9765625ULL, 48828125ULL,
+  244140625ULL, 1220703125ULL, 6103515625ULL, 30517578125ULL, 152587890625ULL, 762939453125ULL, 3814697265625ULL,
+  19073486328125ULL, 95367431640625ULL, 476837158203125ULL, 2384185791015625ULL, 11920928955078125ULL,
+  59604644775390625ULL, 298023223876953125ULL, 1490116119384765625ULL, 7450580596923828125ULL
+};
+
+/* Powers of ten that fit in 64 bits. */
+static const uint64_t d4_number_pow10[20] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+  10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL, 1000000000000000ULL,
+  10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+/* Unsigned 128-bit integer used for exact digit generation. */
+typedef struct {
+  uint64_t hi;
+  uint64_t lo;
+} d4_number_u128_t;
+
+static d4_number_u128_t d4_number_mul64 (uint64_t a, uint64_t b) {
+  uint64_t a_lo = a & 0xFFFFFFFF;
+  uint64_t a_hi = a >> 32;
+  uint64_t b_lo = b & 0xFFFFFFFF;
+  uint64_t b_hi = b >> 32;
+  uint64_t lo_lo = a_lo * b_lo;
+  uint64_t hi_lo = a_hi * b_lo;
+  uint64_t lo_hi = a_lo * b_hi;
+  uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+
+  return (d4_number_u128_t) {a_hi * b_hi + (hi_lo >> 32) + (cross >> 32), (cross << 32) | (lo_lo & 0xFFFFFFFF)};
+}
+
+/* Writes integer backwards ending at end, returns number of written characters. */
+static size_t d4_number_write_u64 (wchar_t *end, uint64_t self) {
+  wchar_t *it = end;
+
+  while (self >= 100) {
+    const char *pair = &d4_number_digits[(self % 100) * 2];
+    self /= 100;
+    *--it = (wchar_t) pair[1];
+    *--it = (wchar_t) pair[0];
+  }
+
+  if (self >= 10) {
+    const char *pair = &d4_number_digits[self * 2];
+    *--it = (wchar_t) pair[1];
+    *--it = (wchar_t) pair[0];
+  } else {
+    *--it = (wchar_t) (L'0' + (wchar_t) self);
+  }
+
+  return (size_t) (end - it);
+}
+
+static d4_str_t d4_number_str_i64 (int64_t self) {
+  wchar_t buf[D4_NUMBER_BUF_LEN];
+  wchar_t *end = &buf[D4_NUMBER_BUF_LEN];
+  size_t len = d4_number_write_u64(end, self < 0 ? (uint64_t) 0 - (uint64_t) self : (uint64_t) self);
+
+  if (self < 0) buf[D4_NUMBER_BUF_LEN - ++len] = L'-';
+  return d4_str_calloc(end - len, len);
+}
+
+static d4_str_t d4_number_str_u64 (uint64_t self) {
+  wchar_t buf[D4_NUMBER_BUF_LEN];
+  wchar_t *end = &buf[D4_NUMBER_BUF_LEN];
+  size_t len = d4_number_write_u64(end, self);
+
+  return d4_str_calloc(end - len, len);
+}
+
+/*
+ * Rounds m * 2^e * 10^s to the nearest integer with ties to even, the way printf rounds exact value of the double.
+ * Returns false when the value can't be computed exactly in 128 bits, caller falls back to printf then.
+ */
+static bool d4_number_scale (uint64_t m, int e, int s, uint64_t *result) {
+  uint64_t q;
+  int round;
+
+  if (s >= 0) {
+    d4_number_u128_t num;
+    int shift = e + s;
+
+    if (s > 27) {
+      d4_number_u128_t high;
+      if (s > 32) return false;
+      num = d4_number_mul64(m, d4_number_pow5[27]);
+      high = d4_number_mul64(num.hi, d4_number_pow5[s - 27]);
+      num = d4_number_mul64(num.lo, d4_number_pow5[s - 27]);
+      if (high.hi != 0 || num.hi + high.lo < num.hi) return false;
+      num.hi += high.lo;
+    } else {
+      num = d4_number_mul64(m, d4_number_pow5[s]);
+    }
+
+    if (shift >= 0) {
+      if (num.hi != 0 || shift >= 64 || (num.lo >> (63 - shift)) > 1) return false;
+      *result = num.lo << shift;
+      return true;
+    } else if (-shift >= 128) {
+      return false;
+    }
+
+    shift = -shift;
+
+    if (shift >= 64) {
+      uint64_t rest_half = shift == 64 ? num.lo >> 63 : (num.hi >> (shift - 65)) & 1;
+      uint64_t rest_low = shift == 64 ? num.lo << 1 : (num.hi & ((((uint64_t) 1) << (shift - 65)) - 1)) | num.lo;
+
+      q = shift == 64 ? num.hi : num.hi >> (shift - 64);
+      round = rest_half == 0 ? -1 : rest_low != 0 ? 1 : 0;
+    } else {
+      uint64_t rest = num.lo & ((((uint64_t) 1) << shift) - 1);
+      uint64_t half = ((uint64_t) 1) << (shift - 1);
+
+      if (num.hi >> shift != 0) return false;
+      q = (num.lo >> shift) | (num.hi << (64 - shift));
+      round = rest < half ? -1 : rest > half ? 1 : 0;
+    }
+  } else {
+    int t = -s;
+    int u = e - t;
+
+    if (t > 27) {
+      return false;
+    } else if (u >= 0) {
+      uint64_t num;
+      uint64_t rest;
+
+      if (u > 11) return false;
+      num = m << u;
+      q = num / d4_number_pow5[t];
+      rest = num % d4_number_pow5[t];
+      round = rest < d4_number_pow5[t] - rest ? -1 : 1;
+    } else {
+      uint64_t den;
+      uint64_t rest;
+
+      if (-u >= 64 || (d4_number_pow5[t] >> (63 + u)) > 1) return false;
+      den = d4_number_pow5[t] << -u;
+      q = m / den;
+      rest = m % den;
+      round = rest < den - rest ? -1 : rest > den - rest ? 1 : 0;
+    }
+  }
+
+  *result = q + (round > 0 || (round == 0 && (q & 1) != 0));
+  return true;
+}
+
+/* Writes %.*g representation of the double into buf, returns number of written characters or 0 when it can't be done exactly. */
+static size_t d4_number_write_double (wchar_t *buf, double self, int precision) {
+  wchar_t digits[D4_NUMBER_BUF_LEN];
+  wchar_t *digits_end = &digits[D4_NUMBER_BUF_LEN];
+  wchar_t *it = buf;
+  uint64_t bits;
+  uint64_t m;
+  uint64_t q = 0;
+  int biased;
+  int e;
+  int k;
+  int exp10;
+  size_t digits_len;
+
+  memcpy(&bits, &self, sizeof(bits));
+  biased = (int) ((bits >> 52) & 0x7FF);
+  m = bits & 0xFFFFFFFFFFFFF;
+
+  if (biased == 0x7FF || (biased == 0 && m != 0)) {
+    return 0;
+  } else if (bits >> 63 != 0) {
+    *it++ = L'-';
+  }
+
+  if (biased == 0) {
+    *it++ = L'0';
+    return (size_t) (it - buf);
+  }
+
+  m |= ((uint64_t) 1) << 52;
+  e = biased - 1075;
+  k = e + 52;
+  exp10 = k >= 0 ? (k * 78913) >> 18 : -((-k * 78913 + 262143) >> 18);
+
+  for (int i = 0; i < 3; i++) {
+    if (!d4_number_scale(m, e, precision - 1 - exp10, &q)) {
+      return 0;
+    } else if (q >= d4_number_pow10[precision]) {
+      exp10++;
+    } else if (q < d4_number_pow10[precision - 1]) {
+      exp10--;
+    } else {
+      break;
+    }
+  }
+
+  if (q < d4_number_pow10[precision - 1] || q >= d4_number_pow10[precision]) {
+    return 0;
+  }
+
+  while (q % 10 == 0) q /= 10;
+  digits_len = d4_number_write_u64(digits_end, q);
+
+  if (exp10 < -4 || exp10 >= precision) {
+    wchar_t exp10_buf[4];
+    size_t exp10_len = d4_number_write_u64(&exp10_buf[4], (uint64_t) (exp10 < 0 ? -exp10 : exp10));
+
+    *it++ = digits_end[-(ptrdiff_t) digits_len];
+
+    if (digits_len > 1) {
+      *it++ = L'.';
+      wmemcpy(it, digits_end - digits_len + 1, digits_len - 1);
+      it += digits_len - 1;
+    }
+
+    *it++ = L'e';
+    *it++ = exp10 < 0 ? L'-' : L'+';
+    if (exp10_len == 1) *it++ = L'0';
+    wmemcpy(it, &exp10_buf[4] - exp10_len, exp10_len);
+    it += exp10_len;
+  } else if (exp10 < 0) {
+    *it++ = L'0';
+    *it++ = L'.';
+    for (int i = -1; i > exp10; i--) *it++ = L'0';
+    wmemcpy(it, digits_end - digits_len, digits_len);
+    it += digits_len;
+  } else if (digits_len <= (size_t) exp10 + 1) {
+    wmemcpy(it, digits_end - digits_len, digits_len);
+    it += digits_len;
+    for (size_t i = digits_len; i <= (size_t) exp10; i++) *it++ = L'0';
+  } else {
+    wmemcpy(it, digits_end - digits_len, (size_t) exp10 + 1);
+    it += exp10 + 1;
+    *it++ = L'.';
+    wmemcpy(it, digits_end - digits_len + exp10 + 1, digits_len - (size_t) exp10 - 1);
+    it += digits_len - (size_t) exp10 - 1;
+  }
+
+  return (size_t) (it - buf);
+}
+
+static d4_str_t d4_number_str_double (double self, int precision, const wchar_t *fmt) {
+  wchar_t buf[D4_NUMBER_BUF_LEN];
+  size_t len = d4_number_write_double(buf, self, precision);
+  return len == 0 ? d4_str_alloc(fmt, self) : d4_str_calloc(buf, len);
+}
+
 d4_str_t d4_f32_str (float self) {
-  return d4_str_alloc(L"%g", (double) self);
+  return d4_number_str_double((double) self, 6, L"%g");
 }
 
 d4_str_t d4_f64_str (double self) {
-  return d4_str_alloc(L"%.16g", self);
+  return d4_number_str_double(self, 16, L"%.16g");
 }
 
 d4_str_t d4_float_str (double self) {
-  return d4_str_alloc(L"%.16g", self);
+  return d4_number_str_double(self, 16, L"%.16g");
 }
 
 d4_str_t d4_i8_str (int8_t self) {
-  return d4_str_alloc(L"%" PRId8, self);
+  return d4_number_str_i64(self);
 }
 
 d4_str_t d4_i16_str (int16_t self) {
-  return d4_str_alloc(L"%" PRId16, self);
+  return d4_number_str_i64(self);
 }
 
 d4_str_t d4_i32_str (int32_t self) {
-  return d4_str_alloc(L"%" PRId32, self);
+  return d4_number_str_i64(self);
 }
 
 d4_str_t d4_i64_str (int64_t self) {
-  return d4_str_alloc(L"%" PRId64, self);
+  return d4_number_str_i64(self);
 }
 
 d4_str_t d4_int_str (int32_t self) {
-  return d4_str_alloc(L"%" PRId32, self);
+  return d4_number_str_i64(self);
 }
 
 d4_str_t d4_isize_str (ptrdiff_t self) {
-  return d4_str_alloc(L"%zd", self);
+  return d4_number_str_i64((int64_t) self);
 }
 
 d4_str_t d4_u8_str (uint8_t self) {
-  return d4_str_alloc(L"%" PRIu8, self);
+  return d4_number_str_u64(self);
 }
 
 d4_str_t d4_u16_str (uint16_t self) {
-  return d4_str_alloc(L"%" PRIu16, self);
+  return d4_number_str_u64(self);
 }
 
 d4_str_t d4_u32_str (uint32_t self) {
-  return d4_str_alloc(L"%" PRIu32, self);
+  return d4_number_str_u64(self);
 }
 
 d4_str_t d4_u64_str (uint64_t self) {
-  return d4_str_alloc(L"%" PRIu64, self);
+  return d4_number_str_u64(self);
 }
 
 d4_str_t d4_usize_str (size_t self) {
-  return d4_str_alloc(L"%zu", self);
+  return d4_number_str_u64((uint64_t) self);
 }
@@ -52,8 +52,7 @@ d4_str_t d4_rune_repeat (wchar_t self, int32_t times) {
 }
 
 d4_str_t d4_rune_str (wchar_t self) {
-  wchar_t buf[2] = {self, '\0'};
-  return d4_str_alloc(buf);
+  return self == L'\0' ? d4_str_empty_val : d4_str_calloc(&self, 1);
 }
 
 wchar_t d4_rune_upper (wchar_t self) {
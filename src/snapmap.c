@@ -0,0 +1,186 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include "snapmap.h"
+#include "safe.h"
+#include <string.h>
+
+#if defined(D4_OS_WINDOWS)
+  #include <windows.h>
+#else
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+/*
+ * Versions are protected with hazard pointers: reader publishes version it is about to read
+ * in a slot and confirms it is still current, writer frees retired versions that no slot refers to.
+ */
+struct d4_snapmap {
+  void *current;
+  void *slots[D4_SNAPMAP_SLOTS];
+  void **retired;
+  size_t retired_len;
+  size_t retired_cap;
+  void (*version_free) (void *);
+
+  #if defined(D4_OS_WINDOWS)
+    SRWLOCK lock;
+  #else
+    pthread_mutex_t lock;
+  #endif
+};
+
+/* Marker of the slot that is taken by reader, but doesn't protect any version yet. */
+static char d4_snapmap_reserved;
+
+static void *d4_snapmap_load (void **ptr) {
+  #if defined(D4_OS_WINDOWS)
+    return InterlockedCompareExchangePointer(ptr, NULL, NULL);
+  #else
+    return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+  #endif
+}
+
+static void d4_snapmap_store (void **ptr, void *val) {
+  #if defined(D4_OS_WINDOWS)
+    InterlockedExchangePointer(ptr, val);
+  #else
+    __atomic_store_n(ptr, val, __ATOMIC_SEQ_CST);
+  #endif
+}
+
+static bool d4_snapmap_swap (void **ptr, void *expected, void *val) {
+  #if defined(D4_OS_WINDOWS)
+    return InterlockedCompareExchangePointer(ptr, val, expected) == expected;
+  #else
+    return __atomic_compare_exchange_n(ptr, &expected, val, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+  #endif
+}
+
+static void d4_snapmap_yield (void) {
+  #if defined(D4_OS_WINDOWS)
+    SwitchToThread();
+  #else
+    sched_yield();
+  #endif
+}
+
+static bool d4_snapmap_protected (d4_snapmap_t *self, void *version) {
+  for (size_t i = 0; i < D4_SNAPMAP_SLOTS; i++) {
+    if (d4_snapmap_load(&self->slots[i]) == version) return true;
+  }
+
+  return false;
+}
+
+static void d4_snapmap_reclaim (d4_snapmap_t *self) {
+  size_t j = 0;
+
+  for (size_t i = 0; i < self->retired_len; i++) {
+    if (d4_snapmap_protected(self, self->retired[i])) {
+      self->retired[j++] = self->retired[i];
+    } else {
+      self->version_free(self->retired[i]);
+    }
+  }
+
+  self->retired_len = j;
+}
+
+void *d4_snapmap_acquire (d4_snapmap_t *self, size_t *slot) {
+  void *reserved = &d4_snapmap_reserved;
+  void *version;
+  /* Readers on different threads have different stacks, so start looking for a free slot from different positions. */
+  size_t i = ((size_t) (uintptr_t) &version >> 12) % D4_SNAPMAP_SLOTS;
+
+  while (!d4_snapmap_swap(&self->slots[i], NULL, reserved)) {
+    i = (i + 1) % D4_SNAPMAP_SLOTS;
+    if (i == 0) d4_snapmap_yield();
+  }
+
+  do {
+    version = d4_snapmap_load(&self->current);
+    d4_snapmap_store(&self->slots[i], version);
+  } while (d4_snapmap_load(&self->current) != version);
+
+  *slot = i;
+  return version;
+}
+
+d4_snapmap_t *d4_snapmap_alloc (void *version, void (*version_free) (void *)) {
+  d4_snapmap_t *self = d4_safe_alloc(sizeof(d4_snapmap_t));
+  memset(self, 0, sizeof(d4_snapmap_t));
+  self->current = version;
+  self->version_free = version_free;
+
+  #if defined(D4_OS_WINDOWS)
+    InitializeSRWLock(&self->lock);
+  #else
+    pthread_mutex_init(&self->lock, NULL);
+  #endif
+
+  return self;
+}
+
+void d4_snapmap_free (d4_snapmap_t *self) {
+  for (size_t i = 0; i < self->retired_len; i++) {
+    self->version_free(self->retired[i]);
+  }
+
+  self->version_free(self->current);
+
+  #if !defined(D4_OS_WINDOWS)
+    pthread_mutex_destroy(&self->lock);
+  #endif
+
+  d4_safe_free(self->retired);
+  d4_safe_free(self);
+}
+
+size_t d4_snapmap_pending (d4_snapmap_t *self) {
+  size_t result;
+  d4_snapmap_write_begin(self);
+  d4_snapmap_reclaim(self);
+  result = self->retired_len;
+  d4_snapmap_write_end(self, NULL);
+  return result;
+}
+
+void d4_snapmap_release (d4_snapmap_t *self, size_t slot) {
+  d4_snapmap_store(&self->slots[slot], NULL);
+}
+
+void *d4_snapmap_write_begin (d4_snapmap_t *self) {
+  #if defined(D4_OS_WINDOWS)
+    AcquireSRWLockExclusive(&self->lock);
+  #else
+    pthread_mutex_lock(&self->lock);
+  #endif
+
+  return self->current;
+}
+
+void d4_snapmap_write_end (d4_snapmap_t *self, void *version) {
+  if (version != NULL) {
+    void *previous = self->current;
+    d4_snapmap_store(&self->current, version);
+
+    if (self->retired_len == self->retired_cap) {
+      self->retired_cap = self->retired_cap == 0 ? 4 : self->retired_cap * 2;
+      self->retired = d4_safe_realloc(self->retired, self->retired_cap * sizeof(void *));
+    }
+
+    self->retired[self->retired_len++] = previous;
+    d4_snapmap_reclaim(self);
+  }
+
+  #if defined(D4_OS_WINDOWS)
+    ReleaseSRWLockExclusive(&self->lock);
+  #else
+    pthread_mutex_unlock(&self->lock);
+  #endif
+}
@@ -0,0 +1,11 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef SRC_SNAPMAP_H
+#define SRC_SNAPMAP_H
+
+#include "../include/d4/snapmap.h"
+
+#endif
@@ -0,0 +1,116 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include "strbuf.h"
+#include <limits.h>
+#include <stdarg.h>
+#include "safe.h"
+
+d4_strbuf_t d4_strbuf_alloc (size_t cap) {
+  d4_strbuf_t self = {NULL, 0, 0};
+  if (cap != 0) d4_strbuf_reserve(&self, cap);
+  return self;
+}
+
+void d4_strbuf_append (d4_strbuf_t *self, const d4_str_t str) {
+  if (str.len == 0) return;
+  d4_strbuf_reserve(self, str.len);
+  wmemcpy(&self->data[self->len], str.data, str.len);
+  self->len += str.len;
+}
+
+void d4_strbuf_appendChar (d4_strbuf_t *self, wchar_t c) {
+  d4_strbuf_reserve(self, 1);
+  self->data[self->len++] = c;
+}
+
+void d4_strbuf_appendFmt (d4_strbuf_t *self, const wchar_t *fmt, ...) {
+  va_list args;
+  d4_strbuf_reserve(self, 32);
+
+  while (self->cap - self->len <= INT_MAX) {
+    size_t available = self->cap - self->len;
+    int written;
+
+    va_start(args, fmt);
+    written = vswprintf(&self->data[self->len], available, fmt, args);
+    va_end(args);
+
+    if (written >= 0 && (size_t) written < available) {
+      self->len += (size_t) written;
+      return;
+    }
+
+    d4_strbuf_reserve(self, available * 2);
+  }
+}
+
+void d4_strbuf_appendInt (d4_strbuf_t *self, int64_t value) {
+  uint64_t magnitude = value < 0 ? (uint64_t) 0 - (uint64_t) value : (uint64_t) value;
+  wchar_t buf[20];
+  size_t i = sizeof(buf) / sizeof(wchar_t);
+
+  do {
+    buf[--i] = (wchar_t) (L'0' + (wchar_t) (magnitude % 10));
+    magnitude /= 10;
+  } while (magnitude != 0);
+
+  d4_strbuf_reserve(self, sizeof(buf) / sizeof(wchar_t) - i + 1);
+  if (value < 0) self->data[self->len++] = L'-';
+  wmemcpy(&self->data[self->len], &buf[i], sizeof(buf) / sizeof(wchar_t) - i);
+  self->len += sizeof(buf) / sizeof(wchar_t) - i;
+}
+
+void d4_strbuf_appendMove (d4_strbuf_t *self, d4_str_t str) {
+  d4_strbuf_append(self, str);
+  d4_str_free(str);
+}
+
+d4_str_t d4_strbuf_finish (d4_strbuf_t *self) {
+  d4_str_t result;
+
+  if (self->len == 0) {
+    d4_strbuf_free(*self);
+    result = d4_str_empty_val;
+  } else {
+    self->data[self->len] = L'\0';
+    result = (d4_str_t) {self->data, self->len, false};
+  }
+
+  *self = (d4_strbuf_t) {NULL, 0, 0};
+  return result;
+}
+
+void d4_strbuf_free (d4_strbuf_t self) {
+  d4_safe_free(self.data);
+}
+
+d4_strbuf_t d4_strbuf_from (d4_str_t self) {
+  d4_strbuf_t result = {NULL, 0, 0};
+
+  if (self.is_static) {
+    d4_strbuf_append(&result, self);
+    d4_str_free(self);
+  } else if (self.len != 0) {
+    result = (d4_strbuf_t) {self.data, self.len, self.len + 1};
+  } else {
+    d4_str_free(self);
+  }
+
+  return result;
+}
+
+void d4_strbuf_reserve (d4_strbuf_t *self, size_t additional) {
+  size_t needed = self->len + additional + 1;
+  size_t cap;
+
+  if (needed <= self->cap) return;
+  cap = self->cap < 8 ? 16 : self->cap * 2;
+  if (cap < needed) cap = needed;
+
+  self->data = d4_safe_realloc(self->data, cap * sizeof(wchar_t));
+  self->cap = cap;
+}
@@ -0,0 +1,11 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef SRC_STRBUF_H
+#define SRC_STRBUF_H
+
+#include "../include/d4/strbuf.h"
+
+#endif
@@ -5,16 +5,192 @@
 
 #include "../include/d4/macro.h"
 #include "string.h"
-#include <ctype.h>
 #include <float.h>
 #include <limits.h>
 #include <string.h>
+#include <wctype.h>
 #include "../include/d4/array.h"
+#include "safe.h"
+#include "strbuf.h"
+#include "strview.h"
+
+#if defined(D4_OS_WINDOWS)
+  #include <windows.h>
+#endif
 
 D4_ARRAY_DEFINE(str, d4_str_t, d4_str_t, d4_str_copy(element), d4_str_eq(lhs_element, rhs_element), d4_str_free(element), d4_str_copy(element))
 
 d4_str_t d4_str_empty_val = {NULL, 0, true};
 
+/* Minimum length of the search string that is searched by skipping windows instead of scanning for its first character. */
+#define D4_STR_SEARCH_SKIP_MIN_LEN 8
+
+/* Number of characters that case mapping checks for ASCII at once, the loops over such blocks are vectorized by compiler. */
+#define D4_STR_BLOCK_LEN 8
+
+/* Mask of the high bit of every byte in a word, word of ASCII bytes has none of them set. */
+#define D4_STR_UTF8_NON_ASCII 0x8080808080808080ULL
+
+/* Number of characters formatted on stack by d4_str_alloc before falling back to heap buffer. */
+#define D4_STR_ALLOC_BUF_LEN 256
+
+/* Character that follows backslash in escaped form of every ASCII character, 0 for characters that are kept as is. */
+static const char d4_str_escapes[128] = {
+  ['\t'] = 't', ['\n'] = 'n', ['\v'] = 'v', ['\f'] = 'f', ['\r'] = 'r', ['"'] = '"'
+};
+
+/* Shared buffer that data of D4_STR_SHARED strings points into, deallocated when the last reference is dropped. */
+typedef struct {
+  #if defined(D4_OS_WINDOWS)
+    volatile LONG64 refs;
+  #else
+    size_t refs;
+  #endif
+
+  wchar_t data[];
+} d4_str_shared_t;
+
+static d4_str_shared_t *d4_str_shared (const d4_str_t self) {
+  return (d4_str_shared_t *) (void *) ((char *) self.data - offsetof(d4_str_shared_t, data));
+}
+
+static d4_str_t d4_str_shared_alloc (const wchar_t *data, size_t len) {
+  d4_str_shared_t *shared = d4_safe_alloc(offsetof(d4_str_shared_t, data) + (len + 1) * sizeof(wchar_t));
+  shared->refs = 1;
+  wmemcpy(shared->data, data, len);
+  shared->data[len] = L'\0';
+  return (d4_str_t) {shared->data, len, D4_STR_SHARED};
+}
+
+static void d4_str_shared_retain (const d4_str_t self) {
+  #if defined(D4_OS_WINDOWS)
+    InterlockedIncrement64(&d4_str_shared(self)->refs);
+  #else
+    __atomic_fetch_add(&d4_str_shared(self)->refs, 1, __ATOMIC_RELAXED);
+  #endif
+}
+
+/* Whether self holds the only reference to its shared buffer, so that it can be modified in place. */
+static bool d4_str_shared_unique (const d4_str_t self) {
+  #if defined(D4_OS_WINDOWS)
+    return InterlockedCompareExchange64(&d4_str_shared(self)->refs, 0, 0) == 1;
+  #else
+    return __atomic_load_n(&d4_str_shared(self)->refs, __ATOMIC_ACQUIRE) == 1;
+  #endif
+}
+
+static void d4_str_shared_release (const d4_str_t self) {
+  d4_str_shared_t *shared = d4_str_shared(self);
+
+  #if defined(D4_OS_WINDOWS)
+    if (InterlockedDecrement64(&shared->refs) == 0) d4_safe_free(shared);
+  #else
+    if (__atomic_sub_fetch(&shared->refs, 1, __ATOMIC_ACQ_REL) == 0) d4_safe_free(shared);
+  #endif
+}
+
+static d4_str_t d4_str_copy_mutable (const d4_str_t self) {
+  wchar_t *d = d4_safe_alloc((self.len + 1) * sizeof(wchar_t));
+  wmemcpy(d, self.data, self.len);
+  d[self.len] = L'\0';
+  return (d4_str_t) {d, self.len, false};
+}
+
+static bool d4_str_block_ascii (const wchar_t *data) {
+  uint32_t mask = 0;
+
+  for (size_t i = 0; i < D4_STR_BLOCK_LEN; i++) {
+    mask |= (uint32_t) data[i];
+  }
+
+  return mask < 0x80;
+}
+
+static wchar_t d4_str_char_lower (wchar_t c) {
+  return (uint32_t) c < 0x80 ? (wchar_t) (c | (((uint32_t) c - L'A' < 26) << 5)) : (wchar_t) towlower((wint_t) c);
+}
+
+static wchar_t d4_str_char_upper (wchar_t c) {
+  return (uint32_t) c < 0x80 ? (wchar_t) (c ^ (((uint32_t) c - L'a' < 26) << 5)) : (wchar_t) towupper((wint_t) c);
+}
+
+/* Maps case of every character, blocks of ASCII characters are mapped without branches and other characters with towlower or towupper. */
+static d4_str_t d4_str_case (const d4_str_t self, bool upper) {
+  wchar_t *d;
+  size_t i = 0;
+
+  if (self.len == 0) {
+    return d4_str_empty_val;
+  }
+
+  d = d4_safe_alloc((self.len + 1) * sizeof(wchar_t));
+
+  for (; i + D4_STR_BLOCK_LEN <= self.len; i += D4_STR_BLOCK_LEN) {
+    const wchar_t *block = &self.data[i];
+
+    if (!d4_str_block_ascii(block)) {
+      for (size_t j = 0; j < D4_STR_BLOCK_LEN; j++) {
+        d[i + j] = upper ? d4_str_char_upper(block[j]) : d4_str_char_lower(block[j]);
+      }
+    } else if (upper) {
+      for (size_t j = 0; j < D4_STR_BLOCK_LEN; j++) {
+        d[i + j] = (wchar_t) (block[j] ^ (((uint32_t) block[j] - L'a' < 26) << 5));
+      }
+    } else {
+      for (size_t j = 0; j < D4_STR_BLOCK_LEN; j++) {
+        d[i + j] = (wchar_t) (block[j] | (((uint32_t) block[j] - L'A' < 26) << 5));
+      }
+    }
+  }
+
+  for (; i < self.len; i++) {
+    d[i] = upper ? d4_str_char_upper(self.data[i]) : d4_str_char_lower(self.data[i]);
+  }
+
+  d[self.len] = L'\0';
+  return (d4_str_t) {d, self.len, false};
+}
+
+static bool d4_str_utf8_ascii (const char *data) {
+  uint64_t word;
+  memcpy(&word, data, sizeof(word));
+  return (word & D4_STR_UTF8_NON_ASCII) == 0;
+}
+
+/* Number of bytes that encode character, unpaired surrogates and values above U+10FFFF are encoded as U+FFFD. */
+static size_t d4_str_utf8_size (uint32_t c) {
+  return (size_t) 1 + (c >= 0x80) + (c >= 0x800) + (c >= 0x10000 && c <= 0x10FFFF);
+}
+
+/* Reads character of the string at index and moves index past it, combining surrogate pairs where wchar_t is UTF-16. */
+static uint32_t d4_str_utf16_decode (const d4_str_t self, size_t *index) {
+  uint32_t c = (uint32_t) self.data[*index];
+
+  if (sizeof(wchar_t) == 2 && c >= 0xD800 && c <= 0xDBFF && *index + 1 < self.len) {
+    uint32_t low = (uint32_t) self.data[*index + 1];
+
+    if (low >= 0xDC00 && low <= 0xDFFF) {
+      *index += 2;
+      return 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+    }
+  }
+
+  *index += 1;
+  return c;
+}
+
+/* Copies every string view into array of strings and deallocates array of string views. */
+static d4_arr_str_t d4_str_views_toOwned (d4_arr_strview_t views) {
+  d4_str_t *r = views.len == 0 ? NULL : d4_safe_alloc(views.len * sizeof(d4_str_t));
+
+  for (size_t i = 0; i < views.len; i++) {
+    r[i] = d4_strview_toOwned(views.data[i]);
+  }
+
+  d4_arr_strview_free(views);
+  return (d4_arr_str_t) {r, views.len};
+}
+
 int snwprintf (const wchar_t *fmt, ...) {
   va_list args;
   int result;
@@ -52,27 +228,42 @@ int vsnwprintf (const wchar_t *fmt, va_list args) {
 }
 
 d4_str_t d4_str_alloc (const wchar_t *fmt, ...) {
+  wchar_t buf[D4_STR_ALLOC_BUF_LEN];
+  unsigned long long buf_size = D4_STR_ALLOC_BUF_LEN * 2;
   wchar_t *d = NULL;
-  size_t l = 0;
+  va_list args;
+  va_list args_copy;
+  int y;
 
-  if (fmt != NULL) {
-    va_list args;
-    va_start(args, fmt);
-    l = (size_t) vsnwprintf(fmt, args);
+  if (fmt == NULL) {
+    return d4_str_empty_val;
+  }
 
-    if (l != 0) {
-      d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
-      vswprintf(d, l + 1, fmt, args);
-    }
+  va_start(args, fmt);
+  va_copy(args_copy, args);
+  y = vswprintf(buf, D4_STR_ALLOC_BUF_LEN, fmt, args_copy);
+  va_end(args_copy);
 
-    va_end(args);
+  /* Short results are formatted once into the stack buffer, longer ones are formatted into a growing heap buffer that becomes the result. */
+  while (y < 0 && buf_size <= INT_MAX) {
+    d = d4_safe_realloc(d, buf_size * sizeof(wchar_t));
+    va_copy(args_copy, args);
+    y = vswprintf(d, (size_t) buf_size, fmt, args_copy);
+    va_end(args_copy);
+    buf_size *= 2;
   }
 
-  if (l == 0) {
+  va_end(args);
+
+  if (y <= 0) {
+    d4_safe_free(d);
     return d4_str_empty_val;
+  } else if (d == NULL) {
+    return d4_str_calloc(buf, (size_t) y);
   }
 
-  return (d4_str_t) {d, l, false};
+  d = d4_safe_realloc(d, ((size_t) y + 1) * sizeof(wchar_t));
+  return (d4_str_t) {d, (size_t) y, false};
 }
 
 d4_str_t d4_str_calloc (const wchar_t *self, size_t length) {
@@ -88,7 +279,7 @@ d4_str_t d4_str_calloc (const wchar_t *self, size_t length) {
   return (d4_str_t) {d, length, false};
 }
 
-wchar_t *d4_str_at (d4_err_state_t *state, int line, int col, const d4_str_t self, int32_t index) {
+const wchar_t *d4_str_at (d4_err_state_t *state, int line, int col, const d4_str_t self, int32_t index) {
   if ((index >= 0 && (size_t) index >= self.len) || (index < 0 && index < -((int32_t) self.len))) {
     d4_str_t message = d4_str_alloc(L"index %" PRId32 L" out of string bounds", index);
     d4_error_assign_generic(state, line, col, message);
@@ -99,6 +290,18 @@ wchar_t *d4_str_at (d4_err_state_t *state, int line, int col, const d4_str_t sel
   return index < 0 ? &self.data[self.len + (size_t) index] : &self.data[index];
 }
 
+wchar_t *d4_str_atMut (d4_err_state_t *state, int line, int col, d4_str_t *self, int32_t index) {
+  size_t offset = (size_t) (d4_str_at(state, line, col, *self, index) - self->data);
+
+  if (self->is_static == D4_STR_SHARED ? !d4_str_shared_unique(*self) : self->is_static) {
+    d4_str_t result = d4_str_copy_mutable(*self);
+    d4_str_free(*self);
+    *self = result;
+  }
+
+  return &self->data[offset];
+}
+
 d4_str_t d4_str_concat (const d4_str_t self, const d4_str_t other) {
   size_t l = self.len + other.len;
   wchar_t *d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
@@ -109,30 +312,20 @@ d4_str_t d4_str_concat (const d4_str_t self, const d4_str_t other) {
 }
 
 bool d4_str_contains (const d4_str_t self, const d4_str_t search) {
-  if (self.len == search.len) {
-    return memcmp(self.data, search.data, self.len * sizeof(wchar_t)) >= 0;
-  }
-
-  if (self.len > 0 && self.len > search.len) {
-    for (size_t i = 0; i < self.len - search.len + 1; i++) {
-      if (memcmp(&self.data[i], search.data, search.len * sizeof(wchar_t)) >= 0) {
-        return true;
-      }
-    }
-  }
-
-  return false;
+  return search.len == 0 || d4_str_search(self.data, self.len, search.data, search.len) != SIZE_MAX;
 }
 
 d4_str_t d4_str_copy (const d4_str_t self) {
-  wchar_t *d;
   if (self.len == 0) {
     return d4_str_empty_val;
+  } else if (self.is_static == D4_STR_SHARED) {
+    d4_str_shared_retain(self);
+    return self;
+  } else if (self.len >= D4_STR_SHARED_MIN_LEN) {
+    return d4_str_shared_alloc(self.data, self.len);
   }
-  d = d4_safe_alloc((self.len + 1) * sizeof(wchar_t));
-  wmemcpy(d, self.data, self.len);
-  d[self.len] = L'\0';
-  return (d4_str_t) {d, self.len, false};
+
+  return d4_str_copy_mutable(self);
 }
 
 bool d4_str_empty (const d4_str_t self) {
@@ -150,64 +343,80 @@ bool d4_str_eq (const d4_str_t self, const d4_str_t rhs) {
 d4_str_t d4_str_escape (const d4_str_t self) {
   wchar_t *d;
   size_t l = 0;
+  size_t escaped = 0;
+  size_t start = 0;
 
   if (self.len == 0) {
     return d4_str_empty_val;
   }
 
-  d = d4_safe_alloc((self.len + 1) * sizeof(wchar_t));
-
+  /* Counts escaped characters first, so that result is allocated once and unescaped runs are copied at once. */
   for (size_t i = 0; i < self.len; i++) {
-    wchar_t c = self.data[i];
-
-    if (c == L'\f' || c == L'\n' || c == L'\r' || c == L'\t' || c == L'\v' || c == L'"') {
-      if (l + 3 > self.len) {
-        d = d4_safe_realloc(d, (l + 3) * sizeof(wchar_t));
-      }
-
-      d[l++] = L'\\';
+    escaped += (uint32_t) self.data[i] < 0x80 && d4_str_escapes[self.data[i]] != 0;
+  }
 
-      if (c == L'\f') d[l++] = L'f';
-      else if (c == L'\n') d[l++] = L'n';
-      else if (c == L'\r') d[l++] = L'r';
-      else if (c == L'\t') d[l++] = L't';
-      else if (c == L'\v') d[l++] = L'v';
-      else if (c == L'"') d[l++] = L'"';
+  d = d4_safe_alloc((self.len + escaped + 1) * sizeof(wchar_t));
 
-      continue;
-    }
+  for (size_t i = 0; escaped != 0 && i < self.len; i++) {
+    wchar_t c = self.data[i];
 
-    if (l + 2 > self.len) {
-      d = d4_safe_realloc(d, (l + 2) * sizeof(wchar_t));
+    if ((uint32_t) c < 0x80 && d4_str_escapes[c] != 0) {
+      wmemcpy(&d[l], &self.data[start], i - start);
+      l += i - start;
+      d[l++] = L'\\';
+      d[l++] = (wchar_t) d4_str_escapes[c];
+      start = i + 1;
     }
-
-    d[l++] = c;
   }
 
+  wmemcpy(&d[l], &self.data[start], self.len - start);
+  l += self.len - start;
   d[l] = L'\0';
   return (d4_str_t) {d, l, false};
 }
 
 int32_t d4_str_find (const d4_str_t self, const d4_str_t search) {
+  size_t index;
+
   if (search.len == 0) {
     return 0;
   }
 
-  if (search.len > self.len) {
-    return -1;
+  index = d4_str_search(self.data, self.len, search.data, search.len);
+  return index == SIZE_MAX ? -1 : (int32_t) index;
+}
+
+void d4_str_free (d4_str_t self) {
+  if (self.is_static == D4_STR_SHARED) {
+    d4_str_shared_release(self);
+  } else if (!self.is_static) {
+    d4_safe_free(self.data);
   }
+}
 
-  for (size_t i = 0; i < self.len - search.len + 1; i++) {
-    if (memcmp(&self.data[i], search.data, search.len * sizeof(wchar_t)) == 0) {
-      return (int32_t) i;
-    }
+d4_str_t d4_str_fromUtf8 (d4_err_state_t *state, int line, int col, const char *data, size_t len) {
+  size_t index = d4_str_utf8_validate(data, len);
+
+  if (index != SIZE_MAX) {
+    d4_str_t message = d4_str_alloc(L"invalid UTF-8 sequence at byte %zu", index);
+    d4_error_assign_generic(state, line, col, message);
+    d4_str_free(message);
+    longjmp(state->buf_last->buf, state->id);
   }
 
-  return -1;
+  return d4_str_utf8_decode(data, len);
 }
 
-void d4_str_free (d4_str_t self) {
-  if (!self.is_static) d4_safe_free(self.data);
+size_t d4_str_fromUtf8Len (const char *data, size_t len) {
+  size_t result = 0;
+
+  /* Every character starts with one byte that is not a continuation byte, four-byte characters take two units where wchar_t is UTF-16. */
+  for (size_t i = 0; i < len; i++) {
+    unsigned char b = (unsigned char) data[i];
+    result += ((b & 0xC0) != 0x80) + (sizeof(wchar_t) == 2 && b >= 0xF0);
+  }
+
+  return result;
 }
 
 bool d4_str_ge (const d4_str_t self, const d4_str_t rhs) {
@@ -247,15 +456,13 @@ bool d4_str_lt (const d4_str_t self, const d4_str_t rhs) {
 }
 
 d4_str_t d4_str_quoted_escape (d4_str_t self) {
-  d4_str_t q = (d4_str_t) {L"\"", 1, true};
-  d4_str_t escaped = d4_str_escape(self);
-  d4_str_t left_result = d4_str_concat(q, escaped);
-  d4_str_t result = d4_str_concat(left_result, q);
+  d4_strbuf_t result = d4_strbuf_alloc(self.len + 3);
 
-  d4_str_free(escaped);
-  d4_str_free(left_result);
+  d4_strbuf_appendChar(&result, L'"');
+  d4_strbuf_appendMove(&result, d4_str_escape(self));
+  d4_strbuf_appendChar(&result, L'"');
 
-  return result;
+  return d4_strbuf_finish(&result);
 }
 
 d4_str_t d4_str_realloc (d4_str_t self, const d4_str_t rhs) {
@@ -264,77 +471,36 @@ d4_str_t d4_str_realloc (d4_str_t self, const d4_str_t rhs) {
     return d4_str_empty_val;
   }
 
-  if (self.len == 0) {
-    self.data = d4_safe_alloc((rhs.len + 1) * sizeof(wchar_t));
-  } else {
-    self.data = d4_safe_realloc(self.data, (rhs.len + 1) * sizeof(wchar_t));
+  if (self.len == 0 || self.is_static) {
+    d4_str_t result = d4_str_copy_mutable(rhs);
+    d4_str_free(self);
+    return result;
   }
 
+  self.data = d4_safe_realloc(self.data, (rhs.len + 1) * sizeof(wchar_t));
   wmemcpy(self.data, rhs.data, rhs.len);
   self.data[rhs.len] = L'\0';
   return (d4_str_t) {self.data, rhs.len, false};
 }
 
 d4_arr_str_t d4_str_lines (const d4_str_t self, unsigned char o1, bool keepLineBreaks) {
-  bool k = o1 == 0 ? false : keepLineBreaks;
-  d4_str_t *result = NULL;
-  size_t len = 0;
-  size_t start = 0;
-  size_t j = 0;
-
-  if (self.len == 0) {
-    return (d4_arr_str_t) {NULL, 0};
-  }
-
-  while (j < self.len) {
-    wchar_t c = self.data[j];
-
-    if (c == L'\r' || c == L'\n') {
-      size_t beforeLineBreak = j;
-
-      if (c == L'\r' && j + 1 < self.len && self.data[j + 1] == L'\n') {
-        j++;
-      }
-
-      result = d4_safe_realloc(result, ++len * sizeof(d4_str_t));
-      result[len - 1] = d4_str_calloc(&self.data[start], (k ? j + 1 : beforeLineBreak) - start);
-
-      start = j + 1;
-    }
-
-    j++;
-  }
-
-  if (start != self.len) {
-    result = d4_safe_realloc(result, ++len * sizeof(d4_str_t));
-    result[len - 1] = d4_str_calloc(&self.data[start], self.len - start);
-  }
-
-  return (d4_arr_str_t) {result, len};
+  return d4_str_views_toOwned(d4_strview_lines(d4_strview_from(self), o1, keepLineBreaks));
 }
 
 d4_str_t d4_str_lower (const d4_str_t self) {
-  d4_str_t d = d4_str_copy(self);
-
-  if (self.len == 0) {
-    return d;
-  }
-
-  for (size_t i = 0; i < d.len; i++) {
-    d.data[i] = (wchar_t) tolower(d.data[i]);
-  }
-
-  return d;
+  return d4_str_case(self, false);
 }
 
 d4_str_t d4_str_lowerFirst (const d4_str_t self) {
-  d4_str_t d = d4_str_copy(self);
+  d4_str_t d;
 
   if (self.len == 0) {
-    return d;
+    return d4_str_empty_val;
   }
 
-  d.data[0] = (wchar_t) tolower(d.data[0]);
+  d = d4_str_copy_mutable(self);
+
+  d.data[0] = d4_str_char_lower(d.data[0]);
   return d;
 }
 
@@ -362,73 +528,19 @@ d4_str_t d4_str_replace (const d4_str_t self, const d4_str_t search, const d4_st
         j += replacement.len;
       }
     }
-  } else if (self.len == search.len && search.len > 0) {
-    if (memcmp(self.data, search.data, search.len * sizeof(wchar_t)) != 0) {
-      l = self.len;
-      d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
-      wmemcpy(d, self.data, l);
-    } else if (replacement.len > 0) {
-      l = replacement.len;
-      d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
-      wmemcpy(d, replacement.data, l);
-    }
-  } else if (self.len > search.len && search.len > 0 && replacement.len == 0) {
-    size_t i = 0;
-    d = d4_safe_alloc((self.len + 1) * sizeof(wchar_t));
-
-    while (i < self.len) {
-      if (
-        i <= self.len - search.len &&
-        memcmp(&self.data[i], search.data, search.len * sizeof(wchar_t)) == 0 &&
-        (count <= 0 || k++ < count)
-      ) {
-        i += search.len - 1;
-      } else {
-        d[l++] = self.data[i];
-      }
-
-      i++;
+  } else if (self.len >= search.len && search.len > 0) {
+    d4_strbuf_t result = d4_strbuf_alloc(self.len);
+
+    while (count <= 0 || k++ < count) {
+      size_t index = d4_str_search(&self.data[j], self.len - j, search.data, search.len);
+      if (index == SIZE_MAX) break;
+      d4_strbuf_append(&result, (d4_str_t) {&self.data[j], index, true});
+      d4_strbuf_append(&result, replacement);
+      j += index + search.len;
     }
 
-    if (l == 0) {
-      d4_safe_free(d);
-      d = NULL;
-    } else if (l != self.len) {
-      d = d4_safe_realloc(d, (l + 1) * sizeof(wchar_t));
-    }
-  } else if (self.len > search.len && search.len > 0 && replacement.len > 0) {
-    size_t i = 0;
-
-    l = self.len;
-    d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
-
-    while (i < self.len) {
-      if (
-        i <= self.len - search.len &&
-        memcmp(&self.data[i], search.data, search.len * sizeof(wchar_t)) == 0 &&
-        (count <= 0 || k++ < count)
-      ) {
-        if (search.len < replacement.len) {
-          l += replacement.len - search.len;
-
-          if (l > self.len) {
-            d = d4_safe_realloc(d, (l + 1) * sizeof(wchar_t));
-          }
-        } else if (search.len > replacement.len) {
-          l -= search.len - replacement.len;
-        }
-
-        wmemcpy(&d[j], replacement.data, replacement.len);
-        j += replacement.len;
-        i += search.len - 1;
-      } else {
-        d[j++] = self.data[i];
-      }
-
-      i++;
-    }
-
-    d = d4_safe_realloc(d, (l + 1) * sizeof(wchar_t));
+    d4_strbuf_append(&result, (d4_str_t) {&self.data[j], self.len - j, true});
+    return d4_strbuf_finish(&result);
   } else if (self.len > 0) {
     l = self.len;
     d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
@@ -442,95 +554,371 @@ d4_str_t d4_str_replace (const d4_str_t self, const d4_str_t search, const d4_st
   return (d4_str_t) {d, l, false};
 }
 
-d4_str_t d4_str_slice (const d4_str_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end) {
-  int32_t i = 0;
-  int32_t j = 0;
+/* Decodes data that is already validated with d4_str_utf8_validate. */
+d4_str_t d4_str_utf8_decode (const char *data, size_t len) {
+  const unsigned char *bytes = (const unsigned char *) data;
+  size_t l = d4_str_fromUtf8Len(data, len);
+  wchar_t *d;
+  size_t i = 0;
+  size_t j = 0;
+
+  if (l == 0) {
+    return d4_str_empty_val;
+  }
+
+  d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
+
+  while (i < len) {
+    uint32_t c;
+
+    if (i + 8 <= len && d4_str_utf8_ascii(&data[i])) {
+      for (size_t k = 0; k < 8; k++) d[j + k] = (wchar_t) bytes[i + k];
+      i += 8;
+      j += 8;
+      continue;
+    } else if (bytes[i] < 0x80) {
+      d[j++] = (wchar_t) bytes[i++];
+      continue;
+    }
+
+    i += d4_str_utf8_decodeChar(data, len, i, &c);
 
-  if (o1 != 0 && start < 0 && start >= -((int32_t) self.len)) {
-    i = (int32_t) ((size_t) start + self.len);
-  } else if (o1 != 0 && start >= 0) {
-    i = (int32_t) ((size_t) start > self.len ? self.len : (size_t) start);
+    if (sizeof(wchar_t) == 2 && c >= 0x10000) {
+      d[j++] = (wchar_t) (0xD800 + ((c - 0x10000) >> 10));
+      d[j++] = (wchar_t) (0xDC00 + ((c - 0x10000) & 0x3FF));
+    } else {
+      d[j++] = (wchar_t) c;
+    }
   }
 
-  if (o2 == 0 || (end >= 0 && (size_t) end > self.len)) {
-    j = (int32_t) self.len;
-  } else if (end < 0 && end >= -((int32_t) self.len)) {
-    j = (int32_t) ((size_t) end + self.len);
-  } else if (end >= 0) {
-    j = (int32_t) end;
+  d[l] = L'\0';
+  return (d4_str_t) {d, l, false};
+}
+
+/* Decodes character that starts at index, returns number of its bytes, or 0 if sequence is invalid, overlong or encodes surrogate. */
+size_t d4_str_utf8_decodeChar (const char *data, size_t len, size_t index, uint32_t *result) {
+  const unsigned char *bytes = (const unsigned char *) data;
+  uint32_t c = bytes[index];
+  uint32_t min;
+  size_t n;
+
+  if (c < 0x80) {
+    *result = c;
+    return 1;
+  } else if ((c & 0xE0) == 0xC0) {
+    n = 1;
+    min = 0x80;
+    c &= 0x1F;
+  } else if ((c & 0xF0) == 0xE0) {
+    n = 2;
+    min = 0x800;
+    c &= 0x0F;
+  } else if ((c & 0xF8) == 0xF0) {
+    n = 3;
+    min = 0x10000;
+    c &= 0x07;
+  } else {
+    return 0;
   }
 
-  if (i >= j || (size_t) i >= self.len) {
-    return d4_str_empty_val;
+  if (len - index <= n) {
+    return 0;
+  }
+
+  for (size_t k = 1; k <= n; k++) {
+    if ((bytes[index + k] & 0xC0) != 0x80) return 0;
+    c = (c << 6) | (bytes[index + k] & 0x3F);
+  }
+
+  if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+    return 0;
   }
 
-  return d4_str_calloc(&self.data[i], (size_t) (j - i));
+  *result = c;
+  return n + 1;
 }
 
-d4_arr_str_t d4_str_split (const d4_str_t self, D4_UNUSED unsigned char o1, const d4_str_t delimiter) {
-  d4_str_t *r = NULL;
-  size_t l = 0;
+/* Encodes character into buffer of at least 4 bytes, returns number of written bytes. Surrogates and values above U+10FFFF are encoded as U+FFFD. */
+size_t d4_str_utf8_encode (char *buf, uint32_t c) {
+  if (c < 0x80) {
+    buf[0] = (char) c;
+    return 1;
+  } else if (c < 0x800) {
+    buf[0] = (char) (0xC0 | (c >> 6));
+    buf[1] = (char) (0x80 | (c & 0x3F));
+    return 2;
+  } else if (c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+    c = 0xFFFD;
+  } else if (c >= 0x10000) {
+    buf[0] = (char) (0xF0 | (c >> 18));
+    buf[1] = (char) (0x80 | ((c >> 12) & 0x3F));
+    buf[2] = (char) (0x80 | ((c >> 6) & 0x3F));
+    buf[3] = (char) (0x80 | (c & 0x3F));
+    return 4;
+  }
+
+  buf[0] = (char) (0xE0 | (c >> 12));
+  buf[1] = (char) (0x80 | ((c >> 6) & 0x3F));
+  buf[2] = (char) (0x80 | (c & 0x3F));
+  return 3;
+}
 
-  if (self.len > 0 && delimiter.len == 0) {
-    l = self.len;
-    r = d4_safe_alloc(l * sizeof(d4_str_t));
+size_t d4_str_utf8_validate (const char *data, size_t len) {
+  size_t i = 0;
+
+  while (i < len) {
+    uint32_t c;
+    size_t n;
+
+    if (i + 8 <= len && d4_str_utf8_ascii(&data[i])) {
+      i += 8;
+    } else if ((n = d4_str_utf8_decodeChar(data, len, i, &c)) == 0) {
+      return i;
+    } else {
+      i += n;
+    }
+  }
+
+  return SIZE_MAX;
+}
+
+size_t d4_str_search (const wchar_t *self, size_t self_len, const wchar_t *search, size_t search_len) {
+  const wchar_t *end = self + self_len;
+  const wchar_t *it = self;
+  wchar_t first;
+  wchar_t last;
 
-    for (size_t i = 0; i < l; i++) {
-      r[i] = d4_str_calloc(&self.data[i], 1);
+  if (search_len == 0 || search_len > self_len) {
+    return search_len == 0 ? 0 : SIZE_MAX;
+  } else if (search_len == 1) {
+    it = wmemchr(self, search[0], self_len);
+    return it == NULL ? SIZE_MAX : (size_t) (it - self);
+  }
+
+  /* Long needles skip by the last character of every window (Horspool), hashed into 256 slots since characters are wide. */
+  if (search_len >= D4_STR_SEARCH_SKIP_MIN_LEN && self_len >= search_len * 4) {
+    size_t skip[256];
+    size_t last_index = search_len - 1;
+
+    for (size_t i = 0; i < 256; i++) {
+      skip[i] = search_len;
     }
-  } else if (self.len < delimiter.len) {
-    r = d4_safe_realloc(r, ++l * sizeof(d4_str_t));
-    r[0] = d4_str_calloc(self.data, self.len);
-  } else if (delimiter.len > 0) {
-    size_t i = 0;
-    size_t j = 0;
-
-    while (j <= self.len - delimiter.len) {
-      if (memcmp(&self.data[j], delimiter.data, delimiter.len * sizeof(wchar_t)) == 0) {
-        r = d4_safe_realloc(r, ++l * sizeof(d4_str_t));
-        r[l - 1] = d4_str_calloc(&self.data[i], j - i);
-        j += delimiter.len;
-        i = j;
+
+    for (size_t i = 0; i < last_index; i++) {
+      skip[(uint32_t) search[i] & 0xFF] = last_index - i;
+    }
+
+    for (size_t i = 0; i <= self_len - search_len; i += skip[(uint32_t) self[i + last_index] & 0xFF]) {
+      if (self[i + last_index] == search[last_index] && wmemcmp(&self[i], search, last_index) == 0) {
+        return i;
       }
+    }
+
+    return SIZE_MAX;
+  }
 
-      j++;
+  /* Short needles jump between occurrences of the first character with wmemchr, which libc vectorizes, and filter by the last one. */
+  first = search[0];
+  last = search[search_len - 1];
+  end -= search_len - 1;
+
+  while (it < end && (it = wmemchr(it, first, (size_t) (end - it))) != NULL) {
+    if (it[search_len - 1] == last && wmemcmp(it + 1, search + 1, search_len - 2) == 0) {
+      return (size_t) (it - self);
     }
 
-    r = d4_safe_realloc(r, ++l * sizeof(d4_str_t));
-    r[l - 1] = d4_str_calloc(&self.data[i], self.len - i);
+    it++;
+  }
+
+  return SIZE_MAX;
+}
+
+d4_str_t d4_str_share (d4_str_t self) {
+  d4_str_t result;
+
+  if (self.len == 0 || self.is_static) {
+    return self;
   }
 
-  return (d4_arr_str_t) {r, l};
+  result = d4_str_shared_alloc(self.data, self.len);
+  d4_safe_free(self.data);
+  return result;
+}
+
+d4_str_t d4_str_slice (const d4_str_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end) {
+  return d4_strview_toOwned(d4_strview_slice(d4_strview_from(self), o1, start, o2, end));
+}
+
+d4_arr_str_t d4_str_split (const d4_str_t self, unsigned char o1, const d4_str_t delimiter) {
+  return d4_str_views_toOwned(d4_strview_split(d4_strview_from(self), o1, d4_strview_from(delimiter)));
+}
+
+d4_arr_str_t d4_str_splitN (const d4_str_t self, unsigned char o1, const d4_str_t delimiter, size_t n) {
+  return d4_str_views_toOwned(d4_strview_splitN(d4_strview_from(self), o1, d4_strview_from(delimiter), n));
 }
 
 bool d4_str_startsWith (const d4_str_t self, const d4_str_t search) {
   return self.len >= search.len && memcmp(self.data, search.data, search.len * sizeof(wchar_t)) == 0;
 }
 
-double d4_str_toFloat (d4_err_state_t *state, int line, int col, const d4_str_t self) {
-  wchar_t *e = NULL;
-  double r;
+/* Value of every ASCII character as a digit, 36 for characters that are not digits in any radix. */
+static const unsigned char d4_str_digit_values[128] = {
+  36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36,
+  36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 36, 36, 36, 36, 36, 36,
+  36, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 36, 36, 36, 36,
+  36, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 36, 36, 36, 36
+};
+
+/* Whether float arithmetic is performed in the precision of its type, which exact fast path of float parsing relies on. */
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  #define D4_STR_FAST_FLOAT 1
+#else
+  #define D4_STR_FAST_FLOAT 0
+#endif
+
+/* Powers of ten that are exactly representable as double. */
+static const double d4_str_pow10[23] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Powers of ten that are exactly representable as float. */
+static const float d4_str_pow10f[11] = {
+  1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+/*
+ * Parses string made only of optional sign and digits of radix, which is how numeric fields usually look.
+ * Returns false for anything else (whitespace, prefixes, overflow of max), such strings are parsed by libc to keep its exact semantics.
+ */
+static bool d4_str_parse_int (const d4_str_t self, int32_t radix, bool is_signed, uint64_t max, bool *negative, uint64_t *result) {
+  uint64_t limit = max;
+  uint64_t value = 0;
+  uint64_t cutoff;
+  uint64_t cutoff_digit;
+  size_t i = 0;
 
-  errno = 0;
-  r = self.len == 0 ? 0 : wcstod(self.data, &e);
+  if (self.len == 0 || radix < 2 || radix > 36) {
+    return false;
+  } else if (self.data[0] == L'-' || self.data[0] == L'+') {
+    if (self.data[0] == L'-' && !is_signed) return false;
+    if (self.data[0] == L'-') limit = max + 1;
+    i = 1;
+  }
 
-  if (errno == ERANGE || r < -DBL_MAX || DBL_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0) {
-    d4_str_t message;
-    if (self.len == 0) {
-      message = d4_str_alloc(L"value `` has invalid syntax");
-    } else {
-      message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
+  if (i == self.len) {
+    return false;
+  }
+
+  *negative = self.data[0] == L'-';
+  cutoff = limit / (uint64_t) radix;
+  cutoff_digit = limit % (uint64_t) radix;
+
+  for (; i < self.len; i++) {
+    uint64_t digit = (uint64_t) self.data[i] < 128 ? d4_str_digit_values[self.data[i]] : 36;
+    if (digit >= (uint64_t) radix || value > cutoff || (value == cutoff && digit > cutoff_digit)) return false;
+    value = value * (uint64_t) radix + digit;
+  }
+
+  if (value == 0) *negative = false;
+  *result = value;
+  return true;
+}
+
+/*
+ * Parses decimal float of up to 19 significant digits without whitespace, hexadecimal, infinity or nan notation.
+ * Returns false for anything else, such strings are parsed by libc to keep its exact semantics.
+ */
+static bool d4_str_parse_decimal (const d4_str_t self, bool *negative, uint64_t *mantissa, int *exponent) {
+  uint64_t value = 0;
+  int digits = 0;
+  int scale = 0;
+  bool has_digits = false;
+  size_t i = 0;
+
+  if (self.len == 0) return false;
+  *negative = self.data[0] == L'-';
+  if (self.data[0] == L'-' || self.data[0] == L'+') i = 1;
+
+  for (; i < self.len && self.data[i] >= L'0' && self.data[i] <= L'9'; i++) {
+    has_digits = true;
+    if (value == 0 && self.data[i] == L'0') continue;
+    if (++digits > 19) return false;
+    value = value * 10 + (uint64_t) (self.data[i] - L'0');
+  }
+
+  if (i < self.len && self.data[i] == L'.') {
+    for (i++; i < self.len && self.data[i] >= L'0' && self.data[i] <= L'9'; i++) {
+      has_digits = true;
+      scale--;
+      if (value == 0 && self.data[i] == L'0') continue;
+      if (++digits > 19) return false;
+      value = value * 10 + (uint64_t) (self.data[i] - L'0');
     }
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return r;
+  if (!has_digits) {
+    return false;
+  } else if (i < self.len && (self.data[i] == L'e' || self.data[i] == L'E')) {
+    bool exponent_negative = false;
+    int exponent_value = 0;
+    size_t start;
+
+    if (++i < self.len && (self.data[i] == L'-' || self.data[i] == L'+')) {
+      exponent_negative = self.data[i++] == L'-';
+    }
+
+    for (start = i; i < self.len && self.data[i] >= L'0' && self.data[i] <= L'9'; i++) {
+      if (exponent_value > 10000) return false;
+      exponent_value = exponent_value * 10 + (int) (self.data[i] - L'0');
+    }
+
+    if (i == start) return false;
+    scale += exponent_negative ? -exponent_value : exponent_value;
+  }
+
+  if (i != self.len) {
+    return false;
+  }
+
+  *mantissa = value;
+  *exponent = scale;
+  return true;
+}
+
+/*
+ * Fast paths of float parsing, mantissa and power of ten are both exact, so a single operation rounds correctly as libc does.
+ * Return false for strings that can't be parsed exactly this way.
+ */
+static bool d4_str_fast_f32 (const d4_str_t self, float *result) {
+  bool negative;
+  uint64_t mantissa;
+  int exponent;
+
+  if (!D4_STR_FAST_FLOAT || !d4_str_parse_decimal(self, &negative, &mantissa, &exponent) || mantissa > ((uint64_t) 1 << 24) || exponent < -10 || exponent > 10) {
+    return false;
+  }
+
+  *result = exponent < 0 ? (float) mantissa / d4_str_pow10f[-exponent] : (float) mantissa * d4_str_pow10f[exponent];
+  *result = negative ? -*result : *result;
+  return true;
+}
+
+static bool d4_str_fast_f64 (const d4_str_t self, double *result) {
+  bool negative;
+  uint64_t mantissa;
+  int exponent;
+
+  if (!D4_STR_FAST_FLOAT || !d4_str_parse_decimal(self, &negative, &mantissa, &exponent) || mantissa > ((uint64_t) 1 << 53) || exponent < -22 || exponent > 22) {
+    return false;
+  }
+
+  *result = exponent < 0 ? (double) mantissa / d4_str_pow10[-exponent] : (double) mantissa * d4_str_pow10[exponent];
+  *result = negative ? -*result : *result;
+  return true;
+}
+
+double d4_str_toFloat (d4_err_state_t *state, int line, int col, const d4_str_t self) {
+  return d4_str_toF64(state, line, col, self);
 }
 
 float d4_str_toF32 (d4_err_state_t *state, int line, int col, const d4_str_t self) {
@@ -538,7 +926,12 @@ float d4_str_toF32 (d4_err_state_t *state, int line, int col, const d4_str_t sel
   float r;
 
   errno = 0;
-  r = self.len == 0 ? 0 : wcstof(self.data, &e);
+
+  if (d4_str_fast_f32(self, &r)) {
+    e = &self.data[self.len];
+  } else {
+    r = self.len == 0 ? 0 : wcstof(self.data, &e);
+  }
 
   if (errno == ERANGE || r < -FLT_MAX || FLT_MAX < r) {
     d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
@@ -564,7 +957,12 @@ double d4_str_toF64 (d4_err_state_t *state, int line, int col, const d4_str_t se
   double r;
 
   errno = 0;
-  r = self.len == 0 ? 0 : wcstod(self.data, &e);
+
+  if (d4_str_fast_f64(self, &r)) {
+    e = &self.data[self.len];
+  } else {
+    r = self.len == 0 ? 0 : wcstod(self.data, &e);
+  }
 
   if (errno == ERANGE || r < -DBL_MAX || DBL_MAX < r) {
     d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
@@ -588,6 +986,8 @@ double d4_str_toF64 (d4_err_state_t *state, int line, int col, const d4_str_t se
 ptrdiff_t d4_str_toIsize (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
   wchar_t *e = NULL;
   long long r;
+  bool negative;
+  uint64_t magnitude;
 
   if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
     d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
@@ -597,7 +997,13 @@ ptrdiff_t d4_str_toIsize (d4_err_state_t *state, int line, int col, const d4_str
   }
 
   errno = 0;
-  r = self.len == 0 ? 0 : wcstoll(self.data, &e, o1 == 0 ? 10 : radix);
+
+  if (d4_str_parse_int(self, o1 == 0 ? 10 : radix, true, LLONG_MAX, &negative, &magnitude)) {
+    r = negative ? -(long long) (magnitude - 1) - 1 : (long long) magnitude;
+    e = &self.data[self.len];
+  } else {
+    r = self.len == 0 ? 0 : wcstoll(self.data, &e, o1 == 0 ? 10 : radix);
+  }
 
   if (errno == ERANGE || r < PTRDIFF_MIN || PTRDIFF_MAX < r) {
     d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
@@ -621,6 +1027,8 @@ ptrdiff_t d4_str_toIsize (d4_err_state_t *state, int line, int col, const d4_str
 int8_t d4_str_toI8 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
   wchar_t *e = NULL;
   long r;
+  bool negative;
+  uint64_t magnitude;
 
   if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
     d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
@@ -630,7 +1038,13 @@ int8_t d4_str_toI8 (d4_err_state_t *state, int line, int col, const d4_str_t sel
   }
 
   errno = 0;
-  r = self.len == 0 ? 0 : wcstol(self.data, &e, o1 == 0 ? 10 : radix);
+
+  if (d4_str_parse_int(self, o1 == 0 ? 10 : radix, true, LONG_MAX, &negative, &magnitude)) {
+    r = negative ? -(long) (magnitude - 1) - 1 : (long) magnitude;
+    e = &self.data[self.len];
+  } else {
+    r = self.len == 0 ? 0 : wcstol(self.data, &e, o1 == 0 ? 10 : radix);
+  }
 
   if (errno == ERANGE || r < INT8_MIN || INT8_MAX < r) {
     d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
@@ -654,6 +1068,8 @@ int8_t d4_str_toI8 (d4_err_state_t *state, int line, int col, const d4_str_t sel
 int16_t d4_str_toI16 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
   wchar_t *e = NULL;
   long r;
+  bool negative;
+  uint64_t magnitude;
 
   if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
     d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
@@ -663,7 +1079,13 @@ int16_t d4_str_toI16 (d4_err_state_t *state, int line, int col, const d4_str_t s
   }
 
   errno = 0;
-  r = self.len == 0 ? 0 : wcstol(self.data, &e, o1 == 0 ? 10 : radix);
+
+  if (d4_str_parse_int(self, o1 == 0 ? 10 : radix, true, LONG_MAX, &negative, &magnitude)) {
+    r = negative ? -(long) (magnitude - 1) - 1 : (long) magnitude;
+    e = &self.data[self.len];
+  } else {
+    r = self.len == 0 ? 0 : wcstol(self.data, &e, o1 == 0 ? 10 : radix);
+  }
 
   if (errno == ERANGE || r < INT16_MIN || INT16_MAX < r) {
     d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
@@ -687,6 +1109,8 @@ int16_t d4_str_toI16 (d4_err_state_t *state, int line, int col, const d4_str_t s
 int32_t d4_str_toI32 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
   wchar_t *e = NULL;
   long r;
+  bool negative;
+  uint64_t magnitude;
 
   if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
     d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
@@ -696,7 +1120,13 @@ int32_t d4_str_toI32 (d4_err_state_t *state, int line, int col, const d4_str_t s
   }
 
   errno = 0;
-  r = self.len == 0 ? 0 : wcstol(self.data, &e, o1 == 0 ? 10 : radix);
+
+  if (d4_str_parse_int(self, o1 == 0 ? 10 : radix, true, LONG_MAX, &negative, &magnitude)) {
+    r = negative ? -(long) (magnitude - 1) - 1 : (long) magnitude;
+    e = &self.data[self.len];
+  } else {
+    r = self.len == 0 ? 0 : wcstol(self.data, &e, o1 == 0 ? 10 : radix);
+  }
 
   if (errno == ERANGE || r < INT32_MIN || INT32_MAX < r) {
     d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
@@ -720,6 +1150,8 @@ int32_t d4_str_toI32 (d4_err_state_t *state, int line, int col, const d4_str_t s
 int64_t d4_str_toI64 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
   wchar_t *e = NULL;
   long long r;
+  bool negative;
+  uint64_t magnitude;
 
   if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
     d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
@@ -729,7 +1161,13 @@ int64_t d4_str_toI64 (d4_err_state_t *state, int line, int col, const d4_str_t s
   }
 
   errno = 0;
-  r = self.len == 0 ? 0 : wcstoll(self.data, &e, o1 == 0 ? 10 : radix);
+
+  if (d4_str_parse_int(self, o1 == 0 ? 10 : radix, true, LLONG_MAX, &negative, &magnitude)) {
+    r = negative ? -(long long) (magnitude - 1) - 1 : (long long) magnitude;
+    e = &self.data[self.len];
+  } else {
+    r = self.len == 0 ? 0 : wcstoll(self.data, &e, o1 == 0 ? 10 : radix);
+  }
 
   if (errno == ERANGE || r < INT64_MIN || INT64_MAX < r) {
     d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
@@ -753,6 +1191,8 @@ int64_t d4_str_toI64 (d4_err_state_t *state, int line, int col, const d4_str_t s
 size_t d4_str_toUsize (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
   wchar_t *e = NULL;
   unsigned long long r;
+  bool negative;
+  uint64_t magnitude;
 
   if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
     d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
@@ -762,7 +1202,13 @@ size_t d4_str_toUsize (d4_err_state_t *state, int line, int col, const d4_str_t
   }
 
   errno = 0;
-  r = self.len == 0 ? 0 : wcstoull(self.data, &e, o1 == 0 ? 10 : radix);
+
+  if (d4_str_parse_int(self, o1 == 0 ? 10 : radix, false, ULLONG_MAX, &negative, &magnitude)) {
+    r = (unsigned long long) magnitude;
+    e = &self.data[self.len];
+  } else {
+    r = self.len == 0 ? 0 : wcstoull(self.data, &e, o1 == 0 ? 10 : radix);
+  }
 
   if (errno == ERANGE || SIZE_MAX < r || (self.len != 0 && self.data[0] == L'-')) {
     d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
@@ -786,6 +1232,8 @@ size_t d4_str_toUsize (d4_err_state_t *state, int line, int col, const d4_str_t
 uint8_t d4_str_toU8 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {\
   wchar_t *e = NULL;
   unsigned long r;
+  bool negative;
+  uint64_t magnitude;
 
   if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
     d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
@@ -795,7 +1243,13 @@ uint8_t d4_str_toU8 (d4_err_state_t *state, int line, int col, const d4_str_t se
   }
 
   errno = 0;
-  r = self.len == 0 ? 0 : wcstoul(self.data, &e, o1 == 0 ? 10 : radix);
+
+  if (d4_str_parse_int(self, o1 == 0 ? 10 : radix, false, ULONG_MAX, &negative, &magnitude)) {
+    r = (unsigned long) magnitude;
+    e = &self.data[self.len];
+  } else {
+    r = self.len == 0 ? 0 : wcstoul(self.data, &e, o1 == 0 ? 10 : radix);
+  }
 
   if (errno == ERANGE || UINT8_MAX < r || (self.len != 0 && self.data[0] == L'-')) {
     d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
@@ -819,6 +1273,8 @@ uint8_t d4_str_toU8 (d4_err_state_t *state, int line, int col, const d4_str_t se
 uint16_t d4_str_toU16 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
   wchar_t *e = NULL;
   unsigned long r;
+  bool negative;
+  uint64_t magnitude;
 
   if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
     d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
@@ -828,7 +1284,13 @@ uint16_t d4_str_toU16 (d4_err_state_t *state, int line, int col, const d4_str_t
   }
 
   errno = 0;
-  r = self.len == 0 ? 0 : wcstoul(self.data, &e, o1 == 0 ? 10 : radix);
+
+  if (d4_str_parse_int(self, o1 == 0 ? 10 : radix, false, ULONG_MAX, &negative, &magnitude)) {
+    r = (unsigned long) magnitude;
+    e = &self.data[self.len];
+  } else {
+    r = self.len == 0 ? 0 : wcstoul(self.data, &e, o1 == 0 ? 10 : radix);
+  }
 
   if (errno == ERANGE || UINT16_MAX < r || (self.len != 0 && self.data[0] == L'-')) {
     d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
@@ -852,6 +1314,8 @@ uint16_t d4_str_toU16 (d4_err_state_t *state, int line, int col, const d4_str_t
 uint32_t d4_str_toU32 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
   wchar_t *e = NULL;
   unsigned long r;
+  bool negative;
+  uint64_t magnitude;
 
   if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
     d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
@@ -861,7 +1325,13 @@ uint32_t d4_str_toU32 (d4_err_state_t *state, int line, int col, const d4_str_t
   }
 
   errno = 0;
-  r = self.len == 0 ? 0 : wcstoul(self.data, &e, o1 == 0 ? 10 : radix);
+
+  if (d4_str_parse_int(self, o1 == 0 ? 10 : radix, false, ULONG_MAX, &negative, &magnitude)) {
+    r = (unsigned long) magnitude;
+    e = &self.data[self.len];
+  } else {
+    r = self.len == 0 ? 0 : wcstoul(self.data, &e, o1 == 0 ? 10 : radix);
+  }
 
   if (errno == ERANGE || UINT32_MAX < r || (self.len != 0 && self.data[0] == L'-')) {
     d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
@@ -885,6 +1355,8 @@ uint32_t d4_str_toU32 (d4_err_state_t *state, int line, int col, const d4_str_t
 uint64_t d4_str_toU64 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
   wchar_t *e = NULL;
   unsigned long long r;
+  bool negative;
+  uint64_t magnitude;
 
   if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
     d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
@@ -894,7 +1366,13 @@ uint64_t d4_str_toU64 (d4_err_state_t *state, int line, int col, const d4_str_t
   }
 
   errno = 0;
-  r = self.len == 0 ? 0 : wcstoull(self.data, &e, o1 == 0 ? 10 : radix);
+
+  if (d4_str_parse_int(self, o1 == 0 ? 10 : radix, false, ULLONG_MAX, &negative, &magnitude)) {
+    r = (unsigned long long) magnitude;
+    e = &self.data[self.len];
+  } else {
+    r = self.len == 0 ? 0 : wcstoull(self.data, &e, o1 == 0 ? 10 : radix);
+  }
 
   if (errno == ERANGE || UINT64_MAX < r || (self.len != 0 && self.data[0] == L'-')) {
     d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
@@ -915,89 +1393,62 @@ uint64_t d4_str_toU64 (d4_err_state_t *state, int line, int col, const d4_str_t
   return (uint64_t) r;
 }
 
-d4_str_t d4_str_trim (const d4_str_t self) {
+size_t d4_str_toUtf8 (const d4_str_t self, char *buf) {
   size_t i = 0;
-  size_t j = self.len;
-  size_t l;
-
-  if (self.len == 0) {
-    return d4_str_empty_val;
-  }
-
-  while (i < self.len && isspace(self.data[i])) {
-    i++;
-  }
-
-  while (isspace(self.data[j - 1])) {
-    j--;
-    if (j == 0) break;
-  }
+  size_t j = 0;
 
-  if (i >= j) {
-    return d4_str_empty_val;
+  while (i < self.len) {
+    if (i + D4_STR_BLOCK_LEN <= self.len && d4_str_block_ascii(&self.data[i])) {
+      for (size_t k = 0; k < D4_STR_BLOCK_LEN; k++) buf[j + k] = (char) self.data[i + k];
+      i += D4_STR_BLOCK_LEN;
+      j += D4_STR_BLOCK_LEN;
+    } else if ((uint32_t) self.data[i] < 0x80) {
+      buf[j++] = (char) self.data[i++];
+    } else {
+      j += d4_str_utf8_encode(&buf[j], d4_str_utf16_decode(self, &i));
+    }
   }
 
-  l = j - i;
-  return d4_str_calloc(&self.data[i], l);
+  return j;
 }
 
-d4_str_t d4_str_trimEnd (const d4_str_t self) {
-  size_t l = self.len;
+size_t d4_str_toUtf8Len (const d4_str_t self) {
+  size_t result = 0;
 
-  if (self.len == 0) {
-    return d4_str_empty_val;
+  if (sizeof(wchar_t) == 2) {
+    for (size_t i = 0; i < self.len;) result += d4_str_utf8_size(d4_str_utf16_decode(self, &i));
+  } else {
+    for (size_t i = 0; i < self.len; i++) result += d4_str_utf8_size((uint32_t) self.data[i]);
   }
 
-  while (isspace(self.data[l - 1])) {
-    l--;
+  return result;
+}
 
-    if (l == 0) {
-      return d4_str_empty_val;
-    }
-  }
+d4_str_t d4_str_trim (const d4_str_t self) {
+  return d4_strview_toOwned(d4_strview_trim(d4_strview_from(self)));
+}
 
-  return d4_str_calloc(self.data, l);
+d4_str_t d4_str_trimEnd (const d4_str_t self) {
+  return d4_strview_toOwned(d4_strview_trimEnd(d4_strview_from(self)));
 }
 
 d4_str_t d4_str_trimStart (const d4_str_t self) {
-  size_t i = 0;
-
-  if (self.len == 0) {
-    return d4_str_empty_val;
-  }
-
-  while (i < self.len && isspace(self.data[i])) {
-    i++;
-  }
-
-  if (i >= self.len) {
-    return d4_str_empty_val;
-  }
-
-  return d4_str_calloc(&self.data[i], self.len - i);
+  return d4_strview_toOwned(d4_strview_trimStart(d4_strview_from(self)));
 }
 
 d4_str_t d4_str_upper (const d4_str_t self) {
-  d4_str_t d = d4_str_copy(self);
-
-  if (self.len == 0) {
-    return d;
-  }
-
-  for (size_t i = 0; i < d.len; i++) {
-    d.data[i] = (wchar_t) toupper(d.data[i]);
-  }
-
-  return d;
+  return d4_str_case(self, true);
 }
 
 d4_str_t d4_str_upperFirst (const d4_str_t self) {
-  d4_str_t d = d4_str_copy(self);
+  d4_str_t d;
 
   if (self.len == 0) {
-    return d;
+    return d4_str_empty_val;
   }
 
-  d.data[0] = (wchar_t) toupper(d.data[0]);
+  d = d4_str_copy_mutable(self);
+
+  d.data[0] = d4_str_char_upper(d.data[0]);
   return d;
 }
@@ -9,6 +9,11 @@
 #include "../include/d4/string.h"
 
 int snwprintf (const wchar_t *, ...);
+size_t d4_str_search (const wchar_t *, size_t, const wchar_t *, size_t);
+d4_str_t d4_str_utf8_decode (const char *, size_t);
+size_t d4_str_utf8_decodeChar (const char *, size_t, size_t, uint32_t *);
+size_t d4_str_utf8_encode (char *, uint32_t);
+size_t d4_str_utf8_validate (const char *, size_t);
 int vsnwprintf (const wchar_t *, va_list);
 
 #endif
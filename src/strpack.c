@@ -0,0 +1,243 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include "strpack.h"
+#include <string.h>
+#include "safe.h"
+
+static const d4_strpack_t d4_strpack_empty_val = {NULL, 0, D4_STRPACK_LATIN1};
+
+static unsigned char d4_strpack_kind (uint32_t mask) {
+  return mask < 0x100 ? D4_STRPACK_LATIN1 : mask < 0x10000 ? D4_STRPACK_UCS2 : D4_STRPACK_UCS4;
+}
+
+/* Combines all characters in the range of packed string with bitwise or, which is below the limit of a kind only when every character is. */
+static uint32_t d4_strpack_mask (const d4_strpack_t self, size_t start, size_t end) {
+  uint32_t mask = 0;
+
+  if (self.kind == D4_STRPACK_UCS2) {
+    const uint16_t *data = self.data;
+    for (size_t i = start; i < end; i++) mask |= data[i];
+  } else if (self.kind == D4_STRPACK_UCS4) {
+    const uint32_t *data = self.data;
+    for (size_t i = start; i < end; i++) mask |= data[i];
+  }
+
+  return mask;
+}
+
+static void d4_strpack_set (void *data, unsigned char kind, size_t index, uint32_t c) {
+  if (kind == D4_STRPACK_LATIN1) {
+    ((uint8_t *) data)[index] = (uint8_t) c;
+  } else if (kind == D4_STRPACK_UCS2) {
+    ((uint16_t *) data)[index] = (uint16_t) c;
+  } else {
+    ((uint32_t *) data)[index] = c;
+  }
+}
+
+/* Writes len characters of src starting at src_start into data of provided kind at index, kind must fit all written characters. */
+static void d4_strpack_write (void *data, unsigned char kind, size_t index, const d4_strpack_t src, size_t src_start, size_t len) {
+  if (src.kind == kind) {
+    memcpy((char *) data + index * kind, (const char *) src.data + src_start * kind, len * kind);
+    return;
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    d4_strpack_set(data, kind, index + i, d4_strpack_at(src, src_start + i));
+  }
+}
+
+uint32_t d4_strpack_at (const d4_strpack_t self, size_t index) {
+  if (self.kind == D4_STRPACK_LATIN1) {
+    return ((const uint8_t *) self.data)[index];
+  } else if (self.kind == D4_STRPACK_UCS2) {
+    return ((const uint16_t *) self.data)[index];
+  }
+
+  return ((const uint32_t *) self.data)[index];
+}
+
+d4_strpack_t d4_strpack_concat (const d4_strpack_t self, const d4_strpack_t other) {
+  unsigned char kind = self.kind > other.kind ? self.kind : other.kind;
+  size_t len = self.len + other.len;
+  void *data;
+
+  if (len == 0) {
+    return d4_strpack_empty_val;
+  } else if (self.len == 0 || other.len == 0) {
+    return d4_strpack_copy(self.len == 0 ? other : self);
+  }
+
+  data = d4_safe_alloc(len * kind);
+  d4_strpack_write(data, kind, 0, self, 0, self.len);
+  d4_strpack_write(data, kind, self.len, other, 0, other.len);
+  return (d4_strpack_t) {data, len, kind};
+}
+
+d4_strpack_t d4_strpack_copy (const d4_strpack_t self) {
+  void *data;
+
+  if (self.len == 0) {
+    return d4_strpack_empty_val;
+  }
+
+  data = d4_safe_alloc(self.len * self.kind);
+  memcpy(data, self.data, self.len * self.kind);
+  return (d4_strpack_t) {data, self.len, self.kind};
+}
+
+bool d4_strpack_eq (const d4_strpack_t self, const d4_strpack_t rhs) {
+  return self.len == rhs.len && (self.len == 0 || (self.kind == rhs.kind && memcmp(self.data, rhs.data, self.len * self.kind) == 0));
+}
+
+int32_t d4_strpack_find (const d4_strpack_t self, const d4_strpack_t search) {
+  const char *data = self.data;
+  const char *needle = search.data;
+  void *widened = NULL;
+  size_t last = self.len - search.len;
+  size_t size = search.len * self.kind;
+  uint32_t first;
+  int32_t result = -1;
+
+  if (search.len == 0) {
+    return 0;
+  } else if (search.len > self.len || search.kind > self.kind) {
+    return -1;
+  } else if (search.kind != self.kind) {
+    widened = d4_safe_alloc(size);
+    d4_strpack_write(widened, self.kind, 0, search, 0, search.len);
+    needle = widened;
+  }
+
+  first = d4_strpack_at(search, 0);
+
+  for (size_t i = 0; i <= last; i++) {
+    if (self.kind == D4_STRPACK_LATIN1) {
+      const char *it = memchr(&data[i], (int) first, last - i + 1);
+      if (it == NULL) break;
+      i = (size_t) (it - data);
+    } else if (d4_strpack_at(self, i) != first) {
+      continue;
+    }
+
+    if (memcmp(&data[i * self.kind], needle, size) == 0) {
+      result = (int32_t) i;
+      break;
+    }
+  }
+
+  d4_safe_free(widened);
+  return result;
+}
+
+void d4_strpack_free (d4_strpack_t self) {
+  d4_safe_free(self.data);
+}
+
+d4_strpack_t d4_strpack_from (const d4_str_t str) {
+  uint32_t mask = 0;
+  unsigned char kind;
+  void *data;
+
+  if (str.len == 0) {
+    return d4_strpack_empty_val;
+  }
+
+  for (size_t i = 0; i < str.len; i++) {
+    mask |= (uint32_t) str.data[i];
+  }
+
+  kind = d4_strpack_kind(mask);
+  data = d4_safe_alloc(str.len * kind);
+
+  if (kind == D4_STRPACK_LATIN1) {
+    uint8_t *d = data;
+    for (size_t i = 0; i < str.len; i++) d[i] = (uint8_t) str.data[i];
+  } else if (kind == D4_STRPACK_UCS2) {
+    uint16_t *d = data;
+    for (size_t i = 0; i < str.len; i++) d[i] = (uint16_t) str.data[i];
+  } else {
+    uint32_t *d = data;
+    for (size_t i = 0; i < str.len; i++) d[i] = (uint32_t) str.data[i];
+  }
+
+  return (d4_strpack_t) {data, str.len, kind};
+}
+
+size_t d4_strpack_hash (const d4_strpack_t self, size_t cap) {
+  size_t result = 0xcbf29ce484222325;
+
+  if (self.kind == D4_STRPACK_LATIN1) {
+    const uint8_t *data = self.data;
+
+    for (size_t i = 0; i < self.len; i++) {
+      result *= 0x100000001b3;
+      result ^= (size_t) data[i];
+    }
+  } else {
+    for (size_t i = 0; i < self.len; i++) {
+      result *= 0x100000001b3;
+      result ^= (size_t) d4_strpack_at(self, i);
+    }
+  }
+
+  return result % cap;
+}
+
+d4_strpack_t d4_strpack_slice (const d4_strpack_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end) {
+  int32_t i = 0;
+  int32_t j = 0;
+  unsigned char kind;
+  void *data;
+
+  if (o1 != 0 && start < 0 && start >= -((int32_t) self.len)) {
+    i = (int32_t) ((size_t) start + self.len);
+  } else if (o1 != 0 && start >= 0) {
+    i = (int32_t) ((size_t) start > self.len ? self.len : (size_t) start);
+  }
+
+  if (o2 == 0 || (end >= 0 && (size_t) end > self.len)) {
+    j = (int32_t) self.len;
+  } else if (end < 0 && end >= -((int32_t) self.len)) {
+    j = (int32_t) ((size_t) end + self.len);
+  } else if (end >= 0) {
+    j = (int32_t) end;
+  }
+
+  if (i >= j || (size_t) i >= self.len) {
+    return d4_strpack_empty_val;
+  }
+
+  kind = d4_strpack_kind(d4_strpack_mask(self, (size_t) i, (size_t) j));
+  data = d4_safe_alloc((size_t) (j - i) * kind);
+  d4_strpack_write(data, kind, 0, self, (size_t) i, (size_t) (j - i));
+  return (d4_strpack_t) {data, (size_t) (j - i), kind};
+}
+
+d4_str_t d4_strpack_toStr (const d4_strpack_t self) {
+  wchar_t *d;
+
+  if (self.len == 0) {
+    return d4_str_empty_val;
+  }
+
+  d = d4_safe_alloc((self.len + 1) * sizeof(wchar_t));
+
+  if (self.kind == D4_STRPACK_LATIN1) {
+    const uint8_t *data = self.data;
+    for (size_t i = 0; i < self.len; i++) d[i] = (wchar_t) data[i];
+  } else if (self.kind == D4_STRPACK_UCS2) {
+    const uint16_t *data = self.data;
+    for (size_t i = 0; i < self.len; i++) d[i] = (wchar_t) data[i];
+  } else {
+    const uint32_t *data = self.data;
+    for (size_t i = 0; i < self.len; i++) d[i] = (wchar_t) data[i];
+  }
+
+  d[self.len] = L'\0';
+  return (d4_str_t) {d, self.len, false};
+}
@@ -0,0 +1,11 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef SRC_STRPACK_H
+#define SRC_STRPACK_H
+
+#include "../include/d4/strpack.h"
+
+#endif
@@ -0,0 +1,202 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include "strview.h"
+#include <string.h>
+#include <wctype.h>
+#include "../include/d4/array.h"
+#include "safe.h"
+#include "string.h"
+
+D4_ARRAY_DEFINE(strview, d4_strview_t, d4_strview_t, element, d4_strview_eq(lhs_element, rhs_element), (void) element, d4_strview_toOwned(element))
+
+/* Whether character is whitespace, ASCII characters are checked without calling iswspace. */
+static bool d4_strview_isSpace (wchar_t c) {
+  return (uint32_t) c < 0x80 ? c == L' ' || (uint32_t) c - L'\t' < 5 : iswspace((wint_t) c) != 0;
+}
+
+/* Appends piece to array of string views, doubling its capacity so that collecting pieces stays linear. */
+static void d4_strview_push (d4_arr_strview_t *self, size_t *cap, const d4_strview_t piece) {
+  if (self->len == *cap) {
+    *cap = *cap == 0 ? 8 : *cap * 2;
+    self->data = d4_safe_realloc(self->data, *cap * sizeof(d4_strview_t));
+  }
+
+  self->data[self->len++] = piece;
+}
+
+/* Collects at most n pieces of the cursor, the last one holds the rest of the string view. */
+static d4_arr_strview_t d4_strview_collect (d4_strview_iter_t it, size_t n) {
+  d4_arr_strview_t result = {NULL, 0};
+  size_t cap = 0;
+  d4_strview_t piece;
+
+  while (result.len + 1 < n && d4_strview_iter_next(&it, &piece)) {
+    d4_strview_push(&result, &cap, piece);
+  }
+
+  if (result.len + 1 == n && !it.done) {
+    d4_strview_push(&result, &cap, d4_strview_iter_rest(it));
+  }
+
+  return result;
+}
+
+bool d4_strview_contains (const d4_strview_t self, const d4_strview_t search) {
+  return search.len == 0 || d4_str_search(self.data, self.len, search.data, search.len) != SIZE_MAX;
+}
+
+bool d4_strview_endsWith (const d4_strview_t self, const d4_strview_t search) {
+  return search.len <= self.len && memcmp(&self.data[self.len - search.len], search.data, search.len * sizeof(wchar_t)) == 0;
+}
+
+bool d4_strview_eq (const d4_strview_t self, const d4_strview_t rhs) {
+  return self.len == rhs.len && memcmp(self.data, rhs.data, self.len * sizeof(wchar_t)) == 0;
+}
+
+int32_t d4_strview_find (const d4_strview_t self, const d4_strview_t search) {
+  size_t index = d4_str_search(self.data, self.len, search.data, search.len);
+  return index == SIZE_MAX ? -1 : (int32_t) index;
+}
+
+d4_strview_t d4_strview_from (const d4_str_t str) {
+  return (d4_strview_t) {str.data, str.len};
+}
+
+bool d4_strview_iter_next (d4_strview_iter_t *self, d4_strview_t *piece) {
+  size_t start = self->pos;
+
+  if (self->done) {
+    return false;
+  } else if (self->lines) {
+    for (size_t j = start; j < self->view.len; j++) {
+      wchar_t c = self->view.data[j];
+
+      if (c == L'\r' || c == L'\n') {
+        size_t beforeLineBreak = j;
+
+        if (c == L'\r' && j + 1 < self->view.len && self->view.data[j + 1] == L'\n') {
+          j++;
+        }
+
+        *piece = (d4_strview_t) {&self->view.data[start], (self->keepLineBreaks ? j + 1 : beforeLineBreak) - start};
+        self->pos = j + 1;
+        self->done = self->pos == self->view.len;
+        return true;
+      }
+    }
+
+    self->done = true;
+    if (start == self->view.len) return false;
+    *piece = (d4_strview_t) {&self->view.data[start], self->view.len - start};
+    self->pos = self->view.len;
+    return true;
+  } else if (self->delimiter.len == 0) {
+    self->done = start + 1 >= self->view.len;
+    if (start == self->view.len) return false;
+    *piece = (d4_strview_t) {&self->view.data[start], 1};
+    self->pos = start + 1;
+    return true;
+  } else {
+    size_t index = d4_str_search(&self->view.data[start], self->view.len - start, self->delimiter.data, self->delimiter.len);
+
+    if (index == SIZE_MAX) {
+      *piece = (d4_strview_t) {self->view.len == 0 ? NULL : &self->view.data[start], self->view.len - start};
+      self->pos = self->view.len;
+      self->done = true;
+    } else {
+      *piece = (d4_strview_t) {&self->view.data[start], index};
+      self->pos = start + index + self->delimiter.len;
+    }
+
+    return true;
+  }
+}
+
+d4_strview_t d4_strview_iter_rest (const d4_strview_iter_t self) {
+  if (self.done || self.pos == self.view.len) {
+    return (d4_strview_t) {NULL, 0};
+  }
+
+  return (d4_strview_t) {&self.view.data[self.pos], self.view.len - self.pos};
+}
+
+d4_arr_strview_t d4_strview_lines (const d4_strview_t self, unsigned char o1, bool keepLineBreaks) {
+  return d4_strview_collect(d4_strview_linesIter(self, o1, keepLineBreaks), SIZE_MAX);
+}
+
+d4_strview_iter_t d4_strview_linesIter (const d4_strview_t self, unsigned char o1, bool keepLineBreaks) {
+  return (d4_strview_iter_t) {self, {NULL, 0}, 0, true, o1 == 0 ? false : keepLineBreaks, self.len == 0};
+}
+
+d4_strview_t d4_strview_slice (const d4_strview_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end) {
+  int32_t i = 0;
+  int32_t j = 0;
+
+  if (o1 != 0 && start < 0 && start >= -((int32_t) self.len)) {
+    i = (int32_t) ((size_t) start + self.len);
+  } else if (o1 != 0 && start >= 0) {
+    i = (int32_t) ((size_t) start > self.len ? self.len : (size_t) start);
+  }
+
+  if (o2 == 0 || (end >= 0 && (size_t) end > self.len)) {
+    j = (int32_t) self.len;
+  } else if (end < 0 && end >= -((int32_t) self.len)) {
+    j = (int32_t) ((size_t) end + self.len);
+  } else if (end >= 0) {
+    j = (int32_t) end;
+  }
+
+  if (i >= j || (size_t) i >= self.len) {
+    return (d4_strview_t) {NULL, 0};
+  }
+
+  return (d4_strview_t) {&self.data[i], (size_t) (j - i)};
+}
+
+d4_arr_strview_t d4_strview_split (const d4_strview_t self, unsigned char o1, const d4_strview_t delimiter) {
+  return d4_strview_collect(d4_strview_splitIter(self, o1, delimiter), SIZE_MAX);
+}
+
+d4_strview_iter_t d4_strview_splitIter (const d4_strview_t self, D4_UNUSED unsigned char o1, const d4_strview_t delimiter) {
+  return (d4_strview_iter_t) {self, delimiter, 0, false, false, self.len == 0 && delimiter.len == 0};
+}
+
+d4_arr_strview_t d4_strview_splitN (const d4_strview_t self, unsigned char o1, const d4_strview_t delimiter, size_t n) {
+  return d4_strview_collect(d4_strview_splitIter(self, o1, delimiter), n);
+}
+
+bool d4_strview_startsWith (const d4_strview_t self, const d4_strview_t search) {
+  return self.len >= search.len && memcmp(self.data, search.data, search.len * sizeof(wchar_t)) == 0;
+}
+
+d4_str_t d4_strview_toOwned (const d4_strview_t self) {
+  return d4_str_calloc(self.data, self.len);
+}
+
+d4_strview_t d4_strview_trim (const d4_strview_t self) {
+  return d4_strview_trimStart(d4_strview_trimEnd(self));
+}
+
+d4_strview_t d4_strview_trimEnd (const d4_strview_t self) {
+  size_t l = self.len;
+
+  while (l != 0 && d4_strview_isSpace(self.data[l - 1])) {
+    l--;
+  }
+
+  return (d4_strview_t) {l == 0 ? NULL : self.data, l};
+}
+
+d4_strview_t d4_strview_trimStart (const d4_strview_t self) {
+  size_t i = 0;
+
+  while (i < self.len && d4_strview_isSpace(self.data[i])) {
+    i++;
+  }
+
+  return i == self.len ? (d4_strview_t) {NULL, 0} : (d4_strview_t) {&self.data[i], self.len - i};
+}
@@ -0,0 +1,11 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef SRC_STRVIEW_H
+#define SRC_STRVIEW_H
+
+#include "../include/d4/strview.h"
+
+#endif
@@ -0,0 +1,525 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include "utf8.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <wctype.h>
+#include "../include/d4/array.h"
+#include "safe.h"
+#include "string.h"
+
+D4_ARRAY_DEFINE(utf8, d4_utf8_t, d4_utf8_t, d4_utf8_copy(element), d4_utf8_eq(lhs_element, rhs_element), d4_utf8_free(element), d4_utf8_str(element))
+
+d4_utf8_t d4_utf8_empty_val = {NULL, 0, true};
+
+/* Bytes of the UTF-8 string that is being built, grows geometrically and reserves one byte for null terminator. */
+typedef struct {
+  char *data;
+  size_t len;
+  size_t cap;
+} d4_utf8_builder_t;
+
+static void d4_utf8_builder_append (d4_utf8_builder_t *self, const char *data, size_t len) {
+  if (len == 0) {
+    return;
+  } else if (len >= self->cap - self->len) {
+    size_t cap = self->cap == 0 ? 16 : self->cap * 2;
+    while (cap - self->len <= len) cap *= 2;
+    self->data = d4_safe_realloc(self->data, cap);
+    self->cap = cap;
+  }
+
+  memcpy(&self->data[self->len], data, len);
+  self->len += len;
+}
+
+static d4_utf8_t d4_utf8_builder_finish (d4_utf8_builder_t *self) {
+  if (self->len == 0) {
+    d4_safe_free(self->data);
+    return d4_utf8_empty_val;
+  }
+
+  self->data[self->len] = '\0';
+  return (d4_utf8_t) {self->data, self->len, false};
+}
+
+/* Decodes character at index and moves index past it, invalid sequences are decoded as U+FFFD one byte at a time. */
+static uint32_t d4_utf8_decode (const d4_utf8_t self, size_t *index) {
+  uint32_t c;
+  size_t n = d4_str_utf8_decodeChar(self.data, self.len, *index, &c);
+
+  *index += n == 0 ? 1 : n;
+  return n == 0 ? 0xFFFD : c;
+}
+
+static size_t d4_utf8_next (const d4_utf8_t self, size_t index) {
+  if ((unsigned char) self.data[index] < 0x80) {
+    return index + 1;
+  }
+
+  d4_utf8_decode(self, &index);
+  return index;
+}
+
+/* Returns byte offset of the character index, or length when index is past the end. */
+static size_t d4_utf8_offset (const d4_utf8_t self, size_t index) {
+  size_t i = 0;
+
+  while (index-- != 0 && i < self.len) {
+    i = d4_utf8_next(self, i);
+  }
+
+  return i;
+}
+
+static size_t d4_utf8_search (const char *self, size_t self_len, const char *search, size_t search_len) {
+  const char *it = self;
+  const char *end;
+
+  if (search_len == 0 || search_len > self_len) {
+    return search_len == 0 ? 0 : SIZE_MAX;
+  }
+
+  end = self + self_len - search_len + 1;
+
+  while (it < end && (it = memchr(it, (unsigned char) search[0], (size_t) (end - it))) != NULL) {
+    if (memcmp(it, search, search_len) == 0) {
+      return (size_t) (it - self);
+    }
+
+    it++;
+  }
+
+  return SIZE_MAX;
+}
+
+static bool d4_utf8_isSpace (uint32_t c) {
+  return c < 0x80 ? c == ' ' || c - '\t' < 5 : iswspace((wint_t) c) != 0;
+}
+
+static size_t d4_utf8_trimStartOffset (const d4_utf8_t self, size_t end) {
+  size_t i = 0;
+
+  while (i < end) {
+    size_t next = i;
+    if (!d4_utf8_isSpace(d4_utf8_decode(self, &next))) break;
+    i = next;
+  }
+
+  return i;
+}
+
+static size_t d4_utf8_trimEndOffset (const d4_utf8_t self) {
+  size_t j = self.len;
+
+  while (j != 0) {
+    size_t start = j - 1;
+    size_t next;
+
+    while (start != 0 && ((unsigned char) self.data[start] & 0xC0) == 0x80 && j - start < 4) {
+      start--;
+    }
+
+    next = start;
+    if (!d4_utf8_isSpace(d4_utf8_decode(self, &next)) || next != j) break;
+    j = start;
+  }
+
+  return j;
+}
+
+static void d4_utf8_push (d4_arr_utf8_t *self, size_t *cap, const d4_utf8_t piece) {
+  if (self->len == *cap) {
+    *cap = *cap == 0 ? 8 : *cap * 2;
+    self->data = d4_safe_realloc(self->data, *cap * sizeof(d4_utf8_t));
+  }
+
+  self->data[self->len++] = piece;
+}
+
+static d4_utf8_t d4_utf8_case (const d4_utf8_t self, bool upper) {
+  d4_utf8_builder_t result = {NULL, 0, 0};
+  unsigned char mask = 0;
+  size_t i = 0;
+
+  for (size_t j = 0; j < self.len; j++) {
+    mask |= (unsigned char) self.data[j];
+  }
+
+  /* ASCII strings are mapped byte by byte without branches, others are decoded and mapped with towlower or towupper. */
+  if (mask < 0x80) {
+    char *d;
+
+    if (self.len == 0) {
+      return d4_utf8_empty_val;
+    }
+
+    d = d4_safe_alloc(self.len + 1);
+
+    for (size_t j = 0; j < self.len; j++) {
+      unsigned char c = (unsigned char) self.data[j];
+      d[j] = (char) (upper ? c ^ (((unsigned char) (c - 'a') < 26) << 5) : c | (((unsigned char) (c - 'A') < 26) << 5));
+    }
+
+    d[self.len] = '\0';
+    return (d4_utf8_t) {d, self.len, false};
+  }
+
+  while (i < self.len) {
+    char buf[4];
+    uint32_t c = d4_utf8_decode(self, &i);
+    c = upper ? (uint32_t) towupper((wint_t) c) : (uint32_t) towlower((wint_t) c);
+    d4_utf8_builder_append(&result, buf, d4_str_utf8_encode(buf, c));
+  }
+
+  return d4_utf8_builder_finish(&result);
+}
+
+static int d4_utf8_cmp (const d4_utf8_t self, const d4_utf8_t rhs) {
+  int cmp;
+
+  if (self.len == 0 || rhs.len == 0) {
+    return self.len == rhs.len ? 0 : self.len < rhs.len ? -1 : 1;
+  }
+
+  cmp = memcmp(self.data, rhs.data, self.len < rhs.len ? self.len : rhs.len);
+  return cmp != 0 ? cmp : self.len == rhs.len ? 0 : self.len < rhs.len ? -1 : 1;
+}
+
+d4_utf8_t d4_utf8_alloc (const char *fmt, ...) {
+  va_list args;
+  va_list args_copy;
+  char *d;
+  int y;
+
+  if (fmt == NULL) {
+    return d4_utf8_empty_val;
+  }
+
+  va_start(args, fmt);
+  va_copy(args_copy, args);
+  y = vsnprintf(NULL, 0, fmt, args_copy);
+  va_end(args_copy);
+
+  if (y <= 0) {
+    va_end(args);
+    return d4_utf8_empty_val;
+  }
+
+  d = d4_safe_alloc((size_t) y + 1);
+  vsnprintf(d, (size_t) y + 1, fmt, args);
+  va_end(args);
+
+  return (d4_utf8_t) {d, (size_t) y, false};
+}
+
+d4_utf8_t d4_utf8_calloc (const char *self, size_t length) {
+  char *d;
+
+  if (length == 0) {
+    return d4_utf8_empty_val;
+  }
+
+  d = d4_safe_alloc(length + 1);
+  memcpy(d, self, length);
+  d[length] = '\0';
+  return (d4_utf8_t) {d, length, false};
+}
+
+d4_utf8_t d4_utf8_concat (const d4_utf8_t self, const d4_utf8_t other) {
+  d4_utf8_builder_t result = {NULL, 0, 0};
+
+  d4_utf8_builder_append(&result, self.data, self.len);
+  d4_utf8_builder_append(&result, other.data, other.len);
+  return d4_utf8_builder_finish(&result);
+}
+
+bool d4_utf8_contains (const d4_utf8_t self, const d4_utf8_t search) {
+  return d4_utf8_search(self.data, self.len, search.data, search.len) != SIZE_MAX;
+}
+
+d4_utf8_t d4_utf8_copy (const d4_utf8_t self) {
+  return d4_utf8_calloc(self.data, self.len);
+}
+
+bool d4_utf8_empty (const d4_utf8_t self) {
+  return self.len == 0;
+}
+
+bool d4_utf8_endsWith (const d4_utf8_t self, const d4_utf8_t search) {
+  return search.len == 0 || (search.len <= self.len && memcmp(&self.data[self.len - search.len], search.data, search.len) == 0);
+}
+
+bool d4_utf8_eq (const d4_utf8_t self, const d4_utf8_t rhs) {
+  return self.len == rhs.len && (self.len == 0 || memcmp(self.data, rhs.data, self.len) == 0);
+}
+
+d4_utf8_t d4_utf8_escape (const d4_utf8_t self) {
+  d4_utf8_builder_t result = {NULL, 0, 0};
+  size_t start = 0;
+
+  for (size_t i = 0; i < self.len; i++) {
+    char escaped[2] = {'\\', 0};
+
+    switch (self.data[i]) {
+      case '\f': escaped[1] = 'f'; break;
+      case '\n': escaped[1] = 'n'; break;
+      case '\r': escaped[1] = 'r'; break;
+      case '\t': escaped[1] = 't'; break;
+      case '\v': escaped[1] = 'v'; break;
+      case '"': escaped[1] = '"'; break;
+      default: continue;
+    }
+
+    d4_utf8_builder_append(&result, &self.data[start], i - start);
+    d4_utf8_builder_append(&result, escaped, 2);
+    start = i + 1;
+  }
+
+  d4_utf8_builder_append(&result, &self.data[start], self.len - start);
+  return d4_utf8_builder_finish(&result);
+}
+
+int32_t d4_utf8_find (const d4_utf8_t self, const d4_utf8_t search) {
+  size_t index = d4_utf8_search(self.data, self.len, search.data, search.len);
+  int32_t result = 0;
+
+  if (index == SIZE_MAX) {
+    return -1;
+  }
+
+  for (size_t i = 0; i < index; i = d4_utf8_next(self, i)) {
+    result++;
+  }
+
+  return result;
+}
+
+void d4_utf8_free (d4_utf8_t self) {
+  if (!self.is_static) {
+    d4_safe_free(self.data);
+  }
+}
+
+d4_utf8_t d4_utf8_fromStr (const d4_str_t str) {
+  size_t len = d4_str_toUtf8Len(str);
+  char *d;
+
+  if (len == 0) {
+    return d4_utf8_empty_val;
+  }
+
+  d = d4_safe_alloc(len + 1);
+  d4_str_toUtf8(str, d);
+  d[len] = '\0';
+  return (d4_utf8_t) {d, len, false};
+}
+
+bool d4_utf8_ge (const d4_utf8_t self, const d4_utf8_t rhs) {
+  return d4_utf8_cmp(self, rhs) >= 0;
+}
+
+bool d4_utf8_gt (const d4_utf8_t self, const d4_utf8_t rhs) {
+  return d4_utf8_cmp(self, rhs) > 0;
+}
+
+bool d4_utf8_le (const d4_utf8_t self, const d4_utf8_t rhs) {
+  return d4_utf8_cmp(self, rhs) <= 0;
+}
+
+size_t d4_utf8_len (const d4_utf8_t self) {
+  size_t result = 0;
+
+  for (size_t i = 0; i < self.len; i = d4_utf8_next(self, i)) {
+    result++;
+  }
+
+  return result;
+}
+
+d4_arr_utf8_t d4_utf8_lines (const d4_utf8_t self, unsigned char o1, bool keepLineBreaks) {
+  bool k = o1 == 0 ? false : keepLineBreaks;
+  d4_arr_utf8_t result = {NULL, 0};
+  size_t cap = 0;
+  size_t start = 0;
+
+  for (size_t j = 0; j < self.len; j++) {
+    char c = self.data[j];
+
+    if (c == '\r' || c == '\n') {
+      size_t beforeLineBreak = j;
+
+      if (c == '\r' && j + 1 < self.len && self.data[j + 1] == '\n') {
+        j++;
+      }
+
+      d4_utf8_push(&result, &cap, d4_utf8_calloc(&self.data[start], (k ? j + 1 : beforeLineBreak) - start));
+      start = j + 1;
+    }
+  }
+
+  if (start != self.len) {
+    d4_utf8_push(&result, &cap, d4_utf8_calloc(&self.data[start], self.len - start));
+  }
+
+  return result;
+}
+
+d4_utf8_t d4_utf8_lower (const d4_utf8_t self) {
+  return d4_utf8_case(self, false);
+}
+
+bool d4_utf8_lt (const d4_utf8_t self, const d4_utf8_t rhs) {
+  return d4_utf8_cmp(self, rhs) < 0;
+}
+
+bool d4_utf8_not (const d4_utf8_t self) {
+  return self.len == 0;
+}
+
+d4_utf8_t d4_utf8_replace (const d4_utf8_t self, const d4_utf8_t search, const d4_utf8_t replacement, D4_UNUSED unsigned char o3, int32_t count) {
+  d4_utf8_builder_t result = {NULL, 0, 0};
+  int32_t k = 0;
+  size_t j = 0;
+
+  if (search.len == 0 && replacement.len > 0) {
+    d4_utf8_builder_append(&result, replacement.data, replacement.len);
+
+    while (j < self.len) {
+      size_t next = d4_utf8_next(self, j);
+      d4_utf8_builder_append(&result, &self.data[j], next - j);
+      j = next;
+
+      if (count <= 0 || ++k < count) {
+        d4_utf8_builder_append(&result, replacement.data, replacement.len);
+      }
+    }
+
+    return d4_utf8_builder_finish(&result);
+  } else if (self.len >= search.len && search.len > 0) {
+    while (count <= 0 || k++ < count) {
+      size_t index = d4_utf8_search(&self.data[j], self.len - j, search.data, search.len);
+      if (index == SIZE_MAX) break;
+      d4_utf8_builder_append(&result, &self.data[j], index);
+      d4_utf8_builder_append(&result, replacement.data, replacement.len);
+      j += index + search.len;
+    }
+  }
+
+  d4_utf8_builder_append(&result, &self.data[j], self.len - j);
+  return d4_utf8_builder_finish(&result);
+}
+
+d4_utf8_t d4_utf8_slice (const d4_utf8_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end) {
+  size_t len = d4_utf8_len(self);
+  int32_t i = 0;
+  int32_t j = 0;
+  size_t from;
+
+  if (o1 != 0 && start < 0 && start >= -((int32_t) len)) {
+    i = (int32_t) ((size_t) start + len);
+  } else if (o1 != 0 && start >= 0) {
+    i = (int32_t) ((size_t) start > len ? len : (size_t) start);
+  }
+
+  if (o2 == 0 || (end >= 0 && (size_t) end > len)) {
+    j = (int32_t) len;
+  } else if (end < 0 && end >= -((int32_t) len)) {
+    j = (int32_t) ((size_t) end + len);
+  } else if (end >= 0) {
+    j = (int32_t) end;
+  }
+
+  if (i >= j || (size_t) i >= len) {
+    return d4_utf8_empty_val;
+  }
+
+  from = d4_utf8_offset(self, (size_t) i);
+  return d4_utf8_calloc(&self.data[from], d4_utf8_offset((d4_utf8_t) {&self.data[from], self.len - from, true}, (size_t) (j - i)));
+}
+
+d4_arr_utf8_t d4_utf8_split (const d4_utf8_t self, D4_UNUSED unsigned char o1, const d4_utf8_t delimiter) {
+  d4_arr_utf8_t result = {NULL, 0};
+  size_t cap = 0;
+  size_t i = 0;
+
+  if (self.len > 0 && delimiter.len == 0) {
+    while (i < self.len) {
+      size_t next = d4_utf8_next(self, i);
+      d4_utf8_push(&result, &cap, d4_utf8_calloc(&self.data[i], next - i));
+      i = next;
+    }
+  } else if (delimiter.len > 0) {
+    size_t index;
+
+    while ((index = d4_utf8_search(&self.data[i], self.len - i, delimiter.data, delimiter.len)) != SIZE_MAX) {
+      d4_utf8_push(&result, &cap, d4_utf8_calloc(&self.data[i], index));
+      i += index + delimiter.len;
+    }
+
+    d4_utf8_push(&result, &cap, d4_utf8_calloc(&self.data[i], self.len - i));
+  }
+
+  return result;
+}
+
+bool d4_utf8_startsWith (const d4_utf8_t self, const d4_utf8_t search) {
+  return search.len == 0 || (self.len >= search.len && memcmp(self.data, search.data, search.len) == 0);
+}
+
+d4_str_t d4_utf8_str (const d4_utf8_t self) {
+  size_t len = 0;
+  size_t j = 0;
+  wchar_t *d;
+
+  if (self.len == 0) {
+    return d4_str_empty_val;
+  } else if (d4_str_utf8_validate(self.data, self.len) == SIZE_MAX) {
+    return d4_str_utf8_decode(self.data, self.len);
+  }
+
+  for (size_t i = 0; i < self.len; len++) {
+    uint32_t c = d4_utf8_decode(self, &i);
+    if (sizeof(wchar_t) == 2 && c >= 0x10000) len++;
+  }
+
+  d = d4_safe_alloc((len + 1) * sizeof(wchar_t));
+
+  for (size_t i = 0; i < self.len;) {
+    uint32_t c = d4_utf8_decode(self, &i);
+
+    if (sizeof(wchar_t) == 2 && c >= 0x10000) {
+      d[j++] = (wchar_t) (0xD800 + ((c - 0x10000) >> 10));
+      d[j++] = (wchar_t) (0xDC00 + ((c - 0x10000) & 0x3FF));
+    } else {
+      d[j++] = (wchar_t) c;
+    }
+  }
+
+  d[len] = L'\0';
+  return (d4_str_t) {d, len, false};
+}
+
+d4_utf8_t d4_utf8_trim (const d4_utf8_t self) {
+  size_t j = d4_utf8_trimEndOffset(self);
+  size_t i = d4_utf8_trimStartOffset(self, j);
+  return d4_utf8_calloc(&self.data[i], j - i);
+}
+
+d4_utf8_t d4_utf8_trimEnd (const d4_utf8_t self) {
+  return d4_utf8_calloc(self.data, d4_utf8_trimEndOffset(self));
+}
+
+d4_utf8_t d4_utf8_trimStart (const d4_utf8_t self) {
+  size_t i = d4_utf8_trimStartOffset(self, self.len);
+  return d4_utf8_calloc(&self.data[i], self.len - i);
+}
+
+d4_utf8_t d4_utf8_upper (const d4_utf8_t self) {
+  return d4_utf8_case(self, true);
+}
@@ -0,0 +1,11 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#ifndef SRC_UTF8_H
+#define SRC_UTF8_H
+
+#include "../include/d4/utf8.h"
+
+#endif
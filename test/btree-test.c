@@ -0,0 +1,550 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include <assert.h>
+#include "../include/d4/btree.h"
+#include "../include/d4/number.h"
+#include "utils.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_BTREE_DECLARE(int, int32_t, int, int32_t)
+D4_BTREE_DEFINE(int, int32_t, int, key, (lhs_key > rhs_key) - (lhs_key < rhs_key), (void) key, d4_i32_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+D4_BTREE_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_BTREE_DEFINE(str, d4_str_t, d4_str_t, d4_str_copy(key), d4_str_lt(lhs_key, rhs_key) ? -1 : d4_str_gt(lhs_key, rhs_key), d4_str_free(key), d4_str_copy(key), str, d4_str_t, d4_str_t, d4_str_copy(val), d4_str_eq(lhs_val, rhs_val), d4_str_free(val), d4_str_quoted_escape(val))
+
+static size_t btree_node_check (const d4_btree_intMSintME_node_t *node, bool root, size_t *leaf_depth, size_t depth) {
+  size_t len = node->len;
+
+  assert(((void) "Node is not overfilled", node->len <= D4_BTREE_MAX_KEYS));
+  assert(((void) "Node is not underfilled", root ? node->len > 0 : node->len >= D4_BTREE_MIN_DEGREE - 1));
+
+  for (size_t i = 1; i < node->len; i++) {
+    assert(((void) "Node keys are sorted", node->keys[i - 1] < node->keys[i]));
+  }
+
+  if (node->leaf) {
+    if (*leaf_depth == 0) *leaf_depth = depth;
+    assert(((void) "Leaves are at the same depth", *leaf_depth == depth));
+    return len;
+  }
+
+  for (size_t i = 0; i <= node->len; i++) {
+    const d4_btree_intMSintME_node_t *child = node->children[i];
+    assert(((void) "Child keys are less than separator", i == node->len || child->keys[child->len - 1] < node->keys[i]));
+    assert(((void) "Child keys are greater than separator", i == 0 || child->keys[0] > node->keys[i - 1]));
+    len += btree_node_check(child, false, leaf_depth, depth + 1);
+  }
+
+  return len;
+}
+
+static void btree_check (const d4_btree_intMSintME_t self) {
+  size_t leaf_depth = 0;
+
+  if (self.root == NULL) {
+    assert(((void) "Empty tree has zero length", self.len == 0));
+    return;
+  }
+
+  assert(((void) "Length matches number of keys", btree_node_check(self.root, true, &leaf_depth, 1) == self.len));
+}
+
+static void test_btree_alloc (void) {
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(0);
+  d4_btree_intMSintME_t b2 = d4_btree_intMSintME_alloc(1, 1, 10);
+  d4_btree_intMSintME_t b3 = d4_btree_intMSintME_alloc(3, 2, 20, 1, 10, 2, 30);
+
+  assert(((void) "Creates B-tree with zero pairs", b1.len == 0 && b1.root == NULL));
+  assert(((void) "Creates B-tree with one pair", b2.len == 1));
+  assert(((void) "Creates B-tree without repeated keys", b3.len == 2));
+
+  d4_btree_intMSintME_free(b1);
+  d4_btree_intMSintME_free(b2);
+  d4_btree_intMSintME_free(b3);
+}
+
+static void test_btree_ceiling (void) {
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(0);
+  d4_btree_intMSintME_iter_t it;
+
+  it = d4_btree_intMSintME_ceiling(b1, 1);
+  assert(((void) "Ceiling of empty B-tree", !d4_btree_intMSintME_iterNext(&it)));
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_btree_intMSintME_set(&b1, i * 2, i);
+  }
+
+  it = d4_btree_intMSintME_ceiling(b1, 500);
+  assert(((void) "Ceiling of existing key", d4_btree_intMSintME_iterNext(&it) && *it.key == 500 && *it.value == 250));
+  assert(((void) "Continues after ceiling", d4_btree_intMSintME_iterNext(&it) && *it.key == 502));
+
+  for (int32_t i = -1; i < 1998; i += 2) {
+    it = d4_btree_intMSintME_ceiling(b1, i);
+    assert(((void) "Ceiling of missing key", d4_btree_intMSintME_iterNext(&it) && *it.key == i + 1));
+  }
+
+  it = d4_btree_intMSintME_ceiling(b1, 1999);
+  assert(((void) "Ceiling after last key", !d4_btree_intMSintME_iterNext(&it)));
+
+  d4_btree_intMSintME_free(b1);
+}
+
+static void test_btree_clear (void) {
+  d4_str_t key = d4_str_alloc(L"key");
+  d4_str_t val = d4_str_alloc(L"val");
+  d4_btree_strMSstrME_t b1 = d4_btree_strMSstrME_alloc(0);
+  d4_btree_strMSstrME_t b2 = d4_btree_strMSstrME_alloc(1, key, val);
+
+  d4_btree_strMSstrME_clear(&b1);
+  assert(((void) "Clears empty B-tree", b1.len == 0 && b1.root == NULL));
+  d4_btree_strMSstrME_clear(&b2);
+  assert(((void) "Clears filled B-tree", b2.len == 0 && b2.root == NULL));
+  d4_btree_strMSstrME_set(&b2, key, val);
+  assert(((void) "Sets after clear", b2.len == 1));
+
+  d4_btree_strMSstrME_free(b1);
+  d4_btree_strMSstrME_free(b2);
+  d4_str_free(key);
+  d4_str_free(val);
+}
+
+static void test_btree_copy (void) {
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(0);
+  d4_btree_intMSintME_t b2;
+  d4_btree_intMSintME_t b3;
+
+  b2 = d4_btree_intMSintME_copy(b1);
+  assert(((void) "Copies empty B-tree", b2.len == 0 && b2.root == NULL));
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_btree_intMSintME_set(&b1, i, i);
+  }
+
+  b3 = d4_btree_intMSintME_copy(b1);
+  btree_check(b3);
+  assert(((void) "Copies filled B-tree", d4_btree_intMSintME_eq(b1, b3)));
+  d4_btree_intMSintME_set(&b3, 1, 2);
+  assert(((void) "Copy doesn't share pairs", !d4_btree_intMSintME_eq(b1, b3)));
+
+  d4_btree_intMSintME_free(b1);
+  d4_btree_intMSintME_free(b2);
+  d4_btree_intMSintME_free(b3);
+}
+
+static void test_btree_empty (void) {
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(0);
+  d4_btree_intMSintME_t b2 = d4_btree_intMSintME_alloc(1, 1, 1);
+
+  assert(((void) "Checks empty B-tree", d4_btree_intMSintME_empty(b1)));
+  assert(((void) "Checks filled B-tree", !d4_btree_intMSintME_empty(b2)));
+
+  d4_btree_intMSintME_free(b1);
+  d4_btree_intMSintME_free(b2);
+}
+
+static void test_btree_eq (void) {
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(0);
+  d4_btree_intMSintME_t b2 = d4_btree_intMSintME_alloc(2, 1, 10, 2, 20);
+  d4_btree_intMSintME_t b3 = d4_btree_intMSintME_alloc(2, 2, 20, 1, 10);
+  d4_btree_intMSintME_t b4 = d4_btree_intMSintME_alloc(2, 1, 10, 2, 30);
+  d4_btree_intMSintME_t b5 = d4_btree_intMSintME_alloc(2, 1, 10, 3, 20);
+
+  assert(((void) "Compares empty B-trees", d4_btree_intMSintME_eq(b1, b1)));
+  assert(((void) "Compares B-trees of different length", !d4_btree_intMSintME_eq(b1, b2)));
+  assert(((void) "Compares B-trees filled in different order", d4_btree_intMSintME_eq(b2, b3)));
+  assert(((void) "Compares B-trees with different values", !d4_btree_intMSintME_eq(b2, b4)));
+  assert(((void) "Compares B-trees with different keys", !d4_btree_intMSintME_eq(b2, b5)));
+
+  d4_btree_intMSintME_free(b1);
+  d4_btree_intMSintME_free(b2);
+  d4_btree_intMSintME_free(b3);
+  d4_btree_intMSintME_free(b4);
+  d4_btree_intMSintME_free(b5);
+}
+
+static void test_btree_floor (void) {
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(0);
+  d4_btree_intMSintME_iter_t it;
+
+  it = d4_btree_intMSintME_floor(b1, 1);
+  assert(((void) "Floor of empty B-tree", !d4_btree_intMSintME_iterNext(&it)));
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_btree_intMSintME_set(&b1, i * 2, i);
+  }
+
+  it = d4_btree_intMSintME_floor(b1, 500);
+  assert(((void) "Floor of existing key", d4_btree_intMSintME_iterNext(&it) && *it.key == 500 && *it.value == 250));
+  assert(((void) "Continues after floor", d4_btree_intMSintME_iterNext(&it) && *it.key == 502));
+
+  for (int32_t i = 1; i < 2000; i += 2) {
+    it = d4_btree_intMSintME_floor(b1, i);
+    assert(((void) "Floor of missing key", d4_btree_intMSintME_iterNext(&it) && *it.key == i - 1));
+    assert(((void) "Continues after floor of missing key", i == 1999 ? !d4_btree_intMSintME_iterNext(&it) : d4_btree_intMSintME_iterNext(&it) && *it.key == i + 1));
+  }
+
+  it = d4_btree_intMSintME_floor(b1, -1);
+  assert(((void) "Floor before first key", !d4_btree_intMSintME_iterNext(&it)));
+
+  d4_btree_intMSintME_free(b1);
+}
+
+static void test_btree_free (void) {
+  d4_str_t key = d4_str_alloc(L"key");
+  d4_str_t val = d4_str_alloc(L"val");
+  d4_btree_strMSstrME_t b1 = d4_btree_strMSstrME_alloc(0);
+  d4_btree_strMSstrME_t b2 = d4_btree_strMSstrME_alloc(1, key, val);
+
+  d4_btree_strMSstrME_free(b1);
+  d4_btree_strMSstrME_free(b2);
+  d4_str_free(key);
+  d4_str_free(val);
+}
+
+static void test_btree_fromSorted (void) {
+  d4_arr_int_t keys = {d4_safe_alloc(3000 * sizeof(int32_t)), 3000};
+  d4_arr_int_t values = {d4_safe_alloc(3000 * sizeof(int32_t)), 3000};
+  d4_arr_int_t unsorted_keys = d4_arr_int_alloc(3, 3, 1, 3);
+  d4_arr_int_t unsorted_values = d4_arr_int_alloc(3, 30, 10, 40);
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_fromSorted(unsorted_keys, unsorted_values);
+  d4_btree_intMSintME_t b2 = d4_btree_intMSintME_alloc(2, 1, 10, 3, 40);
+
+  for (int32_t i = 0; i < 3000; i++) {
+    keys.data[i] = i;
+    values.data[i] = i * 2;
+  }
+
+  for (size_t len = 0; len <= 3000; len += len < 100 ? 1 : 37) {
+    d4_btree_intMSintME_t b;
+    d4_btree_intMSintME_iter_t it;
+    int32_t expected = 0;
+
+    keys.len = len;
+    values.len = len;
+    b = d4_btree_intMSintME_fromSorted(keys, values);
+    btree_check(b);
+    assert(((void) "Builds B-tree of every length", b.len == len));
+
+    it = d4_btree_intMSintME_iterBegin(b);
+    while (d4_btree_intMSintME_iterNext(&it)) {
+      assert(((void) "Keeps every pair", *it.key == expected && *it.value == expected * 2));
+      expected++;
+    }
+
+    assert(((void) "Iterates every pair", (size_t) expected == len));
+    d4_btree_intMSintME_free(b);
+  }
+
+  assert(((void) "Builds from unsorted keys", d4_btree_intMSintME_eq(b1, b2)));
+  btree_check(b1);
+
+  keys.len = 3000;
+  values.len = 3000;
+  d4_arr_int_free(keys);
+  d4_arr_int_free(values);
+  d4_arr_int_free(unsorted_keys);
+  d4_arr_int_free(unsorted_values);
+  d4_btree_intMSintME_free(b1);
+  d4_btree_intMSintME_free(b2);
+}
+
+static void test_btree_get (void) {
+  d4_str_t key = d4_str_alloc(L"key");
+  d4_str_t val = d4_str_alloc(L"val");
+  d4_btree_strMSstrME_t b1 = d4_btree_strMSstrME_alloc(1, key, val);
+  d4_btree_intMSintME_t b2 = d4_btree_intMSintME_alloc(0);
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_btree_intMSintME_set(&b2, i, i * 3);
+  }
+
+  ASSERT_NO_THROW(GET1, {
+    d4_str_t v = d4_btree_strMSstrME_get(&d4_err_state, 0, 0, b1, key);
+    assert(((void) "Gets string value", d4_str_eq(v, val)));
+    d4_str_free(v);
+
+    for (int32_t i = 0; i < 1000; i++) {
+      assert(((void) "Gets every value", d4_btree_intMSintME_get(&d4_err_state, 0, 0, b2, i) == i * 3));
+    }
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(GET2, {
+    d4_btree_intMSintME_get(&d4_err_state, 0, 0, b2, 1000);
+  }, L"failed to find key '1000'");
+
+  ASSERT_THROW_WITH_MESSAGE(GET3, {
+    d4_btree_strMSstrME_get(&d4_err_state, 0, 0, b1, val);
+  }, L"failed to find key 'val'");
+
+  d4_btree_strMSstrME_free(b1);
+  d4_btree_intMSintME_free(b2);
+  d4_str_free(key);
+  d4_str_free(val);
+}
+
+static void test_btree_has (void) {
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(0);
+  d4_btree_intMSintME_t b2 = d4_btree_intMSintME_alloc(0);
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_btree_intMSintME_set(&b2, i * 2, i);
+  }
+
+  assert(((void) "Checks empty B-tree", !d4_btree_intMSintME_has(b1, 0)));
+
+  for (int32_t i = 0; i < 2000; i++) {
+    assert(((void) "Checks every key", d4_btree_intMSintME_has(b2, i) == (i % 2 == 0)));
+  }
+
+  d4_btree_intMSintME_free(b1);
+  d4_btree_intMSintME_free(b2);
+}
+
+static void test_btree_iterNext (void) {
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(0);
+  d4_btree_intMSintME_iter_t it = d4_btree_intMSintME_iterBegin(b1);
+  int32_t expected = 0;
+
+  assert(((void) "Iterates empty B-tree", !d4_btree_intMSintME_iterNext(&it) && it.key == NULL && it.value == NULL));
+
+  for (int32_t i = 999; i >= 0; i--) {
+    d4_btree_intMSintME_set(&b1, i, i + 1);
+  }
+
+  it = d4_btree_intMSintME_iterBegin(b1);
+
+  while (d4_btree_intMSintME_iterNext(&it)) {
+    assert(((void) "Iterates in ascending order", *it.key == expected && *it.value == expected + 1));
+    *it.value = 0;
+    expected++;
+  }
+
+  assert(((void) "Iterates every pair", expected == 1000));
+  assert(((void) "Stays at the end", !d4_btree_intMSintME_iterNext(&it)));
+
+  ASSERT_NO_THROW(ITER_NEXT, {
+    assert(((void) "Updates values through iterator", d4_btree_intMSintME_get(&d4_err_state, 0, 0, b1, 10) == 0));
+  });
+
+  d4_btree_intMSintME_free(b1);
+}
+
+static void test_btree_keys (void) {
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(0);
+  d4_btree_intMSintME_t b2 = d4_btree_intMSintME_alloc(3, 3, 30, 1, 10, 2, 20);
+  d4_arr_int_t k1 = d4_btree_intMSintME_keys(b1);
+  d4_arr_int_t k2 = d4_btree_intMSintME_keys(b2);
+  d4_arr_int_t k3 = d4_arr_int_alloc(3, 1, 2, 3);
+
+  assert(((void) "Returns keys of empty B-tree", k1.len == 0));
+  assert(((void) "Returns keys in ascending order", d4_arr_int_eq(k2, k3)));
+
+  d4_arr_int_free(k1);
+  d4_arr_int_free(k2);
+  d4_arr_int_free(k3);
+  d4_btree_intMSintME_free(b1);
+  d4_btree_intMSintME_free(b2);
+}
+
+static void test_btree_range (void) {
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(0);
+  d4_btree_intMSintME_iter_t it;
+  int32_t expected = 100;
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_btree_intMSintME_set(&b1, i, i);
+  }
+
+  it = d4_btree_intMSintME_range(b1, 100, 600);
+
+  while (d4_btree_intMSintME_iterNext(&it)) {
+    assert(((void) "Iterates range in ascending order", *it.key == expected));
+    expected++;
+  }
+
+  assert(((void) "Stops before end of range", expected == 600));
+
+  it = d4_btree_intMSintME_range(b1, 600, 100);
+  assert(((void) "Iterates empty range", !d4_btree_intMSintME_iterNext(&it)));
+
+  it = d4_btree_intMSintME_range(b1, 990, 2000);
+  expected = 990;
+  while (d4_btree_intMSintME_iterNext(&it)) expected++;
+  assert(((void) "Iterates range past the last key", expected == 1000));
+
+  d4_btree_intMSintME_free(b1);
+}
+
+static void test_btree_realloc (void) {
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(1, 1, 1);
+  d4_btree_intMSintME_t b2 = d4_btree_intMSintME_alloc(2, 2, 2, 3, 3);
+
+  b1 = d4_btree_intMSintME_realloc(b1, b2);
+  assert(((void) "Reallocates B-tree", d4_btree_intMSintME_eq(b1, b2)));
+
+  d4_btree_intMSintME_free(b1);
+  d4_btree_intMSintME_free(b2);
+}
+
+static void test_btree_remove (void) {
+  d4_str_t key = d4_str_alloc(L"key");
+  d4_str_t val = d4_str_alloc(L"val");
+  d4_btree_strMSstrME_t b1 = d4_btree_strMSstrME_alloc(1, key, val);
+  d4_btree_intMSintME_t b2 = d4_btree_intMSintME_alloc(0);
+  uint32_t seed = 1;
+
+  for (int32_t i = 0; i < 5000; i++) {
+    d4_btree_intMSintME_set(&b2, i, i);
+  }
+
+  ASSERT_NO_THROW(REMOVE1, {
+    d4_btree_strMSstrME_remove(&d4_err_state, 0, 0, &b1, key);
+    assert(((void) "Removes last pair", b1.len == 0 && b1.root == NULL));
+
+    for (int32_t i = 0; i < 5000; i++) {
+      int32_t k = (int32_t) (seed % 5000);
+      seed = seed * 1103515245 + 12345;
+
+      if (d4_btree_intMSintME_has(b2, k)) {
+        d4_btree_intMSintME_remove(&d4_err_state, 0, 0, &b2, k);
+        assert(((void) "Removes pair", !d4_btree_intMSintME_has(b2, k)));
+      }
+
+      if (i % 500 == 0) btree_check(b2);
+    }
+
+    btree_check(b2);
+
+    for (int32_t i = 0; i < 5000; i++) {
+      if (d4_btree_intMSintME_has(b2, i)) d4_btree_intMSintME_remove(&d4_err_state, 0, 0, &b2, i);
+    }
+
+    assert(((void) "Removes every pair", b2.len == 0 && b2.root == NULL));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(REMOVE2, {
+    d4_btree_intMSintME_remove(&d4_err_state, 0, 0, &b2, 1);
+  }, L"failed to remove key '1'");
+
+  ASSERT_THROW_WITH_MESSAGE(REMOVE3, {
+    d4_btree_strMSstrME_remove(&d4_err_state, 0, 0, &b1, key);
+  }, L"failed to remove key 'key'");
+
+  d4_btree_strMSstrME_free(b1);
+  d4_btree_intMSintME_free(b2);
+  d4_str_free(key);
+  d4_str_free(val);
+}
+
+static void test_btree_set (void) {
+  d4_str_t key = d4_str_alloc(L"key");
+  d4_str_t val1 = d4_str_alloc(L"val1");
+  d4_str_t val2 = d4_str_alloc(L"val2");
+  d4_btree_strMSstrME_t b1 = d4_btree_strMSstrME_alloc(0);
+  d4_btree_intMSintME_t b2 = d4_btree_intMSintME_alloc(0);
+  uint32_t seed = 7;
+
+  d4_btree_strMSstrME_set(&b1, key, val1);
+  d4_btree_strMSstrME_set(&b1, key, val2);
+  assert(((void) "Replaces value of existing key", b1.len == 1));
+
+  ASSERT_NO_THROW(SET, {
+    d4_str_t v = d4_btree_strMSstrME_get(&d4_err_state, 0, 0, b1, key);
+    assert(((void) "Keeps replaced value", d4_str_eq(v, val2)));
+    d4_str_free(v);
+  });
+
+  for (int32_t i = 0; i < 10000; i++) {
+    d4_btree_intMSintME_set(&b2, (int32_t) (seed % 20000), i);
+    seed = seed * 1103515245 + 12345;
+  }
+
+  btree_check(b2);
+
+  d4_btree_strMSstrME_free(b1);
+  d4_btree_intMSintME_free(b2);
+  d4_str_free(key);
+  d4_str_free(val1);
+  d4_str_free(val2);
+}
+
+static void test_btree_str (void) {
+  d4_str_t key1 = d4_str_alloc(L"b");
+  d4_str_t key2 = d4_str_alloc(L"a");
+  d4_str_t val = d4_str_alloc(L"val");
+
+  d4_str_t s1 = d4_str_alloc(L"{}");
+  d4_str_t s2 = d4_str_alloc(L"{\"1\": 10, \"2\": 20}");
+  d4_str_t s3 = d4_str_alloc(L"{\"a\": \"val\", \"b\": \"val\"}");
+
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(0);
+  d4_btree_intMSintME_t b2 = d4_btree_intMSintME_alloc(2, 2, 20, 1, 10);
+  d4_btree_strMSstrME_t b3 = d4_btree_strMSstrME_alloc(2, key1, val, key2, val);
+
+  d4_str_t s1_cmp = d4_btree_intMSintME_str(b1);
+  d4_str_t s2_cmp = d4_btree_intMSintME_str(b2);
+  d4_str_t s3_cmp = d4_btree_strMSstrME_str(b3);
+
+  assert(((void) "Stringifies empty B-tree", d4_str_eq(s1, s1_cmp)));
+  assert(((void) "Stringifies B-tree in ascending order", d4_str_eq(s2, s2_cmp)));
+  assert(((void) "Stringifies B-tree with string values", d4_str_eq(s3, s3_cmp)));
+
+  d4_str_free(s1_cmp);
+  d4_str_free(s2_cmp);
+  d4_str_free(s3_cmp);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+
+  d4_btree_intMSintME_free(b1);
+  d4_btree_intMSintME_free(b2);
+  d4_btree_strMSstrME_free(b3);
+
+  d4_str_free(key1);
+  d4_str_free(key2);
+  d4_str_free(val);
+}
+
+static void test_btree_values (void) {
+  d4_btree_intMSintME_t b1 = d4_btree_intMSintME_alloc(0);
+  d4_btree_intMSintME_t b2 = d4_btree_intMSintME_alloc(3, 3, 30, 1, 10, 2, 20);
+  d4_arr_int_t v1 = d4_btree_intMSintME_values(b1);
+  d4_arr_int_t v2 = d4_btree_intMSintME_values(b2);
+  d4_arr_int_t v3 = d4_arr_int_alloc(3, 10, 20, 30);
+
+  assert(((void) "Returns values of empty B-tree", v1.len == 0));
+  assert(((void) "Returns values in ascending order of keys", d4_arr_int_eq(v2, v3)));
+
+  d4_arr_int_free(v1);
+  d4_arr_int_free(v2);
+  d4_arr_int_free(v3);
+  d4_btree_intMSintME_free(b1);
+  d4_btree_intMSintME_free(b2);
+}
+
+int main (void) {
+  test_btree_alloc();
+  test_btree_ceiling();
+  test_btree_clear();
+  test_btree_copy();
+  test_btree_empty();
+  test_btree_eq();
+  test_btree_floor();
+  test_btree_free();
+  test_btree_fromSorted();
+  test_btree_get();
+  test_btree_has();
+  test_btree_iterNext();
+  test_btree_keys();
+  test_btree_range();
+  test_btree_realloc();
+  test_btree_remove();
+  test_btree_set();
+  test_btree_str();
+  test_btree_values();
+}
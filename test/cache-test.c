@@ -0,0 +1,206 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include <assert.h>
+#include "../include/d4/cache.h"
+#include "../include/d4/error.h"
+#include "../include/d4/number.h"
+#include "utils.h"
+
+D4_CACHE_DECLARE(int, int32_t, int, int32_t)
+D4_CACHE_DEFINE(int, int32_t, key, lhs_key == rhs_key, (void) key, d4_map_hash_int((uint64_t) key, SIZE_MAX), d4_i32_str(key), int, int32_t, val, (void) val, 1)
+
+D4_CACHE_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_CACHE_DEFINE(str, d4_str_t, d4_str_copy(key), d4_str_eq(lhs_key, rhs_key), d4_str_free(key), d4_map_hash(key, SIZE_MAX), d4_str_copy(key), str, d4_str_t, d4_str_copy(val), d4_str_free(val), val.len)
+
+static void test_cache_alloc (void) {
+  d4_cache_intMSintME_t c1 = d4_cache_intMSintME_alloc(D4_CACHE_LRU, 4, 0);
+  d4_cache_intMSintME_t c2 = d4_cache_intMSintME_alloc(D4_CACHE_CLOCK, 0, 0);
+
+  assert(((void) "Allocates empty cache", c1.len == 0 && c1.cap == 4 && c1.weight == 0));
+  assert(((void) "Allocates cache without entries", c2.entries == NULL));
+
+  d4_cache_intMSintME_put(&c2, 1, 10);
+  assert(((void) "Cache without entries ignores put", c2.len == 0));
+
+  d4_cache_intMSintME_free(c1);
+  d4_cache_intMSintME_free(c2);
+}
+
+static void test_cache_clear (void) {
+  d4_cache_intMSintME_t c1 = d4_cache_intMSintME_alloc(D4_CACHE_LRU, 4, 0);
+
+  d4_cache_intMSintME_put(&c1, 1, 10);
+  d4_cache_intMSintME_put(&c1, 2, 20);
+  d4_cache_intMSintME_lookup(&c1, 1);
+  d4_cache_intMSintME_clear(&c1);
+
+  assert(((void) "Removes all entries", c1.len == 0 && !d4_cache_intMSintME_has(c1, 1)));
+  assert(((void) "Resets counters", c1.hits == 0 && c1.misses == 0));
+
+  for (int32_t i = 0; i < 4; i++) {
+    d4_cache_intMSintME_put(&c1, i, i);
+  }
+
+  assert(((void) "Reuses entries after clear", c1.len == 4 && c1.evictions == 0));
+  d4_cache_intMSintME_free(c1);
+}
+
+static void test_cache_get (void) {
+  d4_str_t key1 = d4_str_alloc(L"key1");
+  d4_str_t key2 = d4_str_alloc(L"key2");
+  d4_str_t val1 = d4_str_alloc(L"val1");
+  d4_cache_strMSstrME_t c1 = d4_cache_strMSstrME_alloc(D4_CACHE_LRU, 2, 0);
+
+  d4_cache_strMSstrME_put(&c1, key1, val1);
+
+  ASSERT_NO_THROW(GET1, {
+    d4_str_t v1 = d4_cache_strMSstrME_get(&d4_err_state, 0, 0, &c1, key1);
+    assert(((void) "Gets copy of the value", d4_str_eq(v1, val1) && v1.data != val1.data));
+    d4_str_free(v1);
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(GET2, {
+    d4_cache_strMSstrME_get(&d4_err_state, 0, 0, &c1, key2);
+  }, L"failed to find key 'key2'");
+
+  assert(((void) "Counts hits and misses", c1.hits == 1 && c1.misses == 1));
+
+  d4_cache_strMSstrME_free(c1);
+  d4_str_free(key1);
+  d4_str_free(key2);
+  d4_str_free(val1);
+}
+
+static void test_cache_has (void) {
+  d4_cache_intMSintME_t c1 = d4_cache_intMSintME_alloc(D4_CACHE_LRU, 2, 0);
+
+  d4_cache_intMSintME_put(&c1, 1, 10);
+
+  assert(((void) "Has existing key", d4_cache_intMSintME_has(c1, 1)));
+  assert(((void) "Has no missing key", !d4_cache_intMSintME_has(c1, 2)));
+  assert(((void) "Doesn't affect counters", c1.hits == 0 && c1.misses == 0));
+
+  d4_cache_intMSintME_free(c1);
+}
+
+static void test_cache_lookup (void) {
+  d4_cache_intMSintME_t c1 = d4_cache_intMSintME_alloc(D4_CACHE_LRU, 2, 0);
+  int32_t *v1;
+
+  d4_cache_intMSintME_put(&c1, 1, 10);
+  v1 = d4_cache_intMSintME_lookup(&c1, 1);
+
+  assert(((void) "Finds value in place", v1 != NULL && *v1 == 10));
+  *v1 = 11;
+  assert(((void) "Allows updating value in place", *d4_cache_intMSintME_lookup(&c1, 1) == 11));
+  assert(((void) "Returns NULL for missing key", d4_cache_intMSintME_lookup(&c1, 2) == NULL));
+  assert(((void) "Counts hits and misses", c1.hits == 2 && c1.misses == 1));
+
+  d4_cache_intMSintME_free(c1);
+}
+
+static void test_cache_put_lru (void) {
+  d4_cache_intMSintME_t c1 = d4_cache_intMSintME_alloc(D4_CACHE_LRU, 3, 0);
+
+  d4_cache_intMSintME_put(&c1, 1, 10);
+  d4_cache_intMSintME_put(&c1, 2, 20);
+  d4_cache_intMSintME_put(&c1, 3, 30);
+  d4_cache_intMSintME_lookup(&c1, 1);
+  d4_cache_intMSintME_put(&c1, 4, 40);
+
+  assert(((void) "Evicts least recently used entry", !d4_cache_intMSintME_has(c1, 2)));
+  assert(((void) "Keeps recently used entry", d4_cache_intMSintME_has(c1, 1) && c1.len == 3 && c1.evictions == 1));
+
+  d4_cache_intMSintME_put(&c1, 3, 31);
+  d4_cache_intMSintME_put(&c1, 5, 50);
+
+  assert(((void) "Updating entry marks it as recently used", !d4_cache_intMSintME_has(c1, 1) && *d4_cache_intMSintME_lookup(&c1, 3) == 31));
+
+  d4_cache_intMSintME_free(c1);
+}
+
+static void test_cache_put_clock (void) {
+  d4_cache_intMSintME_t c1 = d4_cache_intMSintME_alloc(D4_CACHE_CLOCK, 3, 0);
+
+  d4_cache_intMSintME_put(&c1, 1, 10);
+  d4_cache_intMSintME_put(&c1, 2, 20);
+  d4_cache_intMSintME_put(&c1, 3, 30);
+  d4_cache_intMSintME_lookup(&c1, 1);
+  d4_cache_intMSintME_lookup(&c1, 1);
+  d4_cache_intMSintME_lookup(&c1, 3);
+  d4_cache_intMSintME_put(&c1, 4, 40);
+
+  assert(((void) "Evicts the first entry without hits", !d4_cache_intMSintME_has(c1, 2)));
+
+  d4_cache_intMSintME_put(&c1, 5, 50);
+  assert(((void) "Gives entries with hits a second chance", !d4_cache_intMSintME_has(c1, 4) && d4_cache_intMSintME_has(c1, 3)));
+
+  d4_cache_intMSintME_put(&c1, 6, 60);
+  assert(((void) "Evicts entries whose hits were forgotten", !d4_cache_intMSintME_has(c1, 3)));
+  assert(((void) "Keeps frequently used entry", d4_cache_intMSintME_has(c1, 1)));
+  assert(((void) "Counts evictions", c1.len == 3 && c1.evictions == 3));
+
+  d4_cache_intMSintME_free(c1);
+}
+
+static void test_cache_put_weight (void) {
+  d4_str_t key1 = d4_str_alloc(L"key1");
+  d4_str_t key2 = d4_str_alloc(L"key2");
+  d4_str_t key3 = d4_str_alloc(L"key3");
+  d4_str_t val1 = d4_str_alloc(L"abcd");
+  d4_str_t val2 = d4_str_alloc(L"abcdefgh");
+  d4_str_t val3 = d4_str_alloc(L"abcdefghijk");
+  d4_cache_strMSstrME_t c1 = d4_cache_strMSstrME_alloc(D4_CACHE_LRU, 10, 10);
+
+  d4_cache_strMSstrME_put(&c1, key1, val1);
+  d4_cache_strMSstrME_put(&c1, key2, val1);
+  assert(((void) "Sums weights of entries", c1.weight == 8));
+
+  d4_cache_strMSstrME_put(&c1, key3, val1);
+  assert(((void) "Evicts entries until weight fits", c1.weight == 8 && !d4_cache_strMSstrME_has(c1, key1)));
+
+  d4_cache_strMSstrME_put(&c1, key2, val2);
+  assert(((void) "Evicts other entries when updated value is heavier", c1.weight == 8 && c1.len == 1 && d4_cache_strMSstrME_has(c1, key2)));
+
+  d4_cache_strMSstrME_put(&c1, key2, val3);
+  assert(((void) "Doesn't cache values heavier than maximum weight", c1.weight == 0 && c1.len == 0));
+
+  d4_cache_strMSstrME_free(c1);
+  d4_str_free(key1);
+  d4_str_free(key2);
+  d4_str_free(key3);
+  d4_str_free(val1);
+  d4_str_free(val2);
+  d4_str_free(val3);
+}
+
+static void test_cache_remove (void) {
+  d4_cache_intMSintME_t c1 = d4_cache_intMSintME_alloc(D4_CACHE_CLOCK, 2, 0);
+
+  d4_cache_intMSintME_put(&c1, 1, 10);
+  d4_cache_intMSintME_put(&c1, 2, 20);
+
+  assert(((void) "Removes existing key", d4_cache_intMSintME_remove(&c1, 1) && !d4_cache_intMSintME_has(c1, 1)));
+  assert(((void) "Doesn't remove missing key", !d4_cache_intMSintME_remove(&c1, 1)));
+
+  d4_cache_intMSintME_put(&c1, 3, 30);
+  assert(((void) "Reuses removed entry", c1.len == 2 && c1.evictions == 0));
+
+  d4_cache_intMSintME_free(c1);
+}
+
+int main (void) {
+  test_cache_alloc();
+  test_cache_clear();
+  test_cache_get();
+  test_cache_has();
+  test_cache_lookup();
+  test_cache_put_lru();
+  test_cache_put_clock();
+  test_cache_put_weight();
+  test_cache_remove();
+}
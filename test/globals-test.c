@@ -27,8 +27,8 @@ static void test_globals_print (void) {
   d4_str_t s_comma = d4_str_alloc(L",");
   d4_str_t s_stdout = d4_str_alloc(L"stdout");
   d4_str_t s_stderr = d4_str_alloc(L"stderr");
-  d4_str_t s_string = d4_str_alloc(L"string");
-  d4_str_t result = d4_str_alloc(D4_EOL L"10 string" D4_EOL L"10,string");
+  d4_str_t s_string = d4_str_alloc(L"str\u00EFng \U0001F600");
+  d4_str_t result = d4_str_alloc(D4_EOL L"10 str\u00EFng \U0001F600" D4_EOL L"10,str\u00EFng \U0001F600");
 
   d4_any_t i1 = d4_any_int_alloc(10);
   d4_any_t i2 = d4_any_str_alloc(s_string);
@@ -0,0 +1,432 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include <assert.h>
+#include "../include/d4/error.h"
+#include "../include/d4/map-int.h"
+#include "../include/d4/number.h"
+#include "utils.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_ARRAY_DECLARE(i8, int8_t)
+D4_ARRAY_DEFINE(i8, int8_t, int, element, lhs_element == rhs_element, (void) element, d4_i8_str(element))
+
+D4_ARRAY_DECLARE(u64, uint64_t)
+D4_ARRAY_DEFINE(u64, uint64_t, uint64_t, element, lhs_element == rhs_element, (void) element, d4_u64_str(element))
+
+D4_MAP_INT_DECLARE(int, int32_t, int, int32_t)
+D4_MAP_INT_DEFINE(int, int32_t, int, d4_i32_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+D4_MAP_INT_DECLARE(int, int32_t, str, d4_str_t)
+D4_MAP_INT_DEFINE(int, int32_t, int, d4_i32_str(key), str, d4_str_t, d4_str_t, d4_str_copy(val), d4_str_eq(lhs_val, rhs_val), d4_str_free(val), d4_str_quoted_escape(val))
+
+D4_MAP_INT_DECLARE(i8, int8_t, int, int32_t)
+D4_MAP_INT_DEFINE(i8, int8_t, int, d4_i8_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+D4_MAP_INT_DECLARE(u64, uint64_t, int, int32_t)
+D4_MAP_INT_DEFINE(u64, uint64_t, uint64_t, d4_u64_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+static int32_t sum = 0;
+
+static void sum_func (D4_UNUSED void *ctx, void *params) {
+  d4_fn_esFP3intFP3intFP3intFRvoidFE_params_t *p = params;
+  sum += p->n0 * p->n1 + p->n2;
+}
+
+static bool is_even_key_func (D4_UNUSED void *ctx, void *params) {
+  d4_fn_esFP3intFP3intFRboolFE_params_t *p = params;
+  return p->n0 % 2 == 0;
+}
+
+static void test_map_int_alloc (void) {
+  d4_str_t val1 = d4_str_alloc(L"val1");
+  d4_str_t val2 = d4_str_alloc(L"val2");
+
+  d4_map_intMSstrME_t m1 = d4_map_intMSstrME_alloc(0);
+  d4_map_intMSstrME_t m2 = d4_map_intMSstrME_alloc(1, 1, val1);
+  d4_map_intMSstrME_t m3 = d4_map_intMSstrME_alloc(3, 2, val1, 3, val2, 2, val2);
+
+  assert(((void) "Creates map with zero pairs", m1.len == 0 && m1.cap == 0x0F));
+  assert(((void) "Creates map with one pair", m2.len == 1 && m2.cap == 0x0F));
+  assert(((void) "Creates map with repeated key once", m3.len == 2 && m3.cap == 0x0F));
+
+  d4_map_intMSstrME_free(m1);
+  d4_map_intMSstrME_free(m2);
+  d4_map_intMSstrME_free(m3);
+
+  d4_str_free(val1);
+  d4_str_free(val2);
+}
+
+static void test_map_int_clear (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(2, 1, 10, 2, 20);
+
+  d4_map_intMSintME_clear(&m1);
+  assert(((void) "Clears map", m1.len == 0 && m1.cap == 0x0F));
+  assert(((void) "Cleared map has no pairs", !d4_map_intMSintME_has(m1, 1) && !d4_map_intMSintME_has(m1, 2)));
+
+  d4_map_intMSintME_set(&m1, 1, 30);
+  assert(((void) "Cleared map is reusable", m1.len == 1 && d4_map_intMSintME_has(m1, 1)));
+
+  d4_map_intMSintME_free(m1);
+}
+
+static void test_map_int_copy (void) {
+  d4_str_t val = d4_str_alloc(L"val");
+
+  d4_map_intMSstrME_t m1 = d4_map_intMSstrME_alloc(0);
+  d4_map_intMSstrME_t m2 = d4_map_intMSstrME_alloc(2, 2, val, 3, val);
+
+  d4_map_intMSstrME_t m3 = d4_map_intMSstrME_copy(m1);
+  d4_map_intMSstrME_t m4 = d4_map_intMSstrME_copy(m2);
+
+  assert(((void) "Copies map with zero pairs", d4_map_intMSstrME_eq(m1, m3)));
+  assert(((void) "Copies map with two pairs", d4_map_intMSstrME_eq(m2, m4)));
+
+  d4_map_intMSstrME_free(m1);
+  d4_map_intMSstrME_free(m2);
+  d4_map_intMSstrME_free(m3);
+  d4_map_intMSstrME_free(m4);
+
+  d4_str_free(val);
+}
+
+static void test_map_int_eq (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(2, 1, 10, 2, 20);
+  d4_map_intMSintME_t m2 = d4_map_intMSintME_alloc(2, 2, 20, 1, 10);
+  d4_map_intMSintME_t m3 = d4_map_intMSintME_alloc(2, 1, 10, 2, 21);
+  d4_map_intMSintME_t m4 = d4_map_intMSintME_alloc(2, 1, 10, 3, 20);
+  d4_map_intMSintME_t m5 = d4_map_intMSintME_alloc(0);
+
+  d4_map_intMSintME_reserve(&m5, 1000);
+  d4_map_intMSintME_set(&m5, 1, 10);
+  d4_map_intMSintME_set(&m5, 2, 20);
+
+  assert(((void) "Maps with same pairs in different order are equal", d4_map_intMSintME_eq(m1, m2)));
+  assert(((void) "Maps with different values are not equal", !d4_map_intMSintME_eq(m1, m3)));
+  assert(((void) "Maps with different keys are not equal", !d4_map_intMSintME_eq(m1, m4)));
+  assert(((void) "Maps with different capacities are equal", d4_map_intMSintME_eq(m1, m5)));
+
+  d4_map_intMSintME_free(m1);
+  d4_map_intMSintME_free(m2);
+  d4_map_intMSintME_free(m3);
+  d4_map_intMSintME_free(m4);
+  d4_map_intMSintME_free(m5);
+}
+
+static void test_map_int_forEach (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(3, 1, 10, 2, 20, 3, 30);
+  d4_fn_esFP3intFP3intFP3intFRvoidFE_t iterator = {(d4_str_t) {L"sum", 3, true}, NULL, NULL, NULL, sum_func};
+
+  sum = 0;
+  d4_map_intMSintME_forEach(&d4_err_state, 0, 0, m1, iterator);
+  assert(((void) "Calls iterator on every pair", sum == 10 + 40 + 90 + 0 + 1 + 2));
+
+  d4_map_intMSintME_free(m1);
+}
+
+static void test_map_int_fromArrays (void) {
+  int32_t keys_data[] = {1, 2, 2, 3};
+  int32_t values_data[] = {10, 20, 21};
+  d4_arr_int_t keys = {keys_data, 4};
+  d4_arr_int_t values = {values_data, 3};
+  d4_map_intMSintME_entry_t entries[] = {{-1, 1}, {-2, 2}};
+
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_fromArrays(keys, values);
+  d4_map_intMSintME_t m2 = d4_map_intMSintME_fromPairs(entries, 2);
+
+  ASSERT_NO_THROW(FROM_ARRAYS1, {
+    assert(((void) "Pairs elements by index", m1.len == 2));
+    assert(((void) "Keeps last value of repeated key", d4_map_intMSintME_get(&d4_err_state, 0, 0, m1, 2) == 21));
+    assert(((void) "Ignores extra keys", !d4_map_intMSintME_has(m1, 3)));
+    assert(((void) "Builds map from entries", m2.len == 2 && d4_map_intMSintME_get(&d4_err_state, 0, 0, m2, -2) == 2));
+  });
+
+  d4_map_intMSintME_free(m1);
+  d4_map_intMSintME_free(m2);
+}
+
+static void test_map_int_get (void) {
+  d4_map_i8MSintME_t m1 = d4_map_i8MSintME_alloc(3, -128, 1, 0, 2, 127, 3);
+  d4_map_u64MSintME_t m2 = d4_map_u64MSintME_alloc(2, (uint64_t) 0, 1, UINT64_MAX, 2);
+
+  ASSERT_NO_THROW(GET1, {
+    assert(((void) "Gets smallest i8 key", d4_map_i8MSintME_get(&d4_err_state, 0, 0, m1, -128) == 1));
+    assert(((void) "Gets zero i8 key", d4_map_i8MSintME_get(&d4_err_state, 0, 0, m1, 0) == 2));
+    assert(((void) "Gets largest i8 key", d4_map_i8MSintME_get(&d4_err_state, 0, 0, m1, 127) == 3));
+    assert(((void) "Gets zero u64 key", d4_map_u64MSintME_get(&d4_err_state, 0, 0, m2, 0) == 1));
+    assert(((void) "Gets largest u64 key", d4_map_u64MSintME_get(&d4_err_state, 0, 0, m2, UINT64_MAX) == 2));
+  });
+
+  d4_map_i8MSintME_free(m1);
+  d4_map_u64MSintME_free(m2);
+}
+
+static void test_map_int_get_throws (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_u64MSintME_t m2 = d4_map_u64MSintME_alloc(1, (uint64_t) 1, 1);
+
+  ASSERT_THROW_WITH_MESSAGE(GET1, {
+    d4_map_intMSintME_get(&d4_err_state, 0, 0, m1, -1);
+  }, L"failed to find key '-1'");
+
+  ASSERT_THROW_WITH_MESSAGE(GET2, {
+    d4_map_u64MSintME_get(&d4_err_state, 0, 0, m2, UINT64_MAX);
+  }, L"failed to find key '18446744073709551615'");
+
+  d4_map_intMSintME_free(m1);
+  d4_map_u64MSintME_free(m2);
+}
+
+static void test_map_int_has (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(2, 2, 20, 3, 30);
+
+  assert(((void) "Has first element", d4_map_intMSintME_has(m1, 2)));
+  assert(((void) "Has second element", d4_map_intMSintME_has(m1, 3)));
+  assert(((void) "Has no missing element", !d4_map_intMSintME_has(m1, 1)));
+  assert(((void) "Has no negative element", !d4_map_intMSintME_has(m1, -2)));
+
+  d4_map_intMSintME_free(m1);
+}
+
+static void test_map_int_iterNext (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_intMSintME_iter_t it;
+  int32_t keys_sum = 0;
+  size_t count = 0;
+
+  for (int32_t i = 0; i < 100; i++) {
+    d4_map_intMSintME_set(&m1, i, i * 2);
+  }
+
+  it = d4_map_intMSintME_iterBegin(m1);
+
+  while (d4_map_intMSintME_iterNext(&it)) {
+    assert(((void) "Iterates pairs with matching values", *it.value == *it.key * 2));
+    keys_sum += *it.key;
+    count++;
+  }
+
+  assert(((void) "Iterates every pair once", count == 100 && keys_sum == 4950));
+
+  d4_map_intMSintME_free(m1);
+}
+
+static void test_map_int_keys (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_intMSintME_t m2 = d4_map_intMSintME_alloc(2, 2, 20, 3, 30);
+  d4_arr_int_t k1 = d4_map_intMSintME_keys(m1);
+  d4_arr_int_t k2 = d4_map_intMSintME_keys(m2);
+
+  assert(((void) "Returns no keys of empty map", k1.len == 0));
+  assert(((void) "Returns keys of map", k2.len == 2 && d4_arr_int_contains(k2, 2) && d4_arr_int_contains(k2, 3)));
+
+  d4_arr_int_free(k1);
+  d4_arr_int_free(k2);
+
+  d4_map_intMSintME_free(m1);
+  d4_map_intMSintME_free(m2);
+}
+
+static void test_map_int_merge (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(2, 1, 10, 2, 20);
+  d4_map_intMSintME_t m2 = d4_map_intMSintME_alloc(2, 2, 21, 3, 30);
+  d4_map_intMSintME_t m3 = d4_map_intMSintME_alloc(1, 4, 40);
+
+  ASSERT_NO_THROW(MERGE1, {
+    d4_map_intMSintME_merge(&m1, m2);
+    assert(((void) "Merges only new keys into length", m1.len == 3));
+    assert(((void) "Updates existing key", d4_map_intMSintME_get(&d4_err_state, 0, 0, m1, 2) == 21));
+    assert(((void) "Leaves other map untouched", m2.len == 2));
+
+    d4_map_intMSintME_mergeMove(&m1, &m3);
+    assert(((void) "Moves pairs of other map", m1.len == 4 && m3.len == 0));
+    assert(((void) "Moves value of other map", d4_map_intMSintME_get(&d4_err_state, 0, 0, m1, 4) == 40));
+
+    d4_map_intMSintME_mergeMove(&m1, &m1);
+    assert(((void) "Moves map into itself", m1.len == 4 && d4_map_intMSintME_get(&d4_err_state, 0, 0, m1, 4) == 40));
+  });
+
+  d4_map_intMSintME_free(m1);
+  d4_map_intMSintME_free(m2);
+  d4_map_intMSintME_free(m3);
+}
+
+static void test_map_int_remove (void) {
+  d4_str_t val = d4_str_alloc(L"val");
+  d4_map_intMSstrME_t m1 = d4_map_intMSstrME_alloc(3, 1, val, 2, val, 3, val);
+
+  ASSERT_NO_THROW(REMOVE1, {
+    d4_map_intMSstrME_remove(&d4_err_state, 0, 0, &m1, 2);
+    assert(((void) "Removes pair", m1.len == 2 && !d4_map_intMSstrME_has(m1, 2)));
+    assert(((void) "Keeps other pairs", d4_map_intMSstrME_has(m1, 1) && d4_map_intMSstrME_has(m1, 3)));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(REMOVE2, {
+    d4_map_intMSstrME_remove(&d4_err_state, 0, 0, &m1, 2);
+  }, L"failed to remove key '2'");
+
+  d4_map_intMSstrME_free(m1);
+  d4_str_free(val);
+}
+
+static void test_map_int_retain (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_fn_esFP3intFP3intFRboolFE_t predicate = {(d4_str_t) {L"isEvenKey", 9, true}, NULL, NULL, NULL, is_even_key_func};
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_map_intMSintME_set(&m1, i, i);
+  }
+
+  d4_map_intMSintME_retain(&d4_err_state, 0, 0, &m1, predicate);
+  assert(((void) "Keeps pairs matching predicate", m1.len == 500 && d4_map_intMSintME_has(m1, 998) && !d4_map_intMSintME_has(m1, 999)));
+
+  d4_map_intMSintME_removeIf(&d4_err_state, 0, 0, &m1, predicate);
+  assert(((void) "Removes pairs matching predicate and shrinks", m1.len == 0 && m1.cap == 0x0F));
+
+  d4_map_intMSintME_free(m1);
+}
+
+static void test_map_int_set (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_i8MSintME_t m2 = d4_map_i8MSintME_alloc(0);
+  bool all_found = true;
+
+  for (int32_t i = -5000; i < 5000; i++) {
+    d4_map_intMSintME_set(&m1, i * 7, i);
+  }
+
+  for (int32_t i = -5000; i < 5000; i++) {
+    d4_map_intMSintME_set(&m1, i * 7, i + 1);
+  }
+
+  for (int32_t i = -128; i < 128; i++) {
+    d4_map_i8MSintME_set(&m2, (int8_t) i, i);
+  }
+
+  ASSERT_NO_THROW(SET1, {
+    for (int32_t i = -5000; i < 5000; i++) {
+      if (d4_map_intMSintME_get(&d4_err_state, 0, 0, m1, i * 7) != i + 1) all_found = false;
+    }
+
+    for (int32_t i = -128; i < 128; i++) {
+      if (d4_map_i8MSintME_get(&d4_err_state, 0, 0, m2, (int8_t) i) != i) all_found = false;
+    }
+  });
+
+  assert(((void) "Sets pairs and updates existing ones", m1.len == 10000 && all_found));
+  assert(((void) "Sets every i8 key", m2.len == 256));
+  assert(((void) "Keeps load factor", !d4_map_should_reserve(m1.cap, m1.len)));
+
+  d4_map_intMSintME_free(m1);
+  d4_map_i8MSintME_free(m2);
+}
+
+static void test_map_int_stats (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_stats_t stats;
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_map_intMSintME_set(&m1, i, i);
+  }
+
+  stats = d4_map_intMSintME_stats(m1);
+
+  assert(((void) "Counts pairs", stats.len == 1000 && stats.cap == m1.cap));
+  assert(((void) "Uses no memory for identifiers", stats.ids_bytes == 0));
+  assert(((void) "Counts pairs memory", stats.pairs_bytes == 1000 * sizeof(d4_map_intMSintME_pair_t)));
+  assert(((void) "Spreads sequential keys", stats.longest_chain < 8));
+
+  d4_map_intMSintME_free(m1);
+}
+
+static void test_map_int_str (void) {
+  d4_str_t val = d4_str_alloc(L"val");
+
+  d4_str_t s1 = d4_str_alloc(L"{}");
+  d4_str_t s2 = d4_str_alloc(L"{\"1\": 10}");
+  d4_str_t s3 = d4_str_alloc(L"{\"-1\": \"val\"}");
+
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_intMSintME_t m2 = d4_map_intMSintME_alloc(1, 1, 10);
+  d4_map_intMSstrME_t m3 = d4_map_intMSstrME_alloc(1, -1, val);
+
+  d4_str_t s1_cmp = d4_map_intMSintME_str(m1);
+  d4_str_t s2_cmp = d4_map_intMSintME_str(m2);
+  d4_str_t s3_cmp = d4_map_intMSstrME_str(m3);
+
+  assert(((void) "Stringifies map with zero pairs", d4_str_eq(s1, s1_cmp)));
+  assert(((void) "Stringifies map with one pair", d4_str_eq(s2, s2_cmp)));
+  assert(((void) "Stringifies map with negative key", d4_str_eq(s3, s3_cmp)));
+
+  d4_str_free(s1_cmp);
+  d4_str_free(s2_cmp);
+  d4_str_free(s3_cmp);
+
+  d4_map_intMSintME_free(m1);
+  d4_map_intMSintME_free(m2);
+  d4_map_intMSstrME_free(m3);
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+
+  d4_str_free(val);
+}
+
+static void test_map_int_values (void) {
+  d4_str_t val1 = d4_str_alloc(L"val1");
+  d4_str_t val2 = d4_str_alloc(L"val2");
+  d4_map_intMSstrME_t m1 = d4_map_intMSstrME_alloc(2, 1, val1, 2, val2);
+  d4_arr_str_t v1 = d4_map_intMSstrME_values(m1);
+
+  assert(((void) "Returns values of map", v1.len == 2 && d4_arr_str_contains(v1, val1) && d4_arr_str_contains(v1, val2)));
+
+  d4_arr_str_free(v1);
+  d4_map_intMSstrME_free(m1);
+
+  d4_str_free(val1);
+  d4_str_free(val2);
+}
+
+static void test_map_hash_int (void) {
+  bool in_range = true;
+  bool differs = false;
+
+  for (uint64_t i = 0; i < 1000; i++) {
+    if (d4_map_hash_int(i, 0x0F) >= 0x0F) in_range = false;
+    if (d4_map_hash_int(i, 0xFFFFFFFF) != i) differs = true;
+  }
+
+  assert(((void) "Maps keys inside of capacity", in_range));
+  assert(((void) "Mixes keys instead of using them as index", differs));
+  assert(((void) "Is deterministic", d4_map_hash_int(42, 0x3C) == d4_map_hash_int(42, 0x3C)));
+  assert(((void) "Distinguishes high bits", d4_map_hash_int((uint64_t) 1 << 32, 0xFFFFFFFF) != d4_map_hash_int(0, 0xFFFFFFFF)));
+}
+
+int main (void) {
+  test_map_int_alloc();
+  test_map_int_clear();
+  test_map_int_copy();
+  test_map_int_eq();
+  test_map_int_forEach();
+  test_map_int_fromArrays();
+  test_map_int_get();
+  test_map_int_get_throws();
+  test_map_int_has();
+  test_map_int_iterNext();
+  test_map_int_keys();
+  test_map_int_merge();
+  test_map_int_remove();
+  test_map_int_retain();
+  test_map_int_set();
+  test_map_int_stats();
+  test_map_int_str();
+  test_map_int_values();
+  test_map_hash_int();
+}
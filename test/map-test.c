@@ -3,6 +3,7 @@
  * Licensed under the MIT License
  */
 
+#include "../include/d4/macro.h"
 #include <assert.h>
 #include "../include/d4/error.h"
 #include "../include/d4/number.h"
@@ -21,6 +22,38 @@ D4_MAP_DEFINE(int, int32_t, int, key, lhs_key == rhs_key, (void) key, d4_i32_str
 D4_MAP_DECLARE(str, d4_str_t, str, d4_str_t)
 D4_MAP_DEFINE(str, d4_str_t, d4_str_t, d4_str_copy(key), d4_str_eq(lhs_key, rhs_key), d4_str_free(key), d4_str_copy(key), d4_str_copy(key), str, d4_str_t, d4_str_t, d4_str_copy(val), d4_str_eq(lhs_val, rhs_val), d4_str_free(val), d4_str_quoted_escape(val))
 
+D4_MAP_DECLARE(str, d4_str_t, int, int32_t)
+D4_MAP_DEFINE_WITH_HASH(str, d4_str_t, d4_str_t, d4_str_copy(key), d4_str_eq(lhs_key, rhs_key), d4_str_free(key), d4_str_copy(key), d4_str_copy(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val), d4_map_hash_seeded)
+
+static int32_t sum = 0;
+
+static void sum_func (D4_UNUSED void *ctx, void *params) {
+  d4_fn_esFP3intFP3intFP3intFRvoidFE_params_t *p = params;
+  sum += p->n0 * p->n1 + p->n2;
+}
+
+static bool is_even_key_func (D4_UNUSED void *ctx, void *params) {
+  d4_fn_esFP3intFP3intFRboolFE_params_t *p = params;
+  return p->n0 % 2 == 0;
+}
+
+static bool is_short_value_func (D4_UNUSED void *ctx, void *params) {
+  d4_fn_esFP3strFP3strFRboolFE_params_t *p = params;
+  return p->n1.len < 4;
+}
+
+static bool throws_func (D4_UNUSED void *ctx, void *params) {
+  d4_fn_esFP3intFP3intFRboolFE_params_t *p = params;
+  d4_str_t message;
+
+  if (p->n0 < 5) return true;
+
+  message = d4_str_alloc(L"predicate failed");
+  d4_error_assign_generic(p->state, p->line, p->col, message);
+  d4_str_free(message);
+  longjmp(p->state->buf_last->buf, p->state->id);
+}
+
 static void test_map_alloc (void) {
   d4_str_t val1 = d4_str_alloc(L"val1");
   d4_str_t val2 = d4_str_alloc(L"val2");
@@ -137,6 +170,22 @@ static void test_map_eq (void) {
   d4_str_free(val);
 }
 
+static void test_map_forEach (void) {
+  d4_fn_esFP3intFP3intFP3intFRvoidFE_t sum_fn = {(d4_str_t) {L"sum", 3, true}, NULL, NULL, NULL, sum_func};
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_intMSintME_t m2 = d4_map_intMSintME_alloc(3, 1, 10, 2, 20, 3, 30);
+
+  sum = 0;
+  d4_map_intMSintME_forEach(&d4_err_state, 0, 0, m1, sum_fn);
+  assert(((void) "Iterates empty map", sum == 0));
+
+  d4_map_intMSintME_forEach(&d4_err_state, 0, 0, m2, sum_fn);
+  assert(((void) "Iterates every pair with position", sum == 10 + 40 + 90 + 0 + 1 + 2));
+
+  d4_map_intMSintME_free(m1);
+  d4_map_intMSintME_free(m2);
+}
+
 static void test_map_free (void) {
   d4_str_t val = d4_str_alloc(L"val");
 
@@ -151,6 +200,127 @@ static void test_map_free (void) {
   d4_str_free(val);
 }
 
+static void test_map_fromArrays (void) {
+  d4_str_t val1 = d4_str_alloc(L"val1");
+  d4_str_t val2 = d4_str_alloc(L"val2");
+  d4_str_t val3 = d4_str_alloc(L"val3");
+
+  d4_arr_int_t k1 = d4_arr_int_alloc(0);
+  d4_arr_str_t v1 = d4_arr_str_alloc(0);
+  d4_arr_int_t k2 = d4_arr_int_alloc(3, 1, 2, 1);
+  d4_arr_str_t v2 = d4_arr_str_alloc(3, val1, val2, val3);
+  d4_arr_int_t k3 = d4_arr_int_alloc(3, 1, 2, 3);
+  d4_arr_str_t v3 = d4_arr_str_alloc(1, val1);
+
+  d4_map_intMSstrME_t m1 = d4_map_intMSstrME_fromArrays(k1, v1);
+  d4_map_intMSstrME_t m2 = d4_map_intMSstrME_fromArrays(k2, v2);
+  d4_map_intMSstrME_t m3 = d4_map_intMSstrME_fromArrays(k3, v3);
+  d4_map_intMSstrME_t m4 = d4_map_intMSstrME_alloc(2, 1, val3, 2, val2);
+  d4_map_intMSstrME_t m5 = d4_map_intMSstrME_alloc(1, 1, val1);
+
+  assert(((void) "Allocates from empty arrays", m1.len == 0 && m1.cap == 0x0F));
+  assert(((void) "Allocates with repeated keys", d4_map_intMSstrME_eq(m2, m4)));
+  assert(((void) "Allocates from arrays of different length", d4_map_intMSstrME_eq(m3, m5)));
+  assert(((void) "Keeps arrays untouched", k2.len == 3 && v2.len == 3 && d4_str_eq(v2.data[2], val3)));
+
+  d4_map_intMSstrME_free(m1);
+  d4_map_intMSstrME_free(m2);
+  d4_map_intMSstrME_free(m3);
+  d4_map_intMSstrME_free(m4);
+  d4_map_intMSstrME_free(m5);
+
+  d4_arr_int_free(k1);
+  d4_arr_str_free(v1);
+  d4_arr_int_free(k2);
+  d4_arr_str_free(v2);
+  d4_arr_int_free(k3);
+  d4_arr_str_free(v3);
+
+  d4_str_free(val1);
+  d4_str_free(val2);
+  d4_str_free(val3);
+}
+
+static void test_map_fromArraysMove (void) {
+  d4_str_t key1 = d4_str_alloc(L"key1");
+  d4_str_t key2 = d4_str_alloc(L"key2");
+  d4_str_t val1 = d4_str_alloc(L"val1");
+  d4_str_t val2 = d4_str_alloc(L"val2");
+  d4_str_t val3 = d4_str_alloc(L"val3");
+
+  d4_map_strMSstrME_t m1 = d4_map_strMSstrME_fromArraysMove(d4_arr_str_alloc(0), d4_arr_str_alloc(0));
+  d4_map_strMSstrME_t m2 = d4_map_strMSstrME_fromArraysMove(d4_arr_str_alloc(3, key1, key2, key1), d4_arr_str_alloc(3, val1, val2, val3));
+  d4_map_strMSstrME_t m3 = d4_map_strMSstrME_fromArraysMove(d4_arr_str_alloc(2, key1, key2), d4_arr_str_alloc(1, val1));
+  d4_map_strMSstrME_t m4 = d4_map_strMSstrME_fromArraysMove(d4_arr_str_alloc(1, key1), d4_arr_str_alloc(2, val1, val2));
+  d4_map_strMSstrME_t m5 = d4_map_strMSstrME_alloc(2, key1, val3, key2, val2);
+  d4_map_strMSstrME_t m6 = d4_map_strMSstrME_alloc(1, key1, val1);
+
+  assert(((void) "Allocates from empty arrays", m1.len == 0 && m1.cap == 0x0F));
+  assert(((void) "Allocates with repeated keys", d4_map_strMSstrME_eq(m2, m5)));
+  assert(((void) "Allocates from more keys than values", d4_map_strMSstrME_eq(m3, m6)));
+  assert(((void) "Allocates from more values than keys", d4_map_strMSstrME_eq(m4, m6)));
+
+  d4_map_strMSstrME_free(m1);
+  d4_map_strMSstrME_free(m2);
+  d4_map_strMSstrME_free(m3);
+  d4_map_strMSstrME_free(m4);
+  d4_map_strMSstrME_free(m5);
+  d4_map_strMSstrME_free(m6);
+
+  d4_str_free(key1);
+  d4_str_free(key2);
+  d4_str_free(val1);
+  d4_str_free(val2);
+  d4_str_free(val3);
+}
+
+static void test_map_fromPairs (void) {
+  d4_str_t val1 = d4_str_alloc(L"val1");
+  d4_str_t val2 = d4_str_alloc(L"val2");
+  d4_map_intMSstrME_entry_t entries[] = {{1, val1}, {2, val2}, {1, val2}};
+
+  d4_map_intMSstrME_t m1 = d4_map_intMSstrME_fromPairs(NULL, 0);
+  d4_map_intMSstrME_t m2 = d4_map_intMSstrME_fromPairs(entries, 2);
+  d4_map_intMSstrME_t m3 = d4_map_intMSstrME_fromPairs(entries, 3);
+  d4_map_intMSstrME_t m4 = d4_map_intMSstrME_alloc(2, 1, val1, 2, val2);
+  d4_map_intMSstrME_t m5 = d4_map_intMSstrME_alloc(2, 1, val2, 2, val2);
+
+  assert(((void) "Allocates from zero entries", m1.len == 0 && m1.cap == 0x0F));
+  assert(((void) "Allocates from entries", d4_map_intMSstrME_eq(m2, m4)));
+  assert(((void) "Allocates with repeated keys", d4_map_intMSstrME_eq(m3, m5)));
+
+  d4_map_intMSstrME_free(m1);
+  d4_map_intMSstrME_free(m2);
+  d4_map_intMSstrME_free(m3);
+  d4_map_intMSstrME_free(m4);
+  d4_map_intMSstrME_free(m5);
+
+  d4_str_free(val1);
+  d4_str_free(val2);
+}
+
+static void test_map_fromArrays_large (void) {
+  d4_arr_int_t keys = {d4_safe_alloc(1000 * sizeof(int32_t)), 1000};
+  d4_arr_int_t values = {d4_safe_alloc(1000 * sizeof(int32_t)), 1000};
+  d4_map_intMSintME_t m;
+
+  for (int32_t i = 0; i < 1000; i++) {
+    keys.data[i] = i;
+    values.data[i] = i * 2;
+  }
+
+  m = d4_map_intMSintME_fromArraysMove(keys, values);
+  assert(((void) "Sizes map once", m.len == 1000 && m.cap == d4_map_calc_cap(0x0F, 1000)));
+
+  ASSERT_NO_THROW(FROM_ARRAYS_LARGE, {
+    for (int32_t i = 0; i < 1000; i++) {
+      assert(((void) "Contains every pair", d4_map_intMSintME_get(&d4_err_state, 0, 0, m, i) == i * 2));
+    }
+  });
+
+  d4_map_intMSintME_free(m);
+}
+
 static void test_map_get (void) {
   d4_str_t val1 = d4_str_alloc(L"val1");
   d4_str_t val2 = d4_str_alloc(L"val2");
@@ -228,6 +398,52 @@ static void test_map_has (void) {
   d4_str_free(val);
 }
 
+static void test_map_iterNext (void) {
+  d4_str_t key = d4_str_alloc(L"key");
+  d4_str_t val = d4_str_alloc(L"val");
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_strMSstrME_t m2 = d4_map_strMSstrME_alloc(1, key, val);
+  d4_map_intMSintME_iter_t it1 = d4_map_intMSintME_iterBegin(m1);
+  d4_map_strMSstrME_iter_t it2 = d4_map_strMSstrME_iterBegin(m2);
+  int32_t keys_sum = 0;
+  int32_t len = 0;
+
+  assert(((void) "Iterates empty map", !d4_map_intMSintME_iterNext(&it1) && it1.key == NULL && it1.value == NULL));
+  assert(((void) "Iterates string pair", d4_map_strMSstrME_iterNext(&it2) && d4_str_eq(*it2.key, key) && d4_str_eq(*it2.value, val)));
+  assert(((void) "Stops after last pair", !d4_map_strMSstrME_iterNext(&it2)));
+
+  for (int32_t i = 0; i < 100; i++) {
+    d4_map_intMSintME_set(&m1, i, i);
+  }
+
+  it1 = d4_map_intMSintME_iterBegin(m1);
+
+  while (d4_map_intMSintME_iterNext(&it1)) {
+    keys_sum += *it1.key;
+    *it1.value = *it1.key * 2;
+    len++;
+  }
+
+  assert(((void) "Iterates every pair", len == 100 && keys_sum == 4950));
+
+  ASSERT_NO_THROW(ITER_NEXT, {
+    assert(((void) "Updates values through iterator", d4_map_intMSintME_get(&d4_err_state, 0, 0, m1, 10) == 20));
+
+    it1 = d4_map_intMSintME_iterBegin(m1);
+
+    while (d4_map_intMSintME_iterNext(&it1)) {
+      if (*it1.key % 2 == 0) d4_map_intMSintME_remove(&d4_err_state, 0, 0, &m1, *it1.key);
+    }
+
+    assert(((void) "Removes current pair while iterating", m1.len == 50 && !d4_map_intMSintME_has(m1, 10) && d4_map_intMSintME_has(m1, 11)));
+  });
+
+  d4_map_intMSintME_free(m1);
+  d4_map_strMSstrME_free(m2);
+  d4_str_free(key);
+  d4_str_free(val);
+}
+
 static void test_map_keys (void) {
   d4_str_t val = d4_str_alloc(L"val");
 
@@ -267,11 +483,12 @@ static void test_map_merge (void) {
   d4_map_intMSstrME_merge(&m1, m2);
   assert(((void) "Merges into empty map", m1.len == 1));
   d4_map_intMSstrME_merge(&m1, m2);
-  assert(((void) "Merges into filled empty map", m1.len == 2));
+  assert(((void) "Merges repeated keys into filled empty map", m1.len == 1));
   d4_map_intMSstrME_merge(&m2, m3);
   assert(((void) "Merges into filled map", m2.len == 3));
   d4_map_intMSstrME_merge(&m2, m1);
-  assert(((void) "Merges previously filled into filled map", m2.len == 5));
+  assert(((void) "Merges previously filled into filled map", m2.len == 3));
+  assert(((void) "Keeps other map untouched", m3.len == 2));
 
   d4_map_intMSstrME_free(m1);
   d4_map_intMSstrME_free(m2);
@@ -280,6 +497,45 @@ static void test_map_merge (void) {
   d4_str_free(val);
 }
 
+static void test_map_mergeMove (void) {
+  d4_str_t val = d4_str_alloc(L"val");
+  d4_str_t val2 = d4_str_alloc(L"val2");
+
+  d4_map_intMSstrME_t m1 = d4_map_intMSstrME_alloc(0);
+  d4_map_intMSstrME_t m2 = d4_map_intMSstrME_alloc(1, 1, val);
+  d4_map_intMSstrME_t m3 = d4_map_intMSstrME_alloc(2, 1, val2, 2, val2);
+  d4_map_intMSstrME_t m4 = d4_map_intMSstrME_alloc(0);
+  d4_map_intMSstrME_t m5 = d4_map_intMSstrME_alloc(2, 1, val2, 2, val2);
+
+  d4_map_intMSstrME_mergeMove(&m1, &m2);
+  assert(((void) "Moves into empty map", m1.len == 1 && m2.len == 0));
+  assert(((void) "Leaves other map empty", d4_map_intMSstrME_eq(m2, m4)));
+  d4_map_intMSstrME_mergeMove(&m1, &m2);
+  assert(((void) "Moves from empty map", m1.len == 1));
+  d4_map_intMSstrME_mergeMove(&m1, &m3);
+  assert(((void) "Moves repeated keys into filled map", d4_map_intMSstrME_eq(m1, m5) && m3.len == 0));
+  d4_map_intMSstrME_mergeMove(&m1, &m1);
+  assert(((void) "Moves map into itself", d4_map_intMSstrME_eq(m1, m5)));
+
+  for (int32_t i = 0; i < 100; i++) {
+    d4_map_intMSstrME_set(&m4, i, val);
+  }
+
+  d4_map_intMSstrME_mergeMove(&m2, &m4);
+  assert(((void) "Moves many pairs and reallocates", m2.len == 100 && m4.len == 0 && !d4_map_intMSstrME_has(m4, 0)));
+  d4_map_intMSstrME_set(&m4, 1, val);
+  assert(((void) "Keeps other map usable", m4.len == 1));
+
+  d4_map_intMSstrME_free(m1);
+  d4_map_intMSstrME_free(m2);
+  d4_map_intMSstrME_free(m3);
+  d4_map_intMSstrME_free(m4);
+  d4_map_intMSstrME_free(m5);
+
+  d4_str_free(val);
+  d4_str_free(val2);
+}
+
 static void test_map_place (void) {
   d4_str_t key = d4_str_alloc(L"key");
   d4_str_t key2 = d4_str_alloc(L"2");
@@ -329,6 +585,28 @@ static void test_map_place (void) {
   d4_str_free(key4);
 }
 
+static void test_map_placeMove (void) {
+  d4_str_t key = d4_str_alloc(L"key");
+  d4_str_t val = d4_str_alloc(L"val");
+  d4_str_t val2 = d4_str_alloc(L"val2");
+
+  d4_map_strMSstrME_t m1 = d4_map_strMSstrME_alloc(0);
+  d4_map_strMSstrME_t m2 = d4_map_strMSstrME_alloc(1, key, val2);
+
+  d4_map_strMSstrME_placeMove(&m1, d4_str_copy(key), d4_str_copy(key), d4_str_copy(val));
+  assert(((void) "Places into empty map", m1.len == 1 && m1.cap == 0x0F));
+
+  d4_map_strMSstrME_placeMove(&m1, d4_str_copy(key), d4_str_copy(key), d4_str_copy(val2));
+  assert(((void) "Replaces value of repeated key", d4_map_strMSstrME_eq(m1, m2)));
+
+  d4_map_strMSstrME_free(m1);
+  d4_map_strMSstrME_free(m2);
+
+  d4_str_free(key);
+  d4_str_free(val);
+  d4_str_free(val2);
+}
+
 static void test_map_realloc (void) {
   d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
   d4_map_intMSintME_t m2 = d4_map_intMSintME_alloc(1, 1, 10);
@@ -383,6 +661,41 @@ static void test_map_remove (void) {
   d4_str_free(val);
 }
 
+static void test_map_removeIf (void) {
+  d4_str_t key1 = d4_str_alloc(L"key1");
+  d4_str_t key2 = d4_str_alloc(L"key2");
+  d4_str_t val1 = d4_str_alloc(L"val");
+  d4_str_t val2 = d4_str_alloc(L"value");
+  d4_fn_esFP3intFP3intFRboolFE_t is_even_key = {(d4_str_t) {L"is_even_key", 11, true}, NULL, NULL, NULL, is_even_key_func};
+  d4_fn_esFP3strFP3strFRboolFE_t is_short_value = {(d4_str_t) {L"is_short_value", 14, true}, NULL, NULL, NULL, is_short_value_func};
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_strMSstrME_t m2 = d4_map_strMSstrME_alloc(2, key1, val1, key2, val2);
+  d4_map_strMSstrME_t m3 = d4_map_strMSstrME_alloc(1, key2, val2);
+
+  ASSERT_NO_THROW(REMOVE_IF, {
+    d4_map_intMSintME_removeIf(&d4_err_state, 0, 0, &m1, is_even_key);
+    assert(((void) "Removes from empty map", m1.len == 0 && m1.cap == 0x0F));
+
+    for (int32_t i = 0; i < 1000; i++) {
+      d4_map_intMSintME_set(&m1, i, i);
+    }
+
+    d4_map_intMSintME_removeIf(&d4_err_state, 0, 0, &m1, is_even_key);
+    assert(((void) "Removes matching pairs", m1.len == 500 && !d4_map_intMSintME_has(m1, 0) && d4_map_intMSintME_has(m1, 1)));
+
+    d4_map_strMSstrME_removeIf(&d4_err_state, 0, 0, &m2, is_short_value);
+    assert(((void) "Removes matching string pairs", d4_map_strMSstrME_eq(m2, m3)));
+  });
+
+  d4_map_intMSintME_free(m1);
+  d4_map_strMSstrME_free(m2);
+  d4_map_strMSstrME_free(m3);
+  d4_str_free(key1);
+  d4_str_free(key2);
+  d4_str_free(val1);
+  d4_str_free(val2);
+}
+
 static void test_map_reserve (void) {
   d4_str_t key1 = d4_str_alloc(L"key1");
   d4_str_t key2 = d4_str_alloc(L"key2");
@@ -410,6 +723,44 @@ static void test_map_reserve (void) {
   d4_str_free(val2);
 }
 
+static void test_map_retain (void) {
+  d4_fn_esFP3intFP3intFRboolFE_t is_even_key = {(d4_str_t) {L"is_even_key", 11, true}, NULL, NULL, NULL, is_even_key_func};
+  d4_fn_esFP3intFP3intFRboolFE_t throws = {(d4_str_t) {L"throws", 6, true}, NULL, NULL, NULL, throws_func};
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_intMSintME_t m2 = d4_map_intMSintME_alloc(0);
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_map_intMSintME_set(&m1, i, i);
+  }
+
+  for (int32_t i = 0; i < 10; i++) {
+    d4_map_intMSintME_set(&m2, i, i);
+  }
+
+  ASSERT_NO_THROW(RETAIN1, {
+    d4_map_intMSintME_retain(&d4_err_state, 0, 0, &m1, is_even_key);
+    assert(((void) "Keeps matching pairs", m1.len == 500 && d4_map_intMSintME_has(m1, 0) && !d4_map_intMSintME_has(m1, 1)));
+    assert(((void) "Keeps capacity above low-water mark", m1.cap == 1920));
+
+    for (int32_t i = 2; i < 1000; i += 2) {
+      d4_map_intMSintME_remove(&d4_err_state, 0, 0, &m1, i);
+    }
+
+    d4_map_intMSintME_set(&m1, 1, 1);
+    d4_map_intMSintME_retain(&d4_err_state, 0, 0, &m1, is_even_key);
+    assert(((void) "Shrinks below low-water mark", m1.len == 1 && m1.cap == 0x0F && d4_map_intMSintME_has(m1, 0)));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(RETAIN2, {
+    d4_map_intMSintME_retain(&d4_err_state, 0, 0, &m2, throws);
+  }, L"predicate failed");
+
+  assert(((void) "Keeps map consistent when predicate throws", m2.len == 10));
+
+  d4_map_intMSintME_free(m1);
+  d4_map_intMSintME_free(m2);
+}
+
 static void test_map_set (void) {
   d4_str_t key = d4_str_alloc(L"key");
   d4_str_t val = d4_str_alloc(L"val");
@@ -476,6 +827,52 @@ static void test_map_shrink (void) {
   d4_str_free(val2);
 }
 
+static void test_map_stats (void) {
+  d4_str_t key1 = d4_str_alloc(L"key1");
+  d4_str_t key2 = d4_str_alloc(L"key2");
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_strMSstrME_t m2 = d4_map_strMSstrME_alloc(2, key1, key2, key2, key1);
+  d4_map_intMSintME_t m3 = d4_map_intMSintME_alloc(0);
+  d4_str_t key3 = d4_str_share(d4_str_alloc(L"key3"));
+  d4_map_strMSstrME_t m4 = d4_map_strMSstrME_alloc(1, key3, key1);
+  d4_map_stats_t s1 = d4_map_intMSintME_stats(m1);
+  d4_map_stats_t s2 = d4_map_strMSstrME_stats(m2);
+  d4_map_stats_t s3;
+  d4_map_stats_t s4 = d4_map_strMSstrME_stats(m4);
+  size_t histogram_total = 0;
+  size_t histogram_pairs = 0;
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_map_intMSintME_set(&m3, i, i);
+  }
+
+  s3 = d4_map_intMSintME_stats(m3);
+
+  for (size_t i = 0; i < D4_MAP_STATS_HISTOGRAM_LEN; i++) {
+    histogram_total += s3.chain_histogram[i];
+    histogram_pairs += i * s3.chain_histogram[i];
+  }
+
+  assert(((void) "Collects stats of empty map", s1.len == 0 && s1.cap == 0x0F && s1.load_factor == 0));
+  assert(((void) "Counts empty buckets of empty map", s1.empty_buckets == 0x0F && s1.chain_histogram[0] == 0x0F && s1.longest_chain == 0));
+  assert(((void) "Counts bytes of empty map", s1.pairs_bytes == 0 && s1.ids_bytes == 0 && s1.buckets_bytes == 0x0F * sizeof(d4_map_intMSintME_pair_t *)));
+  assert(((void) "Counts bytes of pairs", s2.pairs_bytes == 2 * sizeof(d4_map_strMSstrME_pair_t)));
+  assert(((void) "Counts bytes of ids", s2.ids_bytes == 2 * 5 * sizeof(wchar_t)));
+  assert(((void) "Counts bytes of shared ids", s4.ids_bytes == 5 * sizeof(wchar_t)));
+  assert(((void) "Counts empty buckets of filled map", s2.empty_buckets == 0x0F - (s2.longest_chain == 2 ? 1 : 2)));
+  assert(((void) "Calculates load factor", s3.load_factor == (double) s3.len / (double) s3.cap && s3.load_factor < 0.75));
+  assert(((void) "Histogram covers every bucket", histogram_total == s3.cap && s3.chain_histogram[0] == s3.empty_buckets));
+  assert(((void) "Histogram covers every pair", s3.longest_chain >= D4_MAP_STATS_HISTOGRAM_LEN - 1 || histogram_pairs == s3.len));
+
+  d4_map_intMSintME_free(m1);
+  d4_map_strMSstrME_free(m2);
+  d4_map_intMSintME_free(m3);
+  d4_map_strMSstrME_free(m4);
+  d4_str_free(key1);
+  d4_str_free(key2);
+  d4_str_free(key3);
+}
+
 static void test_map_str (void) {
   d4_str_t key = d4_str_alloc(L"key");
   d4_str_t val = d4_str_alloc(L"val");
@@ -554,6 +951,34 @@ static void test_map_calc_cap (void) {
   assert(((void) "Returns same capacity when should not reserve", d4_map_calc_cap(0x20, 0x0F) == 0x20));
 }
 
+static void test_map_counters (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_map_counters_t c1;
+  d4_map_counters_t c2;
+  d4_map_counters_t c3;
+
+  d4_map_counters_reset();
+  for (int32_t i = 0; i < 100; i++) d4_map_intMSintME_set(&m1, i, i);
+  c1 = d4_map_counters_get();
+  assert(((void) "Doesn't collect counters by default", c1.resizes == 0 && c1.rehashed_pairs == 0));
+
+  d4_map_counters_enable(true);
+  for (int32_t i = 100; i < 1000; i++) d4_map_intMSintME_set(&m1, i, i);
+  d4_map_intMSintME_shrink(&m1);
+  c2 = d4_map_counters_get();
+  assert(((void) "Collects resizes", c2.resizes == 4));
+  assert(((void) "Collects rehashed pairs", c2.rehashed_pairs == 180 + 360 + 720 + 1000));
+  assert(((void) "Collects resize time", c2.resize_time >= 0 && c2.longest_resize_time <= c2.resize_time));
+
+  d4_map_counters_enable(false);
+  d4_map_intMSintME_shrink(&m1);
+  d4_map_counters_reset();
+  c3 = d4_map_counters_get();
+  assert(((void) "Resets counters", c3.resizes == 0 && c3.rehashed_pairs == 0 && c3.resize_time == 0));
+
+  d4_map_intMSintME_free(m1);
+}
+
 static void test_map_hash (void) {
   d4_str_t s1 = d4_str_alloc(L"");
   d4_str_t s2 = d4_str_alloc(L"h");
@@ -612,33 +1037,150 @@ static void test_map_hash (void) {
   d4_str_free(s13);
 }
 
+static void test_map_hash_seed (void) {
+  unsigned char key[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
+  d4_str_t s1 = d4_str_alloc(L"hello");
+  size_t h1 = d4_map_hash_seeded(s1, 0xFFFFFFFFFFFFFFFF);
+  size_t h2;
+
+  key[0] = 0xFF;
+  d4_map_hash_seed(key);
+  h2 = d4_map_hash_seeded(s1, 0xFFFFFFFFFFFFFFFF);
+  assert(((void) "Random key differs from fixed key", h1 != h2));
+  key[0] = 0x00;
+  d4_map_hash_seed(key);
+  assert(((void) "Changing key changes hash", h2 != d4_map_hash_seeded(s1, 0xFFFFFFFFFFFFFFFF)));
+
+  d4_str_free(s1);
+}
+
+static void test_map_hash_seeded (void) {
+  unsigned char key[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
+  d4_str_t s1 = d4_str_alloc(L"");
+  d4_str_t s2 = d4_str_alloc(L"h");
+  d4_str_t s3 = d4_str_alloc(L"he");
+  d4_str_t s4 = d4_str_alloc(L"hel");
+  d4_str_t s5 = d4_str_alloc(L"hello");
+  d4_str_t s6 = d4_str_alloc(L"hello world");
+
+  d4_map_hash_seed(key);
+
+  assert(((void) "Calculates seeded hash for s1 with cap 0x10", d4_map_hash_seeded(s1, 0x10) == 0x0C));
+  assert(((void) "Calculates seeded hash for s1 with cap 0xFFFFFFFFFFFFFFFF", d4_map_hash_seeded(s1, 0xFFFFFFFFFFFFFFFF) == 0xabac0158050fc4dc));
+  assert(((void) "Calculates seeded hash for s2 with cap 0xFFFFFFFFFFFFFFFF", d4_map_hash_seeded(s2, 0xFFFFFFFFFFFFFFFF) == 0xcd8365db758f36bb));
+  assert(((void) "Calculates seeded hash for s3 with cap 0xFFFFFFFFFFFFFFFF", d4_map_hash_seeded(s3, 0xFFFFFFFFFFFFFFFF) == 0xd99714832a4503ca));
+  assert(((void) "Calculates seeded hash for s4 with cap 0xFFFFFFFFFFFFFFFF", d4_map_hash_seeded(s4, 0xFFFFFFFFFFFFFFFF) == 0xa3a8ff7e21c4e40f));
+  assert(((void) "Calculates seeded hash for s5 with cap 0xFFFFFFFFFFFFFFFF", d4_map_hash_seeded(s5, 0xFFFFFFFFFFFFFFFF) == 0xf5333b49e21265c4));
+  assert(((void) "Calculates seeded hash for s6 with cap 0xFFFFFFFFFFFFFFFF", d4_map_hash_seeded(s6, 0xFFFFFFFFFFFFFFFF) == 0x8e75528f7e662d6c));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+  d4_str_free(s6);
+}
+
+static void test_map_with_hash (void) {
+  d4_map_strMSintME_t m1 = d4_map_strMSintME_alloc(0);
+  d4_map_strMSintME_t m2;
+  d4_str_t key = d4_str_alloc(L"key0");
+
+  for (int32_t i = 0; i < 100; i++) {
+    d4_str_t k = d4_str_alloc(L"key%" PRId32, i);
+    d4_map_strMSintME_set(&m1, k, i);
+    d4_str_free(k);
+  }
+
+  m2 = d4_map_strMSintME_copy(m1);
+  assert(((void) "Seeded map keeps all pairs", m1.len == 100));
+  assert(((void) "Seeded map grows", m1.cap > 100));
+  assert(((void) "Seeded map copies", d4_map_strMSintME_eq(m1, m2)));
+
+  ASSERT_NO_THROW(WITH_HASH1, {
+    assert(((void) "Seeded map gets pair", d4_map_strMSintME_get(&d4_err_state, 0, 0, m1, key) == 0));
+    d4_map_strMSintME_remove(&d4_err_state, 0, 0, &m1, key);
+  });
+
+  assert(((void) "Seeded map removes pair", !d4_map_strMSintME_has(m1, key)));
+
+  d4_map_strMSintME_free(m1);
+  d4_map_strMSintME_free(m2);
+  d4_str_free(key);
+}
+
+static void test_map_low_water_set (void) {
+  d4_fn_esFP3intFP3intFRboolFE_t is_even_key = {(d4_str_t) {L"is_even_key", 11, true}, NULL, NULL, NULL, is_even_key_func};
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+
+  for (int32_t i = 1; i < 1000; i += 2) {
+    d4_map_intMSintME_set(&m1, i, i);
+  }
+
+  d4_map_low_water_set(0);
+  assert(((void) "Disables shrinking", !d4_map_should_shrink(0x1000, 0)));
+
+  ASSERT_NO_THROW(LOW_WATER_SET, {
+    d4_map_intMSintME_retain(&d4_err_state, 0, 0, &m1, is_even_key);
+    assert(((void) "Doesn't shrink when disabled", m1.len == 0 && m1.cap == 960));
+  });
+
+  d4_map_low_water_set(0.125);
+  assert(((void) "Restores shrinking", d4_map_should_shrink(0x1000, 0)));
+
+  d4_map_intMSintME_free(m1);
+}
+
 static void test_map_should_reserve (void) {
   assert(((void) "Reserves when len == cap", d4_map_should_reserve(0x0F, 0x0F)));
   assert(((void) "Reserves when len > cap", d4_map_should_reserve(0x00, 0x0F)));
   assert(((void) "Does not reserve when capacity satisfies load factor", !d4_map_should_reserve(0xFF, 0x0F)));
 }
 
+static void test_map_should_shrink (void) {
+  assert(((void) "Doesn't shrink initial capacity", !d4_map_should_shrink(0x0F, 0)));
+  assert(((void) "Shrinks when load factor below low-water mark", d4_map_should_shrink(0x20, 3)));
+  assert(((void) "Doesn't shrink when load factor at low-water mark", !d4_map_should_shrink(0x20, 4)));
+}
+
 int main (void) {
   test_map_alloc();
   test_map_clear();
   test_map_copy();
   test_map_empty();
   test_map_eq();
+  test_map_forEach();
   test_map_free();
+  test_map_fromArrays();
+  test_map_fromArraysMove();
+  test_map_fromPairs();
+  test_map_fromArrays_large();
   test_map_get();
   test_map_get_throws();
   test_map_has();
+  test_map_iterNext();
   test_map_keys();
   test_map_merge();
+  test_map_mergeMove();
   test_map_place();
+  test_map_placeMove();
   test_map_realloc();
   test_map_remove();
+  test_map_removeIf();
   test_map_reserve();
+  test_map_retain();
   test_map_set();
   test_map_shrink();
+  test_map_stats();
   test_map_str();
   test_map_values();
   test_map_calc_cap();
+  test_map_counters();
   test_map_hash();
+  test_map_hash_seed();
+  test_map_hash_seeded();
+  test_map_low_water_set();
   test_map_should_reserve();
+  test_map_should_shrink();
+  test_map_with_hash();
 }
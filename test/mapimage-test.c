@@ -0,0 +1,221 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include <assert.h>
+#include <stdio.h>
+#include "../include/d4/error.h"
+#include "../include/d4/mapimage.h"
+#include "../include/d4/number.h"
+#include "utils.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_MAP_DECLARE(int, int32_t, int, int32_t)
+D4_MAP_DEFINE(int, int32_t, int, key, lhs_key == rhs_key, (void) key, d4_i32_str(key), d4_i32_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+D4_MAP_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_MAP_DEFINE(str, d4_str_t, d4_str_t, d4_str_copy(key), d4_str_eq(lhs_key, rhs_key), d4_str_free(key), d4_str_copy(key), d4_str_copy(key), str, d4_str_t, d4_str_t, d4_str_copy(val), d4_str_eq(lhs_val, rhs_val), d4_str_free(val), d4_str_quoted_escape(val))
+
+D4_MAPIMAGE_DECLARE(int, int32_t, int, int32_t)
+D4_MAPIMAGE_DEFINE(int, int32_t, &key, sizeof(key), *(int32_t *) data, lhs_key == rhs_key, d4_map_hash_int((uint64_t) key, SIZE_MAX), d4_i32_str(key), int, int32_t, &val, sizeof(val), *(int32_t *) data, val)
+
+D4_MAPIMAGE_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_MAPIMAGE_DEFINE(str, d4_str_t, key.data, key.len * sizeof(wchar_t), ((d4_str_t) {data, size / sizeof(wchar_t), true}), d4_str_eq(lhs_key, rhs_key), d4_map_hash(key, SIZE_MAX), d4_str_copy(key), str, d4_str_t, val.data, val.len * sizeof(wchar_t), ((d4_str_t) {data, size / sizeof(wchar_t), true}), d4_str_copy(val))
+
+#define IMAGE_PATH L"mapimage-test.bin"
+
+static d4_str_t image_path = {IMAGE_PATH, sizeof(IMAGE_PATH) / sizeof(wchar_t) - 1, true};
+
+static void image_patch (long offset, int whence, unsigned char byte) {
+  FILE *file = fopen("mapimage-test.bin", "r+b");
+  fseek(file, offset, whence);
+  fwrite(&byte, 1, 1, file);
+  fclose(file);
+}
+
+// Offset of the first record, which follows 56 bytes of the header and offsets of the buckets.
+static uint64_t image_records_start (void) {
+  FILE *file = fopen("mapimage-test.bin", "rb");
+  uint64_t buckets_len = 0;
+
+  fseek(file, 32, SEEK_SET);
+  fread(&buckets_len, sizeof(buckets_len), 1, file);
+  fclose(file);
+  return 56 + buckets_len * sizeof(uint64_t);
+}
+
+static void image_patch_u64 (long offset, uint64_t value) {
+  FILE *file = fopen("mapimage-test.bin", "r+b");
+  fseek(file, offset, SEEK_SET);
+  fwrite(&value, sizeof(value), 1, file);
+  fclose(file);
+}
+
+static void test_mapimage_get (void) {
+  d4_str_t key1 = d4_str_alloc(L"key1");
+  d4_str_t key2 = d4_str_alloc(L"key2");
+  d4_str_t val1 = d4_str_alloc(L"val1");
+  d4_map_strMSstrME_t m1 = d4_map_strMSstrME_alloc(1, key1, val1);
+  d4_mapimage_strMSstrME_t i1;
+
+  d4_mapimage_strMSstrME_write(&d4_err_state, 0, 0, m1, image_path);
+  i1 = d4_mapimage_strMSstrME_open(&d4_err_state, 0, 0, image_path);
+
+  ASSERT_NO_THROW(GET1, {
+    d4_str_t v1 = d4_mapimage_strMSstrME_get(&d4_err_state, 0, 0, i1, key1);
+    assert(((void) "Gets copy of the value", d4_str_eq(v1, val1) && !v1.is_static));
+    d4_str_free(v1);
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(GET2, {
+    d4_mapimage_strMSstrME_get(&d4_err_state, 0, 0, i1, key2);
+  }, L"failed to find key 'key2'");
+
+  d4_mapimage_strMSstrME_free(i1);
+  d4_map_strMSstrME_free(m1);
+  d4_str_free(key1);
+  d4_str_free(key2);
+  d4_str_free(val1);
+  remove("mapimage-test.bin");
+}
+
+static void test_mapimage_has (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_mapimage_intMSintME_t i1;
+
+  for (int32_t i = -500; i < 500; i++) {
+    d4_map_intMSintME_set(&m1, i, i * 2);
+  }
+
+  d4_mapimage_intMSintME_write(&d4_err_state, 0, 0, m1, image_path);
+  i1 = d4_mapimage_intMSintME_open(&d4_err_state, 0, 0, image_path);
+
+  assert(((void) "Keeps number of pairs", i1.len == 1000));
+  assert(((void) "Has every written key", d4_mapimage_intMSintME_has(i1, -500) && d4_mapimage_intMSintME_has(i1, 0) && d4_mapimage_intMSintME_has(i1, 499)));
+  assert(((void) "Has no missing key", !d4_mapimage_intMSintME_has(i1, 500)));
+  assert(((void) "Gets scalar value", d4_mapimage_intMSintME_get(&d4_err_state, 0, 0, i1, -7) == -14));
+
+  d4_mapimage_intMSintME_free(i1);
+  d4_map_intMSintME_free(m1);
+  remove("mapimage-test.bin");
+}
+
+static void test_mapimage_lookup (void) {
+  d4_str_t key1 = d4_str_alloc(L"key1");
+  d4_str_t key2 = d4_str_alloc(L"");
+  d4_str_t val1 = d4_str_alloc(L"val1");
+  d4_map_strMSstrME_t m1 = d4_map_strMSstrME_alloc(2, key1, val1, key2, key2);
+  d4_mapimage_strMSstrME_t i1;
+  d4_str_t v1;
+  d4_str_t v2;
+
+  d4_mapimage_strMSstrME_write(&d4_err_state, 0, 0, m1, image_path);
+  i1 = d4_mapimage_strMSstrME_open(&d4_err_state, 0, 0, image_path);
+
+  assert(((void) "Finds value without copying", d4_mapimage_strMSstrME_lookup(i1, key1, &v1) && v1.is_static && d4_str_eq(v1, val1)));
+  assert(((void) "Value is null-terminated", v1.data[v1.len] == L'\0'));
+  assert(((void) "Finds empty string", d4_mapimage_strMSstrME_lookup(i1, key2, &v2) && v2.len == 0));
+  assert(((void) "Doesn't find missing key", !d4_mapimage_strMSstrME_lookup(i1, val1, &v2)));
+
+  d4_mapimage_strMSstrME_free(i1);
+  d4_map_strMSstrME_free(m1);
+  d4_str_free(key1);
+  d4_str_free(key2);
+  d4_str_free(val1);
+  remove("mapimage-test.bin");
+}
+
+static void test_mapimage_open (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(1, 1, 10);
+  d4_str_t path = d4_str_alloc(L"mapimage-missing.bin");
+  FILE *file;
+
+  ASSERT_THROW_WITH_MESSAGE(OPEN1, {
+    d4_mapimage_intMSintME_open(&d4_err_state, 0, 0, path);
+  }, L"failed to open map image 'mapimage-missing.bin'");
+
+  file = fopen("mapimage-test.bin", "wb");
+  fputs("not a map image, but long enough to contain header", file);
+  fclose(file);
+
+  ASSERT_THROW_WITH_MESSAGE(OPEN2, {
+    d4_mapimage_intMSintME_open(&d4_err_state, 0, 0, image_path);
+  }, L"invalid map image 'mapimage-test.bin'");
+
+  d4_mapimage_intMSintME_write(&d4_err_state, 0, 0, m1, image_path);
+  image_patch(8, SEEK_SET, 2);
+
+  ASSERT_THROW_WITH_MESSAGE(OPEN3, {
+    d4_mapimage_intMSintME_open(&d4_err_state, 0, 0, image_path);
+  }, L"unsupported version of map image 'mapimage-test.bin'");
+
+  d4_map_intMSintME_free(m1);
+  d4_str_free(path);
+  remove("mapimage-test.bin");
+}
+
+static void test_mapimage_verify (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(2, 1, 10, 2, 20);
+  d4_map_intMSintME_t m2 = d4_map_intMSintME_alloc(1, 1, 10);
+  d4_mapimage_intMSintME_t i1;
+  d4_mapimage_intMSintME_t i2;
+  d4_mapimage_intMSintME_t i3;
+  uint64_t records_start;
+
+  d4_mapimage_intMSintME_write(&d4_err_state, 0, 0, m1, image_path);
+  i1 = d4_mapimage_intMSintME_open(&d4_err_state, 0, 0, image_path);
+  assert(((void) "Verifies intact image", d4_mapimage_intMSintME_verify(i1)));
+  d4_mapimage_intMSintME_free(i1);
+
+  image_patch(-1, SEEK_END, 0xFF);
+
+  i2 = d4_mapimage_intMSintME_open(&d4_err_state, 0, 0, image_path);
+  assert(((void) "Detects corrupted image", !d4_mapimage_intMSintME_verify(i2)));
+  d4_mapimage_intMSintME_free(i2);
+
+  d4_mapimage_intMSintME_write(&d4_err_state, 0, 0, m2, image_path);
+  records_start = image_records_start();
+  image_patch_u64((long) records_start, 0);
+  image_patch_u64((long) records_start + 8, records_start);
+
+  i3 = d4_mapimage_intMSintME_open(&d4_err_state, 0, 0, image_path);
+  assert(((void) "Stops at looping chain of corrupted image", !d4_mapimage_intMSintME_has(i3, 1)));
+  assert(((void) "Detects looping chain", !d4_mapimage_intMSintME_verify(i3)));
+  d4_mapimage_intMSintME_free(i3);
+
+  d4_map_intMSintME_free(m1);
+  d4_map_intMSintME_free(m2);
+  remove("mapimage-test.bin");
+}
+
+static void test_mapimage_write (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_str_t path = d4_str_alloc(L"mapimage-missing/mapimage-test.bin");
+  d4_mapimage_intMSintME_t i1;
+
+  d4_mapimage_intMSintME_write(&d4_err_state, 0, 0, m1, image_path);
+  i1 = d4_mapimage_intMSintME_open(&d4_err_state, 0, 0, image_path);
+  assert(((void) "Writes empty map", i1.len == 0 && !d4_mapimage_intMSintME_has(i1, 0) && d4_mapimage_intMSintME_verify(i1)));
+  d4_mapimage_intMSintME_free(i1);
+
+  ASSERT_THROW_WITH_MESSAGE(WRITE1, {
+    d4_mapimage_intMSintME_write(&d4_err_state, 0, 0, m1, path);
+  }, L"failed to write map image 'mapimage-missing/mapimage-test.bin'");
+
+  d4_map_intMSintME_free(m1);
+  d4_str_free(path);
+  remove("mapimage-test.bin");
+}
+
+int main (void) {
+  test_mapimage_get();
+  test_mapimage_has();
+  test_mapimage_lookup();
+  test_mapimage_open();
+  test_mapimage_verify();
+  test_mapimage_write();
+}
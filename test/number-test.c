@@ -75,6 +75,30 @@ static void test_float_str (void) {
   d4_str_free(a3);
 }
 
+static void test_float_str_printf (void) {
+  double values[] = {
+    -0.0, 1.0, -1.5, 0.1, 0.30000000000000004, 2.5, 9.5, 0.5, 1e-4, 1e-5, 0.000123456789, 123456.789,
+    999999.5, 9999995.0, 1e15, 1e16, 9999999999999999.0, 123456789012345678.0, 1e22, 1e23, 1e100, 1e-100,
+    1.7976931348623157e308, 2.2250738585072014e-308, 5e-324, M_E, -M_PI, 1.0 / 3.0, 2.0 / 3.0, 100.0 / 7.0
+  };
+
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    d4_str_t a1 = d4_f64_str(values[i]);
+    d4_str_t a2 = d4_f32_str((float) values[i]);
+    d4_str_t s1_cmp = d4_str_alloc(L"%.16g", values[i]);
+    d4_str_t s2_cmp = d4_str_alloc(L"%g", (double) (float) values[i]);
+
+    assert(((void) "Stringifies f64 same as printf", d4_str_eq(a1, s1_cmp)));
+    assert(((void) "Stringifies f32 same as printf", d4_str_eq(a2, s2_cmp)));
+
+    d4_str_free(s1_cmp);
+    d4_str_free(s2_cmp);
+
+    d4_str_free(a1);
+    d4_str_free(a2);
+  }
+}
+
 static void test_i8_str (void) {
   d4_str_t a1 = d4_i8_str(INT8_MIN);
   d4_str_t a2 = d4_i8_str(0);
@@ -296,6 +320,7 @@ int main (void) {
   test_f32_str();
   test_f64_str();
   test_float_str();
+  test_float_str_printf();
   test_i8_str();
   test_i16_str();
   test_i32_str();
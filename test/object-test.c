@@ -45,7 +45,7 @@ D4_OBJECT_DEFINE(Test0, Test0, {
 }, {
   d4_str_free(self.prop);
 }, {
-  result = d4_obj_str_append(result, d4_str_alloc(L"prop"), d4_str_quoted_escape(self.prop));
+  d4_obj_str_append(&buf, d4_str_alloc(L"prop"), d4_str_quoted_escape(self.prop));
 }, const d4_str_t prop)
 
 D4_OBJECT_DEFINE(Test, Test, {
@@ -59,8 +59,8 @@ D4_OBJECT_DEFINE(Test, Test, {
 }, {
   d4_str_free(self.prop1);
 }, {
-  result = d4_obj_str_append(result, d4_str_alloc(L"prop1"), d4_str_quoted_escape(self.prop1));
-  result = d4_obj_str_append(result, d4_str_alloc(L"prop2"), d4_i32_str(self.prop2));
+  d4_obj_str_append(&buf, d4_str_alloc(L"prop1"), d4_str_quoted_escape(self.prop1));
+  d4_obj_str_append(&buf, d4_str_alloc(L"prop2"), d4_i32_str(self.prop2));
 }, const d4_str_t prop1, const int32_t prop2)
 
 static void test_object_alloc (void) {
@@ -185,20 +185,30 @@ static void test_object_str_append (void) {
   d4_str_t value2 = d4_str_alloc(L"\"string\"");
   d4_str_t value3 = d4_str_alloc(L"true");
 
-  d4_str_t r = d4_str_alloc(L"");
+  d4_strbuf_t b1 = d4_strbuf_alloc(0);
+  d4_strbuf_t b2 = d4_strbuf_alloc(0);
+  d4_str_t r1;
+  d4_str_t r2;
 
   d4_str_t cmp1 = d4_str_alloc(L"name1: 123");
   d4_str_t cmp2 = d4_str_alloc(L"name1: 123, name2: \"string\"");
   d4_str_t cmp3 = d4_str_alloc(L"name1: 123, name2: \"string\", name3: true");
 
-  r = d4_obj_str_append(r, name1, value1);
-  assert(((void) "Appends first field to object str", d4_str_eq(r, cmp1)));
-  r = d4_obj_str_append(r, name2, value2);
-  assert(((void) "Appends second field to object str", d4_str_eq(r, cmp2)));
-  r = d4_obj_str_append(r, name3, value3);
-  assert(((void) "Appends third field to object str", d4_str_eq(r, cmp3)));
+  d4_obj_str_append(&b1, name1, value1);
+  assert(((void) "Appends first field to object str", d4_str_eq((d4_str_t) {b1.data, b1.len, true}, cmp1)));
+  d4_obj_str_append(&b1, name2, value2);
+  assert(((void) "Appends second field to object str", d4_str_eq((d4_str_t) {b1.data, b1.len, true}, cmp2)));
+  d4_obj_str_append(&b1, name3, value3);
+  r1 = d4_strbuf_finish(&b1);
+  assert(((void) "Appends third field to object str", d4_str_eq(r1, cmp3)));
 
-  d4_str_free(r);
+  d4_strbuf_appendChar(&b2, L'{');
+  d4_obj_str_append(&b2, d4_str_alloc(L"name"), d4_str_alloc(L"1"));
+  r2 = d4_strbuf_finish(&b2);
+  assert(((void) "Doesn't separate first field after opening brace", d4_str_eq(r2, (d4_str_t) {L"{name: 1", 8, true})));
+
+  d4_str_free(r1);
+  d4_str_free(r2);
 
   d4_str_free(cmp1);
   d4_str_free(cmp2);
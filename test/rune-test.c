@@ -104,18 +104,21 @@ static void test_rune_repeat (void) {
 static void test_rune_str (void) {
   d4_str_t a1 = d4_rune_str(L'A');
   d4_str_t a2 = d4_rune_str(L'9');
+  d4_str_t a3 = d4_rune_str(L'%');
 
   d4_str_t s1_cmp = d4_str_alloc(L"A");
   d4_str_t s2_cmp = d4_str_alloc(L"9");
 
   assert(((void) "Stringifies 'A'", d4_str_eq(a1, s1_cmp)));
   assert(((void) "Stringifies '9'", d4_str_eq(a2, s2_cmp)));
+  assert(((void) "Stringifies '%'", a3.len == 1 && a3.data[0] == L'%'));
 
   d4_str_free(s1_cmp);
   d4_str_free(s2_cmp);
 
   d4_str_free(a1);
   d4_str_free(a2);
+  d4_str_free(a3);
 }
 
 static void test_rune_upper (void) {
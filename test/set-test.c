@@ -0,0 +1,373 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include <assert.h>
+#include "../include/d4/number.h"
+#include "../include/d4/set.h"
+#include "utils.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_SET_DECLARE(int, int32_t)
+D4_SET_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element), d4_i32_str(element))
+
+D4_SET_DECLARE(str, d4_str_t)
+D4_SET_DEFINE_WITH_HASH(str, d4_str_t, d4_str_t, d4_str_copy(element), d4_str_eq(lhs_element, rhs_element), d4_str_free(element), d4_str_copy(element), d4_str_quoted_escape(element), d4_map_hash_seeded)
+
+static int32_t sum = 0;
+
+static void sum_func (D4_UNUSED void *ctx, void *params) {
+  d4_fn_esFP3intFP3intFRvoidFE_params_t *p = params;
+  sum += p->n0;
+}
+
+static void test_set_alloc (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(0);
+  d4_set_int_t s2 = d4_set_int_alloc(1, 1);
+  d4_set_int_t s3 = d4_set_int_alloc(3, 1, 2, 1);
+
+  assert(((void) "Creates set with zero elements", s1.len == 0 && s1.cap == 0x0F));
+  assert(((void) "Creates set with one element", s2.len == 1 && s2.cap == 0x0F));
+  assert(((void) "Creates set without repeated elements", s3.len == 2 && s3.cap == 0x0F));
+
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+  d4_set_int_free(s3);
+}
+
+static void test_set_add (void) {
+  d4_str_t val1 = d4_str_alloc(L"val1");
+  d4_str_t val2 = d4_str_alloc(L"val2");
+  d4_set_int_t s1 = d4_set_int_alloc(0);
+  d4_set_str_t s2 = d4_set_str_alloc(0);
+
+  d4_set_int_add(&s1, 1);
+  assert(((void) "Adds element to empty set", s1.len == 1 && d4_set_int_has(s1, 1)));
+  d4_set_int_add(&s1, 1);
+  assert(((void) "Doesn't add repeated element", s1.len == 1));
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_set_int_add(&s1, i);
+  }
+
+  assert(((void) "Adds many elements", s1.len == 1000 && s1.cap > 1000));
+
+  d4_set_str_add(&s2, val1);
+  d4_set_str_add(&s2, val2);
+  d4_set_str_add(&s2, val1);
+  assert(((void) "Adds string elements", s2.len == 2 && d4_set_str_has(s2, val1) && d4_set_str_has(s2, val2)));
+
+  d4_set_int_free(s1);
+  d4_set_str_free(s2);
+  d4_str_free(val1);
+  d4_str_free(val2);
+}
+
+static void test_set_clear (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(0);
+  d4_set_int_t s2 = d4_set_int_alloc(2, 1, 2);
+
+  d4_set_int_clear(&s1);
+  d4_set_int_clear(&s2);
+
+  assert(((void) "Clears set with zero elements", s1.len == 0));
+  assert(((void) "Clears set with two elements", s2.len == 0 && !d4_set_int_has(s2, 1) && s2.cap == 0x0F));
+
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+}
+
+static void test_set_copy (void) {
+  d4_str_t val = d4_str_alloc(L"val");
+  d4_set_int_t s1 = d4_set_int_alloc(0);
+  d4_set_int_t s2 = d4_set_int_alloc(3, 1, 2, 3);
+  d4_set_str_t s3 = d4_set_str_alloc(1, val);
+
+  d4_set_int_t s4 = d4_set_int_copy(s1);
+  d4_set_int_t s5 = d4_set_int_copy(s2);
+  d4_set_str_t s6 = d4_set_str_copy(s3);
+
+  assert(((void) "Copies set with zero elements", d4_set_int_eq(s1, s4)));
+  assert(((void) "Copies set with three elements", d4_set_int_eq(s2, s5)));
+  assert(((void) "Copies set with string elements", d4_set_str_eq(s3, s6)));
+
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+  d4_set_str_free(s3);
+  d4_set_int_free(s4);
+  d4_set_int_free(s5);
+  d4_set_str_free(s6);
+  d4_str_free(val);
+}
+
+static void test_set_difference (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(3, 1, 2, 3);
+  d4_set_int_t s2 = d4_set_int_alloc(5, 2, 3, 4, 5, 6);
+  d4_set_int_t s3 = d4_set_int_alloc(1, 2);
+  d4_set_int_t s4 = d4_set_int_alloc(0);
+
+  d4_set_int_t r1 = d4_set_int_difference(s1, s2);
+  d4_set_int_t r2 = d4_set_int_difference(s1, s3);
+  d4_set_int_t r3 = d4_set_int_difference(s1, s4);
+  d4_set_int_t r4 = d4_set_int_difference(s4, s1);
+  d4_set_int_t e1 = d4_set_int_alloc(1, 1);
+  d4_set_int_t e2 = d4_set_int_alloc(2, 1, 3);
+
+  assert(((void) "Difference with larger set", d4_set_int_eq(r1, e1)));
+  assert(((void) "Difference with smaller set", d4_set_int_eq(r2, e2)));
+  assert(((void) "Difference with empty set", d4_set_int_eq(r3, s1)));
+  assert(((void) "Difference of empty set", r4.len == 0));
+
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+  d4_set_int_free(s3);
+  d4_set_int_free(s4);
+  d4_set_int_free(r1);
+  d4_set_int_free(r2);
+  d4_set_int_free(r3);
+  d4_set_int_free(r4);
+  d4_set_int_free(e1);
+  d4_set_int_free(e2);
+}
+
+static void test_set_empty (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(0);
+  d4_set_int_t s2 = d4_set_int_alloc(1, 1);
+
+  assert(((void) "Set with zero elements is empty", d4_set_int_empty(s1)));
+  assert(((void) "Set with one element is not empty", !d4_set_int_empty(s2)));
+
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+}
+
+static void test_set_eq (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(0);
+  d4_set_int_t s2 = d4_set_int_alloc(2, 1, 2);
+  d4_set_int_t s3 = d4_set_int_alloc(2, 2, 1);
+  d4_set_int_t s4 = d4_set_int_alloc(2, 1, 3);
+
+  d4_set_int_reserve(&s3, 1000);
+
+  assert(((void) "Empty sets are equal", d4_set_int_eq(s1, s1)));
+  assert(((void) "Sets with different capacity are equal", d4_set_int_eq(s2, s3)));
+  assert(((void) "Sets with different elements are not equal", !d4_set_int_eq(s2, s4)));
+  assert(((void) "Sets with different length are not equal", !d4_set_int_eq(s1, s2)));
+
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+  d4_set_int_free(s3);
+  d4_set_int_free(s4);
+}
+
+static void test_set_forEach (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(3, 1, 2, 3);
+  d4_fn_esFP3intFP3intFRvoidFE_t iterator = (d4_fn_esFP3intFP3intFRvoidFE_t) {(d4_str_t) {L"sum", 3, true}, NULL, NULL, NULL, sum_func};
+
+  sum = 0;
+  d4_set_int_forEach(&d4_err_state, 0, 0, s1, iterator);
+  assert(((void) "Iterates over every element", sum == 6));
+
+  d4_set_int_free(s1);
+}
+
+static void test_set_has (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(0);
+  d4_set_int_t s2 = d4_set_int_alloc(2, 1, 2);
+
+  assert(((void) "Has no element in empty set", !d4_set_int_has(s1, 1)));
+  assert(((void) "Has first element", d4_set_int_has(s2, 1)));
+  assert(((void) "Has second element", d4_set_int_has(s2, 2)));
+  assert(((void) "Has no missing element", !d4_set_int_has(s2, 3)));
+
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+}
+
+static void test_set_intersection (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(3, 1, 2, 3);
+  d4_set_int_t s2 = d4_set_int_alloc(5, 2, 3, 4, 5, 6);
+  d4_set_int_t s3 = d4_set_int_alloc(0);
+
+  d4_set_int_t r1 = d4_set_int_intersection(s1, s2);
+  d4_set_int_t r2 = d4_set_int_intersection(s2, s1);
+  d4_set_int_t r3 = d4_set_int_intersection(s1, s3);
+  d4_set_int_t e1 = d4_set_int_alloc(2, 2, 3);
+
+  assert(((void) "Intersects with larger set", d4_set_int_eq(r1, e1)));
+  assert(((void) "Intersects with smaller set", d4_set_int_eq(r2, e1)));
+  assert(((void) "Intersects with empty set", r3.len == 0));
+
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+  d4_set_int_free(s3);
+  d4_set_int_free(r1);
+  d4_set_int_free(r2);
+  d4_set_int_free(r3);
+  d4_set_int_free(e1);
+}
+
+static void test_set_isSubset (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(0);
+  d4_set_int_t s2 = d4_set_int_alloc(2, 2, 3);
+  d4_set_int_t s3 = d4_set_int_alloc(3, 1, 2, 3);
+  d4_set_int_t s4 = d4_set_int_alloc(3, 1, 2, 4);
+
+  assert(((void) "Empty set is subset", d4_set_int_isSubset(s1, s2)));
+  assert(((void) "Set is subset of itself", d4_set_int_isSubset(s2, s2)));
+  assert(((void) "Set is subset of larger set", d4_set_int_isSubset(s2, s3)));
+  assert(((void) "Larger set is not subset", !d4_set_int_isSubset(s3, s2)));
+  assert(((void) "Set with missing element is not subset", !d4_set_int_isSubset(s2, s4)));
+
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+  d4_set_int_free(s3);
+  d4_set_int_free(s4);
+}
+
+static void test_set_realloc (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(0);
+  d4_set_int_t s2 = d4_set_int_alloc(2, 1, 2);
+
+  s1 = d4_set_int_realloc(s1, s2);
+  assert(((void) "Re-allocates set", d4_set_int_eq(s1, s2)));
+
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+}
+
+static void test_set_remove (void) {
+  d4_str_t val = d4_str_alloc(L"val");
+  d4_str_t val2 = d4_str_alloc(L"val2");
+  d4_set_int_t s1 = d4_set_int_alloc(2, 1, 2);
+  d4_set_str_t s2 = d4_set_str_alloc(1, val);
+
+  ASSERT_NO_THROW(REMOVE1, {
+    d4_set_int_remove(&d4_err_state, 0, 0, &s1, 1);
+    assert(((void) "Removes element", s1.len == 1 && !d4_set_int_has(s1, 1)));
+    d4_set_str_remove(&d4_err_state, 0, 0, &s2, val);
+    assert(((void) "Removes string element", s2.len == 0));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(REMOVE2, {
+    d4_set_int_remove(&d4_err_state, 0, 0, &s1, 1);
+  }, L"failed to remove element '1'");
+
+  ASSERT_THROW_WITH_MESSAGE(REMOVE3, {
+    d4_set_str_remove(&d4_err_state, 0, 0, &s2, val2);
+  }, L"failed to remove element 'val2'");
+
+  d4_set_int_free(s1);
+  d4_set_str_free(s2);
+  d4_str_free(val);
+  d4_str_free(val2);
+}
+
+static void test_set_reserve (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(2, 1, 2);
+
+  d4_set_int_reserve(&s1, 1000);
+  assert(((void) "Reserves capacity", s1.cap == 1000 && s1.len == 2));
+  assert(((void) "Keeps elements after reserve", d4_set_int_has(s1, 1) && d4_set_int_has(s1, 2)));
+
+  d4_set_int_free(s1);
+}
+
+static void test_set_shrink (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(2, 1, 2);
+
+  d4_set_int_reserve(&s1, 1000);
+  d4_set_int_shrink(&s1);
+  assert(((void) "Shrinks capacity", s1.cap == 0x0F && s1.len == 2));
+  assert(((void) "Keeps elements after shrink", d4_set_int_has(s1, 1) && d4_set_int_has(s1, 2)));
+
+  d4_set_int_free(s1);
+}
+
+static void test_set_str (void) {
+  d4_str_t val = d4_str_alloc(L"val");
+  d4_set_int_t s1 = d4_set_int_alloc(0);
+  d4_set_int_t s2 = d4_set_int_alloc(1, 1);
+  d4_set_str_t s3 = d4_set_str_alloc(1, val);
+
+  d4_str_t r1 = d4_set_int_str(s1);
+  d4_str_t r2 = d4_set_int_str(s2);
+  d4_str_t r3 = d4_set_str_str(s3);
+
+  assert(((void) "Stringifies empty set", wcscmp(r1.data, L"{}") == 0));
+  assert(((void) "Stringifies set with one element", wcscmp(r2.data, L"{1}") == 0));
+  assert(((void) "Stringifies set with string element", wcscmp(r3.data, L"{\"val\"}") == 0));
+
+  d4_str_free(r1);
+  d4_str_free(r2);
+  d4_str_free(r3);
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+  d4_set_str_free(s3);
+  d4_str_free(val);
+}
+
+static void test_set_union (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(3, 1, 2, 3);
+  d4_set_int_t s2 = d4_set_int_alloc(5, 2, 3, 4, 5, 6);
+  d4_set_int_t s3 = d4_set_int_alloc(0);
+
+  d4_set_int_t r1 = d4_set_int_union(s1, s2);
+  d4_set_int_t r2 = d4_set_int_union(s2, s1);
+  d4_set_int_t r3 = d4_set_int_union(s1, s3);
+  d4_set_int_t e1 = d4_set_int_alloc(6, 1, 2, 3, 4, 5, 6);
+
+  assert(((void) "Unites with larger set", d4_set_int_eq(r1, e1)));
+  assert(((void) "Unites with smaller set", d4_set_int_eq(r2, e1)));
+  assert(((void) "Unites with empty set", d4_set_int_eq(r3, s1)));
+
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+  d4_set_int_free(s3);
+  d4_set_int_free(r1);
+  d4_set_int_free(r2);
+  d4_set_int_free(r3);
+  d4_set_int_free(e1);
+}
+
+static void test_set_values (void) {
+  d4_set_int_t s1 = d4_set_int_alloc(0);
+  d4_set_int_t s2 = d4_set_int_alloc(2, 1, 2);
+
+  d4_arr_int_t values1 = d4_set_int_values(s1);
+  d4_arr_int_t values2 = d4_set_int_values(s2);
+
+  assert(((void) "Set with zero elements returns zero values", values1.len == 0));
+  assert(((void) "Set with two elements returns two values", values2.len == 2));
+  assert(((void) "Set returns correct values", values2.data[0] + values2.data[1] == 3));
+
+  d4_arr_int_free(values1);
+  d4_arr_int_free(values2);
+  d4_set_int_free(s1);
+  d4_set_int_free(s2);
+}
+
+int main (void) {
+  test_set_alloc();
+  test_set_add();
+  test_set_clear();
+  test_set_copy();
+  test_set_difference();
+  test_set_empty();
+  test_set_eq();
+  test_set_forEach();
+  test_set_has();
+  test_set_intersection();
+  test_set_isSubset();
+  test_set_realloc();
+  test_set_remove();
+  test_set_reserve();
+  test_set_shrink();
+  test_set_str();
+  test_set_union();
+  test_set_values();
+}
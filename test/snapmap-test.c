@@ -0,0 +1,234 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include <assert.h>
+#include "../include/d4/error.h"
+#include "../include/d4/number.h"
+#include "../include/d4/snapmap.h"
+#include "utils.h"
+
+#if defined(D4_OS_WINDOWS)
+  #include <windows.h>
+#else
+  #include <pthread.h>
+#endif
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_MAP_DECLARE(int, int32_t, int, int32_t)
+D4_MAP_DEFINE(int, int32_t, int, key, lhs_key == rhs_key, (void) key, d4_i32_str(key), d4_i32_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+D4_MAP_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_MAP_DEFINE(str, d4_str_t, d4_str_t, d4_str_copy(key), d4_str_eq(lhs_key, rhs_key), d4_str_free(key), d4_str_copy(key), d4_str_copy(key), str, d4_str_t, d4_str_t, d4_str_copy(val), d4_str_eq(lhs_val, rhs_val), d4_str_free(val), d4_str_quoted_escape(val))
+
+D4_SNAPMAP_DECLARE(int, int32_t, int, int32_t)
+D4_SNAPMAP_DEFINE(int, int32_t, d4_i32_str(key), int, int32_t)
+
+D4_SNAPMAP_DECLARE(str, d4_str_t, str, d4_str_t)
+D4_SNAPMAP_DEFINE(str, d4_str_t, d4_str_copy(key), str, d4_str_t)
+
+#define READERS_COUNT 4
+#define WRITES_COUNT 500
+
+static volatile bool readers_stop = false;
+static volatile bool readers_failed = false;
+
+static void reader_loop (d4_snapmap_intMSintME_t *sm) {
+  while (!readers_stop) {
+    d4_snapmap_intMSintME_snapshot_t snapshot = d4_snapmap_intMSintME_acquire(*sm);
+    int32_t version = d4_map_intMSintME_get(&d4_err_state, 0, 0, *snapshot.map, 0);
+
+    // Every version holds keys 0..version with values equal to the version, so a torn or freed read is detected.
+    if ((int32_t) snapshot.map->len != version + 1) readers_failed = true;
+    if (d4_map_intMSintME_get(&d4_err_state, 0, 0, *snapshot.map, version) != version) readers_failed = true;
+
+    d4_snapmap_intMSintME_release(*sm, snapshot);
+  }
+}
+
+#if defined(D4_OS_WINDOWS)
+  static DWORD WINAPI reader_func (LPVOID arg) {
+    reader_loop(arg);
+    return 0;
+  }
+#else
+  static void *reader_func (void *arg) {
+    reader_loop(arg);
+    return NULL;
+  }
+#endif
+
+static void test_snapmap_alloc (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(2, 1, 10, 2, 20);
+  d4_snapmap_intMSintME_t sm1 = d4_snapmap_intMSintME_alloc(m1);
+  d4_map_intMSintME_t m2;
+
+  d4_map_intMSintME_set(&m1, 3, 30);
+  m2 = d4_snapmap_intMSintME_load(sm1);
+
+  assert(((void) "Copies map into the first version", m2.len == 2 && !d4_map_intMSintME_has(m2, 3)));
+
+  d4_map_intMSintME_free(m1);
+  d4_map_intMSintME_free(m2);
+  d4_snapmap_intMSintME_free(sm1);
+}
+
+static void test_snapmap_get (void) {
+  d4_str_t key = d4_str_alloc(L"route");
+  d4_str_t val = d4_str_alloc(L"/index");
+  d4_map_strMSstrME_t m1 = d4_map_strMSstrME_alloc(1, key, val);
+  d4_snapmap_strMSstrME_t sm1 = d4_snapmap_strMSstrME_alloc(m1);
+
+  ASSERT_NO_THROW(GET1, {
+    d4_str_t v1 = d4_snapmap_strMSstrME_get(&d4_err_state, 0, 0, sm1, key);
+    assert(((void) "Gets value of the current version", d4_str_eq(v1, val)));
+    d4_str_free(v1);
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(GET2, {
+    d4_snapmap_strMSstrME_get(&d4_err_state, 0, 0, sm1, val);
+  }, L"failed to find key '/index'");
+
+  assert(((void) "Releases snapshot when throwing", d4_snapmap_pending(sm1.core) == 0));
+
+  d4_map_strMSstrME_free(m1);
+  d4_snapmap_strMSstrME_free(sm1);
+
+  d4_str_free(key);
+  d4_str_free(val);
+}
+
+static void test_snapmap_has (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(1, 1, 10);
+  d4_snapmap_intMSintME_t sm1 = d4_snapmap_intMSintME_alloc(m1);
+
+  assert(((void) "Has key of the current version", d4_snapmap_intMSintME_has(sm1, 1)));
+  assert(((void) "Has no missing key", !d4_snapmap_intMSintME_has(sm1, 2)));
+
+  d4_map_intMSintME_free(m1);
+  d4_snapmap_intMSintME_free(sm1);
+}
+
+static void test_snapmap_remove (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(2, 1, 10, 2, 20);
+  d4_snapmap_intMSintME_t sm1 = d4_snapmap_intMSintME_alloc(m1);
+
+  ASSERT_NO_THROW(REMOVE1, {
+    d4_snapmap_intMSintME_remove(&d4_err_state, 0, 0, &sm1, 1);
+  });
+
+  assert(((void) "Publishes version without key", !d4_snapmap_intMSintME_has(sm1, 1) && d4_snapmap_intMSintME_has(sm1, 2)));
+
+  ASSERT_THROW_WITH_MESSAGE(REMOVE2, {
+    d4_snapmap_intMSintME_remove(&d4_err_state, 0, 0, &sm1, 1);
+  }, L"failed to remove key '1'");
+
+  d4_snapmap_intMSintME_set(&sm1, 3, 30);
+  assert(((void) "Unlocks writer when throwing", d4_snapmap_intMSintME_has(sm1, 3)));
+
+  d4_map_intMSintME_free(m1);
+  d4_snapmap_intMSintME_free(sm1);
+}
+
+static void test_snapmap_set (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(0);
+  d4_snapmap_intMSintME_t sm1 = d4_snapmap_intMSintME_alloc(m1);
+  d4_snapmap_intMSintME_snapshot_t s1 = d4_snapmap_intMSintME_acquire(sm1);
+  d4_snapmap_intMSintME_snapshot_t s2;
+
+  d4_snapmap_intMSintME_set(&sm1, 1, 10);
+  s2 = d4_snapmap_intMSintME_acquire(sm1);
+  d4_snapmap_intMSintME_set(&sm1, 1, 11);
+
+  assert(((void) "Snapshot keeps version it was taken of", s1.map->len == 0));
+  assert(((void) "Later snapshot sees published version", s2.map->len == 1 && d4_map_intMSintME_get(&d4_err_state, 0, 0, *s2.map, 1) == 10));
+  assert(((void) "Readers see the latest version", d4_snapmap_intMSintME_get(&d4_err_state, 0, 0, sm1, 1) == 11));
+  assert(((void) "Keeps versions protected by snapshots", d4_snapmap_pending(sm1.core) == 2));
+
+  d4_snapmap_intMSintME_release(sm1, s1);
+  assert(((void) "Reclaims version after release", d4_snapmap_pending(sm1.core) == 1));
+
+  d4_snapmap_intMSintME_release(sm1, s2);
+  assert(((void) "Reclaims all versions after release", d4_snapmap_pending(sm1.core) == 0));
+
+  d4_map_intMSintME_free(m1);
+  d4_snapmap_intMSintME_free(sm1);
+}
+
+static void test_snapmap_store (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(1, 1, 10);
+  d4_snapmap_intMSintME_t sm1 = d4_snapmap_intMSintME_alloc(m1);
+  d4_map_intMSintME_t m2 = d4_snapmap_intMSintME_load(sm1);
+
+  for (int32_t i = 2; i < 100; i++) {
+    d4_map_intMSintME_set(&m2, i, i * 10);
+  }
+
+  d4_snapmap_intMSintME_store(&sm1, m2);
+
+  assert(((void) "Publishes many changes at once", d4_snapmap_intMSintME_has(sm1, 1) && d4_snapmap_intMSintME_has(sm1, 99)));
+  assert(((void) "Reclaims previous version", d4_snapmap_pending(sm1.core) == 0));
+
+  d4_map_intMSintME_free(m1);
+  d4_snapmap_intMSintME_free(sm1);
+}
+
+static void test_snapmap_threads (void) {
+  d4_map_intMSintME_t m1 = d4_map_intMSintME_alloc(1, 0, 0);
+  d4_snapmap_intMSintME_t sm1 = d4_snapmap_intMSintME_alloc(m1);
+
+  #if defined(D4_OS_WINDOWS)
+    HANDLE readers[READERS_COUNT];
+  #else
+    pthread_t readers[READERS_COUNT];
+  #endif
+
+  for (size_t i = 0; i < READERS_COUNT; i++) {
+    #if defined(D4_OS_WINDOWS)
+      readers[i] = CreateThread(NULL, 0, reader_func, &sm1, 0, NULL);
+    #else
+      pthread_create(&readers[i], NULL, reader_func, &sm1);
+    #endif
+  }
+
+  for (int32_t i = 1; i < WRITES_COUNT; i++) {
+    d4_map_intMSintME_t m2 = d4_snapmap_intMSintME_load(sm1);
+
+    for (int32_t j = 0; j <= i; j++) {
+      d4_map_intMSintME_set(&m2, j, i);
+    }
+
+    d4_snapmap_intMSintME_store(&sm1, m2);
+  }
+
+  readers_stop = true;
+
+  for (size_t i = 0; i < READERS_COUNT; i++) {
+    #if defined(D4_OS_WINDOWS)
+      WaitForSingleObject(readers[i], INFINITE);
+      CloseHandle(readers[i]);
+    #else
+      pthread_join(readers[i], NULL);
+    #endif
+  }
+
+  assert(((void) "Readers see consistent versions", !readers_failed));
+  assert(((void) "Reclaims all versions after readers finish", d4_snapmap_pending(sm1.core) == 0));
+
+  d4_map_intMSintME_free(m1);
+  d4_snapmap_intMSintME_free(sm1);
+}
+
+int main (void) {
+  test_snapmap_alloc();
+  test_snapmap_get();
+  test_snapmap_has();
+  test_snapmap_remove();
+  test_snapmap_set();
+  test_snapmap_store();
+  test_snapmap_threads();
+}
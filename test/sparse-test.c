@@ -0,0 +1,335 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include <assert.h>
+#include "../include/d4/error.h"
+#include "../include/d4/number.h"
+#include "../include/d4/sparse.h"
+#include "utils.h"
+
+D4_ARRAY_DECLARE(int, int32_t)
+D4_ARRAY_DEFINE(int, int32_t, int, element, lhs_element == rhs_element, (void) element, d4_i32_str(element))
+
+D4_ARRAY_DECLARE(u8, uint8_t)
+D4_ARRAY_DEFINE(u8, uint8_t, int, element, lhs_element == rhs_element, (void) element, d4_u8_str(element))
+
+D4_SPARSE_DECLARE(int, int32_t, int, int32_t)
+D4_SPARSE_DEFINE(int, int32_t, int, d4_i32_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+D4_SPARSE_DECLARE(int, int32_t, str, d4_str_t)
+D4_SPARSE_DEFINE(int, int32_t, int, d4_i32_str(key), str, d4_str_t, d4_str_t, d4_str_copy(val), d4_str_eq(lhs_val, rhs_val), d4_str_free(val), d4_str_quoted_escape(val))
+
+D4_ARRAY_DECLARE(u64, uint64_t)
+D4_ARRAY_DEFINE(u64, uint64_t, uint64_t, element, lhs_element == rhs_element, (void) element, d4_u64_str(element))
+
+D4_SPARSE_DECLARE(u8, uint8_t, int, int32_t)
+D4_SPARSE_DEFINE(u8, uint8_t, int, d4_u8_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+D4_SPARSE_DECLARE(u64, uint64_t, int, int32_t)
+D4_SPARSE_DEFINE(u64, uint64_t, uint64_t, d4_u64_str(key), int, int32_t, int, val, lhs_val == rhs_val, (void) val, d4_i32_str(val))
+
+static void test_sparse_alloc (void) {
+  d4_str_t val1 = d4_str_alloc(L"val1");
+  d4_str_t val2 = d4_str_alloc(L"val2");
+
+  d4_sparse_intMSstrME_t s1 = d4_sparse_intMSstrME_alloc(&d4_err_state, 0, 0, 0);
+  d4_sparse_intMSstrME_t s2 = d4_sparse_intMSstrME_alloc(&d4_err_state, 0, 0, 1, 1, val1);
+  d4_sparse_intMSstrME_t s3 = d4_sparse_intMSstrME_alloc(&d4_err_state, 0, 0, 3, 2, val1, 3, val2, 2, val2);
+
+  assert(((void) "Creates sparse set with zero pairs", s1.len == 0 && s1.cap == 0 && s1.range == 0));
+  assert(((void) "Creates sparse set with one pair", s2.len == 1 && s2.cap == 1));
+  assert(((void) "Creates sparse set with repeated key once", s3.len == 2 && s3.cap == 3));
+
+  d4_sparse_intMSstrME_free(s1);
+  d4_sparse_intMSstrME_free(s2);
+  d4_sparse_intMSstrME_free(s3);
+
+  d4_str_free(val1);
+  d4_str_free(val2);
+}
+
+static void test_sparse_clear (void) {
+  d4_sparse_intMSintME_t s1 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 2, 1, 10, 2, 20);
+  size_t range = s1.range;
+
+  d4_sparse_intMSintME_clear(&s1);
+  assert(((void) "Clears sparse set", s1.len == 0 && s1.range == range));
+  assert(((void) "Cleared sparse set has no pairs", !d4_sparse_intMSintME_has(s1, 1) && !d4_sparse_intMSintME_has(s1, 2)));
+
+  d4_sparse_intMSintME_set(&d4_err_state, 0, 0, &s1, 2, 30);
+  assert(((void) "Cleared sparse set is reusable", s1.len == 1 && d4_sparse_intMSintME_has(s1, 2)));
+
+  d4_sparse_intMSintME_free(s1);
+}
+
+static void test_sparse_copy (void) {
+  d4_str_t val = d4_str_alloc(L"val");
+
+  d4_sparse_intMSstrME_t s1 = d4_sparse_intMSstrME_alloc(&d4_err_state, 0, 0, 0);
+  d4_sparse_intMSstrME_t s2 = d4_sparse_intMSstrME_alloc(&d4_err_state, 0, 0, 2, 2, val, 3, val);
+
+  d4_sparse_intMSstrME_t s3 = d4_sparse_intMSstrME_copy(s1);
+  d4_sparse_intMSstrME_t s4 = d4_sparse_intMSstrME_copy(s2);
+
+  assert(((void) "Copies sparse set with zero pairs", d4_sparse_intMSstrME_eq(s1, s3)));
+  assert(((void) "Copies sparse set with two pairs", d4_sparse_intMSstrME_eq(s2, s4)));
+
+  s3 = d4_sparse_intMSstrME_realloc(s3, s2);
+  assert(((void) "Reallocates sparse set", d4_sparse_intMSstrME_eq(s2, s3)));
+
+  d4_sparse_intMSstrME_free(s1);
+  d4_sparse_intMSstrME_free(s2);
+  d4_sparse_intMSstrME_free(s3);
+  d4_sparse_intMSstrME_free(s4);
+
+  d4_str_free(val);
+}
+
+static void test_sparse_empty (void) {
+  d4_sparse_intMSintME_t s1 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 0);
+  d4_sparse_intMSintME_t s2 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 1, 1, 10);
+
+  assert(((void) "Sparse set with zero pairs is empty", d4_sparse_intMSintME_empty(s1)));
+  assert(((void) "Sparse set with one pair is not empty", !d4_sparse_intMSintME_empty(s2)));
+
+  d4_sparse_intMSintME_free(s1);
+  d4_sparse_intMSintME_free(s2);
+}
+
+static void test_sparse_eq (void) {
+  d4_sparse_intMSintME_t s1 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 2, 1, 10, 2, 20);
+  d4_sparse_intMSintME_t s2 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 2, 2, 20, 1, 10);
+  d4_sparse_intMSintME_t s3 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 2, 1, 10, 2, 21);
+  d4_sparse_intMSintME_t s4 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 2, 1, 10, 300, 20);
+
+  assert(((void) "Sparse sets with same pairs in different order are equal", d4_sparse_intMSintME_eq(s1, s2)));
+  assert(((void) "Sparse sets with different values are not equal", !d4_sparse_intMSintME_eq(s1, s3)));
+  assert(((void) "Sparse sets with different keys are not equal", !d4_sparse_intMSintME_eq(s1, s4)));
+  assert(((void) "Sparse sets with different keys are not equal in reverse", !d4_sparse_intMSintME_eq(s4, s1)));
+
+  d4_sparse_intMSintME_free(s1);
+  d4_sparse_intMSintME_free(s2);
+  d4_sparse_intMSintME_free(s3);
+  d4_sparse_intMSintME_free(s4);
+}
+
+static void test_sparse_get (void) {
+  d4_str_t val1 = d4_str_alloc(L"val1");
+  d4_str_t val2 = d4_str_alloc(L"val2");
+  d4_sparse_intMSstrME_t s1 = d4_sparse_intMSstrME_alloc(&d4_err_state, 0, 0, 2, 1, val1, -1, val2);
+
+  ASSERT_NO_THROW(GET1, {
+    d4_str_t v1 = d4_sparse_intMSstrME_get(&d4_err_state, 0, 0, s1, 1);
+    d4_str_t v2 = d4_sparse_intMSstrME_get(&d4_err_state, 0, 0, s1, -1);
+
+    assert(((void) "Gets first element", d4_str_eq(v1, val1)));
+    assert(((void) "Gets element below first key", d4_str_eq(v2, val2)));
+
+    d4_str_free(v1);
+    d4_str_free(v2);
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(GET2, {
+    d4_sparse_intMSstrME_get(&d4_err_state, 0, 0, s1, 0);
+  }, L"failed to find key '0'");
+
+  ASSERT_THROW_WITH_MESSAGE(GET3, {
+    d4_sparse_intMSstrME_get(&d4_err_state, 0, 0, s1, -1000);
+  }, L"failed to find key '-1000'");
+
+  ASSERT_THROW_WITH_MESSAGE(GET4, {
+    d4_sparse_intMSstrME_get(&d4_err_state, 0, 0, s1, 1000);
+  }, L"failed to find key '1000'");
+
+  d4_sparse_intMSstrME_free(s1);
+
+  d4_str_free(val1);
+  d4_str_free(val2);
+}
+
+static void test_sparse_has (void) {
+  d4_sparse_intMSintME_t s1 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 0);
+  d4_sparse_intMSintME_t s2 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 2, 2, 20, 3, 30);
+
+  assert(((void) "Has no element in sparse set with zero pairs", !d4_sparse_intMSintME_has(s1, 0)));
+  assert(((void) "Has first element", d4_sparse_intMSintME_has(s2, 2)));
+  assert(((void) "Has second element", d4_sparse_intMSintME_has(s2, 3)));
+  assert(((void) "Has no element inside of range", !d4_sparse_intMSintME_has(s2, 4)));
+  assert(((void) "Has no element below range", !d4_sparse_intMSintME_has(s2, 1)));
+  assert(((void) "Has no element above range", !d4_sparse_intMSintME_has(s2, INT32_MAX)));
+
+  d4_sparse_intMSintME_free(s1);
+  d4_sparse_intMSintME_free(s2);
+}
+
+static void test_sparse_keys (void) {
+  d4_sparse_intMSintME_t s1 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 0);
+  d4_sparse_intMSintME_t s2 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 3, 5, 50, 3, 30, 4, 40);
+  d4_arr_int_t k1 = d4_sparse_intMSintME_keys(s1);
+  d4_arr_int_t k2 = d4_sparse_intMSintME_keys(s2);
+  d4_arr_int_t v2 = d4_sparse_intMSintME_values(s2);
+
+  assert(((void) "Returns no keys of empty sparse set", k1.len == 0));
+  assert(((void) "Returns keys in storage order", k2.len == 3 && k2.data[0] == 5 && k2.data[1] == 3 && k2.data[2] == 4));
+  assert(((void) "Returns values in storage order", v2.len == 3 && v2.data[0] == 50 && v2.data[1] == 30 && v2.data[2] == 40));
+
+  d4_arr_int_free(k1);
+  d4_arr_int_free(k2);
+  d4_arr_int_free(v2);
+
+  d4_sparse_intMSintME_free(s1);
+  d4_sparse_intMSintME_free(s2);
+}
+
+static void test_sparse_remove (void) {
+  d4_str_t val = d4_str_alloc(L"val");
+  d4_sparse_intMSstrME_t s1 = d4_sparse_intMSstrME_alloc(&d4_err_state, 0, 0, 3, 1, val, 2, val, 3, val);
+
+  ASSERT_NO_THROW(REMOVE1, {
+    d4_sparse_intMSstrME_remove(&d4_err_state, 0, 0, &s1, 1);
+    assert(((void) "Removes pair", s1.len == 2 && !d4_sparse_intMSstrME_has(s1, 1)));
+    assert(((void) "Moves last pair into freed position", s1.keys[0] == 3 && d4_sparse_intMSstrME_has(s1, 3)));
+
+    d4_sparse_intMSstrME_remove(&d4_err_state, 0, 0, &s1, 2);
+    assert(((void) "Removes last pair", s1.len == 1 && !d4_sparse_intMSstrME_has(s1, 2) && d4_sparse_intMSstrME_has(s1, 3)));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(REMOVE2, {
+    d4_sparse_intMSstrME_remove(&d4_err_state, 0, 0, &s1, 2);
+  }, L"failed to remove key '2'");
+
+  d4_sparse_intMSstrME_free(s1);
+  d4_str_free(val);
+}
+
+static void test_sparse_reserve (void) {
+  d4_sparse_intMSintME_t s1 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 0);
+
+  d4_sparse_intMSintME_reserve(&s1, 100);
+  assert(((void) "Reserves capacity", s1.cap == 100));
+
+  d4_sparse_intMSintME_reserve(&s1, 10);
+  assert(((void) "Doesn't reduce capacity", s1.cap == 100));
+
+  d4_sparse_intMSintME_free(s1);
+}
+
+static void test_sparse_set (void) {
+  d4_sparse_intMSintME_t s1 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 0);
+  d4_sparse_u8MSintME_t s2 = d4_sparse_u8MSintME_alloc(&d4_err_state, 0, 0, 0);
+  bool all_found = true;
+
+  for (int32_t i = 0; i < 5000; i++) {
+    d4_sparse_intMSintME_set(&d4_err_state, 0, 0, &s1, 1000 - i, i);
+  }
+
+  for (int32_t i = 0; i < 5000; i++) {
+    d4_sparse_intMSintME_set(&d4_err_state, 0, 0, &s1, 1000 - i, i + 1);
+  }
+
+  for (int32_t i = 255; i >= 0; i--) {
+    d4_sparse_u8MSintME_set(&d4_err_state, 0, 0, &s2, (uint8_t) i, i);
+  }
+
+  ASSERT_NO_THROW(SET1, {
+    for (int32_t i = 0; i < 5000; i++) {
+      if (d4_sparse_intMSintME_get(&d4_err_state, 0, 0, s1, 1000 - i) != i + 1) all_found = false;
+    }
+
+    for (int32_t i = 0; i < 256; i++) {
+      if (d4_sparse_u8MSintME_get(&d4_err_state, 0, 0, s2, (uint8_t) i) != i) all_found = false;
+    }
+  });
+
+  assert(((void) "Sets pairs in descending order and updates existing ones", s1.len == 5000 && all_found));
+  assert(((void) "Extends index downwards with room for more keys", s1.min < -3999));
+  assert(((void) "Doesn't extend index past the smallest key of the type", s2.len == 256 && s2.min == 0));
+
+  d4_sparse_intMSintME_free(s1);
+  d4_sparse_u8MSintME_free(s2);
+}
+
+static void test_sparse_set_range (void) {
+  d4_sparse_intMSintME_t s1 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 1, 0, 10);
+  d4_sparse_u64MSintME_t s2 = d4_sparse_u64MSintME_alloc(&d4_err_state, 0, 0, 1, 0, 10);
+
+  ASSERT_THROW_WITH_MESSAGE(SET_RANGE1, {
+    d4_sparse_intMSintME_set(&d4_err_state, 0, 0, &s1, INT32_MAX, 20);
+  }, L"key '2147483647' is out of sparse set range");
+
+  ASSERT_THROW_WITH_MESSAGE(SET_RANGE2, {
+    d4_sparse_intMSintME_set(&d4_err_state, 0, 0, &s1, INT32_MIN, 20);
+  }, L"key '-2147483648' is out of sparse set range");
+
+  ASSERT_THROW_WITH_MESSAGE(SET_RANGE3, {
+    d4_sparse_u64MSintME_set(&d4_err_state, 0, 0, &s2, UINT64_MAX, 20);
+  }, L"key '18446744073709551615' is out of sparse set range");
+
+  ASSERT_THROW_WITH_MESSAGE(SET_RANGE4, {
+    d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 2, 0, 10, (int32_t) D4_SPARSE_MAX_RANGE, 20);
+  }, L"key '16777216' is out of sparse set range");
+
+  ASSERT_NO_THROW(SET_RANGE5, {
+    d4_sparse_intMSintME_set(&d4_err_state, 0, 0, &s1, 1000, 20);
+    d4_sparse_intMSintME_set(&d4_err_state, 0, 0, &s1, -1000, 30);
+  });
+
+  assert(((void) "Keeps pairs when rejecting key", s1.len == 3 && d4_sparse_intMSintME_has(s1, 0) && !d4_sparse_intMSintME_has(s1, INT32_MAX)));
+  assert(((void) "Keeps range within maximum", s1.range <= D4_SPARSE_MAX_RANGE && s2.len == 1 && s2.range <= D4_SPARSE_MAX_RANGE));
+
+  d4_sparse_intMSintME_free(s1);
+  d4_sparse_u64MSintME_free(s2);
+}
+
+static void test_sparse_str (void) {
+  d4_str_t val = d4_str_alloc(L"val");
+
+  d4_str_t s1 = d4_str_alloc(L"{}");
+  d4_str_t s2 = d4_str_alloc(L"{\"1\": 10}");
+  d4_str_t s3 = d4_str_alloc(L"{\"3\": \"val\", \"-2\": \"val\"}");
+
+  d4_sparse_intMSintME_t m1 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 0);
+  d4_sparse_intMSintME_t m2 = d4_sparse_intMSintME_alloc(&d4_err_state, 0, 0, 1, 1, 10);
+  d4_sparse_intMSstrME_t m3 = d4_sparse_intMSstrME_alloc(&d4_err_state, 0, 0, 2, 3, val, -2, val);
+
+  d4_str_t s1_cmp = d4_sparse_intMSintME_str(m1);
+  d4_str_t s2_cmp = d4_sparse_intMSintME_str(m2);
+  d4_str_t s3_cmp = d4_sparse_intMSstrME_str(m3);
+
+  assert(((void) "Stringifies sparse set with zero pairs", d4_str_eq(s1, s1_cmp)));
+  assert(((void) "Stringifies sparse set with one pair", d4_str_eq(s2, s2_cmp)));
+  assert(((void) "Stringifies sparse set with two pairs", d4_str_eq(s3, s3_cmp)));
+
+  d4_str_free(s1_cmp);
+  d4_str_free(s2_cmp);
+  d4_str_free(s3_cmp);
+
+  d4_sparse_intMSintME_free(m1);
+  d4_sparse_intMSintME_free(m2);
+  d4_sparse_intMSstrME_free(m3);
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+
+  d4_str_free(val);
+}
+
+int main (void) {
+  test_sparse_alloc();
+  test_sparse_clear();
+  test_sparse_copy();
+  test_sparse_empty();
+  test_sparse_eq();
+  test_sparse_get();
+  test_sparse_has();
+  test_sparse_keys();
+  test_sparse_remove();
+  test_sparse_reserve();
+  test_sparse_set();
+  test_sparse_set_range();
+  test_sparse_str();
+}
@@ -0,0 +1,129 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include <assert.h>
+#include "../include/d4/strbuf.h"
+
+static void test_strbuf_alloc (void) {
+  d4_strbuf_t b1 = d4_strbuf_alloc(0);
+  d4_strbuf_t b2 = d4_strbuf_alloc(100);
+
+  assert(((void) "Allocates nothing without capacity", b1.data == NULL && b1.len == 0 && b1.cap == 0));
+  assert(((void) "Reserves capacity with null terminator", b2.data != NULL && b2.len == 0 && b2.cap >= 101));
+
+  d4_strbuf_free(b1);
+  d4_strbuf_free(b2);
+}
+
+static void test_strbuf_append (void) {
+  d4_strbuf_t b1 = d4_strbuf_alloc(0);
+  d4_str_t s1;
+
+  d4_strbuf_append(&b1, (d4_str_t) {L"Hello", 5, true});
+  d4_strbuf_append(&b1, d4_str_empty_val);
+  d4_strbuf_appendChar(&b1, L',');
+  d4_strbuf_appendChar(&b1, L' ');
+  d4_strbuf_appendMove(&b1, d4_str_alloc(L"World"));
+  s1 = d4_strbuf_finish(&b1);
+
+  assert(((void) "Appends fragments", d4_str_eq(s1, (d4_str_t) {L"Hello, World", 12, true})));
+  assert(((void) "Terminates data", s1.data[s1.len] == L'\0'));
+  assert(((void) "Empties string buffer", b1.data == NULL && b1.len == 0 && b1.cap == 0));
+
+  d4_str_free(s1);
+}
+
+static void test_strbuf_append_fmt (void) {
+  d4_strbuf_t b1 = d4_strbuf_alloc(0);
+  d4_str_t long_str = d4_str_alloc(L"%0*d", 200, 7);
+  d4_str_t s1;
+
+  d4_strbuf_appendFmt(&b1, L"%ls=%d;", L"key", 10);
+  d4_strbuf_appendFmt(&b1, L"%ls", long_str.data);
+  s1 = d4_strbuf_finish(&b1);
+
+  assert(((void) "Appends formatted text", s1.len == 207 && wcsncmp(s1.data, L"key=10;", 7) == 0));
+  assert(((void) "Grows for long formatted text", wcscmp(&s1.data[7], long_str.data) == 0));
+
+  d4_str_free(long_str);
+  d4_str_free(s1);
+}
+
+static void test_strbuf_append_int (void) {
+  d4_strbuf_t b1 = d4_strbuf_alloc(0);
+  d4_str_t s1;
+
+  d4_strbuf_appendInt(&b1, 0);
+  d4_strbuf_appendChar(&b1, L' ');
+  d4_strbuf_appendInt(&b1, -42);
+  d4_strbuf_appendChar(&b1, L' ');
+  d4_strbuf_appendInt(&b1, INT64_MAX);
+  d4_strbuf_appendChar(&b1, L' ');
+  d4_strbuf_appendInt(&b1, INT64_MIN);
+  s1 = d4_strbuf_finish(&b1);
+
+  assert(((void) "Appends integers", d4_str_eq(s1, (d4_str_t) {L"0 -42 9223372036854775807 -9223372036854775808", 46, true})));
+  d4_str_free(s1);
+}
+
+static void test_strbuf_finish (void) {
+  d4_strbuf_t b1 = d4_strbuf_alloc(10);
+  d4_str_t s1 = d4_strbuf_finish(&b1);
+
+  assert(((void) "Finishes empty string buffer as empty string", d4_str_eq(s1, d4_str_empty_val)));
+  d4_str_free(s1);
+}
+
+static void test_strbuf_from (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello");
+  wchar_t *data = s1.data;
+  d4_strbuf_t b1 = d4_strbuf_from(s1);
+  d4_strbuf_t b2 = d4_strbuf_from((d4_str_t) {L"static", 6, true});
+  d4_str_t s2;
+  d4_str_t s3;
+
+  assert(((void) "Takes ownership of allocated data", b1.data == data && b1.len == 5));
+
+  d4_strbuf_append(&b1, (d4_str_t) {L"!", 1, true});
+  d4_strbuf_append(&b2, (d4_str_t) {L"!", 1, true});
+  s2 = d4_strbuf_finish(&b1);
+  s3 = d4_strbuf_finish(&b2);
+
+  assert(((void) "Continues allocated string", d4_str_eq(s2, (d4_str_t) {L"Hello!", 6, true})));
+  assert(((void) "Copies static string", d4_str_eq(s3, (d4_str_t) {L"static!", 7, true}) && !s3.is_static));
+
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_strbuf_reserve (void) {
+  d4_strbuf_t b1 = d4_strbuf_alloc(0);
+  size_t reallocs = 0;
+  size_t cap = 0;
+
+  for (size_t i = 0; i < 10000; i++) {
+    d4_strbuf_appendChar(&b1, L'a');
+    if (b1.cap != cap) reallocs++;
+    cap = b1.cap;
+  }
+
+  assert(((void) "Grows geometrically", reallocs < 20));
+
+  d4_strbuf_reserve(&b1, 100);
+  assert(((void) "Reserves additional characters", b1.cap >= b1.len + 101));
+
+  d4_strbuf_free(b1);
+}
+
+int main (void) {
+  test_strbuf_alloc();
+  test_strbuf_append();
+  test_strbuf_append_fmt();
+  test_strbuf_append_int();
+  test_strbuf_finish();
+  test_strbuf_from();
+  test_strbuf_reserve();
+}
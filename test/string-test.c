@@ -4,6 +4,9 @@
  */
 
 #include <assert.h>
+#include <string.h>
+#include <wctype.h>
+#include "../include/d4/rune.h"
 #include "../src/string.h"
 #include "utils.h"
 
@@ -66,6 +69,37 @@ static void test_string_calloc (void) {
   d4_str_free(s6);
 }
 
+static void test_string_calloc_char (void) {
+  wchar_t data[] = L"a\x100";
+
+  d4_str_t s1 = d4_str_calloc(data, 1);
+  d4_str_t s2 = d4_str_calloc(data, 1);
+  d4_str_t s3 = d4_str_copy(s1);
+  d4_str_t s4 = d4_str_lower(s1);
+  d4_str_t s5 = d4_str_upper(s1);
+  d4_str_t s6;
+
+  assert(((void) "Allocates one-character string", !s1.is_static && !s2.is_static && !s3.is_static && s1.data != s2.data && s1.data[1] == L'\0'));
+  assert(((void) "Doesn't modify source string", s4.data[0] == L'a' && s5.data[0] == L'A' && s1.data[0] == L'a'));
+
+  ASSERT_NO_THROW(CALLOC_CHAR1, {
+    *d4_str_atMut(&d4_err_state, 0, 0, &s3, 0) = L'Z';
+  });
+
+  s6 = d4_rune_str(L'a');
+  assert(((void) "Writing into copy doesn't affect other strings", s1.data[0] == L'a' && s6.data[0] == L'a'));
+
+  s2 = d4_str_realloc(s2, s3);
+  assert(((void) "Reallocates one-character string", d4_str_eq(s2, s3) && s1.data[0] == L'a'));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+  d4_str_free(s6);
+}
+
 static void test_string_at (void) {
   d4_str_t s1 = d4_str_empty_val;
   d4_str_t s2 = d4_str_alloc(L"1234");
@@ -129,6 +163,7 @@ static void test_string_contains (void) {
   d4_str_t s4 = d4_str_alloc(L"ell");
   d4_str_t s5 = d4_str_alloc(L"lo");
   d4_str_t s6 = d4_str_alloc(L"wor");
+  d4_str_t s7 = d4_str_alloc(L"ab");
 
   assert(((void) "Empty contains itself", d4_str_contains(s1, s1)));
   assert(((void) "Empty doesn't contain non-empty", !d4_str_contains(s1, s4)));
@@ -137,6 +172,7 @@ static void test_string_contains (void) {
   assert(((void) "Non-empty contains other part 2", d4_str_contains(s2, s4)));
   assert(((void) "Non-empty contains other part 3", d4_str_contains(s2, s5)));
   assert(((void) "Non-empty doesn't contains other part", !d4_str_contains(s2, s6)));
+  assert(((void) "Non-empty doesn't contains lesser part", !d4_str_contains(s2, s7)));
 
   d4_str_free(s1);
   d4_str_free(s2);
@@ -144,6 +180,7 @@ static void test_string_contains (void) {
   d4_str_free(s4);
   d4_str_free(s5);
   d4_str_free(s6);
+  d4_str_free(s7);
 }
 
 static void test_string_copy (void) {
@@ -262,6 +299,21 @@ static void test_string_escape (void) {
   d4_str_free(r6);
 }
 
+static void test_string_escape_runs (void) {
+  d4_str_t s1 = d4_str_alloc(L"key\t\"value\"\nnext line without escapes\r\n\f\v");
+  d4_str_t s2 = d4_str_alloc(L"n\u00E9ed no escap\u00E9s at all");
+  d4_str_t r1 = d4_str_escape(s1);
+  d4_str_t r2 = d4_str_escape(s2);
+
+  assert(((void) "Escapes characters between runs", d4_str_eq(r1, (d4_str_t) {L"key\\t\\\"value\\\"\\nnext line without escapes\\r\\n\\f\\v", 49, true})));
+  assert(((void) "Copies string without escapes", d4_str_eq(r2, s2)));
+
+  d4_str_free(r1);
+  d4_str_free(r2);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
 static void test_string_find (void) {
   d4_str_t s1 = d4_str_empty_val;
   d4_str_t s2 = d4_str_alloc(L"s");
@@ -295,6 +347,23 @@ static void test_string_find (void) {
   d4_str_free(s8);
 }
 
+static void test_string_find_long (void) {
+  d4_str_t s1 = d4_str_alloc(L"%0*d%ls%0*d", 1000, 0, L"needle-in-a-haystack", 1000, 0);
+  d4_str_t s2 = d4_str_alloc(L"needle-in-a-haystack");
+  d4_str_t s3 = d4_str_alloc(L"needle-in-a-haystacks");
+  d4_str_t s4 = d4_str_alloc(L"%0*d", 30, 0);
+
+  assert(((void) "Finds long string", d4_str_find(s1, s2) == 1000));
+  assert(((void) "Doesn't find long string that differs at the end", d4_str_find(s1, s3) == -1));
+  assert(((void) "Finds repetitive long string", d4_str_find(s1, s4) == 0));
+  assert(((void) "Contains long string", d4_str_contains(s1, s2) && !d4_str_contains(s1, s3)));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+}
+
 static void test_string_free (void) {
   d4_str_t s1 = d4_str_empty_val;
   d4_str_t s2 = d4_str_alloc(L"Test");
@@ -303,6 +372,54 @@ static void test_string_free (void) {
   d4_str_free(s2);
 }
 
+static void test_string_fromUtf8 (void) {
+  const char *d1 = "Hello, World! This is ASCII text";
+  const char *d2 = "na\xC3\xAFve \xE2\x82\xAC" "5 \xF0\x9F\x98\x80";
+
+  ASSERT_NO_THROW(FROM_UTF8_1, {
+    d4_str_t s1 = d4_str_fromUtf8(&d4_err_state, 0, 0, d1, 0);
+    d4_str_t s2 = d4_str_fromUtf8(&d4_err_state, 0, 0, d1, strlen(d1));
+    d4_str_t s3 = d4_str_fromUtf8(&d4_err_state, 0, 0, d2, strlen(d2));
+
+    assert(((void) "Decodes empty bytes", d4_str_eq(s1, d4_str_empty_val)));
+    assert(((void) "Decodes ASCII bytes", d4_str_eq(s2, (d4_str_t) {L"Hello, World! This is ASCII text", 32, true})));
+    assert(((void) "Decodes multi-byte sequences", wcscmp(s3.data, L"na\u00EFve \u20AC" L"5 \U0001F600") == 0));
+
+    d4_str_free(s1);
+    d4_str_free(s2);
+    d4_str_free(s3);
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(FROM_UTF8_2, {
+    d4_str_fromUtf8(&d4_err_state, 0, 0, "test\x80", 5);
+  }, L"invalid UTF-8 sequence at byte 4");
+
+  ASSERT_THROW_WITH_MESSAGE(FROM_UTF8_3, {
+    d4_str_fromUtf8(&d4_err_state, 0, 0, "test\xC0\xAF", 6);
+  }, L"invalid UTF-8 sequence at byte 4");
+
+  ASSERT_THROW_WITH_MESSAGE(FROM_UTF8_4, {
+    d4_str_fromUtf8(&d4_err_state, 0, 0, "test\xED\xA0\x80", 7);
+  }, L"invalid UTF-8 sequence at byte 4");
+
+  ASSERT_THROW_WITH_MESSAGE(FROM_UTF8_5, {
+    d4_str_fromUtf8(&d4_err_state, 0, 0, "0123456789\xF4\x90\x80\x80", 14);
+  }, L"invalid UTF-8 sequence at byte 10");
+
+  ASSERT_THROW_WITH_MESSAGE(FROM_UTF8_6, {
+    d4_str_fromUtf8(&d4_err_state, 0, 0, "test\xE2\x82", 6);
+  }, L"invalid UTF-8 sequence at byte 4");
+}
+
+static void test_string_fromUtf8Len (void) {
+  const char *d1 = "na\xC3\xAFve \xE2\x82\xAC" "5";
+
+  assert(((void) "Calculates length of empty bytes", d4_str_fromUtf8Len(d1, 0) == 0));
+  assert(((void) "Calculates length of ASCII bytes", d4_str_fromUtf8Len("test", 4) == 4));
+  assert(((void) "Calculates length of multi-byte sequences", d4_str_fromUtf8Len(d1, strlen(d1)) == 8));
+  assert(((void) "Calculates length of four-byte sequences", d4_str_fromUtf8Len("\xF0\x9F\x98\x80", 4) == (sizeof(wchar_t) == 2 ? 2 : 1)));
+}
+
 static void test_string_ge (void) {
   d4_str_t s1 = d4_str_alloc(L"");
   d4_str_t s2 = d4_str_alloc(L"t");
@@ -771,6 +888,18 @@ static void test_string_lower (void) {
   d4_str_free(s7);
 }
 
+static void test_string_lower_blocks (void) {
+  d4_str_t s1 = d4_str_alloc(L"@AZ[`az{ Hello, WORLD! \u00C4\u00D6 12345 MiXeD");
+  d4_str_t s2 = d4_str_alloc(L"@az[`az{ hello, world! %lc%lc 12345 mixed", (wint_t) towlower(L'\u00C4'), (wint_t) towlower(L'\u00D6'));
+  d4_str_t r1 = d4_str_lower(s1);
+
+  assert(((void) "Lowers ASCII and non-ASCII blocks", d4_str_eq(r1, s2)));
+
+  d4_str_free(r1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
 static void test_string_lowerFirst (void) {
   d4_str_t s1 = d4_str_alloc(L"");
   d4_str_t s2 = d4_str_alloc(L"t");
@@ -1530,6 +1659,54 @@ static void test_string_replace (void) {
   d4_str_free(cmp110);
 }
 
+static void test_string_share (void) {
+  d4_str_t s1 = d4_str_share(d4_str_alloc(L"%0*d", 100, 7));
+  d4_str_t s2 = d4_str_alloc(L"%0*d", 100, 8);
+  d4_str_t s3 = d4_str_share(d4_str_empty_val);
+  d4_str_t s4 = d4_str_alloc(L"short");
+
+  d4_str_t c1 = d4_str_copy(s1);
+  d4_str_t c2 = d4_str_copy(s2);
+  d4_str_t c3 = d4_str_copy(c2);
+  d4_str_t c4 = d4_str_copy(s4);
+  d4_str_t c5 = d4_str_copy(s1);
+  d4_str_t r1 = d4_str_upper(c1);
+
+  assert(((void) "Shares string", s1.is_static == D4_STR_SHARED && d4_str_eq(s1, c1) && s1.data == c1.data));
+  assert(((void) "Keeps empty string static", s3.is_static && s3.len == 0));
+  assert(((void) "Shares copy of long string", c2.is_static == D4_STR_SHARED && c2.data != s2.data && c3.data == c2.data));
+  assert(((void) "Copies short string into own buffer", !c4.is_static && c4.data != s4.data));
+
+  ASSERT_NO_THROW(SHARE1, {
+    *d4_str_atMut(&d4_err_state, 0, 0, &c2, 0) = L'X';
+  });
+
+  assert(((void) "Copies shared string on write", !c2.is_static && c2.data != c3.data && c2.data[0] == L'X'));
+  assert(((void) "Writing into copy doesn't affect other strings", s2.data[0] == L'0' && c3.data[0] == L'0' && c3.is_static == D4_STR_SHARED));
+
+  d4_str_free(s1);
+  assert(((void) "Keeps data while referenced", d4_str_eq(c1, c5) && c1.data[99] == L'7'));
+
+  c5 = d4_str_realloc(c5, s4);
+  assert(((void) "Reallocates shared string into own buffer", !c5.is_static && d4_str_eq(c5, s4) && c1.data[99] == L'7'));
+  assert(((void) "Doesn't modify shared string", !r1.is_static && c1.data[0] == L'0'));
+
+  ASSERT_NO_THROW(SHARE2, {
+    const wchar_t *data = c1.data;
+    *d4_str_atMut(&d4_err_state, 0, 0, &c1, -1) = L'9';
+    assert(((void) "Writes into unique shared string in place", c1.is_static == D4_STR_SHARED && c1.data == data && c1.data[99] == L'9'));
+  });
+
+  d4_str_free(s2);
+  d4_str_free(s4);
+  d4_str_free(c1);
+  d4_str_free(c2);
+  d4_str_free(c3);
+  d4_str_free(c4);
+  d4_str_free(c5);
+  d4_str_free(r1);
+}
+
 static void test_string_slice (void) {
   d4_str_t s1 = d4_str_alloc(L"");
   d4_str_t s2 = d4_str_alloc(L"t");
@@ -2081,6 +2258,62 @@ static void test_string_split (void) {
   d4_arr_str_free(r44_cmp);
 }
 
+static void test_string_split_adjacent (void) {
+  d4_str_t s1 = d4_str_alloc(L"a,,b,");
+  d4_str_t s2 = d4_str_alloc(L"ababab");
+  d4_str_t d1 = d4_str_alloc(L",");
+  d4_str_t d2 = d4_str_alloc(L"ab");
+  d4_str_t l_empty = d4_str_alloc(L"");
+  d4_str_t l_a = d4_str_alloc(L"a");
+  d4_str_t l_b = d4_str_alloc(L"b");
+
+  d4_arr_str_t r1 = d4_str_split(s1, 1, d1);
+  d4_arr_str_t r2 = d4_str_split(s2, 1, d2);
+
+  d4_arr_str_t r1_cmp = d4_arr_str_alloc(4, l_a, l_empty, l_b, l_empty);
+  d4_arr_str_t r2_cmp = d4_arr_str_alloc(4, l_empty, l_empty, l_empty, l_empty);
+
+  assert(((void) "Splits string by adjacent delimiters", d4_arr_str_eq(r1, r1_cmp)));
+  assert(((void) "Splits string of repeated delimiters", d4_arr_str_eq(r2, r2_cmp)));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(d1);
+  d4_str_free(d2);
+  d4_str_free(l_empty);
+  d4_str_free(l_a);
+  d4_str_free(l_b);
+
+  d4_arr_str_free(r1);
+  d4_arr_str_free(r2);
+  d4_arr_str_free(r1_cmp);
+  d4_arr_str_free(r2_cmp);
+}
+
+static void test_string_splitN (void) {
+  d4_str_t s1 = d4_str_alloc(L"key=value=1");
+  d4_str_t d1 = d4_str_alloc(L"=");
+  d4_str_t l_key = d4_str_alloc(L"key");
+  d4_str_t l_value = d4_str_alloc(L"value=1");
+
+  d4_arr_str_t r1 = d4_str_splitN(s1, 1, d1, 2);
+  d4_arr_str_t r2 = d4_str_splitN(s1, 1, d1, 0);
+
+  d4_arr_str_t r1_cmp = d4_arr_str_alloc(2, l_key, l_value);
+
+  assert(((void) "Splits string into limited number of strings", d4_arr_str_eq(r1, r1_cmp)));
+  assert(((void) "Splits string into nothing", r2.len == 0));
+
+  d4_str_free(s1);
+  d4_str_free(d1);
+  d4_str_free(l_key);
+  d4_str_free(l_value);
+
+  d4_arr_str_free(r1);
+  d4_arr_str_free(r2);
+  d4_arr_str_free(r1_cmp);
+}
+
 static void test_string_startsWith (void) {
   d4_str_t s1 = d4_str_empty_val;
   d4_str_t s2 = d4_str_alloc(L"t");
@@ -2309,6 +2542,24 @@ static void test_string_toF64 (void) {
   d4_str_free(s15);
 }
 
+static void test_string_toF64_exact (void) {
+  const wchar_t *values[] = {
+    L"0.1", L"-0.0", L"+2.5", L".5", L"5.", L"0.30000000000000004", L"9007199254740993", L"123456789.123456789",
+    L"1e22", L"1e23", L"4.9e-30", L"0.000000000000000000001", L"1234567890123456789012", L"16777217"
+  };
+
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    d4_str_t s1 = d4_str_alloc(L"%ls", values[i]);
+
+    ASSERT_NO_THROW(TO_FLOAT64_EXACT, {
+      assert(((void) "Converts to f64 same as libc", d4_str_toF64(&d4_err_state, 0, 0, s1) == wcstod(values[i], NULL)));
+      assert(((void) "Converts to f32 same as libc", d4_str_toF32(&d4_err_state, 0, 0, s1) == wcstof(values[i], NULL)));
+    });
+
+    d4_str_free(s1);
+  }
+}
+
 static void test_string_toIsize (void) {
   d4_str_t s1 = d4_str_alloc(L"0");
   d4_str_t s2 = d4_str_alloc(L"1");
@@ -3294,6 +3545,47 @@ static void test_string_toU64 (void) {
   d4_str_free(s55);
 }
 
+static void test_string_toUtf8 (void) {
+  d4_str_t s1 = d4_str_alloc(L"");
+  d4_str_t s2 = d4_str_alloc(L"Hello, World! This is ASCII text");
+  d4_str_t s3 = d4_str_alloc(L"na\u00EFve \u20AC" L"5 \U0001F600");
+  d4_str_t s4 = d4_str_alloc(L"test");
+  char buf[64];
+
+  s4.data[2] = (wchar_t) 0xD800;
+
+  assert(((void) "Encodes empty string", d4_str_toUtf8(s1, buf) == 0));
+  assert(((void) "Encodes ASCII string", d4_str_toUtf8(s2, buf) == 32 && memcmp(buf, "Hello, World! This is ASCII text", 32) == 0));
+  assert(((void) "Encodes multi-byte characters", d4_str_toUtf8(s3, buf) == 16 && memcmp(buf, "na\xC3\xAFve \xE2\x82\xAC" "5 \xF0\x9F\x98\x80", 16) == 0));
+  assert(((void) "Encodes unpaired surrogate as replacement character", d4_str_toUtf8(s4, buf) == 6 && memcmp(buf, "te\xEF\xBF\xBDt", 6) == 0));
+
+  ASSERT_NO_THROW(TO_UTF8_1, {
+    size_t len = d4_str_toUtf8(s3, buf);
+    d4_str_t s5 = d4_str_fromUtf8(&d4_err_state, 0, 0, buf, len);
+    assert(((void) "Round trips through UTF-8", d4_str_eq(s3, s5)));
+    d4_str_free(s5);
+  });
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+}
+
+static void test_string_toUtf8Len (void) {
+  d4_str_t s1 = d4_str_alloc(L"");
+  d4_str_t s2 = d4_str_alloc(L"test");
+  d4_str_t s3 = d4_str_alloc(L"na\u00EFve \u20AC" L"5 \U0001F600");
+
+  assert(((void) "Calculates bytes of empty string", d4_str_toUtf8Len(s1) == 0));
+  assert(((void) "Calculates bytes of ASCII string", d4_str_toUtf8Len(s2) == 4));
+  assert(((void) "Calculates bytes of multi-byte characters", d4_str_toUtf8Len(s3) == 16));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
 static void test_string_trim (void) {
   d4_str_t s1 = d4_str_alloc(L"");
   d4_str_t s2 = d4_str_alloc(L"t");
@@ -3643,6 +3935,18 @@ static void test_string_upper (void) {
   d4_str_free(s7);
 }
 
+static void test_string_upper_blocks (void) {
+  d4_str_t s1 = d4_str_alloc(L"@AZ[`az{ Hello, WORLD! \u00E4\u00F6 12345 MiXeD");
+  d4_str_t s2 = d4_str_alloc(L"@AZ[`AZ{ HELLO, WORLD! %lc%lc 12345 MIXED", (wint_t) towupper(L'\u00E4'), (wint_t) towupper(L'\u00F6'));
+  d4_str_t r1 = d4_str_upper(s1);
+
+  assert(((void) "Uppers ASCII and non-ASCII blocks", d4_str_eq(r1, s2)));
+
+  d4_str_free(r1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
 static void test_string_upperFirst (void) {
   d4_str_t s1 = d4_str_alloc(L"");
   d4_str_t s2 = d4_str_alloc(L"t");
@@ -3695,6 +3999,7 @@ int main (void) {
   test_string_snwprintf_vsnwprintf();
   test_string_alloc();
   test_string_calloc();
+  test_string_calloc_char();
   test_string_at();
   test_string_concat();
   test_string_contains();
@@ -3703,25 +4008,34 @@ int main (void) {
   test_string_endsWith();
   test_string_eq();
   test_string_escape();
+  test_string_escape_runs();
   test_string_find();
+  test_string_find_long();
   test_string_free();
+  test_string_fromUtf8();
+  test_string_fromUtf8Len();
   test_string_ge();
   test_string_gt();
   test_string_le();
   test_string_lines();
   test_string_lower();
+  test_string_lower_blocks();
   test_string_lowerFirst();
   test_string_lt();
   test_string_not();
   test_string_quoted_escape();
   test_string_realloc();
   test_string_replace();
+  test_string_share();
   test_string_slice();
   test_string_split();
+  test_string_split_adjacent();
+  test_string_splitN();
   test_string_startsWith();
   test_string_toFloat();
   test_string_toF32();
   test_string_toF64();
+  test_string_toF64_exact();
   test_string_toIsize();
   test_string_toI8();
   test_string_toI16();
@@ -3732,9 +4046,12 @@ int main (void) {
   test_string_toU16();
   test_string_toU32();
   test_string_toU64();
+  test_string_toUtf8();
+  test_string_toUtf8Len();
   test_string_trim();
   test_string_trimEnd();
   test_string_trimStart();
   test_string_upper();
+  test_string_upper_blocks();
   test_string_upperFirst();
 }
@@ -0,0 +1,158 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include <assert.h>
+#include "../include/d4/map.h"
+#include "../include/d4/strpack.h"
+
+static void test_strpack_concat (void) {
+  d4_strpack_t p1 = d4_strpack_from((d4_str_t) {L"abc", 3, true});
+  d4_strpack_t p2 = d4_strpack_from((d4_str_t) {L"Āā", 2, true});
+  d4_strpack_t p3 = d4_strpack_concat(p1, p2);
+  d4_strpack_t p4 = d4_strpack_concat(p1, p1);
+  d4_strpack_t p5 = d4_strpack_concat(p1, d4_strpack_from(d4_str_empty_val));
+  d4_str_t s1 = d4_strpack_toStr(p3);
+
+  assert(((void) "Widens to the wider kind", p3.kind == D4_STRPACK_UCS2 && p3.len == 5));
+  assert(((void) "Concatenates characters", d4_str_eq(s1, (d4_str_t) {L"abcĀā", 5, true})));
+  assert(((void) "Keeps the same kind", p4.kind == D4_STRPACK_LATIN1 && p4.len == 6));
+  assert(((void) "Concatenates empty packed string", d4_strpack_eq(p5, p1)));
+
+  d4_str_free(s1);
+  d4_strpack_free(p1);
+  d4_strpack_free(p2);
+  d4_strpack_free(p3);
+  d4_strpack_free(p4);
+  d4_strpack_free(p5);
+}
+
+static void test_strpack_eq (void) {
+  d4_str_t s1 = d4_str_alloc(L"test");
+  d4_str_t s2 = d4_str_alloc(L"tesĀ");
+  d4_strpack_t p1 = d4_strpack_from(s1);
+  d4_strpack_t p2 = d4_strpack_copy(p1);
+  d4_strpack_t p3 = d4_strpack_from(s2);
+
+  assert(((void) "Equals copy", d4_strpack_eq(p1, p2)));
+  assert(((void) "Doesn't equal wider kind", !d4_strpack_eq(p1, p3)));
+  assert(((void) "Equals empty", d4_strpack_eq(d4_strpack_from(d4_str_empty_val), d4_strpack_from(d4_str_empty_val))));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_strpack_free(p1);
+  d4_strpack_free(p2);
+  d4_strpack_free(p3);
+}
+
+static void test_strpack_find (void) {
+  d4_str_t s1 = d4_str_alloc(L"hello world");
+  d4_str_t s2 = d4_str_alloc(L"Ā hello ā world");
+  d4_str_t s3 = d4_str_alloc(L"world");
+  d4_str_t s4 = d4_str_alloc(L"ā w");
+  d4_strpack_t p1 = d4_strpack_from(s1);
+  d4_strpack_t p2 = d4_strpack_from(s2);
+  d4_strpack_t p3 = d4_strpack_from(s3);
+  d4_strpack_t p4 = d4_strpack_from(s4);
+
+  assert(((void) "Finds in the same kind", d4_strpack_find(p1, p3) == 6));
+  assert(((void) "Finds narrower kind", d4_strpack_find(p2, p3) == 10));
+  assert(((void) "Finds the same wider kind", d4_strpack_find(p2, p4) == 8));
+  assert(((void) "Doesn't find wider kind", d4_strpack_find(p1, p4) == -1));
+  assert(((void) "Doesn't find longer", d4_strpack_find(p3, p1) == -1));
+  assert(((void) "Finds empty", d4_strpack_find(p1, d4_strpack_from(d4_str_empty_val)) == 0));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_strpack_free(p1);
+  d4_strpack_free(p2);
+  d4_strpack_free(p3);
+  d4_strpack_free(p4);
+}
+
+static void test_strpack_from (void) {
+  d4_str_t s1 = d4_str_alloc(L"ascii é");
+  d4_str_t s2 = d4_str_alloc(L"ucs2 Ā");
+  d4_str_t s3 = d4_str_alloc(L"ucs4 %lc", (wint_t) 0x1F600);
+  d4_strpack_t p1 = d4_strpack_from(s1);
+  d4_strpack_t p2 = d4_strpack_from(s2);
+  d4_strpack_t p3 = d4_strpack_from(s3);
+  d4_strpack_t p4 = d4_strpack_from(d4_str_empty_val);
+  d4_str_t r1 = d4_strpack_toStr(p1);
+  d4_str_t r2 = d4_strpack_toStr(p2);
+  d4_str_t r3 = d4_strpack_toStr(p3);
+  d4_str_t r4 = d4_strpack_toStr(p4);
+
+  assert(((void) "Packs Latin-1 string", p1.kind == D4_STRPACK_LATIN1 && p1.len == 7));
+  assert(((void) "Packs UCS-2 string", p2.kind == D4_STRPACK_UCS2 && p2.len == 6));
+  assert(((void) "Packs empty string", p4.len == 0));
+  assert(((void) "Unpacks Latin-1 string", d4_str_eq(r1, s1) && r1.data[r1.len] == L'\0'));
+  assert(((void) "Unpacks UCS-2 string", d4_str_eq(r2, s2)));
+  assert(((void) "Unpacks wide string", d4_str_eq(r3, s3) && d4_strpack_at(p3, 5) == 0x1F600));
+  assert(((void) "Unpacks empty string", d4_str_eq(r4, d4_str_empty_val)));
+
+  if (sizeof(wchar_t) == 4) {
+    assert(((void) "Packs UCS-4 string", p3.kind == D4_STRPACK_UCS4));
+  }
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(r1);
+  d4_str_free(r2);
+  d4_str_free(r3);
+  d4_str_free(r4);
+  d4_strpack_free(p1);
+  d4_strpack_free(p2);
+  d4_strpack_free(p3);
+  d4_strpack_free(p4);
+}
+
+static void test_strpack_hash (void) {
+  const wchar_t *texts[] = {L"", L"key", L"café", L"Āā key"};
+
+  for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+    d4_str_t s1 = d4_str_alloc(texts[i]);
+    d4_strpack_t p1 = d4_strpack_from(s1);
+
+    assert(((void) "Hashes the same as unpacked string", d4_strpack_hash(p1, 1024) == d4_map_hash(s1, 1024)));
+
+    d4_str_free(s1);
+    d4_strpack_free(p1);
+  }
+}
+
+static void test_strpack_slice (void) {
+  d4_str_t s1 = d4_str_alloc(L"abc Ā def");
+  d4_strpack_t p1 = d4_strpack_from(s1);
+  d4_strpack_t p2 = d4_strpack_slice(p1, 1, 0, 1, 3);
+  d4_strpack_t p3 = d4_strpack_slice(p1, 1, 2, 1, -2);
+  d4_strpack_t p4 = d4_strpack_slice(p1, 1, 20, 0, 0);
+  d4_strpack_t p5 = d4_strpack_from((d4_str_t) {L"abc", 3, true});
+  d4_str_t r3 = d4_strpack_toStr(p3);
+
+  assert(((void) "Narrows slice without wide characters", p2.kind == D4_STRPACK_LATIN1 && d4_strpack_eq(p2, p5)));
+  assert(((void) "Keeps kind of slice with wide characters", p3.kind == D4_STRPACK_UCS2 && d4_str_eq(r3, (d4_str_t) {L"c Ā d", 5, true})));
+  assert(((void) "Slices out of range", p4.len == 0));
+
+  d4_str_free(s1);
+  d4_str_free(r3);
+  d4_strpack_free(p1);
+  d4_strpack_free(p2);
+  d4_strpack_free(p3);
+  d4_strpack_free(p4);
+  d4_strpack_free(p5);
+}
+
+int main (void) {
+  test_strpack_concat();
+  test_strpack_eq();
+  test_strpack_find();
+  test_strpack_from();
+  test_strpack_hash();
+  test_strpack_slice();
+}
@@ -0,0 +1,237 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include <assert.h>
+#include "../include/d4/strview.h"
+
+static bool view_eq (const d4_strview_t self, const wchar_t *expected) {
+  return d4_strview_eq(self, (d4_strview_t) {expected, wcslen(expected)});
+}
+
+static void test_strview_contains (void) {
+  d4_strview_t v1 = {L"hello world", 11};
+
+  assert(((void) "Contains empty view", d4_strview_contains(v1, (d4_strview_t) {NULL, 0})));
+  assert(((void) "Contains part", d4_strview_contains(v1, (d4_strview_t) {L"o w", 3})));
+  assert(((void) "Contains only viewed characters", !d4_strview_contains((d4_strview_t) {v1.data, 5}, (d4_strview_t) {L"o w", 3})));
+}
+
+static void test_strview_endsWith (void) {
+  d4_strview_t v1 = {L"hello world", 5};
+
+  assert(((void) "Ends with viewed characters", d4_strview_endsWith(v1, (d4_strview_t) {L"llo", 3})));
+  assert(((void) "Ignores characters after view", !d4_strview_endsWith(v1, (d4_strview_t) {L"world", 5})));
+  assert(((void) "Doesn't end with longer view", !d4_strview_endsWith(v1, (d4_strview_t) {L"hello!", 6})));
+}
+
+static void test_strview_eq (void) {
+  assert(((void) "Empty views are equal", d4_strview_eq((d4_strview_t) {NULL, 0}, (d4_strview_t) {L"test", 0})));
+  assert(((void) "Compares viewed characters", d4_strview_eq((d4_strview_t) {L"test1", 4}, (d4_strview_t) {L"test2", 4})));
+  assert(((void) "Compares length", !d4_strview_eq((d4_strview_t) {L"test", 3}, (d4_strview_t) {L"test", 4})));
+}
+
+static void test_strview_find (void) {
+  d4_strview_t v1 = {L"abcabc", 6};
+
+  assert(((void) "Finds first occurrence", d4_strview_find(v1, (d4_strview_t) {L"bc", 2}) == 1));
+  assert(((void) "Finds empty view at start", d4_strview_find(v1, (d4_strview_t) {NULL, 0}) == 0));
+  assert(((void) "Doesn't find missing view", d4_strview_find(v1, (d4_strview_t) {L"cb", 2}) == -1));
+}
+
+static void test_strview_from (void) {
+  d4_str_t s1 = d4_str_alloc(L"test");
+  d4_strview_t v1 = d4_strview_from(s1);
+  d4_strview_t v2 = d4_strview_from(d4_str_empty_val);
+
+  assert(((void) "Borrows string data", v1.data == s1.data && v1.len == 4));
+  assert(((void) "Views empty string", v2.len == 0));
+
+  d4_str_free(s1);
+}
+
+static void test_strview_iter_rest (void) {
+  d4_strview_iter_t it = d4_strview_splitIter((d4_strview_t) {L"a b c", 5}, 1, (d4_strview_t) {L" ", 1});
+  d4_strview_t piece;
+
+  assert(((void) "Rest is the whole view before first piece", view_eq(d4_strview_iter_rest(it), L"a b c")));
+  d4_strview_iter_next(&it, &piece);
+  assert(((void) "Rest follows yielded piece", view_eq(d4_strview_iter_rest(it), L"b c")));
+  while (d4_strview_iter_next(&it, &piece));
+  assert(((void) "Rest is empty when done", d4_strview_iter_rest(it).len == 0));
+}
+
+static void test_strview_lines (void) {
+  d4_str_t s1 = d4_str_alloc(L"line1\r\nline2\n\nline3");
+  d4_arr_strview_t a1 = d4_strview_lines(d4_strview_from(s1), 0, false);
+  d4_arr_strview_t a2 = d4_strview_lines(d4_strview_from(s1), 1, true);
+  d4_arr_strview_t a3 = d4_strview_lines((d4_strview_t) {NULL, 0}, 0, false);
+
+  assert(((void) "Splits lines", a1.len == 4));
+  assert(((void) "Splits lines without line breaks", view_eq(a1.data[0], L"line1") && view_eq(a1.data[1], L"line2")));
+  assert(((void) "Keeps empty lines", a1.data[2].len == 0 && view_eq(a1.data[3], L"line3")));
+  assert(((void) "Points into string", a1.data[1].data == &s1.data[7]));
+  assert(((void) "Keeps line breaks", a2.len == 4 && view_eq(a2.data[0], L"line1\r\n") && view_eq(a2.data[2], L"\n")));
+  assert(((void) "Splits empty view into nothing", a3.len == 0));
+
+  d4_arr_strview_free(a1);
+  d4_arr_strview_free(a2);
+  d4_arr_strview_free(a3);
+  d4_str_free(s1);
+}
+
+static void test_strview_linesIter (void) {
+  const wchar_t *texts[] = {L"", L"\n", L"a", L"a\n", L"a\r\nb\r", L"\n\na\n\nb"};
+
+  // Cursor yields exactly the pieces that are collected by lines.
+  for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+    for (int k = 0; k < 2; k++) {
+      d4_strview_t v1 = {texts[i], wcslen(texts[i])};
+      d4_arr_strview_t a1 = d4_strview_lines(v1, 1, k == 1);
+      d4_strview_iter_t it = d4_strview_linesIter(v1, 1, k == 1);
+      d4_strview_t piece;
+      size_t len = 0;
+
+      while (d4_strview_iter_next(&it, &piece)) {
+        assert(((void) "Yields the same lines", len < a1.len && d4_strview_eq(piece, a1.data[len])));
+        len++;
+      }
+
+      assert(((void) "Yields the same number of lines", len == a1.len));
+      assert(((void) "Stays done", !d4_strview_iter_next(&it, &piece)));
+      d4_arr_strview_free(a1);
+    }
+  }
+}
+
+static void test_strview_slice (void) {
+  d4_str_t s1 = d4_str_alloc(L"hello world");
+  d4_strview_t v1 = d4_strview_from(s1);
+
+  assert(((void) "Slices without copying", d4_strview_slice(v1, 1, 6, 0, 0).data == &s1.data[6]));
+  assert(((void) "Slices from start", view_eq(d4_strview_slice(v1, 1, 6, 0, 0), L"world")));
+  assert(((void) "Slices with negative indexes", view_eq(d4_strview_slice(v1, 1, -5, 1, -1), L"worl")));
+  assert(((void) "Slices out of range", d4_strview_slice(v1, 1, 20, 1, 30).len == 0));
+  assert(((void) "Slices reversed range", d4_strview_slice(v1, 1, 5, 1, 2).len == 0));
+
+  d4_str_free(s1);
+}
+
+static void test_strview_split (void) {
+  d4_str_t s1 = d4_str_alloc(L"a,,b,");
+  d4_arr_strview_t a1 = d4_strview_split(d4_strview_from(s1), 1, (d4_strview_t) {L",", 1});
+  d4_arr_strview_t a2 = d4_strview_split(d4_strview_from(s1), 0, (d4_strview_t) {NULL, 0});
+  d4_arr_strview_t a3 = d4_strview_split((d4_strview_t) {s1.data, 1}, 1, (d4_strview_t) {L",,", 2});
+
+  assert(((void) "Splits by delimiter", a1.len == 4 && view_eq(a1.data[0], L"a") && view_eq(a1.data[2], L"b")));
+  assert(((void) "Keeps empty pieces", a1.data[1].len == 0 && a1.data[3].len == 0));
+  assert(((void) "Points into string", a1.data[2].data == &s1.data[3]));
+  assert(((void) "Splits into characters", a2.len == 5 && view_eq(a2.data[4], L",")));
+  assert(((void) "Keeps view shorter than delimiter", a3.len == 1 && view_eq(a3.data[0], L"a")));
+
+  d4_arr_strview_free(a1);
+  d4_arr_strview_free(a2);
+  d4_arr_strview_free(a3);
+  d4_str_free(s1);
+}
+
+static void test_strview_splitIter (void) {
+  const wchar_t *texts[] = {L"", L",", L"a", L"a,", L",a", L"a,,b", L"abc"};
+  const wchar_t *delimiters[] = {L"", L",", L",,", L"abcd"};
+
+  // Cursor yields exactly the pieces that are collected by split.
+  for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+    for (size_t j = 0; j < sizeof(delimiters) / sizeof(delimiters[0]); j++) {
+      d4_strview_t v1 = {texts[i], wcslen(texts[i])};
+      d4_strview_t v2 = {delimiters[j], wcslen(delimiters[j])};
+      d4_arr_strview_t a1 = d4_strview_split(v1, 1, v2);
+      d4_strview_iter_t it = d4_strview_splitIter(v1, 1, v2);
+      d4_strview_t piece;
+      size_t len = 0;
+
+      while (d4_strview_iter_next(&it, &piece)) {
+        assert(((void) "Yields the same pieces", len < a1.len && d4_strview_eq(piece, a1.data[len])));
+        len++;
+      }
+
+      assert(((void) "Yields the same number of pieces", len == a1.len));
+      assert(((void) "Stays done", !d4_strview_iter_next(&it, &piece)));
+      d4_arr_strview_free(a1);
+    }
+  }
+}
+
+static void test_strview_splitN (void) {
+  d4_strview_t v1 = {L"a,b,,c", 6};
+  d4_strview_t v2 = {L",", 1};
+  d4_arr_strview_t a1 = d4_strview_splitN(v1, 1, v2, 0);
+  d4_arr_strview_t a2 = d4_strview_splitN(v1, 1, v2, 1);
+  d4_arr_strview_t a3 = d4_strview_splitN(v1, 1, v2, 3);
+  d4_arr_strview_t a4 = d4_strview_splitN(v1, 1, v2, 10);
+  d4_arr_strview_t a5 = d4_strview_splitN((d4_strview_t) {L"a,", 2}, 1, v2, 2);
+  d4_arr_strview_t a6 = d4_strview_splitN((d4_strview_t) {L"abc", 3}, 0, (d4_strview_t) {NULL, 0}, 2);
+
+  assert(((void) "Splits into nothing", a1.len == 0));
+  assert(((void) "Keeps view unsplit", a2.len == 1 && view_eq(a2.data[0], L"a,b,,c")));
+  assert(((void) "Keeps rest in the last piece", a3.len == 3 && view_eq(a3.data[1], L"b") && view_eq(a3.data[2], L",c")));
+  assert(((void) "Splits fully below limit", a4.len == 4 && view_eq(a4.data[3], L"c")));
+  assert(((void) "Keeps trailing empty piece", a5.len == 2 && a5.data[1].len == 0));
+  assert(((void) "Splits into characters", a6.len == 2 && view_eq(a6.data[0], L"a") && view_eq(a6.data[1], L"bc")));
+
+  d4_arr_strview_free(a1);
+  d4_arr_strview_free(a2);
+  d4_arr_strview_free(a3);
+  d4_arr_strview_free(a4);
+  d4_arr_strview_free(a5);
+  d4_arr_strview_free(a6);
+}
+
+static void test_strview_startsWith (void) {
+  d4_strview_t v1 = {L"hello world", 5};
+
+  assert(((void) "Starts with viewed characters", d4_strview_startsWith(v1, (d4_strview_t) {L"he", 2})));
+  assert(((void) "Doesn't start with longer view", !d4_strview_startsWith(v1, (d4_strview_t) {L"hello ", 6})));
+}
+
+static void test_strview_toOwned (void) {
+  d4_str_t s1 = d4_strview_toOwned((d4_strview_t) {L"hello world", 5});
+  d4_str_t s2 = d4_strview_toOwned((d4_strview_t) {NULL, 0});
+
+  assert(((void) "Copies viewed characters", d4_str_eq(s1, (d4_str_t) {L"hello", 5, true})));
+  assert(((void) "Terminates data", s1.data[s1.len] == L'\0'));
+  assert(((void) "Copies empty view", d4_str_eq(s2, d4_str_empty_val)));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_strview_trim (void) {
+  d4_strview_t v1 = {L"  \ttest \n", 9};
+  d4_strview_t v2 = {L" \t\n ", 4};
+
+  assert(((void) "Trims both ends", view_eq(d4_strview_trim(v1), L"test")));
+  assert(((void) "Trims end", view_eq(d4_strview_trimEnd(v1), L"  \ttest")));
+  assert(((void) "Trims start", view_eq(d4_strview_trimStart(v1), L"test \n")));
+  assert(((void) "Trims whitespace only view", d4_strview_trim(v2).len == 0 && d4_strview_trimEnd(v2).len == 0 && d4_strview_trimStart(v2).len == 0));
+  assert(((void) "Trims empty view", d4_strview_trim((d4_strview_t) {NULL, 0}).len == 0));
+}
+
+int main (void) {
+  test_strview_contains();
+  test_strview_endsWith();
+  test_strview_eq();
+  test_strview_find();
+  test_strview_from();
+  test_strview_iter_rest();
+  test_strview_lines();
+  test_strview_linesIter();
+  test_strview_slice();
+  test_strview_split();
+  test_strview_splitIter();
+  test_strview_splitN();
+  test_strview_startsWith();
+  test_strview_toOwned();
+  test_strview_trim();
+}
@@ -0,0 +1,183 @@
+/*!
+ * Copyright (c) Aaron Delasy
+ * Licensed under the MIT License
+ */
+
+#include "../include/d4/macro.h"
+#include <assert.h>
+#include <wctype.h>
+#include "../include/d4/utf8.h"
+
+#define U8(data) ((d4_utf8_t) {data, sizeof(data) - 1, true})
+
+static void test_utf8_alloc (void) {
+  d4_utf8_t s1 = d4_utf8_alloc("%s %d", "caf\xC3\xA9", 42);
+  d4_utf8_t s2 = d4_utf8_alloc("");
+  d4_utf8_t s3 = d4_utf8_calloc("test", 3);
+
+  assert(((void) "Allocates with format", d4_utf8_eq(s1, U8("caf\xC3\xA9 42")) && s1.data[s1.len] == '\0'));
+  assert(((void) "Allocates empty", d4_utf8_eq(s2, d4_utf8_empty_val)));
+  assert(((void) "Allocates part of bytes", d4_utf8_eq(s3, U8("tes"))));
+
+  d4_utf8_free(s1);
+  d4_utf8_free(s2);
+  d4_utf8_free(s3);
+}
+
+static void test_utf8_compare (void) {
+  assert(((void) "Compares by code points", d4_utf8_lt(U8("z"), U8("\xC3\xA9")) && d4_utf8_gt(U8("\xC3\xA9"), U8("z"))));
+  assert(((void) "Compares prefix", d4_utf8_lt(U8("ab"), U8("abc")) && d4_utf8_le(U8("ab"), U8("ab")) && d4_utf8_ge(U8("ab"), U8("ab"))));
+  assert(((void) "Compares empty", d4_utf8_lt(d4_utf8_empty_val, U8("a")) && !d4_utf8_gt(d4_utf8_empty_val, d4_utf8_empty_val)));
+  assert(((void) "Checks emptiness", d4_utf8_empty(d4_utf8_empty_val) && d4_utf8_not(d4_utf8_empty_val) && !d4_utf8_empty(U8("a"))));
+}
+
+static void test_utf8_concat (void) {
+  d4_utf8_t s1 = d4_utf8_concat(U8("caf"), U8("\xC3\xA9"));
+  d4_utf8_t s2 = d4_utf8_concat(d4_utf8_empty_val, d4_utf8_empty_val);
+  d4_utf8_t s3 = d4_utf8_copy(s1);
+
+  assert(((void) "Concatenates bytes", d4_utf8_eq(s1, U8("caf\xC3\xA9"))));
+  assert(((void) "Concatenates empty", s2.len == 0));
+  assert(((void) "Copies", d4_utf8_eq(s3, s1) && s3.data != s1.data));
+
+  d4_utf8_free(s1);
+  d4_utf8_free(s2);
+  d4_utf8_free(s3);
+}
+
+static void test_utf8_escape (void) {
+  d4_utf8_t s1 = d4_utf8_escape(U8("\"caf\xC3\xA9\"\t\n"));
+
+  assert(((void) "Escapes the same characters as strings", d4_utf8_eq(s1, U8("\\\"caf\xC3\xA9\\\"\\t\\n"))));
+
+  d4_utf8_free(s1);
+}
+
+static void test_utf8_find (void) {
+  d4_utf8_t s1 = U8("\xC3\xA9t\xC3\xA9 caf\xC3\xA9");
+
+  assert(((void) "Finds in characters", d4_utf8_find(s1, U8("caf")) == 4));
+  assert(((void) "Finds empty", d4_utf8_find(s1, d4_utf8_empty_val) == 0));
+  assert(((void) "Doesn't find missing", d4_utf8_find(s1, U8("tea")) == -1));
+  assert(((void) "Contains", d4_utf8_contains(s1, U8("\xC3\xA9 c")) && !d4_utf8_contains(s1, U8("x"))));
+  assert(((void) "Starts and ends with", d4_utf8_startsWith(s1, U8("\xC3\xA9t")) && d4_utf8_endsWith(s1, U8("f\xC3\xA9"))));
+}
+
+static void test_utf8_fromStr (void) {
+  d4_str_t s1 = d4_str_alloc(L"aé€%lc", (wint_t) 0x1F600);
+  d4_utf8_t u1 = d4_utf8_fromStr(s1);
+  d4_str_t r1 = d4_utf8_str(u1);
+  d4_str_t r2 = d4_utf8_str(U8("a\xFF\xC3"));
+
+  assert(((void) "Encodes every length", d4_utf8_eq(u1, U8("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80"))));
+  assert(((void) "Decodes back", d4_str_eq(r1, s1)));
+  assert(((void) "Decodes invalid bytes as replacement character", d4_str_eq(r2, (d4_str_t) {L"a\uFFFD\uFFFD", 3, true})));
+  assert(((void) "Counts characters", d4_utf8_len(u1) == 4));
+
+  d4_str_free(s1);
+  d4_str_free(r1);
+  d4_str_free(r2);
+  d4_utf8_free(u1);
+}
+
+static void test_utf8_lines (void) {
+  d4_arr_utf8_t a1 = d4_utf8_lines(U8("caf\xC3\xA9\r\n\nend"), 0, false);
+  d4_arr_utf8_t a2 = d4_utf8_lines(U8("a\nb\n"), 1, true);
+
+  assert(((void) "Splits lines", a1.len == 3 && d4_utf8_eq(a1.data[0], U8("caf\xC3\xA9")) && a1.data[1].len == 0 && d4_utf8_eq(a1.data[2], U8("end"))));
+  assert(((void) "Keeps line breaks", a2.len == 2 && d4_utf8_eq(a2.data[1], U8("b\n"))));
+
+  d4_arr_utf8_free(a1);
+  d4_arr_utf8_free(a2);
+}
+
+static void test_utf8_lower_upper (void) {
+  d4_utf8_t s1 = d4_utf8_lower(U8("Hello, WORLD"));
+  d4_utf8_t s2 = d4_utf8_upper(U8("Hello, world"));
+  d4_utf8_t s3 = d4_utf8_lower(U8("CAF\xC3\x89 @[`{"));
+  d4_str_t r3 = d4_utf8_str(s3);
+
+  assert(((void) "Lowers ASCII", d4_utf8_eq(s1, U8("hello, world"))));
+  assert(((void) "Uppers ASCII", d4_utf8_eq(s2, U8("HELLO, WORLD"))));
+  assert(((void) "Lowers non-ASCII", d4_utf8_startsWith(s3, U8("caf")) && r3.data[3] == (wchar_t) towlower(L'É') && d4_utf8_endsWith(s3, U8(" @[`{"))));
+
+  d4_utf8_free(s1);
+  d4_utf8_free(s2);
+  d4_utf8_free(s3);
+  d4_str_free(r3);
+}
+
+static void test_utf8_replace (void) {
+  d4_utf8_t s1 = d4_utf8_replace(U8("caf\xC3\xA9 caf\xC3\xA9"), U8("\xC3\xA9"), U8("e"), 0, 0);
+  d4_utf8_t s2 = d4_utf8_replace(U8("caf\xC3\xA9 caf\xC3\xA9"), U8("caf"), U8("th"), 1, 1);
+  d4_utf8_t s3 = d4_utf8_replace(U8("\xC3\xA9\xC3\xA9"), d4_utf8_empty_val, U8("-"), 0, 0);
+
+  assert(((void) "Replaces all", d4_utf8_eq(s1, U8("cafe cafe"))));
+  assert(((void) "Replaces count", d4_utf8_eq(s2, U8("th\xC3\xA9 caf\xC3\xA9"))));
+  assert(((void) "Replaces empty between characters", d4_utf8_eq(s3, U8("-\xC3\xA9-\xC3\xA9-"))));
+
+  d4_utf8_free(s1);
+  d4_utf8_free(s2);
+  d4_utf8_free(s3);
+}
+
+static void test_utf8_slice (void) {
+  d4_utf8_t s1 = U8("\xC3\xA9t\xC3\xA9 caf\xC3\xA9");
+  d4_utf8_t r1 = d4_utf8_slice(s1, 1, 4, 0, 0);
+  d4_utf8_t r2 = d4_utf8_slice(s1, 1, -4, 1, -1);
+  d4_utf8_t r3 = d4_utf8_slice(s1, 1, 2, 1, 1);
+
+  assert(((void) "Slices by characters", d4_utf8_eq(r1, U8("caf\xC3\xA9"))));
+  assert(((void) "Slices with negative indexes", d4_utf8_eq(r2, U8("caf"))));
+  assert(((void) "Slices reversed range", r3.len == 0));
+
+  d4_utf8_free(r1);
+  d4_utf8_free(r2);
+  d4_utf8_free(r3);
+}
+
+static void test_utf8_split (void) {
+  d4_arr_utf8_t a1 = d4_utf8_split(U8("a,\xC3\xA9,,"), 1, U8(","));
+  d4_arr_utf8_t a2 = d4_utf8_split(U8("a\xC3\xA9"), 0, d4_utf8_empty_val);
+  d4_arr_utf8_t a3 = d4_utf8_split(d4_utf8_empty_val, 1, U8(","));
+
+  assert(((void) "Splits by delimiter", a1.len == 4 && d4_utf8_eq(a1.data[1], U8("\xC3\xA9")) && a1.data[3].len == 0));
+  assert(((void) "Splits into characters", a2.len == 2 && d4_utf8_eq(a2.data[1], U8("\xC3\xA9"))));
+  assert(((void) "Splits empty", a3.len == 1 && a3.data[0].len == 0));
+
+  d4_arr_utf8_free(a1);
+  d4_arr_utf8_free(a2);
+  d4_arr_utf8_free(a3);
+}
+
+static void test_utf8_trim (void) {
+  d4_utf8_t r1 = d4_utf8_trim(U8(" \t caf\xC3\xA9 \n"));
+  d4_utf8_t r2 = d4_utf8_trimStart(U8("  a "));
+  d4_utf8_t r3 = d4_utf8_trimEnd(U8("  \xC3\xA9 "));
+  d4_utf8_t r4 = d4_utf8_trim(U8(" \t\n "));
+
+  assert(((void) "Trims both ends", d4_utf8_eq(r1, U8("caf\xC3\xA9"))));
+  assert(((void) "Trims start", d4_utf8_eq(r2, U8("a "))));
+  assert(((void) "Trims end", d4_utf8_eq(r3, U8("  \xC3\xA9"))));
+  assert(((void) "Trims whitespace only", r4.len == 0));
+
+  d4_utf8_free(r1);
+  d4_utf8_free(r2);
+  d4_utf8_free(r3);
+  d4_utf8_free(r4);
+}
+
+int main (void) {
+  test_utf8_alloc();
+  test_utf8_compare();
+  test_utf8_concat();
+  test_utf8_escape();
+  test_utf8_find();
+  test_utf8_fromStr();
+  test_utf8_lines();
+  test_utf8_lower_upper();
+  test_utf8_replace();
+  test_utf8_slice();
+  test_utf8_split();
+  test_utf8_trim();
+}